@@ -0,0 +1,220 @@
+//----------------------------------------------------------------------------
+//
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//
+//----------------------------------------------------------------------------
+
+#include "command_buffer_c.h"
+
+using namespace emgu;
+
+static bool commandBufferOpIsBinary(int op)
+{
+	return (op >= CB_OP_ADD && op <= CB_OP_BITWISE_XOR) || op == CB_OP_ADD_WEIGHTED;
+}
+
+void CommandBuffer::record(int op, int src1, int src2, int dst, const double* doubleParams, const int* intParams)
+{
+	if (op < 0 || op >= CB_OP_COUNT)
+		CV_Error(cv::Error::StsOutOfRange, "Unknown command buffer operation");
+	if (dst < 0)
+		CV_Error(cv::Error::StsOutOfRange, "The destination register must be non-negative");
+	if (op != CB_OP_SET_TO && src1 < 0)
+		CV_Error(cv::Error::StsOutOfRange, "The source register must be non-negative");
+	if (commandBufferOpIsBinary(op) && src2 < 0)
+		CV_Error(cv::Error::StsOutOfRange, "The second source register must be non-negative");
+
+	Command c;
+	c.op = op;
+	c.src1 = src1;
+	c.src2 = commandBufferOpIsBinary(op) ? src2 : -1;
+	c.dst = dst;
+	for (int i = 0; i < 4; i++)
+	{
+		c.doubleParams[i] = doubleParams ? doubleParams[i] : 0.0;
+		c.intParams[i] = intParams ? intParams[i] : 0;
+	}
+	commands.push_back(c);
+
+	registerCount = std::max(registerCount, std::max(dst, std::max(c.src1, c.src2)) + 1);
+}
+
+static void runCommand(const Command& c, cv::Mat** regs)
+{
+	const double* d = c.doubleParams;
+	const int* i = c.intParams;
+	cv::Mat& dst = *regs[c.dst];
+	switch (c.op)
+	{
+	case CB_OP_COPY:
+		regs[c.src1]->copyTo(dst);
+		break;
+	case CB_OP_ADD:
+		cv::add(*regs[c.src1], *regs[c.src2], dst, cv::noArray(), i[0]);
+		break;
+	case CB_OP_SUBTRACT:
+		cv::subtract(*regs[c.src1], *regs[c.src2], dst, cv::noArray(), i[0]);
+		break;
+	case CB_OP_MULTIPLY:
+		cv::multiply(*regs[c.src1], *regs[c.src2], dst, d[0], i[0]);
+		break;
+	case CB_OP_DIVIDE:
+		cv::divide(*regs[c.src1], *regs[c.src2], dst, d[0], i[0]);
+		break;
+	case CB_OP_ABSDIFF:
+		cv::absdiff(*regs[c.src1], *regs[c.src2], dst);
+		break;
+	case CB_OP_MIN:
+		cv::min(*regs[c.src1], *regs[c.src2], dst);
+		break;
+	case CB_OP_MAX:
+		cv::max(*regs[c.src1], *regs[c.src2], dst);
+		break;
+	case CB_OP_BITWISE_AND:
+		cv::bitwise_and(*regs[c.src1], *regs[c.src2], dst);
+		break;
+	case CB_OP_BITWISE_OR:
+		cv::bitwise_or(*regs[c.src1], *regs[c.src2], dst);
+		break;
+	case CB_OP_BITWISE_XOR:
+		cv::bitwise_xor(*regs[c.src1], *regs[c.src2], dst);
+		break;
+	case CB_OP_BITWISE_NOT:
+		cv::bitwise_not(*regs[c.src1], dst);
+		break;
+	case CB_OP_ADD_WEIGHTED:
+		cv::addWeighted(*regs[c.src1], d[0], *regs[c.src2], d[1], d[2], dst, i[0]);
+		break;
+	case CB_OP_CONVERT_TO:
+		regs[c.src1]->convertTo(dst, i[0], d[0], d[1]);
+		break;
+	case CB_OP_SET_TO:
+		dst.setTo(cv::Scalar(d[0], d[1], d[2], d[3]));
+		break;
+	case CB_OP_THRESHOLD:
+		cv::threshold(*regs[c.src1], dst, d[0], d[1], i[0]);
+		break;
+	case CB_OP_CVT_COLOR:
+		cv::cvtColor(*regs[c.src1], dst, i[0], i[1]);
+		break;
+	case CB_OP_GAUSSIAN_BLUR:
+		cv::GaussianBlur(*regs[c.src1], dst, cv::Size(i[0], i[1]), d[0], d[1], i[2]);
+		break;
+	case CB_OP_BLUR:
+		cv::blur(*regs[c.src1], dst, cv::Size(i[0], i[1]), cv::Point(-1, -1), i[2]);
+		break;
+	case CB_OP_MEDIAN_BLUR:
+		cv::medianBlur(*regs[c.src1], dst, i[0]);
+		break;
+	case CB_OP_RESIZE:
+		cv::resize(*regs[c.src1], dst, cv::Size(i[0], i[1]), d[0], d[1], i[2]);
+		break;
+	case CB_OP_SOBEL:
+		cv::Sobel(*regs[c.src1], dst, i[0], i[1], i[2], i[3], d[0], d[1]);
+		break;
+	}
+}
+
+void CommandBufferRegisters::bind(cv::Mat** mats, int count, int registerCount)
+{
+	//resize only allocates on the first call, the scratch Mats that are already there keep their data
+	scratch.resize(std::max(registerCount - count, 0));
+	regs.resize(std::max(registerCount, count));
+	for (int i = 0; i < static_cast<int>(regs.size()); i++)
+		regs[i] = i < count ? mats[i] : &scratch[i - count];
+}
+
+void CommandBuffer::checkScratchRegisters(int count) const
+{
+	//SET_TO keeps the size and type of its destination, it reads it as well
+	std::vector<bool> written(std::max(registerCount - count, 0), false);
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		const Command& c = commands[i];
+		int reads[] = { c.src1, c.src2, c.op == CB_OP_SET_TO ? c.dst : -1 };
+		for (int j = 0; j < 3; j++)
+			if (reads[j] >= count && !written[reads[j] - count])
+				CV_Error(cv::Error::StsBadArg, "A scratch register is read before a command has written it");
+		if (c.dst >= count && c.op != CB_OP_SET_TO)
+			written[c.dst - count] = true;
+	}
+}
+
+void CommandBuffer::execute(cv::Mat** mats, int count) const
+{
+	checkScratchRegisters(count);
+	CommandBufferRegisters registers;
+	execute(mats, count, registers);
+}
+
+void CommandBuffer::execute(cv::Mat** mats, int count, CommandBufferRegisters& registers) const
+{
+	registers.bind(mats, count, registerCount);
+	for (size_t i = 0; i < commands.size(); i++)
+		runCommand(commands[i], registers.regs.data());
+}
+
+class CommandBufferTileInvoker : public cv::ParallelLoopBody
+{
+public:
+	const CommandBuffer* buffer;
+	cv::Mat** mats;
+	int registersPerTile;
+
+	CommandBufferTileInvoker(const CommandBuffer* b, cv::Mat** m, int r)
+		: buffer(b), mats(m), registersPerTile(r)
+	{
+	}
+
+	void operator()(const cv::Range& range) const CV_OVERRIDE
+	{
+		//The scratch Mats are allocated by the first tile of the range, the following tiles of the same size write into the same buffers
+		CommandBufferRegisters registers;
+		for (int t = range.start; t < range.end; t++)
+			buffer->execute(mats + static_cast<size_t>(t) * registersPerTile, registersPerTile, registers);
+	}
+};
+
+void CommandBuffer::executeTiles(cv::Mat** mats, int count, int tileCount, bool parallel) const
+{
+	CV_Assert(tileCount > 0 && count % tileCount == 0);
+	int registersPerTile = count / tileCount;
+	checkScratchRegisters(registersPerTile);
+	CommandBufferTileInvoker invoker(this, mats, registersPerTile);
+	if (parallel && tileCount > 1)
+		//One range per worker thread, rather than one per tile, such that every worker allocates its scratch Mats only once
+		cv::parallel_for_(cv::Range(0, tileCount), invoker, std::min(tileCount, std::max(cv::getNumThreads(), 1)));
+	else
+		invoker(cv::Range(0, tileCount));
+}
+
+CommandBuffer* cveCommandBufferCreate()
+{
+	return new CommandBuffer();
+}
+void cveCommandBufferRelease(CommandBuffer** buffer)
+{
+	delete *buffer;
+	*buffer = 0;
+}
+void cveCommandBufferRecord(CommandBuffer* buffer, int op, int src1, int src2, int dst, double* doubleParams, int* intParams)
+{
+	buffer->record(op, src1, src2, dst, doubleParams, intParams);
+}
+void cveCommandBufferClear(CommandBuffer* buffer)
+{
+	buffer->commands.clear();
+	buffer->registerCount = 0;
+}
+int cveCommandBufferGetCount(CommandBuffer* buffer)
+{
+	return static_cast<int>(buffer->commands.size());
+}
+int cveCommandBufferGetRegisterCount(CommandBuffer* buffer)
+{
+	return buffer->registerCount;
+}
+void cveCommandBufferExecute(CommandBuffer* buffer, cv::Mat** mats, int count, int tileCount, bool parallel)
+{
+	buffer->executeTiles(mats, count, tileCount, parallel);
+}
@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------------
+//
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+#ifndef EMGU_COMMAND_BUFFER_C_H
+#define EMGU_COMMAND_BUFFER_C_H
+
+#include "opencv2/core/core_c.h"
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "emgu_c.h"
+
+#include <vector>
+
+namespace emgu
+{
+	/*
+	 * The operations that can be recorded in a CommandBuffer.
+	 * The parameters of each operation are stored in the doubleParams / intParams of the command.
+	 */
+	enum CommandBufferOp
+	{
+		CB_OP_COPY = 0,          //dst = src1
+		CB_OP_ADD,               //dst = src1 + src2; i0: dtype
+		CB_OP_SUBTRACT,          //dst = src1 - src2; i0: dtype
+		CB_OP_MULTIPLY,          //dst = src1 * src2 * d0; i0: dtype
+		CB_OP_DIVIDE,            //dst = src1 / src2 * d0; i0: dtype
+		CB_OP_ABSDIFF,           //dst = |src1 - src2|
+		CB_OP_MIN,               //dst = min(src1, src2)
+		CB_OP_MAX,               //dst = max(src1, src2)
+		CB_OP_BITWISE_AND,       //dst = src1 & src2
+		CB_OP_BITWISE_OR,        //dst = src1 | src2
+		CB_OP_BITWISE_XOR,       //dst = src1 ^ src2
+		CB_OP_BITWISE_NOT,       //dst = ~src1
+		CB_OP_ADD_WEIGHTED,      //dst = src1 * d0 + src2 * d1 + d2; i0: dtype
+		CB_OP_CONVERT_TO,        //dst = src1 * d0 + d1; i0: rtype
+		CB_OP_SET_TO,            //dst = (d0, d1, d2, d3)
+		CB_OP_THRESHOLD,         //d0: thresh, d1: maxval, i0: type
+		CB_OP_CVT_COLOR,         //i0: code, i1: dstCn
+		CB_OP_GAUSSIAN_BLUR,     //i0, i1: ksize, d0: sigmaX, d1: sigmaY, i2: borderType
+		CB_OP_BLUR,              //i0, i1: ksize, i2: borderType
+		CB_OP_MEDIAN_BLUR,       //i0: ksize
+		CB_OP_RESIZE,            //i0, i1: dsize, d0: fx, d1: fy, i2: interpolation
+		CB_OP_SOBEL,             //i0: ddepth, i1: dx, i2: dy, i3: ksize, d0: scale, d1: delta
+		CB_OP_COUNT
+	};
+
+	struct Command
+	{
+		int op;
+		int src1;
+		int src2;
+		int dst;
+		double doubleParams[4];
+		int intParams[4];
+	};
+
+	/*
+	 * The registers of an execution: the Mats passed in, followed by the scratch Mats.
+	 * The scratch Mats keep their buffers from one execution to the next, such that a worker running many tiles allocates them only once.
+	 */
+	class CommandBufferRegisters
+	{
+	public:
+		std::vector<cv::Mat> scratch;
+		std::vector<cv::Mat*> regs;
+
+		//Point the first count registers to mats, the following ones to the scratch Mats
+		void bind(cv::Mat** mats, int count, int registerCount);
+	};
+
+	/*
+	 * A list of operations over "registers", the indices of the Mats passed in at execution time.
+	 * Recording once and executing the whole chain in a single native call amortizes the cost of
+	 * crossing the managed boundary and of creating the Input / Output array wrappers per function call.
+	 */
+	class CommandBuffer
+	{
+	public:
+		std::vector<Command> commands;
+		//The number of registers referenced by the recorded commands
+		int registerCount;
+
+		CommandBuffer()
+			: registerCount(0)
+		{
+		}
+
+		void record(int op, int src1, int src2, int dst, const double* doubleParams, const int* intParams);
+
+		//Run the commands on a single set of registers.
+		//Registers with index >= count are scratch Mats that live for the duration of the call.
+		void execute(cv::Mat** mats, int count) const;
+
+		//Run the commands on a single set of registers, the scratch Mats are taken from registers and reused by the next call.
+		//The scratch Mats still hold the data of the previous call, the commands must have passed checkScratchRegisters.
+		void execute(cv::Mat** mats, int count, CommandBufferRegisters& registers) const;
+
+		//Run the commands on tileCount independent set of registers, stored one after the other in mats.
+		//Each worker binds one set of scratch Mats and reuses it for all the tiles of its range.
+		void executeTiles(cv::Mat** mats, int count, int tileCount, bool parallel) const;
+
+		//Raise an error if a command reads a scratch register, with index >= count, before a command has written it,
+		//such that no result depends on the data left in the scratch Mats by a previous tile
+		void checkScratchRegisters(int count) const;
+	};
+}
+
+CVAPI(emgu::CommandBuffer*) cveCommandBufferCreate();
+CVAPI(void) cveCommandBufferRelease(emgu::CommandBuffer** buffer);
+CVAPI(void) cveCommandBufferRecord(emgu::CommandBuffer* buffer, int op, int src1, int src2, int dst, double* doubleParams, int* intParams);
+CVAPI(void) cveCommandBufferClear(emgu::CommandBuffer* buffer);
+CVAPI(int) cveCommandBufferGetCount(emgu::CommandBuffer* buffer);
+CVAPI(int) cveCommandBufferGetRegisterCount(emgu::CommandBuffer* buffer);
+CVAPI(void) cveCommandBufferExecute(emgu::CommandBuffer* buffer, cv::Mat** mats, int count, int tileCount, bool parallel);
+
+#endif
@@ -6,6 +6,11 @@
 
 #include "mat_c.h"
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
 class EmguMatAllocator : public cv::MatAllocator
 {
 public:
@@ -73,6 +78,290 @@ public:
 	}
 };
 
+//Blocks smaller than this are rounded up to this size
+static const size_t POOL_MIN_BLOCK_SIZE = 256;
+//Each power of two range is split into this many size classes, bounding the wasted space to 25%
+static const int POOL_SUB_CLASSES = 4;
+static const int POOL_SIZE_CLASS_COUNT = 1 + (64 - 8) * POOL_SUB_CLASSES;
+
+static int poolSizeClass(size_t size, size_t* blockSize)
+{
+	if (size <= POOL_MIN_BLOCK_SIZE)
+	{
+		*blockSize = POOL_MIN_BLOCK_SIZE;
+		return 0;
+	}
+	int log2 = 8;
+	while ((static_cast<size_t>(1) << (log2 + 1)) < size)
+		log2++;
+	size_t base = static_cast<size_t>(1) << log2;
+	size_t step = base / POOL_SUB_CLASSES;
+	size_t j = (size - base + step - 1) / step;
+	*blockSize = base + j * step;
+	return 1 + (log2 - 8) * POOL_SUB_CLASSES + static_cast<int>(j - 1);
+}
+
+static size_t poolBlockSize(int sizeClass)
+{
+	if (sizeClass == 0)
+		return POOL_MIN_BLOCK_SIZE;
+	size_t base = static_cast<size_t>(1) << (8 + (sizeClass - 1) / POOL_SUB_CLASSES);
+	return base + (base / POOL_SUB_CLASSES) * ((sizeClass - 1) % POOL_SUB_CLASSES + 1);
+}
+
+struct EmguPoolMatAllocator::PoolState
+{
+	std::atomic<size_t> highWaterMark;
+	int threadCacheBlocks;
+	uint64 id;
+
+	std::mutex mutex;
+	std::vector< std::vector<uchar*> > buckets;
+
+	std::atomic<int64> hits;
+	std::atomic<int64> misses;
+	std::atomic<int64> bytesRetained;
+
+	PoolState(size_t highWater, int cacheBlocks, uint64 poolId)
+		: highWaterMark(highWater), threadCacheBlocks(cacheBlocks), id(poolId), buckets(POOL_SIZE_CLASS_COUNT),
+		hits(0), misses(0), bytesRetained(0)
+	{
+	}
+
+	~PoolState()
+	{
+		for (size_t i = 0; i < buckets.size(); i++)
+			for (size_t j = 0; j < buckets[i].size(); j++)
+				cv::fastFree(buckets[i][j]);
+	}
+
+	//Reserve room for a block below the high water mark. Returns false if the block should be freed instead.
+	bool reserve(size_t blockSize)
+	{
+		int64 retained = bytesRetained.fetch_add(static_cast<int64>(blockSize)) + static_cast<int64>(blockSize);
+		if (retained > static_cast<int64>(highWaterMark.load()))
+		{
+			bytesRetained.fetch_sub(static_cast<int64>(blockSize));
+			return false;
+		}
+		return true;
+	}
+
+	void pushShared(int sizeClass, size_t blockSize, uchar* block)
+	{
+		if (reserve(blockSize))
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			buckets[sizeClass].push_back(block);
+		}
+		else
+			cv::fastFree(block);
+	}
+
+	uchar* popShared(int sizeClass, size_t blockSize)
+	{
+		uchar* block = 0;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			std::vector<uchar*>& bucket = buckets[sizeClass];
+			if (!bucket.empty())
+			{
+				block = bucket.back();
+				bucket.pop_back();
+			}
+		}
+		if (block)
+			bytesRetained.fetch_sub(static_cast<int64>(blockSize));
+		return block;
+	}
+};
+
+//The per-thread block caches, one for each pool allocator the thread has been using.
+struct PoolThreadCache
+{
+	struct Entry
+	{
+		std::weak_ptr<EmguPoolMatAllocator::PoolState> pool;
+		std::vector< std::vector<uchar*> > buckets;
+	};
+	std::map<uint64, Entry> entries;
+
+	Entry& get(const std::shared_ptr<EmguPoolMatAllocator::PoolState>& pool)
+	{
+		std::map<uint64, Entry>::iterator it = entries.find(pool->id);
+		if (it != entries.end())
+			return it->second;
+
+		//Drop the caches of the allocators that have already been released
+		for (it = entries.begin(); it != entries.end();)
+		{
+			if (it->second.pool.expired())
+			{
+				flush(it->second);
+				it = entries.erase(it);
+			}
+			else
+				++it;
+		}
+
+		Entry& e = entries[pool->id];
+		e.pool = pool;
+		e.buckets.resize(POOL_SIZE_CLASS_COUNT);
+		return e;
+	}
+
+	//Return all the cached blocks to the shared pool, or to the system if the pool is gone
+	static void flush(Entry& e)
+	{
+		std::shared_ptr<EmguPoolMatAllocator::PoolState> pool = e.pool.lock();
+		if (pool)
+		{
+			//The cached blocks are already accounted for in bytesRetained
+			std::lock_guard<std::mutex> lock(pool->mutex);
+			for (size_t i = 0; i < e.buckets.size(); i++)
+				pool->buckets[i].insert(pool->buckets[i].end(), e.buckets[i].begin(), e.buckets[i].end());
+		}
+		else
+		{
+			for (size_t i = 0; i < e.buckets.size(); i++)
+				for (size_t j = 0; j < e.buckets[i].size(); j++)
+					cv::fastFree(e.buckets[i][j]);
+		}
+		for (size_t i = 0; i < e.buckets.size(); i++)
+			e.buckets[i].clear();
+	}
+
+	~PoolThreadCache()
+	{
+		for (std::map<uint64, Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+			flush(it->second);
+	}
+};
+
+static thread_local PoolThreadCache poolThreadCache;
+static std::atomic<uint64> poolAllocatorCount(0);
+
+EmguPoolMatAllocator::EmguPoolMatAllocator(size_t highWaterMark, int threadCacheBlocks)
+	: MatAllocator(),
+	state(std::make_shared<PoolState>(highWaterMark, threadCacheBlocks < 0 ? 0 : threadCacheBlocks, ++poolAllocatorCount))
+{
+}
+
+EmguPoolMatAllocator::~EmguPoolMatAllocator()
+{
+}
+
+cv::UMatData* EmguPoolMatAllocator::allocate(int dims, const int* sizes, int type,
+	void* data0, size_t* step, cv::AccessFlag /*flags*/, cv::UMatUsageFlags /*usageFlags*/) const
+{
+	size_t total = CV_ELEM_SIZE(type);
+	for (int i = dims - 1; i >= 0; i--)
+	{
+		if (step)
+		{
+			if (data0 && step[i] != CV_AUTOSTEP)
+			{
+				CV_Assert(total <= step[i]);
+				total = step[i];
+			}
+			else
+				step[i] = total;
+		}
+		total *= sizes[i];
+	}
+
+	uchar* data = static_cast<uchar*>(data0);
+	if (!data)
+	{
+		size_t blockSize;
+		int sizeClass = poolSizeClass(total, &blockSize);
+		if (state->threadCacheBlocks > 0)
+		{
+			std::vector<uchar*>& bucket = poolThreadCache.get(state).buckets[sizeClass];
+			if (!bucket.empty())
+			{
+				data = bucket.back();
+				bucket.pop_back();
+				state->bytesRetained.fetch_sub(static_cast<int64>(blockSize));
+			}
+		}
+		if (!data)
+			data = state->popShared(sizeClass, blockSize);
+
+		if (data)
+			state->hits++;
+		else
+		{
+			state->misses++;
+			data = static_cast<uchar*>(cv::fastMalloc(blockSize));
+		}
+	}
+
+	cv::UMatData* u = new cv::UMatData(this);
+	u->data = u->origdata = data;
+	u->size = total;
+	if (data0)
+		u->flags |= cv::UMatData::USER_ALLOCATED;
+
+	return u;
+}
+
+bool EmguPoolMatAllocator::allocate(cv::UMatData* u, cv::AccessFlag /*accessFlags*/, cv::UMatUsageFlags /*usageFlags*/) const
+{
+	if (!u) return false;
+	return true;
+}
+
+void EmguPoolMatAllocator::deallocate(cv::UMatData* u) const
+{
+	if (!u)
+		return;
+
+	CV_Assert(u->urefcount == 0);
+	CV_Assert(u->refcount == 0);
+	if (!(u->flags & cv::UMatData::USER_ALLOCATED))
+	{
+		size_t blockSize;
+		int sizeClass = poolSizeClass(u->size, &blockSize);
+		bool cached = false;
+		if (state->threadCacheBlocks > 0)
+		{
+			std::vector<uchar*>& bucket = poolThreadCache.get(state).buckets[sizeClass];
+			if (static_cast<int>(bucket.size()) < state->threadCacheBlocks && state->reserve(blockSize))
+			{
+				bucket.push_back(u->origdata);
+				cached = true;
+			}
+		}
+		if (!cached)
+			state->pushShared(sizeClass, blockSize, u->origdata);
+		u->origdata = 0;
+	}
+	delete u;
+}
+
+void EmguPoolMatAllocator::trim()
+{
+	std::map<uint64, PoolThreadCache::Entry>::iterator it = poolThreadCache.entries.find(state->id);
+	if (it != poolThreadCache.entries.end())
+	{
+		PoolThreadCache::flush(it->second);
+		poolThreadCache.entries.erase(it);
+	}
+
+	std::vector< std::vector<uchar*> > buckets(POOL_SIZE_CLASS_COUNT);
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		std::swap(buckets, state->buckets);
+	}
+	for (size_t i = 0; i < buckets.size(); i++)
+	{
+		for (size_t j = 0; j < buckets[i].size(); j++)
+			cv::fastFree(buckets[i][j]);
+		state->bytesRetained.fetch_sub(static_cast<int64>(poolBlockSize(static_cast<int>(i)) * buckets[i].size()));
+	}
+}
+
 /*
 cv::MatAllocator* emguMatAllocatorCreate(MatAllocateCallback allocator, MatDeallocateCallback deallocator, void* allocateDataActionPtr, void* freeDataActionPtr)
 {
@@ -91,6 +380,49 @@ cv::Mat* cveMatCreate()
 {
 	return new cv::Mat();
 }
+
+EmguPoolMatAllocator* cveMatPoolAllocatorCreate(size_t highWaterMark, int threadCacheBlocks, cv::MatAllocator** matAllocator)
+{
+	EmguPoolMatAllocator* allocator = new EmguPoolMatAllocator(highWaterMark, threadCacheBlocks);
+	*matAllocator = dynamic_cast<cv::MatAllocator*>(allocator);
+	return allocator;
+}
+void cveMatPoolAllocatorRelease(EmguPoolMatAllocator** allocator)
+{
+	if (*allocator)
+	{
+		if (cv::Mat::getDefaultAllocator() == *allocator)
+			cv::Mat::setDefaultAllocator(0);
+		delete *allocator;
+		*allocator = 0;
+	}
+}
+void cveMatPoolAllocatorGetStats(EmguPoolMatAllocator* allocator, int64* hits, int64* misses, int64* bytesRetained)
+{
+	*hits = allocator->state->hits.load();
+	*misses = allocator->state->misses.load();
+	*bytesRetained = allocator->state->bytesRetained.load();
+}
+void cveMatPoolAllocatorSetHighWaterMark(EmguPoolMatAllocator* allocator, size_t highWaterMark)
+{
+	allocator->state->highWaterMark = highWaterMark;
+}
+size_t cveMatPoolAllocatorGetHighWaterMark(EmguPoolMatAllocator* allocator)
+{
+	return allocator->state->highWaterMark.load();
+}
+void cveMatPoolAllocatorTrim(EmguPoolMatAllocator* allocator)
+{
+	allocator->trim();
+}
+void cveMatSetDefaultAllocator(cv::MatAllocator* allocator)
+{
+	cv::Mat::setDefaultAllocator(allocator);
+}
+void cveMatSetAllocator(cv::Mat* mat, cv::MatAllocator* allocator)
+{
+	mat->allocator = allocator;
+}
 /*
 cv::MatAllocator* cveMatUseCustomAllocator(cv::Mat* mat, MatAllocateCallback allocator, MatDeallocateCallback deallocator, void* allocateDataActionPtr, void* freeDataActionPtr)
 {
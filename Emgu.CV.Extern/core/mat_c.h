@@ -12,12 +12,48 @@
 #include "opencv2/core/ocl.hpp"
 #include "emgu_c.h"
 
+#include <memory>
+
 typedef uchar* (CV_CDECL *MatAllocateCallback)(int depthType, int channel, int totalInBytes, void* allocateDataActionPtr);
 typedef void (CV_CDECL *MatDeallocateCallback)(void* freeDataActionPtr);
 
 //CVAPI(cv::MatAllocator*) emguMatAllocatorCreate(MatAllocateCallback allocator, MatDeallocateCallback deallocator, void* allocateDataActionPtr, void* freeDataActionPtr);
 //CVAPI(void) cveMatAllocatorRelease(cv::MatAllocator** allocator);
 
+/*
+ * A thread safe, size class bucketed pool allocator for the host memory of Mat and UMat.
+ * Freed blocks are first kept in a small per-thread cache, then in a shared pool, until the total 
+ * number of bytes retained reaches the high water mark; beyond that point blocks are returned to the system.
+ * The allocator must outlive every Mat / UMat that has been allocated with it.
+ */
+class EmguPoolMatAllocator : public cv::MatAllocator
+{
+public:
+	struct PoolState;
+
+	EmguPoolMatAllocator(size_t highWaterMark, int threadCacheBlocks);
+	virtual ~EmguPoolMatAllocator();
+
+	cv::UMatData* allocate(int dims, const int* sizes, int type,
+		void* data0, size_t* step, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const CV_OVERRIDE;
+	bool allocate(cv::UMatData* u, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const CV_OVERRIDE;
+	void deallocate(cv::UMatData* u) const CV_OVERRIDE;
+
+	//Release all the blocks kept in the shared pool and in the cache of the calling thread
+	void trim();
+
+	std::shared_ptr<PoolState> state;
+};
+
+CVAPI(EmguPoolMatAllocator*) cveMatPoolAllocatorCreate(size_t highWaterMark, int threadCacheBlocks, cv::MatAllocator** matAllocator);
+CVAPI(void) cveMatPoolAllocatorRelease(EmguPoolMatAllocator** allocator);
+CVAPI(void) cveMatPoolAllocatorGetStats(EmguPoolMatAllocator* allocator, int64* hits, int64* misses, int64* bytesRetained);
+CVAPI(void) cveMatPoolAllocatorSetHighWaterMark(EmguPoolMatAllocator* allocator, size_t highWaterMark);
+CVAPI(size_t) cveMatPoolAllocatorGetHighWaterMark(EmguPoolMatAllocator* allocator);
+CVAPI(void) cveMatPoolAllocatorTrim(EmguPoolMatAllocator* allocator);
+CVAPI(void) cveMatSetDefaultAllocator(cv::MatAllocator* allocator);
+CVAPI(void) cveMatSetAllocator(cv::Mat* mat, cv::MatAllocator* allocator);
+
 CVAPI(cv::Mat*) cveMatCreate();
 //CVAPI(cv::MatAllocator*) cveMatUseCustomAllocator(cv::Mat* mat, MatAllocateCallback allocator, MatDeallocateCallback deallocator, void* allocateDataActionPtr, void* freeDataActionPtr);
 CVAPI(void) cveMatCreateData(cv::Mat* mat, int row, int cols, int type);
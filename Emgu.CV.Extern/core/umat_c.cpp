@@ -29,6 +29,15 @@ void cveUMatCreateData(cv::UMat* mat, int row, int cols, int type, int flags)
 {
    mat->create(row, cols, type, static_cast<cv::UMatUsageFlags>(flags));
 }
+bool cveUMatSetAllocator(cv::UMat* mat, cv::MatAllocator* allocator)
+{
+   //Only the host memory can be served by a custom allocator, 
+   //leave the UMat alone if the OpenCL allocator is in charge of its data.
+   if (cv::ocl::useOpenCL())
+      return false;
+   mat->allocator = allocator;
+   return true;
+}
 cv::UMat* cveUMatCreateFromRect(cv::UMat* mat, CvRect* roi)
 {
    return new cv::UMat(*mat, *roi);
@@ -6,13 +6,289 @@
 
 #include "dataLogger.h"
 
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 using namespace emgu;
 
+//Bounded MPMC queue (D. Vyukov), each slot carries a sequence number that tells
+//producers and the consumer whether the slot is free, being written or ready.
+struct AsyncDataQueue::Impl
+{
+   struct Slot
+   {
+      std::atomic<size_t> sequence;
+   };
+
+   size_t mask;
+   int recordSize;
+   int overflowPolicy;
+   int batchSize;
+   int loggerId;
+   std::unique_ptr<Slot[]> slots;
+   std::vector<char> storage;
+
+   //Keep the positions written by the producers and by the consumer on different cache lines
+   char pad0[64];
+   std::atomic<size_t> enqueuePos;
+   char pad1[64];
+   std::atomic<size_t> dequeuePos;
+   char pad2[64];
+
+   std::atomic<DataCallback> callback;
+   std::atomic<DataBatchCallback> batchCallback;
+
+   std::atomic<int64> enqueued;
+   std::atomic<int64> dispatched;
+   std::atomic<int64> dropped;
+   //Records that have been enqueued and then discarded to make room for newer ones
+   std::atomic<int64> overwritten;
+
+   std::atomic<bool> stop;
+   std::atomic<bool> consumerSleeping;
+   std::mutex mutex;
+   std::condition_variable wakeUp;
+   std::condition_variable drained;
+   std::thread dispatcher;
+
+   Impl(int capacity, int recSize, int policy, int batch, int id)
+      : recordSize(recSize), overflowPolicy(policy), batchSize(batch), loggerId(id),
+      enqueuePos(0), dequeuePos(0), callback(0), batchCallback(0),
+      enqueued(0), dispatched(0), dropped(0), overwritten(0), stop(false), consumerSleeping(false)
+   {
+      size_t size = 2;
+      while (size < static_cast<size_t>(capacity))
+         size <<= 1;
+      mask = size - 1;
+      slots.reset(new Slot[size]);
+      for (size_t i = 0; i < size; i++)
+         slots[i].sequence.store(i, std::memory_order_relaxed);
+      storage.resize(size * recordSize);
+
+      dispatcher = std::thread(&Impl::run, this);
+   }
+
+   ~Impl()
+   {
+      stop = true;
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         wakeUp.notify_one();
+      }
+      if (dispatcher.joinable())
+         dispatcher.join();
+   }
+
+   char* slotData(size_t pos)
+   {
+      return &storage[(pos & mask) * recordSize];
+   }
+
+   char* tryClaim(size_t* claimedPos)
+   {
+      size_t pos = enqueuePos.load(std::memory_order_relaxed);
+      for (;;)
+      {
+         Slot& slot = slots[pos & mask];
+         size_t seq = slot.sequence.load(std::memory_order_acquire);
+         std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+         if (diff == 0)
+         {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+               *claimedPos = pos;
+               return slotData(pos);
+            }
+         }
+         else if (diff < 0)
+            return 0; //full
+         else
+            pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+   }
+
+   bool tryPop(char* record)
+   {
+      size_t pos = dequeuePos.load(std::memory_order_relaxed);
+      Slot* slot;
+      for (;;)
+      {
+         slot = &slots[pos & mask];
+         size_t seq = slot->sequence.load(std::memory_order_acquire);
+         std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+         if (diff == 0)
+         {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+               break;
+         }
+         else if (diff < 0)
+            return false; //empty
+         else
+            pos = dequeuePos.load(std::memory_order_relaxed);
+      }
+      if (record)
+         memcpy(record, slotData(pos), recordSize);
+      slot->sequence.store(pos + mask + 1, std::memory_order_release);
+      return true;
+   }
+
+   char* claim(size_t* claimedPos)
+   {
+      char* data = tryClaim(claimedPos);
+      if (!data && overflowPolicy == DATA_LOGGER_OVERWRITE_OLDEST)
+      {
+         //A few attempts, other producers may be competing for the freed slot
+         for (int attempt = 0; attempt < 4 && !data; attempt++)
+         {
+            if (tryPop(0))
+            {
+               overwritten++;
+               dropped++;
+            }
+            data = tryClaim(claimedPos);
+         }
+      }
+      if (!data)
+         dropped++;
+      return data;
+   }
+
+   void publish(size_t pos)
+   {
+      slots[pos & mask].sequence.store(pos + 1, std::memory_order_release);
+      enqueued++;
+      //The dispatcher also polls, a lost wake up only delays the delivery
+      if (consumerSleeping.load(std::memory_order_relaxed))
+         wakeUp.notify_one();
+   }
+
+   void deliver(char* records, int count)
+   {
+      DataBatchCallback batchCb = batchCallback.load();
+      DataCallback cb = callback.load();
+      if (batchCb)
+         batchCb(records, count, recordSize, loggerId);
+      else if (cb)
+      {
+         for (int i = 0; i < count; i++)
+            cb(records + static_cast<size_t>(i) * recordSize, loggerId);
+      }
+   }
+
+   void run()
+   {
+      std::vector<char> batch(static_cast<size_t>(batchSize) * recordSize);
+      for (;;)
+      {
+         int count = 0;
+         while (count < batchSize && tryPop(&batch[static_cast<size_t>(count) * recordSize]))
+            count++;
+
+         if (count > 0)
+         {
+            deliver(&batch[0], count);
+            dispatched += count;
+            std::lock_guard<std::mutex> lock(mutex);
+            drained.notify_all();
+            continue;
+         }
+
+         if (stop)
+            break;
+
+         std::unique_lock<std::mutex> lock(mutex);
+         consumerSleeping = true;
+         wakeUp.wait_for(lock, std::chrono::milliseconds(10));
+         consumerSleeping = false;
+      }
+   }
+
+   void flush()
+   {
+      //Records logged from within a callback can not be waited for on the dispatcher thread
+      if (std::this_thread::get_id() == dispatcher.get_id())
+         return;
+
+      int64 target = enqueued.load();
+      std::unique_lock<std::mutex> lock(mutex);
+      while (dispatched.load() + overwritten.load() < target)
+      {
+         wakeUp.notify_one();
+         drained.wait_for(lock, std::chrono::milliseconds(10));
+      }
+   }
+};
+
+AsyncDataQueue::AsyncDataQueue(int capacity, int recSize, int overflowPolicy, int batchSize, int loggerId)
+   : recordSize(recSize), impl(0)
+{
+   CV_Assert(capacity > 0 && recSize > 0);
+   impl = new Impl(capacity, recSize, overflowPolicy, batchSize > 0 ? batchSize : 1, loggerId);
+}
+
+AsyncDataQueue::~AsyncDataQueue()
+{
+   delete impl;
+}
+
+void AsyncDataQueue::setCallbacks(DataCallback callback, DataBatchCallback batchCallback)
+{
+   impl->callback = callback;
+   impl->batchCallback = batchCallback;
+}
+
+bool AsyncDataQueue::push(const void* data)
+{
+   size_t pos;
+   char* slot = impl->claim(&pos);
+   if (!slot)
+      return false;
+   memcpy(slot, data, recordSize);
+   impl->publish(pos);
+   return true;
+}
+
+bool AsyncDataQueue::pushFormatted(const char* format, va_list args)
+{
+   size_t pos;
+   char* slot = impl->claim(&pos);
+   if (!slot)
+      return false;
+   vsnprintf(slot, recordSize, format, args);
+   impl->publish(pos);
+   return true;
+}
+
+void AsyncDataQueue::flush()
+{
+   impl->flush();
+}
+
+void AsyncDataQueue::getStats(int64* enqueued, int64* dispatched, int64* dropped) const
+{
+   *enqueued = impl->enqueued.load();
+   *dispatched = impl->dispatched.load();
+   *dropped = impl->dropped.load();
+}
+
 DataLogger* cveDataLoggerCreate(int logLevel, int loggerId)
 {
 	return new DataLogger(logLevel, loggerId);
 }
 
+DataLogger* cveDataLoggerCreateAsync(int logLevel, int loggerId, int capacity, int recordSize, int overflowPolicy, int batchSize)
+{
+	DataLogger* logger = new DataLogger(logLevel, loggerId);
+	logger->enableAsync(capacity, recordSize, overflowPolicy, batchSize);
+	return logger;
+}
+
 void cveDataLoggerRelease(DataLogger** logger)
 {
 	if (*logger)
@@ -24,7 +300,12 @@ void cveDataLoggerRelease(DataLogger** logger)
 
 void cveDataLoggerRegisterCallback(DataLogger* logger, DataCallback dataCallback )
 {
-   logger->callback = dataCallback;
+   logger->registerCallback(dataCallback);
+}
+
+void cveDataLoggerRegisterBatchCallback(DataLogger* logger, DataBatchCallback batchCallback)
+{
+   logger->registerBatchCallback(batchCallback);
 }
 
 void cveDataLoggerLog(DataLogger* logger, void* data, int logLevel)
@@ -32,4 +313,16 @@ void cveDataLoggerLog(DataLogger* logger, void* data, int logLevel)
    logger->log(data, logLevel);
 }
 
+void cveDataLoggerFlush(DataLogger* logger)
+{
+   if (logger->asyncQueue)
+      logger->asyncQueue->flush();
+}
 
+void cveDataLoggerGetStats(DataLogger* logger, int64* enqueued, int64* dispatched, int64* dropped)
+{
+   if (logger->asyncQueue)
+      logger->asyncQueue->getStats(enqueued, dispatched, dropped);
+   else
+      *enqueued = *dispatched = *dropped = 0;
+}
@@ -18,6 +18,50 @@ namespace emgu {
 
    typedef void (CV_CDECL *DataCallback)(void* data, int loggerId);
 
+   //records: count consecutive records of recordSize bytes each
+   typedef void (CV_CDECL *DataBatchCallback)(void* records, int count, int recordSize, int loggerId);
+
+   enum DataLoggerOverflowPolicy
+   {
+      //Discard the incoming record when the queue is full
+      DATA_LOGGER_DROP_NEWEST = 0,
+      //Discard the oldest queued record to make room for the incoming one
+      DATA_LOGGER_OVERWRITE_OLDEST = 1
+   };
+
+   /*
+    * A bounded multiple producer ring buffer of fixed size records, drained by a dispatcher thread.
+    * Producers never block: they claim a slot with a compare-and-swap on the enqueue position
+    * and the queue either drops or overwrites when it is full.
+    */
+   class CV_EXPORTS AsyncDataQueue
+   {
+   public:
+      AsyncDataQueue(int capacity, int recordSize, int overflowPolicy, int batchSize, int loggerId);
+      ~AsyncDataQueue();
+
+      void setCallbacks(DataCallback callback, DataBatchCallback batchCallback);
+
+      //Copy recordSize bytes from data into the queue. Returns false if the record is dropped.
+      bool push(const void* data);
+      //Format the message straight into a queue slot, truncated to recordSize - 1 characters.
+      bool pushFormatted(const char* format, va_list args);
+
+      //Block until all the records queued so far have been dispatched
+      void flush();
+
+      void getStats(int64* enqueued, int64* dispatched, int64* dropped) const;
+
+      int recordSize;
+
+   private:
+      struct Impl;
+      Impl* impl;
+
+      AsyncDataQueue(const AsyncDataQueue&);
+      AsyncDataQueue& operator=(const AsyncDataQueue&);
+   };
+
    class CV_EXPORTS DataLogger
    {
    public:
@@ -25,38 +69,75 @@ namespace emgu {
       int loggerId;
 
       DataCallback callback;
+      DataBatchCallback batchCallback;
+
+      //Non null if the logger is in asynchronous mode
+      AsyncDataQueue* asyncQueue;
 
       DataLogger(int level, int id)
-         : callback(0), logLevel(level), loggerId(id) {};
+         : callback(0), batchCallback(0), asyncQueue(0), logLevel(level), loggerId(id) {};
+
+      ~DataLogger()
+      {
+         //Stops the dispatcher thread after all the queued records have been delivered
+         delete asyncQueue;
+      }
 
       void registerCallback(DataCallback dataCallback)
       {
          callback = dataCallback;
+         if (asyncQueue) asyncQueue->setCallbacks(callback, batchCallback);
+      }
+
+      void registerBatchCallback(DataBatchCallback dataBatchCallback)
+      {
+         batchCallback = dataBatchCallback;
+         if (asyncQueue) asyncQueue->setCallbacks(callback, batchCallback);
+      }
+
+      //Switch to asynchronous mode, the data passed to log will be copied (recordSize bytes) into a ring buffer
+      //and delivered to the callbacks from a dispatcher thread.
+      void enableAsync(int capacity, int recordSize, int overflowPolicy, int batchSize)
+      {
+         delete asyncQueue;
+         asyncQueue = new AsyncDataQueue(capacity, recordSize, overflowPolicy, batchSize, loggerId);
+         asyncQueue->setCallbacks(callback, batchCallback);
       }
 
       void log(void* data, int level)
       {
-         if (callback && level >=logLevel) callback(data, loggerId);
+         if (level >= logLevel) log(data);
       }
 
       void log(void* data)
       {
-         if (callback) callback(data, loggerId);
+         if (asyncQueue)
+            asyncQueue->push(data);
+         else if (callback)
+            callback(data, loggerId);
       }
 
       //Use this function only if you are trying to log messages
-      //the total length of the message should be less than 1024 char
+      //In synchronous mode the message is truncated to 1023 characters,
+      //in asynchronous mode to the record size of the queue minus one.
       void logMsg(const char* format, int level, ...)
       {
-         if (callback && level >=logLevel)
+         if (level < logLevel)
+            return;
+
+         va_list args;
+         va_start(args, level);
+         if (asyncQueue)
+         {
+            asyncQueue->pushFormatted(format, args);
+         }
+         else if (callback)
          {
             char buffer[1024];
-            va_list args;
-            va_start(args, level);
-            vsprintf(buffer, format, args);
-            va_end(args);
+            vsnprintf(buffer, sizeof(buffer), format, args);
             callback(buffer, loggerId);
          }
+         va_end(args);
       }
    };
 };
@@ -64,10 +145,18 @@ namespace emgu {
 /* DataLogger */
 CVAPI(emgu::DataLogger*) cveDataLoggerCreate(int logLevel, int loggerId);
 
+CVAPI(emgu::DataLogger*) cveDataLoggerCreateAsync(int logLevel, int loggerId, int capacity, int recordSize, int overflowPolicy, int batchSize);
+
 CVAPI(void) cveDataLoggerRelease(emgu::DataLogger** logger);
 
 CVAPI(void) cveDataLoggerRegisterCallback(emgu::DataLogger* logger, emgu::DataCallback messageCallback );
 
+CVAPI(void) cveDataLoggerRegisterBatchCallback(emgu::DataLogger* logger, emgu::DataBatchCallback batchCallback);
+
 CVAPI(void) cveDataLoggerLog(emgu::DataLogger* logger, void* data, int logLevel);
 
+CVAPI(void) cveDataLoggerFlush(emgu::DataLogger* logger);
+
+CVAPI(void) cveDataLoggerGetStats(emgu::DataLogger* logger, int64* enqueued, int64* dispatched, int64* dropped);
+
 #endif
@@ -5,6 +5,20 @@
 //----------------------------------------------------------------------------
 
 #include "dnn_c.h"
+#include "sse.h"
+
+#ifdef HAVE_OPENCV_DNN
+#include "opencv2/dnn/shape_utils.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 cv::dnn::Net* cveReadNetFromDarknet(cv::String* cfgFile, cv::String* darknetModel)
 {
@@ -369,6 +383,558 @@ void cveDnnImagesFromBlob(cv::Mat* blob, cv::_OutputArray* images)
 #endif
 }
 
+//The source sampling of one output image, columns / rows outside of [begin, end) are padding
+struct BlobImageLayout
+{
+	cv::Mat image;
+	int xBegin, xEnd;
+	int yBegin, yEnd;
+	//Source row (or column) offset relative to the output row (or column), in the resized image
+	int xOffset, yOffset;
+	double invScaleX, invScaleY;
+	//Per output column: element offsets of the two source pixels and the weight of the second one
+	std::vector<int> xofs0, xofs1;
+	std::vector<float> alpha;
+};
+
+//Same sampling as cv::resize with INTER_LINEAR
+static inline void bilinearCoordinate(int dst, double invScale, int srcSize, int* src0, int* src1, float* weight)
+{
+	double f = (dst + 0.5) * invScale - 0.5;
+	int s = cvFloor(f);
+	float w = (float) (f - s);
+	if (s < 0)
+	{
+		s = 0;
+		w = 0;
+	}
+	if (s >= srcSize - 1)
+	{
+		s = srcSize - 1;
+		w = 0;
+	}
+	*src0 = s;
+	*src1 = std::min(s + 1, srcSize - 1);
+	*weight = w;
+}
+
+//Where an image lands in a blob of the given size: resized pixel = output pixel + offset, source pixel = (resized pixel + 0.5) * invScale - 0.5
+static void blobImageGeometry(const cv::Size& imageSize, const cv::Size& size, int paddingMode, double* invScaleX, double* invScaleY, int* xOffset, int* yOffset, cv::Size* resizedSize)
+{
+	*resizedSize = size;
+	*invScaleX = imageSize.width / (double) size.width;
+	*invScaleY = imageSize.height / (double) size.height;
+	*xOffset = *yOffset = 0;
+
+	if (paddingMode == 1)
+	{
+		//Resize such that the image covers the output, then keep the center, as blobFromImage with crop = true
+		double factor = std::max(size.width / (double) imageSize.width, size.height / (double) imageSize.height);
+		*resizedSize = cv::Size(cvRound(imageSize.width * factor), cvRound(imageSize.height * factor));
+		*invScaleX = *invScaleY = 1.0 / factor;
+		*xOffset = (resizedSize->width - size.width) / 2;
+		*yOffset = (resizedSize->height - size.height) / 2;
+	}
+	else if (paddingMode == 2)
+	{
+		//Resize such that the image fits in the output keeping its aspect ratio, then pad around it
+		double factor = std::min(size.width / (double) imageSize.width, size.height / (double) imageSize.height);
+		*resizedSize = cv::Size(std::max(1, (int) (imageSize.width * factor)), std::max(1, (int) (imageSize.height * factor)));
+		*invScaleX = imageSize.width / (double) resizedSize->width;
+		*invScaleY = imageSize.height / (double) resizedSize->height;
+		*xOffset = -(size.width - resizedSize->width) / 2;
+		*yOffset = -(size.height - resizedSize->height) / 2;
+	}
+}
+
+static void blobImageLayout(const cv::Mat& image, const cv::Size& size, int paddingMode, BlobImageLayout& layout)
+{
+	layout.image = image;
+	cv::Size resized;
+	blobImageGeometry(image.size(), size, paddingMode, &layout.invScaleX, &layout.invScaleY, &layout.xOffset, &layout.yOffset, &resized);
+	int resizedWidth = resized.width, resizedHeight = resized.height;
+
+	layout.xBegin = std::max(0, -layout.xOffset);
+	layout.xEnd = std::min(size.width, resizedWidth - layout.xOffset);
+	layout.yBegin = std::max(0, -layout.yOffset);
+	layout.yEnd = std::min(size.height, resizedHeight - layout.yOffset);
+
+	int cn = image.channels();
+	layout.xofs0.resize(size.width);
+	layout.xofs1.resize(size.width);
+	layout.alpha.resize(size.width);
+	for (int x = layout.xBegin; x < layout.xEnd; x++)
+	{
+		int s0, s1;
+		bilinearCoordinate(x + layout.xOffset, layout.invScaleX, image.cols, &s0, &s1, &layout.alpha[x]);
+		layout.xofs0[x] = s0 * cn;
+		layout.xofs1[x] = s1 * cn;
+	}
+}
+
+//Interpolate a source row horizontally into one float row per output channel
+template<typename T>
+static void blobHorizontalPass(const T* src, const BlobImageLayout& layout, const int* channelToPlane, int cn, int width, float* planes)
+{
+	const int* xofs0 = &layout.xofs0[0];
+	const int* xofs1 = &layout.xofs1[0];
+	const float* alpha = &layout.alpha[0];
+	for (int c = 0; c < cn; c++)
+	{
+		float* dst = planes + channelToPlane[c] * width;
+		const T* s = src + c;
+		for (int x = layout.xBegin; x < layout.xEnd; x++)
+		{
+			float v0 = (float) s[xofs0[x]];
+			float v1 = (float) s[xofs1[x]];
+			dst[x] = v0 + alpha[x] * (v1 - v0);
+		}
+	}
+}
+
+class BlobFromImagesFusedInvoker : public cv::ParallelLoopBody
+{
+public:
+	BlobFromImagesFusedInvoker(const std::vector<BlobImageLayout>& layouts, cv::Mat& blob, const float* offsets, const float* paddings, float scale, const int* channelToPlane)
+		: _layouts(layouts), _blob(blob), _offsets(offsets), _paddings(paddings), _scale(scale), _channelToPlane(channelToPlane)
+	{
+	}
+
+	virtual void operator()(const cv::Range& range) const
+	{
+		int cn = _blob.size[1];
+		int height = _blob.size[2];
+		int width = _blob.size[3];
+		int ddepth = _blob.depth();
+		cv::AutoBuffer<float> buffer(width * (cn * 2 + 1));
+		float* row0 = buffer.data();
+		float* row1 = row0 + width * cn;
+		float* converted = row1 + width * cn;
+
+		for (int r = range.start; r < range.end; r++)
+		{
+			int n = r / height;
+			int y = r % height;
+			const BlobImageLayout& layout = _layouts[n];
+			bool inside = y >= layout.yBegin && y < layout.yEnd;
+
+			float beta = 0;
+			if (inside)
+			{
+				int sy0, sy1;
+				bilinearCoordinate(y + layout.yOffset, layout.invScaleY, layout.image.rows, &sy0, &sy1, &beta);
+				if (layout.image.depth() == CV_8U)
+				{
+					blobHorizontalPass(layout.image.ptr<uchar>(sy0), layout, _channelToPlane, cn, width, row0);
+					if (beta != 0)
+						blobHorizontalPass(layout.image.ptr<uchar>(sy1), layout, _channelToPlane, cn, width, row1);
+				}
+				else
+				{
+					blobHorizontalPass(layout.image.ptr<float>(sy0), layout, _channelToPlane, cn, width, row0);
+					if (beta != 0)
+						blobHorizontalPass(layout.image.ptr<float>(sy1), layout, _channelToPlane, cn, width, row1);
+				}
+			}
+
+			for (int p = 0; p < cn; p++)
+			{
+				int index[4] = { n, p, y, 0 };
+				float* dst = ddepth == CV_32F ? _blob.ptr<float>(index) : converted;
+				//(v - mean) * scale == v * scale - mean * scale
+				float offset = _offsets[p];
+				int xBegin = inside ? layout.xBegin : width;
+				int xEnd = inside ? layout.xEnd : width;
+
+				for (int x = 0; x < xBegin; x++)
+					dst[x] = _paddings[p];
+				for (int x = xEnd; x < width; x++)
+					dst[x] = _paddings[p];
+
+				const float* r0 = row0 + p * width;
+				const float* r1 = row1 + p * width;
+				int x = xBegin;
+				if (beta == 0)
+				{
+#if EMGU_SSE2
+					__m128 s = _mm_set1_ps(_scale), o = _mm_set1_ps(offset);
+					for (; x <= xEnd - 4; x += 4)
+						_mm_storeu_ps(dst + x, _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(r0 + x), s), o));
+#endif
+					for (; x < xEnd; x++)
+						dst[x] = r0[x] * _scale - offset;
+				}
+				else
+				{
+#if EMGU_SSE2
+					__m128 s = _mm_set1_ps(_scale), o = _mm_set1_ps(offset), b = _mm_set1_ps(beta);
+					for (; x <= xEnd - 4; x += 4)
+					{
+						__m128 v0 = _mm_loadu_ps(r0 + x);
+						__m128 v = _mm_add_ps(v0, _mm_mul_ps(b, _mm_sub_ps(_mm_loadu_ps(r1 + x), v0)));
+						_mm_storeu_ps(dst + x, _mm_sub_ps(_mm_mul_ps(v, s), o));
+					}
+#endif
+					for (; x < xEnd; x++)
+						dst[x] = (r0[x] + beta * (r1[x] - r0[x])) * _scale - offset;
+				}
+
+				if (ddepth != CV_32F)
+					cv::Mat(1, width, CV_32F, converted).convertTo(cv::Mat(1, width, ddepth, _blob.ptr(index)), ddepth);
+			}
+		}
+	}
+
+private:
+	const std::vector<BlobImageLayout>& _layouts;
+	cv::Mat& _blob;
+	const float* _offsets;
+	const float* _paddings;
+	float _scale;
+	const int* _channelToPlane;
+};
+
+void cveDnnBlobFromImagesFused(
+	cv::_InputArray* images,
+	cv::Mat* blob,
+	double scalefactor,
+	CvSize* size,
+	CvScalar* mean,
+	bool swapRB,
+	int paddingMode,
+	CvScalar* paddingValue,
+	int ddepth)
+{
+	std::vector<cv::Mat> imageVec;
+	if (images->kind() == cv::_InputArray::MAT || images->kind() == cv::_InputArray::UMAT)
+		imageVec.push_back(images->getMat());
+	else
+		images->getMatVector(imageVec);
+
+	CV_Assert(!imageVec.empty() && size->width > 0 && size->height > 0);
+	CV_Assert(paddingMode >= 0 && paddingMode <= 2);
+	CV_Assert(ddepth == CV_32F || ddepth == CV_16F || ddepth == CV_8U || ddepth == CV_8S);
+	int cn = imageVec[0].channels();
+	int depth = imageVec[0].depth();
+	CV_Assert(cn == 1 || cn == 3 || cn == 4);
+	CV_Assert(depth == CV_8U || depth == CV_32F);
+
+	cv::Size dstSize(size->width, size->height);
+	std::vector<BlobImageLayout> layouts(imageVec.size());
+	for (size_t i = 0; i < imageVec.size(); i++)
+	{
+		CV_Assert(!imageVec[i].empty() && imageVec[i].channels() == cn && imageVec[i].depth() == depth);
+		blobImageLayout(imageVec[i], dstSize, paddingMode, layouts[i]);
+	}
+
+	//The mean is given in the output channel order, the padding value in the source channel order, as in blobFromImages
+	int channelToPlane[4] = { 0, 1, 2, 3 };
+	if (swapRB && cn >= 3)
+		std::swap(channelToPlane[0], channelToPlane[2]);
+	float scale = (float) scalefactor;
+	float offsets[4], paddings[4];
+	for (int c = 0; c < cn; c++)
+	{
+		offsets[c] = (float) (mean->val[c] * scalefactor);
+		paddings[channelToPlane[c]] = (float) ((paddingValue->val[c] - mean->val[channelToPlane[c]]) * scalefactor);
+	}
+
+	int sz[] = { (int) imageVec.size(), cn, dstSize.height, dstSize.width };
+	blob->create(4, sz, ddepth);
+
+	cv::parallel_for_(
+		cv::Range(0, sz[0] * sz[2]),
+		BlobFromImagesFusedInvoker(layouts, *blob, offsets, paddings, scale, channelToPlane));
+}
+
+//A detection in network input coordinates
+struct DetectionCandidate
+{
+	float x1, y1, x2, y2;
+	float score;
+	int classId;
+};
+
+static bool detectionScoreGreater(const DetectionCandidate& a, const DetectionCandidate& b)
+{
+	return a.score > b.score;
+}
+
+//The boxes kept by NMS for one class, stored as structure of arrays for the vectorized overlap test
+struct NmsBucket
+{
+	std::vector<float> x1, y1, x2, y2, area;
+};
+
+//Check if the box overlaps a kept box with an IoU above threshold, as inter > threshold * union to avoid divisions
+static bool nmsOverlaps(const NmsBucket& bucket, const DetectionCandidate& box, float threshold)
+{
+	int n = (int) bucket.x1.size();
+	float area = (box.x2 - box.x1) * (box.y2 - box.y1);
+	int i = 0;
+#if EMGU_SSE2
+	__m128 bx1 = _mm_set1_ps(box.x1), by1 = _mm_set1_ps(box.y1), bx2 = _mm_set1_ps(box.x2), by2 = _mm_set1_ps(box.y2);
+	__m128 barea = _mm_set1_ps(area), t = _mm_set1_ps(threshold), zero = _mm_setzero_ps();
+	for (; i <= n - 4; i += 4)
+	{
+		__m128 w = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(bx2, _mm_loadu_ps(&bucket.x2[i])), _mm_max_ps(bx1, _mm_loadu_ps(&bucket.x1[i]))));
+		__m128 h = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(by2, _mm_loadu_ps(&bucket.y2[i])), _mm_max_ps(by1, _mm_loadu_ps(&bucket.y1[i]))));
+		__m128 inter = _mm_mul_ps(w, h);
+		__m128 uni = _mm_sub_ps(_mm_add_ps(barea, _mm_loadu_ps(&bucket.area[i])), inter);
+		if (_mm_movemask_ps(_mm_cmpgt_ps(inter, _mm_mul_ps(t, uni))))
+			return true;
+	}
+#endif
+	for (; i < n; i++)
+	{
+		float w = std::max(0.f, std::min(box.x2, bucket.x2[i]) - std::max(box.x1, bucket.x1[i]));
+		float h = std::max(0.f, std::min(box.y2, bucket.y2[i]) - std::max(box.y1, bucket.y1[i]));
+		float inter = w * h;
+		if (inter > threshold * (area + bucket.area[i] - inter))
+			return true;
+	}
+	return false;
+}
+
+//The number of rows of a [1, rows, cols] or [rows, cols] blob
+static int detectionRows(const cv::Mat& m, int cols)
+{
+	CV_Assert(m.isContinuous() && m.type() == CV_32F && m.dims >= 2 && m.size[m.dims - 1] == cols);
+	return (int) (m.total() / cols);
+}
+
+static void decodeYoloV5(const cv::Mat& out, float confThreshold, std::vector<DetectionCandidate>& candidates)
+{
+	int cols = out.size[out.dims - 1];
+	CV_Assert(cols > 5);
+	int rows = detectionRows(out, cols);
+	const float* data = out.ptr<float>();
+	for (int r = 0; r < rows; r++)
+	{
+		const float* row = data + (size_t) r * cols;
+		float objectness = row[4];
+		//Most of the rows are discarded here, without scanning their class scores
+		if (objectness < confThreshold)
+			continue;
+		const float* classScores = row + 5;
+		int best = (int) (std::max_element(classScores, row + cols) - classScores);
+		float score = objectness * classScores[best];
+		if (score < confThreshold)
+			continue;
+		DetectionCandidate c = { row[0] - row[2] * 0.5f, row[1] - row[3] * 0.5f, row[0] + row[2] * 0.5f, row[1] + row[3] * 0.5f, score, best };
+		candidates.push_back(c);
+	}
+}
+
+static void decodeYoloV8(const cv::Mat& out, float confThreshold, std::vector<DetectionCandidate>& candidates)
+{
+	CV_Assert(out.isContinuous() && out.type() == CV_32F && out.dims >= 2 && out.total() == (size_t) out.size[out.dims - 2] * out.size[out.dims - 1]);
+	int channels = out.size[out.dims - 2];
+	int n = out.size[out.dims - 1];
+	CV_Assert(channels > 4);
+	const float* data = out.ptr<float>();
+
+	//The class scores are stored class by class, the arg max over the classes is computed for all the anchors at once, one class row after the other
+	cv::AutoBuffer<float> bestScores(n);
+	cv::AutoBuffer<int> bestClasses(n);
+	std::copy(data + 4 * (size_t) n, data + 5 * (size_t) n, bestScores.data());
+	std::fill(bestClasses.data(), bestClasses.data() + n, 0);
+	for (int c = 1; c < channels - 4; c++)
+	{
+		const float* row = data + (size_t) (4 + c) * n;
+		float* best = bestScores.data();
+		int* bestClass = bestClasses.data();
+		int i = 0;
+#if EMGU_SSE2
+		__m128i cls = _mm_set1_epi32(c);
+		for (; i <= n - 4; i += 4)
+		{
+			__m128 v = _mm_loadu_ps(row + i);
+			__m128 m = _mm_loadu_ps(best + i);
+			__m128i greater = _mm_castps_si128(_mm_cmpgt_ps(v, m));
+			__m128i id = _mm_loadu_si128((const __m128i*) (bestClass + i));
+			_mm_storeu_ps(best + i, _mm_max_ps(v, m));
+			_mm_storeu_si128((__m128i*) (bestClass + i), _mm_or_si128(_mm_and_si128(greater, cls), _mm_andnot_si128(greater, id)));
+		}
+#endif
+		for (; i < n; i++)
+		{
+			if (row[i] > best[i])
+			{
+				best[i] = row[i];
+				bestClass[i] = c;
+			}
+		}
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		if (bestScores[i] < confThreshold)
+			continue;
+		float cx = data[i], cy = data[n + i], w = data[2 * n + i], h = data[3 * n + i];
+		DetectionCandidate c = { cx - w * 0.5f, cy - h * 0.5f, cx + w * 0.5f, cy + h * 0.5f, bestScores[i], bestClasses[i] };
+		candidates.push_back(c);
+	}
+}
+
+static void decodeSsd(const cv::Mat& out, float confThreshold, const cv::Size& inputSize, std::vector<DetectionCandidate>& candidates)
+{
+	int rows = detectionRows(out, 7);
+	const float* data = out.ptr<float>();
+	for (int r = 0; r < rows; r++)
+	{
+		const float* row = data + r * 7;
+		//Only the first image of the batch is decoded
+		if (row[0] != 0 || row[2] < confThreshold)
+			continue;
+		DetectionCandidate c = {
+			row[3] * inputSize.width, row[4] * inputSize.height, row[5] * inputSize.width, row[6] * inputSize.height,
+			row[2], (int) row[1] };
+		candidates.push_back(c);
+	}
+}
+
+static void decodeRetinaNet(const cv::Mat& boxes, const cv::Mat& classScores, const cv::Mat& anchors, float confThreshold, std::vector<DetectionCandidate>& candidates)
+{
+	int n = detectionRows(boxes, 4);
+	CV_Assert(classScores.isContinuous() && classScores.type() == CV_32F && classScores.total() % n == 0);
+	int classCount = (int) (classScores.total() / n);
+	bool regression = !anchors.empty();
+	if (regression)
+		CV_Assert(detectionRows(anchors, 4) == n);
+	//Same clamp as the torchvision box coder, such that exp does not overflow
+	const float maxLogScale = (float) std::log(1000. / 16);
+
+	const float* b = boxes.ptr<float>();
+	const float* s = classScores.ptr<float>();
+	for (int i = 0; i < n; i++)
+	{
+		const float* scoreRow = s + (size_t) i * classCount;
+		int best = (int) (std::max_element(scoreRow, scoreRow + classCount) - scoreRow);
+		if (scoreRow[best] < confThreshold)
+			continue;
+
+		const float* box = b + i * 4;
+		DetectionCandidate c = { box[0], box[1], box[2], box[3], scoreRow[best], best };
+		if (regression)
+		{
+			const float* a = anchors.ptr<float>() + i * 4;
+			float aw = a[2] - a[0], ah = a[3] - a[1];
+			float cx = a[0] + 0.5f * aw + box[0] * aw;
+			float cy = a[1] + 0.5f * ah + box[1] * ah;
+			float w = aw * std::exp(std::min(box[2], maxLogScale));
+			float h = ah * std::exp(std::min(box[3], maxLogScale));
+			c.x1 = cx - 0.5f * w;
+			c.y1 = cy - 0.5f * h;
+			c.x2 = cx + 0.5f * w;
+			c.y2 = cy + 0.5f * h;
+		}
+		candidates.push_back(c);
+	}
+}
+
+void cveDnnDecodeDetections(
+	cv::_InputArray* outputs,
+	int headLayout,
+	cv::Mat* anchors,
+	float confThreshold,
+	float nmsThreshold,
+	bool classAware,
+	int topK,
+	CvSize* inputSize,
+	CvSize* imageSize,
+	int paddingMode,
+	std::vector<cv::Rect>* boxes,
+	std::vector<float>* scores,
+	std::vector<int>* classIds)
+{
+	std::vector<cv::Mat> outs;
+	if (outputs->kind() == cv::_InputArray::MAT || outputs->kind() == cv::_InputArray::UMAT)
+		outs.push_back(outputs->getMat());
+	else
+		outputs->getMatVector(outs);
+	CV_Assert(!outs.empty());
+	cv::Size netSize(inputSize->width, inputSize->height);
+	CV_Assert(netSize.width > 0 && netSize.height > 0);
+
+	std::vector<DetectionCandidate> candidates;
+	switch (headLayout)
+	{
+	case 0:
+		decodeYoloV5(outs[0], confThreshold, candidates);
+		break;
+	case 1:
+		decodeYoloV8(outs[0], confThreshold, candidates);
+		break;
+	case 2:
+		decodeSsd(outs[0], confThreshold, netSize, candidates);
+		break;
+	case 3:
+		CV_Assert(outs.size() >= 2);
+		decodeRetinaNet(outs[0], outs[1], anchors ? *anchors : cv::Mat(), confThreshold, candidates);
+		break;
+	default:
+		CV_Error(cv::Error::StsBadArg, "Unknown detection head layout");
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(), detectionScoreGreater);
+
+	//Greedy NMS in decreasing score order, a candidate is only compared with the boxes kept in its bucket
+	std::vector<NmsBucket> buckets(1);
+	std::vector<int> kept;
+	int maxCount = topK > 0 ? topK : (int) candidates.size();
+	for (int i = 0; i < (int) candidates.size() && (int) kept.size() < maxCount; i++)
+	{
+		const DetectionCandidate& c = candidates[i];
+		if (nmsThreshold > 0)
+		{
+			int b = classAware ? c.classId : 0;
+			CV_Assert(b >= 0);
+			if (b >= (int) buckets.size())
+				buckets.resize(b + 1);
+			NmsBucket& bucket = buckets[b];
+			if (nmsOverlaps(bucket, c, nmsThreshold))
+				continue;
+			bucket.x1.push_back(c.x1);
+			bucket.y1.push_back(c.y1);
+			bucket.x2.push_back(c.x2);
+			bucket.y2.push_back(c.y2);
+			bucket.area.push_back((c.x2 - c.x1) * (c.y2 - c.y1));
+		}
+		kept.push_back(i);
+	}
+
+	//Map the boxes from the network input back to the image
+	cv::Size dstSize(imageSize->width, imageSize->height);
+	double invScaleX = 1, invScaleY = 1;
+	int xOffset = 0, yOffset = 0;
+	if (dstSize.width > 0 && dstSize.height > 0)
+	{
+		cv::Size resized;
+		blobImageGeometry(dstSize, netSize, paddingMode, &invScaleX, &invScaleY, &xOffset, &yOffset, &resized);
+	}
+	else
+		dstSize = netSize;
+
+	boxes->clear();
+	scores->clear();
+	classIds->clear();
+	boxes->reserve(kept.size());
+	scores->reserve(kept.size());
+	classIds->reserve(kept.size());
+	for (size_t k = 0; k < kept.size(); k++)
+	{
+		const DetectionCandidate& c = candidates[kept[k]];
+		double x1 = std::min(std::max((c.x1 + xOffset) * invScaleX, 0.), (double) dstSize.width);
+		double y1 = std::min(std::max((c.y1 + yOffset) * invScaleY, 0.), (double) dstSize.height);
+		double x2 = std::min(std::max((c.x2 + xOffset) * invScaleX, 0.), (double) dstSize.width);
+		double y2 = std::min(std::max((c.y2 + yOffset) * invScaleY, 0.), (double) dstSize.height);
+		boxes->push_back(cv::Rect(cvRound(x1), cvRound(y1), cvRound(x2) - cvRound(x1), cvRound(y2) - cvRound(y1)));
+		scores->push_back(c.score);
+		classIds->push_back(c.classId);
+	}
+}
+
 void cveDnnShrinkCaffeModel(cv::String* src, cv::String* dst)
 {
 #ifdef HAVE_OPENCV_DNN
@@ -913,4 +1479,1025 @@ void cveDnnSegmentationModelSegment(
 #else
 	throw_no_dnn();
 #endif
+}
+
+#ifdef HAVE_OPENCV_DNN
+class DnnBatchRequestImpl : public emgu::DnnBatchRequest
+{
+public:
+	cv::Mat image;
+	std::chrono::steady_clock::time_point queued;
+	emgu::DnnBatchCallback callback;
+	int callbackId;
+
+	DnnBatchRequestImpl()
+		: callback(0), callbackId(0), done(false)
+	{
+	}
+
+	virtual bool wait(int timeoutMs)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (timeoutMs < 0)
+		{
+			completed.wait(lock, [this] { return done; });
+			return true;
+		}
+		return completed.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return done; });
+	}
+
+	virtual void getOutputs(std::vector<cv::Mat>& outputs)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		completed.wait(lock, [this] { return done; });
+		if (!error.empty())
+		{
+			cv::String message = error;
+			lock.unlock();
+			CV_Error(cv::Error::StsError, message);
+		}
+		outputs = results;
+	}
+
+	void complete(std::vector<cv::Mat>& outputs, const cv::String& message)
+	{
+		//The callback gets its own headers of the outputs, the request may be released by its owner as soon as it is done
+		std::vector<cv::Mat> callbackOutputs;
+		if (callback)
+			callbackOutputs = outputs;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			results.swap(outputs);
+			error = message;
+			done = true;
+			image.release();
+			completed.notify_all();
+		}
+		if (callback)
+			callback(&callbackOutputs, message.empty() ? 0 : message.c_str(), callbackId);
+	}
+
+private:
+	std::vector<cv::Mat> results;
+	cv::String error;
+	bool done;
+	std::mutex mutex;
+	std::condition_variable completed;
+};
+
+struct emgu::DnnBatchExecutor::Impl
+{
+	cv::dnn::Net net;
+	int maxBatchSize;
+	int maxWaitMs;
+	double scaleFactor;
+	cv::Size size;
+	cv::Scalar mean;
+	bool swapRB;
+	bool crop;
+	int ddepth;
+	std::vector<cv::String> outputNames;
+
+	std::deque< cv::Ptr<DnnBatchRequestImpl> > pending;
+	bool stopRequested;
+	//The type, and the size if size is empty, of the first submitted image, which every other image must match
+	int imageType;
+	cv::Size imageSize;
+
+	int64 requestCount;
+	int64 batchCount;
+	double totalLatencyMs;
+	double maxLatencyMs;
+	double totalInferenceMs;
+
+	std::mutex mutex;
+	std::condition_variable requestQueued;
+	std::thread worker;
+
+	Impl(const cv::dnn::Net& n, int maxBatch, int maxWait, double scale, const cv::Size& sz, const cv::Scalar& m, bool swap, bool c, int depth, const std::vector<cv::String>& names)
+		: net(n), maxBatchSize(maxBatch), maxWaitMs(maxWait), scaleFactor(scale), size(sz), mean(m), swapRB(swap), crop(c), ddepth(depth),
+		outputNames(names), stopRequested(false), imageType(-1), requestCount(0), batchCount(0), totalLatencyMs(0), maxLatencyMs(0), totalInferenceMs(0)
+	{
+		if (outputNames.empty())
+			outputNames = net.getUnconnectedOutLayersNames();
+		worker = std::thread(&Impl::run, this);
+	}
+
+	void run()
+	{
+		std::vector< cv::Ptr<DnnBatchRequestImpl> > batch;
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			requestQueued.wait(lock, [this] { return stopRequested || !pending.empty(); });
+			//The queued requests are always completed before the thread exits
+			if (pending.empty())
+				break;
+
+			//Give the other producers until maxWaitMs after the oldest request to fill the batch.
+			//If the oldest request has been waiting during the previous forward pass the deadline may already be over.
+			if (!stopRequested && (int) pending.size() < maxBatchSize)
+			{
+				std::chrono::steady_clock::time_point deadline = pending.front()->queued + std::chrono::milliseconds(maxWaitMs);
+				requestQueued.wait_until(lock, deadline, [this] { return stopRequested || (int) pending.size() >= maxBatchSize; });
+			}
+
+			int n = std::min((int) pending.size(), maxBatchSize);
+			batch.assign(pending.begin(), pending.begin() + n);
+			pending.erase(pending.begin(), pending.begin() + n);
+			lock.unlock();
+			runBatch(batch);
+			batch.clear();
+			lock.lock();
+		}
+	}
+
+	void runBatch(std::vector< cv::Ptr<DnnBatchRequestImpl> >& batch)
+	{
+		int n = (int) batch.size();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		std::vector<cv::Mat> outs;
+		cv::String message;
+		try
+		{
+			std::vector<cv::Mat> images(n);
+			for (int i = 0; i < n; i++)
+				images[i] = batch[i]->image;
+			cv::Mat blob;
+			cv::dnn::blobFromImages(images, blob, scaleFactor, size, mean, swapRB, crop, ddepth);
+			net.setInput(blob);
+			net.forward(outs, outputNames);
+		}
+		catch (const std::exception& e)
+		{
+			message = e.what();
+			outs.clear();
+		}
+
+		//Split the outputs whose first dimension is the batch size. The slices are copied because the network reuses its output blobs.
+		//The detections of an SSD DetectionOutput layer, [1, 1, N, 7], carry the image index in their first column instead, their rows are split on it.
+		//Any other output is given whole to every request.
+		std::vector< std::vector<cv::Mat> > results(n, std::vector<cv::Mat>(outs.size()));
+		for (size_t j = 0; j < outs.size(); j++)
+		{
+			const cv::Mat& out = outs[j];
+			if (out.dims >= 2 && out.size[0] == n)
+			{
+				std::vector<cv::Range> ranges(out.dims, cv::Range::all());
+				for (int i = 0; i < n; i++)
+				{
+					ranges[0] = cv::Range(i, i + 1);
+					results[i][j] = out(&ranges[0]).clone();
+				}
+			}
+			else if (isDetectionOutput(out))
+			{
+				for (int i = 0; i < n; i++)
+					results[i][j] = splitDetections(out, i);
+			}
+			else
+			{
+				cv::Mat shared = out.clone();
+				for (int i = 0; i < n; i++)
+					results[i][j] = shared;
+			}
+		}
+
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		{
+			//The counters are updated before the requests complete, such that a caller that has waited for its request sees them
+			std::lock_guard<std::mutex> lock(mutex);
+			batchCount++;
+			requestCount += n;
+			totalInferenceMs += std::chrono::duration<double, std::milli>(end - start).count();
+			for (int i = 0; i < n; i++)
+			{
+				double latencyMs = std::chrono::duration<double, std::milli>(end - batch[i]->queued).count();
+				totalLatencyMs += latencyMs;
+				maxLatencyMs = std::max(maxLatencyMs, latencyMs);
+			}
+		}
+		for (int i = 0; i < n; i++)
+			batch[i]->complete(results[i], message);
+	}
+
+	static bool isDetectionOutput(const cv::Mat& out)
+	{
+		return out.dims == 4 && out.size[0] == 1 && out.size[1] == 1 && out.size[3] == 7 && out.type() == CV_32F && out.isContinuous();
+	}
+
+	//The detections of the image at batchIndex, with their image index rewritten to 0. Like the DetectionOutput layer,
+	//a single row of zeros, i.e. a detection with a confidence of 0, is returned if the image has no detection.
+	static cv::Mat splitDetections(const cv::Mat& out, int batchIndex)
+	{
+		cv::Mat rows(out.size[2], out.size[3], CV_32F, const_cast<float*>(out.ptr<float>()));
+		int count = 0;
+		for (int r = 0; r < rows.rows; r++)
+			if (cvRound(rows.at<float>(r, 0)) == batchIndex)
+				count++;
+
+		int sizes[] = { 1, 1, std::max(count, 1), 7 };
+		cv::Mat detections(4, sizes, CV_32F, cv::Scalar::all(0));
+		cv::Mat detectionRows(sizes[2], sizes[3], CV_32F, detections.ptr<float>());
+		int k = 0;
+		for (int r = 0; r < rows.rows; r++)
+		{
+			if (cvRound(rows.at<float>(r, 0)) != batchIndex)
+				continue;
+			rows.row(r).copyTo(detectionRows.row(k));
+			detectionRows.at<float>(k, 0) = 0;
+			k++;
+		}
+		return detections;
+	}
+
+	cv::Ptr<emgu::DnnBatchRequest> submit(const cv::Mat& image, emgu::DnnBatchCallback callback, int callbackId)
+	{
+		CV_Assert(!image.empty());
+		{
+			//blobFromImages fails on the whole batch if an image does not match the others, such an image is rejected here instead
+			std::lock_guard<std::mutex> lock(mutex);
+			if (imageType < 0)
+			{
+				imageType = image.type();
+				imageSize = image.size();
+			}
+			else if (image.type() != imageType)
+				CV_Error(cv::Error::StsUnmatchedFormats, "The image type does not match the type of the images submitted to the executor");
+			else if (size.empty() && image.size() != imageSize)
+				CV_Error(cv::Error::StsUnmatchedSizes, "The image size does not match the size of the images submitted to the executor, and the executor does not resize them");
+		}
+
+		cv::Ptr<DnnBatchRequestImpl> request = cv::makePtr<DnnBatchRequestImpl>();
+		image.copyTo(request->image);
+		request->callback = callback;
+		request->callbackId = callbackId;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		CV_Assert(!stopRequested);
+		request->queued = std::chrono::steady_clock::now();
+		pending.push_back(request);
+		requestQueued.notify_one();
+		return request;
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopRequested = true;
+			requestQueued.notify_all();
+		}
+		if (worker.joinable())
+			worker.join();
+	}
+};
+
+emgu::DnnBatchExecutor::DnnBatchExecutor(
+	cv::dnn::Net* net,
+	int maxBatchSize,
+	int maxWaitMs,
+	double scaleFactor,
+	const cv::Size& size,
+	const cv::Scalar& mean,
+	bool swapRB,
+	bool crop,
+	int ddepth,
+	const std::vector<cv::String>& outputNames)
+{
+	CV_Assert(net && !net->empty() && maxBatchSize > 0 && maxWaitMs >= 0);
+	impl = new Impl(*net, maxBatchSize, maxWaitMs, scaleFactor, size, mean, swapRB, crop, ddepth, outputNames);
+}
+
+emgu::DnnBatchExecutor::~DnnBatchExecutor()
+{
+	impl->stop();
+	delete impl;
+}
+
+cv::Ptr<emgu::DnnBatchRequest> emgu::DnnBatchExecutor::submit(const cv::Mat& image, DnnBatchCallback callback, int callbackId)
+{
+	return impl->submit(image, callback, callbackId);
+}
+
+void emgu::DnnBatchExecutor::getStats(int64* requestCount, int64* batchCount, double* totalLatencyMs, double* maxLatencyMs, double* totalInferenceMs) const
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	*requestCount = impl->requestCount;
+	*batchCount = impl->batchCount;
+	*totalLatencyMs = impl->totalLatencyMs;
+	*maxLatencyMs = impl->maxLatencyMs;
+	*totalInferenceMs = impl->totalInferenceMs;
+}
+#endif
+
+emgu::DnnBatchExecutor* cveDnnBatchExecutorCreate(
+	cv::dnn::Net* net,
+	int maxBatchSize,
+	int maxWaitMs,
+	double scaleFactor,
+	CvSize* size,
+	CvScalar* mean,
+	bool swapRB,
+	bool crop,
+	int ddepth,
+	std::vector<cv::String>* outputNames)
+{
+#ifdef HAVE_OPENCV_DNN
+	std::vector<cv::String> names;
+	if (outputNames)
+		names = *outputNames;
+	return new emgu::DnnBatchExecutor(net, maxBatchSize, maxWaitMs, scaleFactor, *size, *mean, swapRB, crop, ddepth, names);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnBatchExecutorRelease(emgu::DnnBatchExecutor** executor)
+{
+#ifdef HAVE_OPENCV_DNN
+	delete *executor;
+	*executor = 0;
+#else
+	throw_no_dnn();
+#endif
+}
+emgu::DnnBatchRequest* cveDnnBatchExecutorSubmit(
+	emgu::DnnBatchExecutor* executor,
+	cv::_InputArray* image,
+	emgu::DnnBatchCallback callback,
+	int callbackId,
+	cv::Ptr<emgu::DnnBatchRequest>** sharedPtr)
+{
+#ifdef HAVE_OPENCV_DNN
+	cv::Ptr<emgu::DnnBatchRequest> request = executor->submit(image->getMat(), callback, callbackId);
+	*sharedPtr = new cv::Ptr<emgu::DnnBatchRequest>(request);
+	return (*sharedPtr)->get();
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnBatchExecutorGetStats(emgu::DnnBatchExecutor* executor, int64* requestCount, int64* batchCount, double* totalLatencyMs, double* maxLatencyMs, double* totalInferenceMs)
+{
+#ifdef HAVE_OPENCV_DNN
+	executor->getStats(requestCount, batchCount, totalLatencyMs, maxLatencyMs, totalInferenceMs);
+#else
+	throw_no_dnn();
+#endif
+}
+bool cveDnnBatchRequestWait(emgu::DnnBatchRequest* request, int timeoutMs)
+{
+#ifdef HAVE_OPENCV_DNN
+	return request->wait(timeoutMs);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnBatchRequestGetOutputs(emgu::DnnBatchRequest* request, std::vector<cv::Mat>* outputs)
+{
+#ifdef HAVE_OPENCV_DNN
+	request->getOutputs(*outputs);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnBatchRequestRelease(cv::Ptr<emgu::DnnBatchRequest>** request)
+{
+#ifdef HAVE_OPENCV_DNN
+	delete *request;
+	*request = 0;
+#else
+	throw_no_dnn();
+#endif
+}
+
+#ifdef HAVE_OPENCV_DNN
+struct emgu::DnnNetPool::Impl
+{
+	cv::String framework;
+	//Released once maxInstances instances have been parsed
+	std::vector<uchar> bufferModel;
+	std::vector<uchar> bufferConfig;
+	int maxInstances;
+
+	std::vector<cv::dnn::Net> nets;
+	//The indices of the instances that are not leased
+	std::vector<int> available;
+	//The number of instances being parsed outside of the lock
+	int creating;
+
+	int64 leaseCount;
+	int64 waitCount;
+
+	std::mutex mutex;
+	std::condition_variable returned;
+
+	Impl(const cv::String& f, const uchar* model, size_t lenModel, const uchar* config, size_t lenConfig, int max)
+		: framework(f), bufferModel(model, model + lenModel), maxInstances(max), creating(0), leaseCount(0), waitCount(0)
+	{
+		if (config && lenConfig > 0)
+			bufferConfig.assign(config, config + lenConfig);
+		//The first instance is parsed upfront such that an invalid model is reported by the constructor
+		nets.push_back(createNet());
+		available.push_back(0);
+		releaseBuffersIfFull();
+	}
+
+	//No instance can be parsed once the pool is full, the buffers are not needed anymore
+	void releaseBuffersIfFull()
+	{
+		if ((int) nets.size() < maxInstances)
+			return;
+		std::vector<uchar>().swap(bufferModel);
+		std::vector<uchar>().swap(bufferConfig);
+	}
+
+	cv::dnn::Net createNet() const
+	{
+		cv::dnn::Net net = cv::dnn::readNet(framework, bufferModel, bufferConfig);
+		CV_Assert(!net.empty());
+		return net;
+	}
+
+	int acquire(int timeoutMs, cv::dnn::Net& net)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (available.empty() && (int) nets.size() + creating >= maxInstances)
+		{
+			waitCount++;
+			auto canLease = [this] { return !available.empty() || (int) nets.size() + creating < maxInstances; };
+			if (timeoutMs < 0)
+				returned.wait(lock, canLease);
+			else if (!returned.wait_for(lock, std::chrono::milliseconds(timeoutMs), canLease))
+				return -1;
+		}
+
+		int index;
+		if (!available.empty())
+		{
+			index = available.back();
+			available.pop_back();
+		}
+		else
+		{
+			//All the instances are leased, parse a new one without blocking the threads that return theirs
+			creating++;
+			lock.unlock();
+			cv::dnn::Net created;
+			try
+			{
+				created = createNet();
+			}
+			catch (...)
+			{
+				lock.lock();
+				creating--;
+				returned.notify_one();
+				throw;
+			}
+			lock.lock();
+			creating--;
+			index = (int) nets.size();
+			nets.push_back(created);
+			//The other instances being parsed count towards maxInstances, none is left when the pool is full
+			releaseBuffersIfFull();
+		}
+		leaseCount++;
+		net = nets[index];
+		return index;
+	}
+
+	void release(int index)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		CV_Assert(index >= 0 && index < (int) nets.size());
+		CV_Assert(std::find(available.begin(), available.end(), index) == available.end());
+		available.push_back(index);
+		returned.notify_one();
+	}
+};
+
+emgu::DnnNetPool::DnnNetPool(
+	const cv::String& framework,
+	const uchar* bufferModel,
+	size_t lenModel,
+	const uchar* bufferConfig,
+	size_t lenConfig,
+	int maxInstances,
+	int threadsPerInstance)
+{
+	CV_Assert(bufferModel && lenModel > 0);
+	//Each forward pass runs on the process wide thread count, the instances leased at the same time share the cores
+	if (threadsPerInstance <= 0)
+		threadsPerInstance = cv::getNumThreads();
+	if (maxInstances <= 0)
+		maxInstances = std::max(1, cv::getNumberOfCPUs() / std::max(1, threadsPerInstance));
+	impl = new Impl(framework, bufferModel, lenModel, bufferConfig, lenConfig, maxInstances);
+}
+
+emgu::DnnNetPool::~DnnNetPool()
+{
+	delete impl;
+}
+
+int emgu::DnnNetPool::acquire(int timeoutMs, cv::dnn::Net& net)
+{
+	return impl->acquire(timeoutMs, net);
+}
+
+void emgu::DnnNetPool::release(int index)
+{
+	impl->release(index);
+}
+
+void emgu::DnnNetPool::getStats(int* instanceCount, int* availableCount, int64* leaseCount, int64* waitCount) const
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	*instanceCount = (int) impl->nets.size();
+	*availableCount = (int) impl->available.size();
+	*leaseCount = impl->leaseCount;
+	*waitCount = impl->waitCount;
+}
+#endif
+
+emgu::DnnNetPool* cveDnnNetPoolCreate(
+	cv::String* framework,
+	uchar* bufferModel,
+	int lenModel,
+	uchar* bufferConfig,
+	int lenConfig,
+	int maxInstances,
+	int threadsPerInstance)
+{
+#ifdef HAVE_OPENCV_DNN
+	return new emgu::DnnNetPool(*framework, bufferModel, lenModel, bufferConfig, lenConfig, maxInstances, threadsPerInstance);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetPoolRelease(emgu::DnnNetPool** pool)
+{
+#ifdef HAVE_OPENCV_DNN
+	delete *pool;
+	*pool = 0;
+#else
+	throw_no_dnn();
+#endif
+}
+cv::dnn::Net* cveDnnNetPoolAcquire(emgu::DnnNetPool* pool, int timeoutMs, int* index)
+{
+#ifdef HAVE_OPENCV_DNN
+	cv::dnn::Net net;
+	*index = pool->acquire(timeoutMs, net);
+	if (*index < 0)
+		return 0;
+	return new cv::dnn::Net(net);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetPoolReturn(emgu::DnnNetPool* pool, int index)
+{
+#ifdef HAVE_OPENCV_DNN
+	pool->release(index);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetPoolGetStats(emgu::DnnNetPool* pool, int* instanceCount, int* availableCount, int64* leaseCount, int64* waitCount)
+{
+#ifdef HAVE_OPENCV_DNN
+	pool->getStats(instanceCount, availableCount, leaseCount, waitCount);
+#else
+	throw_no_dnn();
+#endif
+}
+
+#ifdef HAVE_OPENCV_DNN
+//The per layer information that only depends on the input shapes, shared by the passes run with the same shapes
+struct DnnProfileLayout
+{
+	std::vector<cv::dnn::MatShape> inputShapes;
+	std::vector<cv::String> names;
+	std::vector<cv::String> types;
+	std::vector<cv::String> shapes;
+	std::vector<int> targets;
+	std::vector<int64> blobBytes;
+	std::vector<int64> weightBytes;
+};
+
+struct DnnProfileRecord
+{
+	//Since the creation of the profiler
+	double startUs;
+	double totalMs;
+	std::vector<float> layerMs;
+	cv::Ptr<DnnProfileLayout> layout;
+};
+
+static void appendShapes(std::ostringstream& os, const std::vector<cv::dnn::MatShape>& shapes)
+{
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		if (i > 0)
+			os << ", ";
+		for (size_t j = 0; j < shapes[i].size(); j++)
+		{
+			if (j > 0)
+				os << 'x';
+			os << shapes[i][j];
+		}
+	}
+}
+
+static void appendJsonString(std::ostringstream& os, const cv::String& s)
+{
+	os << '"';
+	for (size_t i = 0; i < s.size(); i++)
+	{
+		unsigned char c = (unsigned char) s[i];
+		if (c == '"' || c == '\\')
+			os << '\\' << (char) c;
+		else if (c < 0x20)
+		{
+			static const char hex[] = "0123456789abcdef";
+			os << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+		}
+		else
+			os << (char) c;
+	}
+	os << '"';
+}
+
+//Nearest rank percentile of the sorted values
+static double sortedPercentile(const std::vector<double>& sorted, double percent)
+{
+	if (sorted.empty())
+		return 0;
+	int rank = (int) std::ceil(percent / 100.0 * sorted.size());
+	return sorted[std::min(std::max(rank, 1), (int) sorted.size()) - 1];
+}
+
+struct emgu::DnnNetProfiler::Impl
+{
+	cv::dnn::Net net;
+	int historySize;
+	int backendId;
+	int targetId;
+	std::chrono::steady_clock::time_point created;
+
+	//Only used by the thread running the forward passes
+	cv::Ptr<DnnProfileLayout> layout;
+
+	std::deque<DnnProfileRecord> records;
+	int64 forwardCount;
+	mutable std::mutex mutex;
+
+	Impl(const cv::dnn::Net& n, int history, int backend, int target)
+		: net(n), historySize(history), backendId(backend), targetId(target), created(std::chrono::steady_clock::now()), forwardCount(0)
+	{
+	}
+
+	cv::Ptr<DnnProfileLayout> createLayout(const std::vector<cv::dnn::MatShape>& inputShapes)
+	{
+		cv::Ptr<DnnProfileLayout> l = cv::makePtr<DnnProfileLayout>();
+		l->inputShapes = inputShapes;
+		l->names = net.getLayerNames();
+		size_t count = l->names.size();
+		l->types.resize(count);
+		l->targets.resize(count);
+		l->shapes.resize(count);
+		l->blobBytes.resize(count, 0);
+		l->weightBytes.resize(count, 0);
+		//Layer i of the names is the layer id i + 1, id 0 is the input layer
+		for (size_t i = 0; i < count; i++)
+		{
+			cv::Ptr<cv::dnn::Layer> layer = net.getLayer((int) i + 1);
+			l->types[i] = layer->type;
+			l->targets[i] = layer->preferableTarget;
+		}
+
+		std::vector<int> ids;
+		std::vector<std::vector<cv::dnn::MatShape> > inShapes, outShapes;
+		std::vector<size_t> weights, blobs;
+		try
+		{
+			net.getLayersShapes(inputShapes, ids, inShapes, outShapes);
+			for (size_t i = 0; i < ids.size(); i++)
+			{
+				if (ids[i] < 1 || ids[i] > (int) count)
+					continue;
+				std::ostringstream os;
+				appendShapes(os, inShapes[i]);
+				os << " -> ";
+				appendShapes(os, outShapes[i]);
+				l->shapes[ids[i] - 1] = os.str();
+			}
+
+			ids.clear();
+			net.getMemoryConsumption(inputShapes, ids, weights, blobs);
+			for (size_t i = 0; i < ids.size(); i++)
+			{
+				if (ids[i] < 1 || ids[i] > (int) count)
+					continue;
+				l->weightBytes[ids[i] - 1] = (int64) weights[i];
+				l->blobBytes[ids[i] - 1] = (int64) blobs[i];
+			}
+		}
+		catch (const cv::Exception&)
+		{
+			//The shapes of a network with dynamic shapes can not be inferred from its input shapes, they are left empty
+		}
+		return l;
+	}
+
+	void forward(
+		const std::vector<cv::Mat>& inputs,
+		const std::vector<cv::String>& inputNames,
+		std::vector<cv::Mat>& outputs,
+		const std::vector<cv::String>& outputNames)
+	{
+		CV_Assert(!inputs.empty());
+		CV_Assert(inputNames.empty() ? inputs.size() == 1 : inputs.size() == inputNames.size());
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < inputs.size(); i++)
+			net.setInput(inputs[i], inputNames.empty() ? cv::String() : inputNames[i]);
+		if (outputNames.empty())
+			net.forward(outputs, net.getUnconnectedOutLayersNames());
+		else
+			net.forward(outputs, outputNames);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		std::vector<double> timings;
+		net.getPerfProfile(timings);
+
+		std::vector<cv::dnn::MatShape> inputShapes(inputs.size());
+		for (size_t i = 0; i < inputs.size(); i++)
+			inputShapes[i] = cv::dnn::shape(inputs[i]);
+		if (!layout || layout->inputShapes != inputShapes)
+			layout = createLayout(inputShapes);
+
+		DnnProfileRecord record;
+		record.startUs = std::chrono::duration<double, std::micro>(start - created).count();
+		record.totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+		record.layerMs.resize(timings.size());
+		double msPerTick = 1000.0 / cv::getTickFrequency();
+		for (size_t i = 0; i < timings.size(); i++)
+			record.layerMs[i] = (float) (timings[i] * msPerTick);
+		record.layout = layout;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if ((int) records.size() >= historySize)
+			records.pop_front();
+		records.push_back(record);
+		forwardCount++;
+	}
+
+	void getLayerStats(
+		std::vector<cv::String>& names,
+		std::vector<cv::String>& types,
+		std::vector<cv::String>& shapes,
+		std::vector<int>& targets,
+		cv::Mat& stats) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (records.empty())
+		{
+			names.clear();
+			types.clear();
+			shapes.clear();
+			targets.clear();
+			stats.release();
+			return;
+		}
+
+		const DnnProfileLayout& l = *records.back().layout;
+		names = l.names;
+		types = l.types;
+		shapes = l.shapes;
+		targets = l.targets;
+
+		int count = (int) l.names.size();
+		stats.create(count, 7, CV_64F);
+		std::vector<double> values;
+		values.reserve(records.size());
+		for (int i = 0; i < count; i++)
+		{
+			values.clear();
+			double sum = 0;
+			for (std::deque<DnnProfileRecord>::const_iterator r = records.begin(); r != records.end(); ++r)
+			{
+				if (i < (int) r->layerMs.size())
+				{
+					values.push_back(r->layerMs[i]);
+					sum += r->layerMs[i];
+				}
+			}
+			std::sort(values.begin(), values.end());
+
+			double* row = stats.ptr<double>(i);
+			row[0] = values.empty() ? 0 : sum / values.size();
+			row[1] = sortedPercentile(values, 50);
+			row[2] = sortedPercentile(values, 90);
+			row[3] = sortedPercentile(values, 99);
+			row[4] = values.empty() ? 0 : values.back();
+			row[5] = (double) l.blobBytes[i];
+			row[6] = (double) l.weightBytes[i];
+		}
+	}
+
+	void getForwardStats(int64* count, double* meanMs, double* p50Ms, double* p90Ms, double* p99Ms, double* maxMs) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::vector<double> values;
+		values.reserve(records.size());
+		double sum = 0;
+		for (std::deque<DnnProfileRecord>::const_iterator r = records.begin(); r != records.end(); ++r)
+		{
+			values.push_back(r->totalMs);
+			sum += r->totalMs;
+		}
+		std::sort(values.begin(), values.end());
+
+		*count = forwardCount;
+		*meanMs = values.empty() ? 0 : sum / values.size();
+		*p50Ms = sortedPercentile(values, 50);
+		*p90Ms = sortedPercentile(values, 90);
+		*p99Ms = sortedPercentile(values, 99);
+		*maxMs = values.empty() ? 0 : values.back();
+	}
+
+	/*
+	 * Every pass is a complete event, with the layers as nested complete events. OpenCV runs the layers one after the other and only
+	 * records their durations, so the layers are laid out back to back from the start of the pass, the gaps are moved to its end.
+	 * The memory of the blobs is reported as a counter.
+	 */
+	cv::String getChromeTrace() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::ostringstream os;
+		os.imbue(std::locale::classic());
+		os.setf(std::ios::fixed);
+		os.precision(3);
+		os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"dnn\"}}";
+		for (std::deque<DnnProfileRecord>::const_iterator r = records.begin(); r != records.end(); ++r)
+		{
+			const DnnProfileLayout& l = *r->layout;
+			int64 totalBlobBytes = 0;
+			for (size_t i = 0; i < l.blobBytes.size(); i++)
+				totalBlobBytes += l.blobBytes[i];
+
+			std::ostringstream inputs;
+			appendShapes(inputs, l.inputShapes);
+			os << ",\n{\"name\":\"forward\",\"cat\":\"forward\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << r->startUs
+				<< ",\"dur\":" << r->totalMs * 1000.0
+				<< ",\"args\":{\"backend\":" << backendId << ",\"target\":" << targetId << ",\"inputs\":";
+			appendJsonString(os, inputs.str());
+			os << "}}";
+			os << ",\n{\"name\":\"blob memory\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":" << r->startUs
+				<< ",\"args\":{\"bytes\":" << totalBlobBytes << "}}";
+
+			double ts = r->startUs;
+			size_t count = std::min(r->layerMs.size(), l.names.size());
+			for (size_t i = 0; i < count; i++)
+			{
+				//The layers fused into their predecessor are not run
+				if (r->layerMs[i] <= 0)
+					continue;
+				double dur = r->layerMs[i] * 1000.0;
+				os << ",\n{\"name\":";
+				appendJsonString(os, l.names[i]);
+				os << ",\"cat\":";
+				appendJsonString(os, l.types[i]);
+				os << ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << ts << ",\"dur\":" << dur << ",\"args\":{\"shapes\":";
+				appendJsonString(os, l.shapes[i]);
+				os << ",\"blobBytes\":" << l.blobBytes[i] << ",\"weightBytes\":" << l.weightBytes[i] << ",\"target\":" << l.targets[i] << "}}";
+				ts += dur;
+			}
+		}
+		os << "\n]}";
+		return os.str();
+	}
+};
+
+emgu::DnnNetProfiler::DnnNetProfiler(cv::dnn::Net* net, int historySize, int backendId, int targetId)
+{
+	CV_Assert(historySize > 0);
+	net->setPreferableBackend(backendId);
+	net->setPreferableTarget(targetId);
+	impl = new Impl(*net, historySize, backendId, targetId);
+}
+
+emgu::DnnNetProfiler::~DnnNetProfiler()
+{
+	delete impl;
+}
+
+void emgu::DnnNetProfiler::forward(
+	const std::vector<cv::Mat>& inputs,
+	const std::vector<cv::String>& inputNames,
+	std::vector<cv::Mat>& outputs,
+	const std::vector<cv::String>& outputNames)
+{
+	impl->forward(inputs, inputNames, outputs, outputNames);
+}
+
+void emgu::DnnNetProfiler::getLayerStats(
+	std::vector<cv::String>& names,
+	std::vector<cv::String>& types,
+	std::vector<cv::String>& shapes,
+	std::vector<int>& targets,
+	cv::Mat& stats) const
+{
+	impl->getLayerStats(names, types, shapes, targets, stats);
+}
+
+void emgu::DnnNetProfiler::getForwardStats(int64* count, double* meanMs, double* p50Ms, double* p90Ms, double* p99Ms, double* maxMs) const
+{
+	impl->getForwardStats(count, meanMs, p50Ms, p90Ms, p99Ms, maxMs);
+}
+
+cv::String emgu::DnnNetProfiler::getChromeTrace() const
+{
+	return impl->getChromeTrace();
+}
+
+void emgu::DnnNetProfiler::reset()
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	impl->records.clear();
+	impl->forwardCount = 0;
+}
+#endif
+
+emgu::DnnNetProfiler* cveDnnNetProfilerCreate(cv::dnn::Net* net, int historySize, int backendId, int targetId)
+{
+#ifdef HAVE_OPENCV_DNN
+	return new emgu::DnnNetProfiler(net, historySize, backendId, targetId);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetProfilerRelease(emgu::DnnNetProfiler** profiler)
+{
+#ifdef HAVE_OPENCV_DNN
+	delete *profiler;
+	*profiler = 0;
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetProfilerForward(
+	emgu::DnnNetProfiler* profiler,
+	std::vector<cv::Mat>* inputs,
+	std::vector<cv::String>* inputNames,
+	std::vector<cv::Mat>* outputs,
+	std::vector<cv::String>* outputNames)
+{
+#ifdef HAVE_OPENCV_DNN
+	std::vector<cv::String> noNames;
+	profiler->forward(*inputs, inputNames ? *inputNames : noNames, *outputs, outputNames ? *outputNames : noNames);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetProfilerGetLayerStats(
+	emgu::DnnNetProfiler* profiler,
+	std::vector<cv::String>* names,
+	std::vector<cv::String>* types,
+	std::vector<cv::String>* shapes,
+	std::vector<int>* targets,
+	cv::Mat* stats)
+{
+#ifdef HAVE_OPENCV_DNN
+	profiler->getLayerStats(*names, *types, *shapes, *targets, *stats);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetProfilerGetForwardStats(emgu::DnnNetProfiler* profiler, int64* count, double* meanMs, double* p50Ms, double* p90Ms, double* p99Ms, double* maxMs)
+{
+#ifdef HAVE_OPENCV_DNN
+	profiler->getForwardStats(count, meanMs, p50Ms, p90Ms, p99Ms, maxMs);
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetProfilerGetChromeTrace(emgu::DnnNetProfiler* profiler, cv::String* trace)
+{
+#ifdef HAVE_OPENCV_DNN
+	*trace = profiler->getChromeTrace();
+#else
+	throw_no_dnn();
+#endif
+}
+void cveDnnNetProfilerReset(emgu::DnnNetProfiler* profiler)
+{
+#ifdef HAVE_OPENCV_DNN
+	profiler->reset();
+#else
+	throw_no_dnn();
+#endif
 }
\ No newline at end of file
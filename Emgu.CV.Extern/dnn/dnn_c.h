@@ -113,6 +113,50 @@ CVAPI(void) cveDnnBlobFromImages(
 
 CVAPI(void) cveDnnImagesFromBlob(cv::Mat* blob, cv::_OutputArray* images);
 
+/*
+ * Single pass equivalent of blobFromImages: bilinear resize, center crop or letterbox, swapRB, mean subtraction, scaling and
+ * the HWC to NCHW layout change are done in one row parallel pass per output row, writing directly into blob.
+ * blob is only reallocated if its shape or depth changes. paddingMode: 0 = stretch, 1 = crop center, 2 = letterbox.
+ * ddepth can be CV_32F, CV_16F, CV_8U or CV_8S, integer outputs are saturated.
+ */
+CVAPI(void) cveDnnBlobFromImagesFused(
+	cv::_InputArray* images,
+	cv::Mat* blob,
+	double scalefactor,
+	CvSize* size,
+	CvScalar* mean,
+	bool swapRB,
+	int paddingMode,
+	CvScalar* paddingValue,
+	int ddepth);
+
+/*
+ * Decode the raw output of a detection network and run non maximum suppression, such that only the final detections leave native code.
+ * headLayout:
+ *   0 = YOLOv5, one output [1, N, 5 + C]: cx, cy, w, h, objectness, class scores, in input pixels
+ *   1 = YOLOv8, one output [1, 4 + C, N]: cx, cy, w, h, class scores, in input pixels
+ *   2 = SSD, one DetectionOutput [1, 1, N, 7]: image id, class id, score, x1, y1, x2, y2, normalized to [0, 1]
+ *   3 = RetinaNet, two outputs: boxes [N, 4] x1, y1, x2, y2 in input pixels, and class probabilities [N, C].
+ *       If anchors [N, 4] (x1, y1, x2, y2) is not empty the boxes are dx, dy, dw, dh regressions relative to the anchors.
+ * Candidates below confThreshold are dropped before NMS. NMS is skipped if nmsThreshold <= 0, and done per class if classAware.
+ * The boxes are mapped from the network input of inputSize back to the image of imageSize, given the paddingMode of the blob
+ * (see cveDnnBlobFromImagesFused). An empty imageSize keeps the input coordinates. topK <= 0 keeps all the detections.
+ */
+CVAPI(void) cveDnnDecodeDetections(
+	cv::_InputArray* outputs,
+	int headLayout,
+	cv::Mat* anchors,
+	float confThreshold,
+	float nmsThreshold,
+	bool classAware,
+	int topK,
+	CvSize* inputSize,
+	CvSize* imageSize,
+	int paddingMode,
+	std::vector<cv::Rect>* boxes,
+	std::vector<float>* scores,
+	std::vector<int>* classIds);
+
 CVAPI(void) cveDnnShrinkCaffeModel(cv::String* src, cv::String* dst);
 
 CVAPI(void) cveDnnWriteTextGraph(cv::String* model, cv::String* output);
@@ -238,4 +282,220 @@ CVAPI(void) cveDnnSegmentationModelSegment(
 	cv::_InputArray* frame,
 	cv::_OutputArray* mask);
 
+namespace emgu
+{
+	/*
+	 * A single inference request queued on a DnnBatchExecutor. It acts as a future: wait for the batch it has
+	 * been coalesced into to complete, then get the slices of the output blobs that belong to this request.
+	 */
+	class CV_EXPORTS DnnBatchRequest
+	{
+	public:
+		virtual ~DnnBatchRequest() {}
+
+		//Return true if the request has completed, timeoutMs < 0 waits forever
+		virtual bool wait(int timeoutMs) = 0;
+
+		//Wait for the request and get one blob per output name, with a batch size of 1. Raise the error if the forward pass failed.
+		//The [1, 1, N, 7] detections of a DetectionOutput layer are the rows of this request, with their image index set to 0.
+		virtual void getOutputs(std::vector<cv::Mat>& outputs) = 0;
+	};
+
+	/*
+	 * Called from the executor thread once a request submitted with a callback has completed. The outputs, one blob per output name
+	 * with a batch size of 1, are only valid during the call. error is null if the forward pass succeeded.
+	 */
+	typedef void (CV_CDECL *DnnBatchCallback)(std::vector<cv::Mat>* outputs, const char* error, int callbackId);
+
+	/*
+	 * Coalesce the images submitted from many threads into batches, such that the network runs one forward pass for up to
+	 * maxBatchSize images. A batch is started as soon as it is full, or maxWaitMs after its first request has been queued.
+	 * The network is shared with the executor thread, it must not be used by other threads while the executor is alive.
+	 * The images of a batch must share their type, and their size if size is empty. The first submitted image sets them,
+	 * an image that does not match is rejected by submit.
+	 */
+	class CV_EXPORTS DnnBatchExecutor
+	{
+	public:
+		//An empty outputNames runs the unconnected output layers of the network
+		DnnBatchExecutor(
+			cv::dnn::Net* net,
+			int maxBatchSize,
+			int maxWaitMs,
+			double scaleFactor,
+			const cv::Size& size,
+			const cv::Scalar& mean,
+			bool swapRB,
+			bool crop,
+			int ddepth,
+			const std::vector<cv::String>& outputNames);
+		//Run the queued requests and stop the executor thread
+		~DnnBatchExecutor();
+
+		//Queue a copy of the image. If callback is not null, it is called with callbackId once the request has completed.
+		cv::Ptr<DnnBatchRequest> submit(const cv::Mat& image, DnnBatchCallback callback = 0, int callbackId = 0);
+
+		void getStats(int64* requestCount, int64* batchCount, double* totalLatencyMs, double* maxLatencyMs, double* totalInferenceMs) const;
+
+	private:
+		struct Impl;
+		Impl* impl;
+
+		DnnBatchExecutor(const DnnBatchExecutor&);
+		DnnBatchExecutor& operator=(const DnnBatchExecutor&);
+	};
+}
+
+CVAPI(emgu::DnnBatchExecutor*) cveDnnBatchExecutorCreate(
+	cv::dnn::Net* net,
+	int maxBatchSize,
+	int maxWaitMs,
+	double scaleFactor,
+	CvSize* size,
+	CvScalar* mean,
+	bool swapRB,
+	bool crop,
+	int ddepth,
+	std::vector<cv::String>* outputNames);
+CVAPI(void) cveDnnBatchExecutorRelease(emgu::DnnBatchExecutor** executor);
+CVAPI(emgu::DnnBatchRequest*) cveDnnBatchExecutorSubmit(
+	emgu::DnnBatchExecutor* executor,
+	cv::_InputArray* image,
+	emgu::DnnBatchCallback callback,
+	int callbackId,
+	cv::Ptr<emgu::DnnBatchRequest>** sharedPtr);
+CVAPI(void) cveDnnBatchExecutorGetStats(emgu::DnnBatchExecutor* executor, int64* requestCount, int64* batchCount, double* totalLatencyMs, double* maxLatencyMs, double* totalInferenceMs);
+CVAPI(bool) cveDnnBatchRequestWait(emgu::DnnBatchRequest* request, int timeoutMs);
+CVAPI(void) cveDnnBatchRequestGetOutputs(emgu::DnnBatchRequest* request, std::vector<cv::Mat>* outputs);
+CVAPI(void) cveDnnBatchRequestRelease(cv::Ptr<emgu::DnnBatchRequest>** request);
+
+namespace emgu
+{
+	/*
+	 * A pool of networks parsed from the same in memory model, leased to one thread at a time such that forward passes can run concurrently.
+	 * The pool keeps one copy of the model buffers, instances are parsed from it on demand, when all the existing instances are leased.
+	 * The copy is released once maxInstances instances exist.
+	 * The instances do not share their weights: each Net keeps the blobs of its parsed LayerParams, such that the memory of the weights
+	 * grows linearly with the number of instances. Replacing the blobs of the layers with those of the first instance would not release them.
+	 * OpenCV's parallel_for_ thread count is process wide and is not changed by the pool: every forward pass uses cv::getNumThreads() threads.
+	 * threadsPerInstance <= 0 takes that thread count, the default number of instances is the number of CPUs divided by threadsPerInstance,
+	 * such that the leased instances do not oversubscribe the cores.
+	 */
+	class CV_EXPORTS DnnNetPool
+	{
+	public:
+		//The buffers are copied. maxInstances <= 0 uses getNumberOfCPUs() / threadsPerInstance, threadsPerInstance <= 0 uses getNumThreads().
+		DnnNetPool(
+			const cv::String& framework,
+			const uchar* bufferModel,
+			size_t lenModel,
+			const uchar* bufferConfig,
+			size_t lenConfig,
+			int maxInstances,
+			int threadsPerInstance);
+		~DnnNetPool();
+
+		//Lease an instance, timeoutMs < 0 waits forever. Return the index of the instance and a handle to it in net, or -1 if the timeout expired.
+		int acquire(int timeoutMs, cv::dnn::Net& net);
+
+		//Return a leased instance to the pool
+		void release(int index);
+
+		void getStats(int* instanceCount, int* availableCount, int64* leaseCount, int64* waitCount) const;
+
+	private:
+		struct Impl;
+		Impl* impl;
+
+		DnnNetPool(const DnnNetPool&);
+		DnnNetPool& operator=(const DnnNetPool&);
+	};
+}
+
+CVAPI(emgu::DnnNetPool*) cveDnnNetPoolCreate(
+	cv::String* framework,
+	uchar* bufferModel,
+	int lenModel,
+	uchar* bufferConfig,
+	int lenConfig,
+	int maxInstances,
+	int threadsPerInstance);
+CVAPI(void) cveDnnNetPoolRelease(emgu::DnnNetPool** pool);
+CVAPI(cv::dnn::Net*) cveDnnNetPoolAcquire(emgu::DnnNetPool* pool, int timeoutMs, int* index);
+CVAPI(void) cveDnnNetPoolReturn(emgu::DnnNetPool* pool, int index);
+CVAPI(void) cveDnnNetPoolGetStats(emgu::DnnNetPool* pool, int* instanceCount, int* availableCount, int64* leaseCount, int64* waitCount);
+
+namespace emgu
+{
+	/*
+	 * Profile the forward passes of a network. Every forward pass run through the profiler records the wall time of each layer,
+	 * together with the input / output shapes, the memory of the output and internal blobs and the target of the layer.
+	 * The last historySize passes are kept to compute the percentiles of the layer times and to export a Chrome trace-event timeline
+	 * that can be loaded in chrome://tracing or https://ui.perfetto.dev.
+	 * The network must only be run by one thread at a time, the statistics can be read from any thread.
+	 */
+	class CV_EXPORTS DnnNetProfiler
+	{
+	public:
+		//Set the preferable backend and target of the network, they are reported with every pass
+		DnnNetProfiler(cv::dnn::Net* net, int historySize, int backendId, int targetId);
+		~DnnNetProfiler();
+
+		//Set the inputs, in the order of the network inputs, run the forward pass and record its profile.
+		//An empty inputNames sets the single input of the network, an empty outputNames runs the unconnected output layers.
+		void forward(
+			const std::vector<cv::Mat>& inputs,
+			const std::vector<cv::String>& inputNames,
+			std::vector<cv::Mat>& outputs,
+			const std::vector<cv::String>& outputNames);
+
+		/*
+		 * Get one row per layer, in the order of the network layers, computed over the recorded passes.
+		 * The CV_64F stats matrix has the columns: mean, 50th, 90th, 99th percentile and maximum time in milliseconds,
+		 * bytes of the output and internal blobs and bytes of the weights. The shapes and targets are the ones of the last pass.
+		 */
+		void getLayerStats(
+			std::vector<cv::String>& names,
+			std::vector<cv::String>& types,
+			std::vector<cv::String>& shapes,
+			std::vector<int>& targets,
+			cv::Mat& stats) const;
+
+		//Get the statistics of the whole forward passes, in milliseconds
+		void getForwardStats(int64* count, double* meanMs, double* p50Ms, double* p90Ms, double* p99Ms, double* maxMs) const;
+
+		//Chrome trace-event JSON of the recorded passes
+		cv::String getChromeTrace() const;
+
+		//Discard the recorded passes
+		void reset();
+
+	private:
+		struct Impl;
+		Impl* impl;
+
+		DnnNetProfiler(const DnnNetProfiler&);
+		DnnNetProfiler& operator=(const DnnNetProfiler&);
+	};
+}
+
+CVAPI(emgu::DnnNetProfiler*) cveDnnNetProfilerCreate(cv::dnn::Net* net, int historySize, int backendId, int targetId);
+CVAPI(void) cveDnnNetProfilerRelease(emgu::DnnNetProfiler** profiler);
+CVAPI(void) cveDnnNetProfilerForward(
+	emgu::DnnNetProfiler* profiler,
+	std::vector<cv::Mat>* inputs,
+	std::vector<cv::String>* inputNames,
+	std::vector<cv::Mat>* outputs,
+	std::vector<cv::String>* outputNames);
+CVAPI(void) cveDnnNetProfilerGetLayerStats(
+	emgu::DnnNetProfiler* profiler,
+	std::vector<cv::String>* names,
+	std::vector<cv::String>* types,
+	std::vector<cv::String>* shapes,
+	std::vector<int>* targets,
+	cv::Mat* stats);
+CVAPI(void) cveDnnNetProfilerGetForwardStats(emgu::DnnNetProfiler* profiler, int64* count, double* meanMs, double* p50Ms, double* p90Ms, double* p99Ms, double* maxMs);
+CVAPI(void) cveDnnNetProfilerGetChromeTrace(emgu::DnnNetProfiler* profiler, cv::String* trace);
+CVAPI(void) cveDnnNetProfilerReset(emgu::DnnNetProfiler* profiler);
+
 #endif
\ No newline at end of file
@@ -10,61 +10,422 @@
 #define EMGU_DOUBLE_OPS_H
 
 #include "sse.h"
+
+/*
+ * Operations on arrays of double. The functions in the doubleOps namespace pick the widest
+ * implementation supported by the CPU at run time: avx512, avx2, sse2 and finally scalar.
+ * The implementations are also accessible directly, e.g. for benchmarking.
+ * The reductions (dot, sumSq) use several accumulators, the result may differ from the scalar
+ * version in the last bits. minMaxIdx returns the index of the first minimum / maximum, NaN is not supported.
+ */
 namespace doubleOps
 {
-   inline void weightedSum(const double* d1, const double* d2, int elementCount, double w1, double w2, double* r)
+   namespace scalar
    {
-      double* end = r + elementCount;
-#if EMGU_SSE2
-      __m128d f = _mm_set_pd(w1, w2);
+      inline void weightedSum(const double* d1, const double* d2, int elementCount, double w1, double w2, double* r)
+      {
+         for (int i = 0; i < elementCount; i++)
+            r[i] = d1[i] * w1 + d2[i] * w2;
+      }
 
-#if EMGU_SSE4_1
-      if(simdSSE4_1) 
+      inline void mulS(const double* d, double scale, int length, double* result)
       {
-         while(r < end) _mm_store_sd(r++, _mm_dp_pd(_mm_set_pd(*d1++, *d2++), f, 0x33));
-         return;
+         for (int i = 0; i < length; i++)
+            result[i] = d[i] * scale;
       }
-#endif 
-      while (r < end)
+
+      inline void add(const double* d1, const double* d2, int length, double* result)
       {
-         __m128d v = _mm_mul_pd(_mm_set_pd(*d1++, *d2++), f);
-         _mm_store_sd(r++, _mm_add_pd(v, _mm_shuffle_pd(v, v, 1)));
+         for (int i = 0; i < length; i++)
+            result[i] = d1[i] + d2[i];
+      }
+
+      //y = a * x + y
+      inline void axpy(double a, const double* x, int length, double* y)
+      {
+         for (int i = 0; i < length; i++)
+            y[i] += a * x[i];
+      }
+
+      inline double dot(const double* d1, const double* d2, int length)
+      {
+         double s = 0;
+         for (int i = 0; i < length; i++)
+            s += d1[i] * d2[i];
+         return s;
+      }
+
+      inline double sumSq(const double* d, int length)
+      {
+         return dot(d, d, length);
+      }
+
+      //Continue the search from index start, minVal / maxVal and minIdx / maxIdx must be initialized
+      inline void minMaxIdxFrom(const double* d, int start, int length, double* minVal, int* minIdx, double* maxVal, int* maxIdx)
+      {
+         for (int i = start; i < length; i++)
+         {
+            if (d[i] < *minVal) { *minVal = d[i]; *minIdx = i; }
+            if (d[i] > *maxVal) { *maxVal = d[i]; *maxIdx = i; }
+         }
+      }
+
+      inline void minMaxIdx(const double* d, int length, double* minVal, int* minIdx, double* maxVal, int* maxIdx)
+      {
+         if (length <= 0)
+         {
+            *minIdx = *maxIdx = -1;
+            return;
+         }
+         *minVal = *maxVal = d[0];
+         *minIdx = *maxIdx = 0;
+         minMaxIdxFrom(d, 1, length, minVal, minIdx, maxVal, maxIdx);
+      }
+
+      //Reduce the per lane results, on equal values the lowest index wins
+      inline void minMaxIdxReduce(const double* minV, const double* minI, const double* maxV, const double* maxI, int lanes,
+         double* minVal, int* minIdx, double* maxVal, int* maxIdx)
+      {
+         *minVal = minV[0]; *minIdx = (int)minI[0];
+         *maxVal = maxV[0]; *maxIdx = (int)maxI[0];
+         for (int i = 1; i < lanes; i++)
+         {
+            if (minV[i] < *minVal || (minV[i] == *minVal && (int)minI[i] < *minIdx)) { *minVal = minV[i]; *minIdx = (int)minI[i]; }
+            if (maxV[i] > *maxVal || (maxV[i] == *maxVal && (int)maxI[i] < *maxIdx)) { *maxVal = maxV[i]; *maxIdx = (int)maxI[i]; }
+         }
       }
-#else
-      while( r < end) 
-         *r++ = *d1++ * w1 + *d2++ * w2;
-#endif
    }
 
-   inline void mulS(const double* d, double scale, int length, double* result)
-   {
-      const double* current = d;
-      const double* end = d+length;
 #if EMGU_SSE2
-      __m128d _scale = _mm_set1_pd(scale);
-      for(const double* stop = d + (length & -2); current < stop; current+=2, result+=2)
-         _mm_storeu_pd(result,_mm_mul_pd(_mm_loadu_pd(current), _scale));
-#endif
-      while (current < end)
+   namespace sse2
+   {
+      inline void weightedSum(const double* d1, const double* d2, int elementCount, double w1, double w2, double* r)
       {
-         *result++ = (*current++) * scale;
+         __m128d f1 = _mm_set1_pd(w1);
+         __m128d f2 = _mm_set1_pd(w2);
+         int i = 0;
+         for (; i <= elementCount - 2; i += 2)
+            _mm_storeu_pd(r + i, _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(d1 + i), f1), _mm_mul_pd(_mm_loadu_pd(d2 + i), f2)));
+         for (; i < elementCount; i++)
+            r[i] = d1[i] * w1 + d2[i] * w2;
+      }
+
+      inline void mulS(const double* d, double scale, int length, double* result)
+      {
+         __m128d _scale = _mm_set1_pd(scale);
+         int i = 0;
+         for (; i <= length - 2; i += 2)
+            _mm_storeu_pd(result + i, _mm_mul_pd(_mm_loadu_pd(d + i), _scale));
+         for (; i < length; i++)
+            result[i] = d[i] * scale;
+      }
+
+      inline void add(const double* d1, const double* d2, int length, double* result)
+      {
+         int i = 0;
+         for (; i <= length - 2; i += 2)
+            _mm_storeu_pd(result + i, _mm_add_pd(_mm_loadu_pd(d1 + i), _mm_loadu_pd(d2 + i)));
+         for (; i < length; i++)
+            result[i] = d1[i] + d2[i];
+      }
+
+      inline void axpy(double a, const double* x, int length, double* y)
+      {
+         __m128d _a = _mm_set1_pd(a);
+         int i = 0;
+         for (; i <= length - 2; i += 2)
+            _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(_a, _mm_loadu_pd(x + i))));
+         for (; i < length; i++)
+            y[i] += a * x[i];
+      }
+
+      inline double dot(const double* d1, const double* d2, int length)
+      {
+         __m128d s0 = _mm_setzero_pd();
+         __m128d s1 = _mm_setzero_pd();
+         int i = 0;
+         for (; i <= length - 4; i += 4)
+         {
+            s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(d1 + i), _mm_loadu_pd(d2 + i)));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(d1 + i + 2), _mm_loadu_pd(d2 + i + 2)));
+         }
+         s0 = _mm_add_pd(s0, s1);
+         s0 = _mm_add_pd(s0, _mm_shuffle_pd(s0, s0, 1));
+         double s;
+         _mm_store_sd(&s, s0);
+         for (; i < length; i++)
+            s += d1[i] * d2[i];
+         return s;
+      }
+
+      inline double sumSq(const double* d, int length)
+      {
+         return dot(d, d, length);
+      }
+
+      //Without blendv the masked selects cost more than the well predicted branches of the scalar loop
+      inline void minMaxIdx(const double* d, int length, double* minVal, int* minIdx, double* maxVal, int* maxIdx)
+      {
+         scalar::minMaxIdx(d, length, minVal, minIdx, maxVal, maxIdx);
       }
    }
+#endif
 
-   inline void add(const double* d1, const double* d2, int length, double* result)
+#if EMGU_AVX2
+   namespace avx2
    {
-      const double* current1 = d1;
-      const double* current2 = d2;
-      const double* end1 = d1 + length;
-#if EMGU_SSE2
-      for(const double* stop1 = d1 + (length &-2); current1 < stop1; current1+=2, current2 +=2, result +=2)
-         _mm_storeu_pd(result, _mm_add_pd(_mm_loadu_pd(current1), _mm_loadu_pd(current2)));
+      EMGU_TARGET_AVX2 inline void weightedSum(const double* d1, const double* d2, int elementCount, double w1, double w2, double* r)
+      {
+         __m256d f1 = _mm256_set1_pd(w1);
+         __m256d f2 = _mm256_set1_pd(w2);
+         int i = 0;
+         for (; i <= elementCount - 4; i += 4)
+            _mm256_storeu_pd(r + i, _mm256_fmadd_pd(_mm256_loadu_pd(d1 + i), f1, _mm256_mul_pd(_mm256_loadu_pd(d2 + i), f2)));
+         for (; i < elementCount; i++)
+            r[i] = d1[i] * w1 + d2[i] * w2;
+      }
+
+      EMGU_TARGET_AVX2 inline void mulS(const double* d, double scale, int length, double* result)
+      {
+         __m256d _scale = _mm256_set1_pd(scale);
+         int i = 0;
+         for (; i <= length - 4; i += 4)
+            _mm256_storeu_pd(result + i, _mm256_mul_pd(_mm256_loadu_pd(d + i), _scale));
+         for (; i < length; i++)
+            result[i] = d[i] * scale;
+      }
+
+      EMGU_TARGET_AVX2 inline void add(const double* d1, const double* d2, int length, double* result)
+      {
+         int i = 0;
+         for (; i <= length - 4; i += 4)
+            _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_loadu_pd(d1 + i), _mm256_loadu_pd(d2 + i)));
+         for (; i < length; i++)
+            result[i] = d1[i] + d2[i];
+      }
+
+      EMGU_TARGET_AVX2 inline void axpy(double a, const double* x, int length, double* y)
+      {
+         __m256d _a = _mm256_set1_pd(a);
+         int i = 0;
+         for (; i <= length - 4; i += 4)
+            _mm256_storeu_pd(y + i, _mm256_fmadd_pd(_a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+         for (; i < length; i++)
+            y[i] += a * x[i];
+      }
+
+      EMGU_TARGET_AVX2 inline double dot(const double* d1, const double* d2, int length)
+      {
+         __m256d s0 = _mm256_setzero_pd();
+         __m256d s1 = _mm256_setzero_pd();
+         int i = 0;
+         for (; i <= length - 8; i += 8)
+         {
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(d1 + i), _mm256_loadu_pd(d2 + i), s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(d1 + i + 4), _mm256_loadu_pd(d2 + i + 4), s1);
+         }
+         s0 = _mm256_add_pd(s0, s1);
+         __m128d s = _mm_add_pd(_mm256_castpd256_pd128(s0), _mm256_extractf128_pd(s0, 1));
+         s = _mm_add_pd(s, _mm_shuffle_pd(s, s, 1));
+         double result = _mm_cvtsd_f64(s);
+         for (; i < length; i++)
+            result += d1[i] * d2[i];
+         return result;
+      }
+
+      EMGU_TARGET_AVX2 inline double sumSq(const double* d, int length)
+      {
+         return dot(d, d, length);
+      }
+
+      EMGU_TARGET_AVX2 inline void minMaxIdx(const double* d, int length, double* minVal, int* minIdx, double* maxVal, int* maxIdx)
+      {
+         if (length < 8)
+         {
+            scalar::minMaxIdx(d, length, minVal, minIdx, maxVal, maxIdx);
+            return;
+         }
+         //the indices are tracked as double, exact for any int
+         __m256d idx = _mm256_set_pd(3, 2, 1, 0);
+         __m256d step = _mm256_set1_pd(4);
+         __m256d vMin = _mm256_loadu_pd(d), vMax = vMin;
+         __m256d iMin = idx, iMax = idx;
+         int i = 4;
+         for (; i <= length - 4; i += 4)
+         {
+            idx = _mm256_add_pd(idx, step);
+            __m256d v = _mm256_loadu_pd(d + i);
+            __m256d lt = _mm256_cmp_pd(v, vMin, _CMP_LT_OQ);
+            __m256d gt = _mm256_cmp_pd(v, vMax, _CMP_GT_OQ);
+            vMin = _mm256_blendv_pd(vMin, v, lt);
+            iMin = _mm256_blendv_pd(iMin, idx, lt);
+            vMax = _mm256_blendv_pd(vMax, v, gt);
+            iMax = _mm256_blendv_pd(iMax, idx, gt);
+         }
+         double minV[4], minI[4], maxV[4], maxI[4];
+         _mm256_storeu_pd(minV, vMin); _mm256_storeu_pd(minI, iMin);
+         _mm256_storeu_pd(maxV, vMax); _mm256_storeu_pd(maxI, iMax);
+         scalar::minMaxIdxReduce(minV, minI, maxV, maxI, 4, minVal, minIdx, maxVal, maxIdx);
+         scalar::minMaxIdxFrom(d, i, length, minVal, minIdx, maxVal, maxIdx);
+      }
+   }
 #endif
-      while(current1 < end1)
+
+#if EMGU_AVX512
+   namespace avx512
+   {
+      EMGU_TARGET_AVX512 inline void weightedSum(const double* d1, const double* d2, int elementCount, double w1, double w2, double* r)
+      {
+         __m512d f1 = _mm512_set1_pd(w1);
+         __m512d f2 = _mm512_set1_pd(w2);
+         int i = 0;
+         for (; i <= elementCount - 8; i += 8)
+            _mm512_storeu_pd(r + i, _mm512_fmadd_pd(_mm512_loadu_pd(d1 + i), f1, _mm512_mul_pd(_mm512_loadu_pd(d2 + i), f2)));
+         for (; i < elementCount; i++)
+            r[i] = d1[i] * w1 + d2[i] * w2;
+      }
+
+      EMGU_TARGET_AVX512 inline void mulS(const double* d, double scale, int length, double* result)
+      {
+         __m512d _scale = _mm512_set1_pd(scale);
+         int i = 0;
+         for (; i <= length - 8; i += 8)
+            _mm512_storeu_pd(result + i, _mm512_mul_pd(_mm512_loadu_pd(d + i), _scale));
+         for (; i < length; i++)
+            result[i] = d[i] * scale;
+      }
+
+      EMGU_TARGET_AVX512 inline void add(const double* d1, const double* d2, int length, double* result)
+      {
+         int i = 0;
+         for (; i <= length - 8; i += 8)
+            _mm512_storeu_pd(result + i, _mm512_add_pd(_mm512_loadu_pd(d1 + i), _mm512_loadu_pd(d2 + i)));
+         for (; i < length; i++)
+            result[i] = d1[i] + d2[i];
+      }
+
+      EMGU_TARGET_AVX512 inline void axpy(double a, const double* x, int length, double* y)
+      {
+         __m512d _a = _mm512_set1_pd(a);
+         int i = 0;
+         for (; i <= length - 8; i += 8)
+            _mm512_storeu_pd(y + i, _mm512_fmadd_pd(_a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+         for (; i < length; i++)
+            y[i] += a * x[i];
+      }
+
+      EMGU_TARGET_AVX512 inline double dot(const double* d1, const double* d2, int length)
+      {
+         __m512d s0 = _mm512_setzero_pd();
+         __m512d s1 = _mm512_setzero_pd();
+         int i = 0;
+         for (; i <= length - 16; i += 16)
+         {
+            s0 = _mm512_fmadd_pd(_mm512_loadu_pd(d1 + i), _mm512_loadu_pd(d2 + i), s0);
+            s1 = _mm512_fmadd_pd(_mm512_loadu_pd(d1 + i + 8), _mm512_loadu_pd(d2 + i + 8), s1);
+         }
+         s0 = _mm512_add_pd(s0, s1);
+         double lanes[8];
+         _mm512_storeu_pd(lanes, s0);
+         double result = ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+         for (; i < length; i++)
+            result += d1[i] * d2[i];
+         return result;
+      }
+
+      EMGU_TARGET_AVX512 inline double sumSq(const double* d, int length)
+      {
+         return dot(d, d, length);
+      }
+
+      EMGU_TARGET_AVX512 inline void minMaxIdx(const double* d, int length, double* minVal, int* minIdx, double* maxVal, int* maxIdx)
       {
-         *result++ = (*current1++) + (*current2++);
+         if (length < 16)
+         {
+            scalar::minMaxIdx(d, length, minVal, minIdx, maxVal, maxIdx);
+            return;
+         }
+         __m512d idx = _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0);
+         __m512d step = _mm512_set1_pd(8);
+         __m512d vMin = _mm512_loadu_pd(d), vMax = vMin;
+         __m512d iMin = idx, iMax = idx;
+         int i = 8;
+         for (; i <= length - 8; i += 8)
+         {
+            idx = _mm512_add_pd(idx, step);
+            __m512d v = _mm512_loadu_pd(d + i);
+            __mmask8 lt = _mm512_cmp_pd_mask(v, vMin, _CMP_LT_OQ);
+            __mmask8 gt = _mm512_cmp_pd_mask(v, vMax, _CMP_GT_OQ);
+            vMin = _mm512_mask_blend_pd(lt, vMin, v);
+            iMin = _mm512_mask_blend_pd(lt, iMin, idx);
+            vMax = _mm512_mask_blend_pd(gt, vMax, v);
+            iMax = _mm512_mask_blend_pd(gt, iMax, idx);
+         }
+         double minV[8], minI[8], maxV[8], maxI[8];
+         _mm512_storeu_pd(minV, vMin); _mm512_storeu_pd(minI, iMin);
+         _mm512_storeu_pd(maxV, vMax); _mm512_storeu_pd(maxI, iMax);
+         scalar::minMaxIdxReduce(minV, minI, maxV, maxI, 8, minVal, minIdx, maxVal, maxIdx);
+         scalar::minMaxIdxFrom(d, i, length, minVal, minIdx, maxVal, maxIdx);
       }
    }
+#endif
+
+#if EMGU_AVX512 && EMGU_AVX2
+#define EMGU_DOUBLE_OPS_DISPATCH(func, ...) \
+   if (simdAVX512) return avx512::func(__VA_ARGS__); \
+   if (simdAVX2) return avx2::func(__VA_ARGS__); \
+   return sse2::func(__VA_ARGS__);
+#elif EMGU_AVX2
+#define EMGU_DOUBLE_OPS_DISPATCH(func, ...) \
+   if (simdAVX2) return avx2::func(__VA_ARGS__); \
+   return sse2::func(__VA_ARGS__);
+#elif EMGU_SSE2
+#define EMGU_DOUBLE_OPS_DISPATCH(func, ...) \
+   return sse2::func(__VA_ARGS__);
+#else
+#define EMGU_DOUBLE_OPS_DISPATCH(func, ...) \
+   return scalar::func(__VA_ARGS__);
+#endif
+
+   //r = d1 * w1 + d2 * w2
+   inline void weightedSum(const double* d1, const double* d2, int elementCount, double w1, double w2, double* r)
+   {
+      EMGU_DOUBLE_OPS_DISPATCH(weightedSum, d1, d2, elementCount, w1, w2, r)
+   }
+
+   inline void mulS(const double* d, double scale, int length, double* result)
+   {
+      EMGU_DOUBLE_OPS_DISPATCH(mulS, d, scale, length, result)
+   }
+
+   inline void add(const double* d1, const double* d2, int length, double* result)
+   {
+      EMGU_DOUBLE_OPS_DISPATCH(add, d1, d2, length, result)
+   }
+
+   //y = a * x + y
+   inline void axpy(double a, const double* x, int length, double* y)
+   {
+      EMGU_DOUBLE_OPS_DISPATCH(axpy, a, x, length, y)
+   }
+
+   inline double dot(const double* d1, const double* d2, int length)
+   {
+      EMGU_DOUBLE_OPS_DISPATCH(dot, d1, d2, length)
+   }
+
+   inline double sumSq(const double* d, int length)
+   {
+      EMGU_DOUBLE_OPS_DISPATCH(sumSq, d, length)
+   }
+
+   //minIdx and maxIdx are set to -1 if length is 0
+   inline void minMaxIdx(const double* d, int length, double* minVal, int* minIdx, double* maxVal, int* maxIdx)
+   {
+      EMGU_DOUBLE_OPS_DISPATCH(minMaxIdx, d, length, minVal, minIdx, maxVal, maxIdx)
+   }
+
+#undef EMGU_DOUBLE_OPS_DISPATCH
 
    inline bool containsNaN(const double* d, int length)
    {
@@ -73,4 +434,4 @@ namespace doubleOps
       return false;
    }
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//
+//----------------------------------------------------------------------------
+
+#include "features2d_c.h"
+
+#if defined(HAVE_OPENCV_FEATURES2D) && defined(HAVE_OPENCV_CALIB3D)
+#include "opencv2/calib3d/calib3d.hpp"
+#endif
+
+#ifdef HAVE_OPENCV_FEATURES2D
+static double elapsedMs(int64 start)
+{
+	return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+emgu::FeatureMatchPipeline::FeatureMatchPipeline(double uniquenessThreshold, double scaleIncrement, int rotationBins, double ransacThreshold)
+	: uniquenessThreshold(uniquenessThreshold), scaleIncrement(scaleIncrement), rotationBins(rotationBins), ransacThreshold(ransacThreshold)
+{
+	CV_Assert(scaleIncrement > 1.0);
+	CV_Assert(rotationBins > 0);
+}
+
+bool emgu::FeatureMatchPipeline::match(
+	cv::DescriptorMatcher* matcher,
+	const std::vector<cv::KeyPoint>& modelKeyPoints,
+	const std::vector<cv::KeyPoint>& observedKeyPoints,
+	cv::InputArray observedDescriptors,
+	cv::Mat& homography,
+	std::vector<cv::DMatch>& inliers,
+	double* stageMs)
+{
+#ifdef HAVE_OPENCV_CALIB3D
+	for (int i = 0; i < 4; i++)
+		stageMs[i] = 0;
+	inliers.clear();
+
+	int64 start = cv::getTickCount();
+	matcher->knnMatch(observedDescriptors, knnMatches, 2);
+	stageMs[0] = elapsedMs(start);
+
+	//The best match is kept if the second best one is clearly further away
+	start = cv::getTickCount();
+	candidates.clear();
+	for (size_t i = 0; i < knnMatches.size(); i++)
+	{
+		const std::vector<cv::DMatch>& m = knnMatches[i];
+		if (m.empty())
+			continue;
+		if (m.size() > 1 && m[0].distance / m[1].distance > uniquenessThreshold)
+			continue;
+		CV_Assert(m[0].queryIdx < (int) observedKeyPoints.size() && m[0].trainIdx < (int) modelKeyPoints.size());
+		candidates.push_back(m[0]);
+	}
+	stageMs[1] = elapsedMs(start);
+	int count = (int) candidates.size();
+	if (count < 4)
+		return false;
+
+	start = cv::getTickCount();
+	voter.clear();
+	for (int i = 0; i < count; i++)
+		voter.add(modelKeyPoints[candidates[i].trainIdx], observedKeyPoints[candidates[i].queryIdx]);
+	count = voter.vote(scaleIncrement, rotationBins);
+	stageMs[2] = elapsedMs(start);
+	if (count < 4)
+		return false;
+
+	start = cv::getTickCount();
+	modelPoints.clear();
+	observedPoints.clear();
+	for (int i = 0; i < (int) candidates.size(); i++)
+	{
+		if (voter.isKept(i))
+		{
+			modelPoints.push_back(modelKeyPoints[candidates[i].trainIdx].pt);
+			observedPoints.push_back(observedKeyPoints[candidates[i].queryIdx].pt);
+		}
+	}
+	cv::Mat result = cv::findHomography(modelPoints, observedPoints, cv::RANSAC, ransacThreshold, ransacMask);
+	bool found = !result.empty();
+	if (found)
+	{
+		cv::swap(result, homography);
+		const uchar* inlierMask = ransacMask.ptr<uchar>();
+		for (int i = 0, j = 0; i < (int) candidates.size(); i++)
+		{
+			if (voter.isKept(i) && inlierMask[j++])
+				inliers.push_back(candidates[i]);
+		}
+	}
+	stageMs[3] = elapsedMs(start);
+	return found;
+#else
+	CV_Error(cv::Error::StsBadFunc, "The library is compiled without calib3d support. To use this module, please switch to the full Emgu CV runtime.");
+#endif
+}
+#endif
+
+emgu::FeatureMatchPipeline* cveFeatureMatchPipelineCreate(double uniquenessThreshold, double scaleIncrement, int rotationBins, double ransacThreshold)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	return new emgu::FeatureMatchPipeline(uniquenessThreshold, scaleIncrement, rotationBins, ransacThreshold);
+#else
+	throw_no_features2d();
+#endif
+}
+
+bool cveFeatureMatchPipelineMatch(
+	emgu::FeatureMatchPipeline* pipeline,
+	cv::DescriptorMatcher* matcher,
+	std::vector<cv::KeyPoint>* modelKeyPoints,
+	std::vector<cv::KeyPoint>* observedKeyPoints,
+	cv::_InputArray* observedDescriptors,
+	cv::Mat* homography,
+	std::vector<cv::DMatch>* inliers,
+	double* stageMs)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	return pipeline->match(matcher, *modelKeyPoints, *observedKeyPoints, *observedDescriptors, *homography, *inliers, stageMs);
+#else
+	throw_no_features2d();
+#endif
+}
+
+void cveFeatureMatchPipelineRelease(emgu::FeatureMatchPipeline** pipeline)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	delete *pipeline;
+	*pipeline = 0;
+#else
+	throw_no_features2d();
+#endif
+}
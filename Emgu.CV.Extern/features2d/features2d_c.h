@@ -198,8 +198,165 @@ CVAPI(void) cveBFMatcherRelease(cv::BFMatcher** matcher);
 CVAPI(cv::FlannBasedMatcher*) cveFlannBasedMatcherCreate(cv::flann::IndexParams* indexParams, cv::flann::SearchParams* searchParams, cv::DescriptorMatcher** m);
 CVAPI(void) cveFlannBasedMatcherRelease(cv::FlannBasedMatcher** matcher);
 
+//HammingMatcher
+#ifdef HAVE_OPENCV_FEATURES2D
+namespace emgu
+{
+	/*
+	 * Brute force matcher for binary descriptors (ORB, BRISK, AKAZE, BEBLID...) with the Hamming distance.
+	 * The train descriptors are packed into rows padded to a multiple of 32 bytes, the queries are matched in parallel, in blocks against
+	 * cache sized tiles of the train rows, with AVX-512 VPOPCNTDQ or AVX2 popcount kernels when the CPU supports them.
+	 */
+	class CV_EXPORTS HammingMatcher : public cv::DescriptorMatcher
+	{
+	public:
+		HammingMatcher();
+
+		virtual void add(cv::InputArrayOfArrays descriptors) CV_OVERRIDE;
+		virtual void clear() CV_OVERRIDE;
+		virtual bool isMaskSupported() const CV_OVERRIDE;
+		virtual void train() CV_OVERRIDE;
+		virtual cv::Ptr<cv::DescriptorMatcher> clone(bool emptyTrainData = false) const CV_OVERRIDE;
+
+	protected:
+		virtual void knnMatchImpl(
+			cv::InputArray queryDescriptors,
+			std::vector< std::vector<cv::DMatch> >& matches,
+			int k,
+			cv::InputArrayOfArrays masks = cv::noArray(),
+			bool compactResult = false) CV_OVERRIDE;
+		virtual void radiusMatchImpl(
+			cv::InputArray queryDescriptors,
+			std::vector< std::vector<cv::DMatch> >& matches,
+			float maxDistance,
+			cv::InputArrayOfArrays masks = cv::noArray(),
+			bool compactResult = false) CV_OVERRIDE;
+
+	private:
+		//The rows of all the train images, zero padded to a multiple of 32 bytes
+		cv::Mat packedTrain;
+		//The index of the first row of each train image in packedTrain, followed by the total number of rows
+		std::vector<int> startIdx;
+		int descriptorBytes;
+		bool trained;
+	};
+}
+#else
+namespace emgu
+{
+	class HammingMatcher {};
+}
+#endif
+CVAPI(emgu::HammingMatcher*) cveHammingMatcherCreate(cv::DescriptorMatcher** m);
+CVAPI(void) cveHammingMatcherRelease(emgu::HammingMatcher** matcher);
+
 //2D Tracker
+#ifdef HAVE_OPENCV_FEATURES2D
+namespace emgu
+{
+	/*
+	 * The workspace of the size and orientation vote. The matches are binned by the log of their scale ratio and by their rotation, the same bins as cv::calcHist,
+	 * and the matches whose bin has no more than half of the votes of the largest bin are rejected. The buffers keep their capacity between the votes.
+	 */
+	class CV_EXPORTS SizeOrientationVoter
+	{
+	public:
+		SizeOrientationVoter()
+			: maxVotes(0)
+		{
+		}
+
+		void clear()
+		{
+			scaleRatios.clear();
+			rotations.clear();
+		}
+
+		void add(const cv::KeyPoint& modelKeyPoint, const cv::KeyPoint& observedKeyPoint)
+		{
+			scaleRatios.push_back(observedKeyPoint.size / modelKeyPoint.size);
+			float r = observedKeyPoint.angle - modelKeyPoint.angle;
+			rotations.push_back(r < 0.0f ? r + 360.0f : r);
+		}
+
+		//Vote for the matches added since the last clear(), the number of matches kept is returned
+		int vote(double scaleIncrement, int rotationBins, bool parallel = false);
+
+		//Whether the i-th match added has been kept by the last vote
+		bool isKept(int i) const
+		{
+			return bins[i] >= 0 && histogram[bins[i]] * 2 > maxVotes;
+		}
+
+	private:
+		//The scale ratios are replaced by their log10 during the vote
+		std::vector<float> scaleRatios;
+		std::vector<float> rotations;
+		//The histogram bin of each match, -1 if it is out of the ranges
+		std::vector<int> bins;
+		//The histogram of each stripe of the parallel vote, they are summed into the first one
+		std::vector<int> histogram;
+		int maxVotes;
+	};
+
+	/*
+	 * Match the observed descriptors to the model of a descriptor matcher, filter the matches with the uniqueness (ratio) test and the size and orientation vote,
+	 * then find the homography from the model to the observed image with RANSAC. The scratch buffers are kept between the calls, one instance is meant to process
+	 * the frames of a video from one thread.
+	 */
+	class CV_EXPORTS FeatureMatchPipeline
+	{
+	public:
+		FeatureMatchPipeline(double uniquenessThreshold, double scaleIncrement, int rotationBins, double ransacThreshold);
+
+		//Returns false if there are not enough matches to find the homography. inliers are the matches kept by RANSAC, the query is the observed keypoint.
+		//stageMs receives the time in milliseconds of the knn match, the uniqueness test, the size and orientation vote and the homography.
+		bool match(
+			cv::DescriptorMatcher* matcher,
+			const std::vector<cv::KeyPoint>& modelKeyPoints,
+			const std::vector<cv::KeyPoint>& observedKeyPoints,
+			cv::InputArray observedDescriptors,
+			cv::Mat& homography,
+			std::vector<cv::DMatch>& inliers,
+			double* stageMs);
+
+	private:
+		double uniquenessThreshold;
+		double scaleIncrement;
+		int rotationBins;
+		double ransacThreshold;
+
+		std::vector< std::vector<cv::DMatch> > knnMatches;
+		std::vector<cv::DMatch> candidates;
+		SizeOrientationVoter voter;
+		std::vector<cv::Point2f> modelPoints;
+		std::vector<cv::Point2f> observedPoints;
+		cv::Mat ransacMask;
+	};
+}
+#else
+namespace emgu
+{
+	class SizeOrientationVoter {};
+	class FeatureMatchPipeline {};
+}
+#endif
+CVAPI(emgu::FeatureMatchPipeline*) cveFeatureMatchPipelineCreate(double uniquenessThreshold, double scaleIncrement, int rotationBins, double ransacThreshold);
+CVAPI(bool) cveFeatureMatchPipelineMatch(
+	emgu::FeatureMatchPipeline* pipeline,
+	cv::DescriptorMatcher* matcher,
+	std::vector<cv::KeyPoint>* modelKeyPoints,
+	std::vector<cv::KeyPoint>* observedKeyPoints,
+	cv::_InputArray* observedDescriptors,
+	cv::Mat* homography,
+	std::vector<cv::DMatch>* inliers,
+	double* stageMs);
+CVAPI(void) cveFeatureMatchPipelineRelease(emgu::FeatureMatchPipeline** pipeline);
+
 CVAPI(int) cveVoteForSizeAndOrientation(std::vector<cv::KeyPoint>* modelKeyPoints, std::vector<cv::KeyPoint>* observedKeyPoints, std::vector< std::vector< cv::DMatch > >* matches, cv::Mat* mask, double scaleIncrement, int rotationBins);
+CVAPI(emgu::SizeOrientationVoter*) cveSizeOrientationVoterCreate();
+CVAPI(int) cveSizeOrientationVoterVote(emgu::SizeOrientationVoter* voter, std::vector<cv::KeyPoint>* modelKeyPoints, std::vector<cv::KeyPoint>* observedKeyPoints, std::vector< std::vector< cv::DMatch > >* matches, cv::Mat* mask, double scaleIncrement, int rotationBins, bool parallel);
+CVAPI(void) cveSizeOrientationVoterRelease(emgu::SizeOrientationVoter** voter);
 
 //Feature2D
 CVAPI(void) cveFeature2DDetectAndCompute(cv::Feature2D* feature2D, cv::_InputArray* image, cv::_InputArray* mask, std::vector<cv::KeyPoint>* keypoints, cv::_OutputArray* descriptors, bool useProvidedKeyPoints);
@@ -207,6 +364,13 @@ CVAPI(void) cveFeature2DDetect(cv::Feature2D* feature2D, cv::_InputArray* image,
 CVAPI(void) cveFeature2DCompute(cv::Feature2D* feature2D, cv::_InputArray* image, std::vector<cv::KeyPoint>* keypoints, cv::_OutputArray* descriptors);
 CVAPI(int) cveFeature2DGetDescriptorSize(cv::Feature2D* feature2D);
 CVAPI(cv::Algorithm*) cveFeature2DGetAlgorithm(cv::Feature2D* feature2D);
+CVAPI(void) cveFeature2DDetectAndComputeBatch(
+	cv::Feature2D* feature2D,
+	std::vector<cv::Mat>* images,
+	std::vector<cv::Mat>* masks,
+	std::vector<cv::KeyPoint>* keypoints,
+	cv::Mat* descriptors,
+	std::vector<int>* offsets);
 
 //BowKMeansTrainer
 CVAPI(cv::BOWKMeansTrainer*) cveBOWKMeansTrainerCreate(int clusterCount, const CvTermCriteria* termcrit, int attempts, int flags);
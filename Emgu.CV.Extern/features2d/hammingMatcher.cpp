@@ -0,0 +1,504 @@
+//----------------------------------------------------------------------------
+//
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//
+//----------------------------------------------------------------------------
+
+#include "features2d_c.h"
+#include "sse.h"
+
+#ifdef HAVE_OPENCV_FEATURES2D
+#include "opencv2/core/hal/hal.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+//The Hamming distances from a query to count consecutive train rows of stride bytes, stride is a multiple of 32
+typedef void(*HammingRowsFunc)(const uchar* query, const uchar* train, int count, int stride, int* distances);
+
+static void hammingRows(const uchar* query, const uchar* train, int count, int stride, int* distances)
+{
+	for (int i = 0; i < count; i++, train += stride)
+		distances[i] = cv::hal::normHamming(query, train, stride);
+}
+
+#if EMGU_AVX2
+//Count the bits of each byte with a nibble lookup table, then sum them into 4 x 64 bits
+EMGU_TARGET_AVX2 static inline __m256i popcount256(__m256i v)
+{
+	const __m256i lut = _mm256_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i lowMask = _mm256_set1_epi8(0x0F);
+	__m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, lowMask));
+	__m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask));
+	return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+EMGU_TARGET_AVX2 static void hammingRowsAvx2(const uchar* query, const uchar* train, int count, int stride, int* distances)
+{
+	int i = 0;
+	for (; i <= count - 4; i += 4, train += 4 * stride)
+	{
+		__m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+		for (int j = 0; j < stride; j += 32)
+		{
+			__m256i q = _mm256_loadu_si256((const __m256i*) (query + j));
+			s0 = _mm256_add_epi64(s0, popcount256(_mm256_xor_si256(q, _mm256_loadu_si256((const __m256i*) (train + j)))));
+			s1 = _mm256_add_epi64(s1, popcount256(_mm256_xor_si256(q, _mm256_loadu_si256((const __m256i*) (train + stride + j)))));
+			s2 = _mm256_add_epi64(s2, popcount256(_mm256_xor_si256(q, _mm256_loadu_si256((const __m256i*) (train + 2 * stride + j)))));
+			s3 = _mm256_add_epi64(s3, popcount256(_mm256_xor_si256(q, _mm256_loadu_si256((const __m256i*) (train + 3 * stride + j)))));
+		}
+		//The sums fit in 32 bits: interleave rows 0 / 1 and rows 2 / 3 in the 64 bit lanes and reduce the 4 rows at once
+		__m256i a = _mm256_or_si256(s0, _mm256_slli_epi64(s1, 32));
+		__m256i b = _mm256_or_si256(s2, _mm256_slli_epi64(s3, 32));
+		__m256i s = _mm256_add_epi64(_mm256_unpacklo_epi64(a, b), _mm256_unpackhi_epi64(a, b));
+		__m128i r = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+		_mm_storeu_si128((__m128i*) (distances + i), r);
+	}
+	for (; i < count; i++, train += stride)
+	{
+		__m256i s = _mm256_setzero_si256();
+		for (int j = 0; j < stride; j += 32)
+			s = _mm256_add_epi64(s, popcount256(_mm256_xor_si256(
+				_mm256_loadu_si256((const __m256i*) (query + j)),
+				_mm256_loadu_si256((const __m256i*) (train + j)))));
+		__m128i r = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+		distances[i] = _mm_cvtsi128_si32(_mm_add_epi64(r, _mm_unpackhi_epi64(r, r)));
+	}
+}
+#endif
+
+#if EMGU_AVX512_VPOPCNTDQ
+EMGU_TARGET_AVX512_VPOPCNTDQ static void hammingRowsAvx512(const uchar* query, const uchar* train, int count, int stride, int* distances)
+{
+	if (stride == 32)
+	{
+		//Two 256 bits descriptors per register
+		__m512i q = _mm512_broadcast_i64x4(_mm256_loadu_si256((const __m256i*) query));
+		int i = 0;
+		for (; i <= count - 2; i += 2, train += 64)
+		{
+			__m512i c = _mm512_popcnt_epi64(_mm512_xor_si512(q, _mm512_loadu_si512(train)));
+			distances[i] = (int) _mm512_mask_reduce_add_epi64(0x0F, c);
+			distances[i + 1] = (int) _mm512_mask_reduce_add_epi64(0xF0, c);
+		}
+		if (i < count)
+		{
+			//Only the low half holds the last row, the high half is the query xor zero
+			__m512i c = _mm512_popcnt_epi64(_mm512_xor_si512(q, _mm512_maskz_loadu_epi64(0x0F, train)));
+			distances[i] = (int) _mm512_mask_reduce_add_epi64(0x0F, c);
+		}
+		return;
+	}
+
+	for (int i = 0; i < count; i++, train += stride)
+	{
+		__m512i s = _mm512_setzero_si512();
+		int j = 0;
+		for (; j <= stride - 64; j += 64)
+			s = _mm512_add_epi64(s, _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(query + j), _mm512_loadu_si512(train + j))));
+		if (j < stride)
+			s = _mm512_add_epi64(s, _mm512_popcnt_epi64(_mm512_xor_si512(
+				_mm512_maskz_loadu_epi64(0x0F, query + j),
+				_mm512_maskz_loadu_epi64(0x0F, train + j))));
+		distances[i] = (int) _mm512_reduce_add_epi64(s);
+	}
+}
+#endif
+
+static HammingRowsFunc getHammingRowsFunc()
+{
+#if EMGU_AVX512_VPOPCNTDQ
+	if (simdAVX512VPOPCNTDQ)
+		return hammingRowsAvx512;
+#endif
+#if EMGU_AVX2
+	if (simdAVX2)
+		return hammingRowsAvx2;
+#endif
+	return hammingRows;
+}
+
+//Copy the rows into a matrix of stride bytes per row, the padding is zero such that it does not change the distances
+static void packDescriptors(const cv::Mat& src, cv::Mat& dst, int rowOffset, int stride)
+{
+	for (int i = 0; i < src.rows; i++)
+	{
+		uchar* d = dst.ptr<uchar>(rowOffset + i);
+		memcpy(d, src.ptr<uchar>(i), src.cols);
+		memset(d + src.cols, 0, stride - src.cols);
+	}
+}
+
+//The masks of the train images. A single mask is the mask of the first image, it is not split by rows.
+static void getMasks(cv::InputArrayOfArrays masks, std::vector<cv::Mat>& result)
+{
+	result.clear();
+	if (masks.empty())
+		return;
+	if (masks.kind() == cv::_InputArray::STD_VECTOR_MAT || masks.kind() == cv::_InputArray::STD_VECTOR_UMAT)
+		masks.getMatVector(result);
+	else
+		result.push_back(masks.getMat());
+}
+
+//The queries of a block are matched against a tile of train rows before moving to the next tile, such that the tile stays in the cache
+static const int HAMMING_QUERY_BLOCK = 32;
+static const int HAMMING_TILE_BYTES = 16 * 1024;
+
+/*
+ * Find the k nearest train rows of the queries. The distances and global train indices of query q are sorted in
+ * distances / indices row q, the first counts[q] are valid.
+ */
+class HammingKnnInvoker : public cv::ParallelLoopBody
+{
+public:
+	HammingKnnInvoker(
+		const cv::Mat& query,
+		const cv::Mat& train,
+		const std::vector<int>& startIdx,
+		const std::vector<cv::Mat>& masks,
+		int k,
+		cv::Mat& distances,
+		cv::Mat& indices,
+		std::vector<int>& counts)
+		: _query(query), _train(train), _startIdx(startIdx), _masks(masks), _k(k),
+		_distances(distances), _indices(indices), _counts(counts), _func(getHammingRowsFunc())
+	{
+	}
+
+	virtual void operator()(const cv::Range& range) const
+	{
+		int stride = (int) _train.step[0];
+		int tileRows = std::max(64, HAMMING_TILE_BYTES / stride);
+		cv::AutoBuffer<int> rowDistances(tileRows);
+
+		for (int block = range.start; block < range.end; block++)
+		{
+			int q0 = block * HAMMING_QUERY_BLOCK;
+			int q1 = std::min(q0 + HAMMING_QUERY_BLOCK, _query.rows);
+			for (int q = q0; q < q1; q++)
+				_counts[q] = 0;
+
+			//The tiles do not span two images such that a tile has a single mask
+			for (int img = 0; img < (int) _startIdx.size() - 1; img++)
+			{
+				const cv::Mat* mask = img < (int) _masks.size() && !_masks[img].empty() ? &_masks[img] : 0;
+				for (int t0 = _startIdx[img]; t0 < _startIdx[img + 1]; t0 += tileRows)
+				{
+					int tileCount = std::min(tileRows, _startIdx[img + 1] - t0);
+					const uchar* tile = _train.ptr<uchar>(t0);
+					for (int q = q0; q < q1; q++)
+					{
+						const uchar* m = mask ? mask->ptr<uchar>(q) + (t0 - _startIdx[img]) : 0;
+						_func(_query.ptr<uchar>(q), tile, tileCount, stride, rowDistances.data());
+						push(q, rowDistances.data(), tileCount, t0, m);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	//Insert the tile distances into the sorted k nearest of the query, a distance equal to the worst is not inserted such that the lower index is kept
+	void push(int q, const int* tileDistances, int tileCount, int t0, const uchar* mask) const
+	{
+		int* dist = _distances.ptr<int>(q);
+		int* idx = _indices.ptr<int>(q);
+		int n = _counts[q];
+		int worst = n < _k ? INT_MAX : dist[_k - 1];
+		for (int i = 0; i < tileCount; i++)
+		{
+			int d = tileDistances[i];
+			if (d >= worst || (mask && !mask[i]))
+				continue;
+			int j = n < _k ? n++ : _k - 1;
+			for (; j > 0 && dist[j - 1] > d; j--)
+			{
+				dist[j] = dist[j - 1];
+				idx[j] = idx[j - 1];
+			}
+			dist[j] = d;
+			idx[j] = t0 + i;
+			if (n == _k)
+				worst = dist[_k - 1];
+		}
+		_counts[q] = n;
+	}
+
+	const cv::Mat& _query;
+	const cv::Mat& _train;
+	const std::vector<int>& _startIdx;
+	const std::vector<cv::Mat>& _masks;
+	int _k;
+	cv::Mat& _distances;
+	cv::Mat& _indices;
+	std::vector<int>& _counts;
+	HammingRowsFunc _func;
+};
+
+//Find the train rows closer than maxDistance to the queries
+class HammingRadiusInvoker : public cv::ParallelLoopBody
+{
+public:
+	HammingRadiusInvoker(
+		const cv::Mat& query,
+		const cv::Mat& train,
+		const std::vector<int>& startIdx,
+		const std::vector<cv::Mat>& masks,
+		float maxDistance,
+		std::vector< std::vector<cv::DMatch> >& matches)
+		: _query(query), _train(train), _startIdx(startIdx), _masks(masks), _maxDistance(maxDistance),
+		_matches(matches), _func(getHammingRowsFunc())
+	{
+	}
+
+	virtual void operator()(const cv::Range& range) const
+	{
+		int stride = (int) _train.step[0];
+		int tileRows = std::max(64, HAMMING_TILE_BYTES / stride);
+		cv::AutoBuffer<int> rowDistances(tileRows);
+
+		for (int block = range.start; block < range.end; block++)
+		{
+			int q0 = block * HAMMING_QUERY_BLOCK;
+			int q1 = std::min(q0 + HAMMING_QUERY_BLOCK, _query.rows);
+			for (int img = 0; img < (int) _startIdx.size() - 1; img++)
+			{
+				const cv::Mat* mask = img < (int) _masks.size() && !_masks[img].empty() ? &_masks[img] : 0;
+				for (int t0 = _startIdx[img]; t0 < _startIdx[img + 1]; t0 += tileRows)
+				{
+					int tileCount = std::min(tileRows, _startIdx[img + 1] - t0);
+					int localIdx = t0 - _startIdx[img];
+					const uchar* tile = _train.ptr<uchar>(t0);
+					for (int q = q0; q < q1; q++)
+					{
+						const uchar* m = mask ? mask->ptr<uchar>(q) + localIdx : 0;
+						_func(_query.ptr<uchar>(q), tile, tileCount, stride, rowDistances.data());
+						for (int i = 0; i < tileCount; i++)
+						{
+							if ((float) rowDistances[i] < _maxDistance && (!m || m[i]))
+								_matches[q].push_back(cv::DMatch(q, localIdx + i, img, (float) rowDistances[i]));
+						}
+					}
+				}
+			}
+			for (int q = q0; q < q1; q++)
+				std::stable_sort(_matches[q].begin(), _matches[q].end());
+		}
+	}
+
+private:
+	const cv::Mat& _query;
+	const cv::Mat& _train;
+	const std::vector<int>& _startIdx;
+	const std::vector<cv::Mat>& _masks;
+	float _maxDistance;
+	std::vector< std::vector<cv::DMatch> >& _matches;
+	HammingRowsFunc _func;
+};
+
+emgu::HammingMatcher::HammingMatcher()
+	: descriptorBytes(0), trained(false)
+{
+}
+
+void emgu::HammingMatcher::add(cv::InputArrayOfArrays descriptors)
+{
+	if (descriptors.kind() == cv::_InputArray::STD_VECTOR_UMAT)
+	{
+		std::vector<cv::UMat> v;
+		descriptors.getUMatVector(v);
+		for (size_t i = 0; i < v.size(); i++)
+			trainDescCollection.push_back(v[i].getMat(cv::ACCESS_READ).clone());
+	}
+	else if (descriptors.kind() == cv::_InputArray::STD_VECTOR_MAT)
+	{
+		std::vector<cv::Mat> v;
+		descriptors.getMatVector(v);
+		trainDescCollection.insert(trainDescCollection.end(), v.begin(), v.end());
+	}
+	else if (!descriptors.empty())
+	{
+		trainDescCollection.push_back(descriptors.getMat());
+	}
+	trained = false;
+}
+
+void emgu::HammingMatcher::clear()
+{
+	cv::DescriptorMatcher::clear();
+	packedTrain.release();
+	startIdx.clear();
+	descriptorBytes = 0;
+	trained = false;
+}
+
+bool emgu::HammingMatcher::isMaskSupported() const
+{
+	return true;
+}
+
+void emgu::HammingMatcher::train()
+{
+	if (trained)
+		return;
+
+	startIdx.assign(1, 0);
+	descriptorBytes = 0;
+	for (size_t i = 0; i < trainDescCollection.size(); i++)
+	{
+		const cv::Mat& d = trainDescCollection[i];
+		if (!d.empty())
+		{
+			CV_Assert(d.type() == CV_8UC1);
+			CV_Assert(descriptorBytes == 0 || descriptorBytes == d.cols);
+			descriptorBytes = d.cols;
+		}
+		startIdx.push_back(startIdx.back() + d.rows);
+	}
+
+	int stride = (descriptorBytes + 31) & ~31;
+	if (startIdx.back() == 0)
+		packedTrain.release();
+	else
+	{
+		packedTrain.create(startIdx.back(), stride, CV_8UC1);
+		for (size_t i = 0; i < trainDescCollection.size(); i++)
+			packDescriptors(trainDescCollection[i], packedTrain, startIdx[i], stride);
+	}
+	trained = true;
+}
+
+cv::Ptr<cv::DescriptorMatcher> emgu::HammingMatcher::clone(bool emptyTrainData) const
+{
+	cv::Ptr<HammingMatcher> matcher = cv::makePtr<HammingMatcher>();
+	if (!emptyTrainData)
+	{
+		for (size_t i = 0; i < trainDescCollection.size(); i++)
+			matcher->trainDescCollection.push_back(trainDescCollection[i].clone());
+	}
+	return matcher;
+}
+
+//Pad the queries to the stride of the train rows
+static void packQuery(cv::InputArray queryDescriptors, int descriptorBytes, int stride, cv::Mat& query)
+{
+	cv::Mat q = queryDescriptors.getMat();
+	CV_Assert(q.type() == CV_8UC1 && q.cols == descriptorBytes);
+	if (q.cols == stride && q.isContinuous())
+		query = q;
+	else
+	{
+		query.create(q.rows, stride, CV_8UC1);
+		packDescriptors(q, query, 0, stride);
+	}
+}
+
+static bool isEmptyMatches(const std::vector<cv::DMatch>& matches)
+{
+	return matches.empty();
+}
+
+//Remove the queries that are masked out from all the train images
+static void compactMatches(std::vector< std::vector<cv::DMatch> >& matches)
+{
+	matches.erase(std::remove_if(matches.begin(), matches.end(), isEmptyMatches), matches.end());
+}
+
+void emgu::HammingMatcher::knnMatchImpl(
+	cv::InputArray queryDescriptors,
+	std::vector< std::vector<cv::DMatch> >& matches,
+	int k,
+	cv::InputArrayOfArrays masks,
+	bool compactResult)
+{
+	train();
+	int queryCount = queryDescriptors.rows();
+	matches.clear();
+	matches.resize(queryCount);
+	if (packedTrain.empty() || queryCount == 0)
+	{
+		if (compactResult)
+			matches.clear();
+		return;
+	}
+
+	cv::Mat query;
+	packQuery(queryDescriptors, descriptorBytes, packedTrain.cols, query);
+	std::vector<cv::Mat> maskVector;
+	getMasks(masks, maskVector);
+
+	k = std::min(k, packedTrain.rows);
+	cv::Mat distances(queryCount, k, CV_32SC1), indices(queryCount, k, CV_32SC1);
+	std::vector<int> counts(queryCount);
+	int blocks = (queryCount + HAMMING_QUERY_BLOCK - 1) / HAMMING_QUERY_BLOCK;
+	cv::parallel_for_(cv::Range(0, blocks), HammingKnnInvoker(query, packedTrain, startIdx, maskVector, k, distances, indices, counts));
+
+	for (int q = 0; q < queryCount; q++)
+	{
+		const int* dist = distances.ptr<int>(q);
+		const int* idx = indices.ptr<int>(q);
+		matches[q].reserve(counts[q]);
+		for (int j = 0; j < counts[q]; j++)
+		{
+			int img = (int) (std::upper_bound(startIdx.begin(), startIdx.end(), idx[j]) - startIdx.begin()) - 1;
+			matches[q].push_back(cv::DMatch(q, idx[j] - startIdx[img], img, (float) dist[j]));
+		}
+	}
+	if (compactResult)
+		compactMatches(matches);
+}
+
+void emgu::HammingMatcher::radiusMatchImpl(
+	cv::InputArray queryDescriptors,
+	std::vector< std::vector<cv::DMatch> >& matches,
+	float maxDistance,
+	cv::InputArrayOfArrays masks,
+	bool compactResult)
+{
+	train();
+	int queryCount = queryDescriptors.rows();
+	matches.clear();
+	matches.resize(queryCount);
+	if (packedTrain.empty() || queryCount == 0)
+	{
+		if (compactResult)
+			matches.clear();
+		return;
+	}
+
+	cv::Mat query;
+	packQuery(queryDescriptors, descriptorBytes, packedTrain.cols, query);
+	std::vector<cv::Mat> maskVector;
+	getMasks(masks, maskVector);
+
+	int blocks = (queryCount + HAMMING_QUERY_BLOCK - 1) / HAMMING_QUERY_BLOCK;
+	cv::parallel_for_(cv::Range(0, blocks), HammingRadiusInvoker(query, packedTrain, startIdx, maskVector, maxDistance, matches));
+	if (compactResult)
+		compactMatches(matches);
+}
+#endif
+
+emgu::HammingMatcher* cveHammingMatcherCreate(cv::DescriptorMatcher** m)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	emgu::HammingMatcher* matcher = new emgu::HammingMatcher();
+	*m = dynamic_cast<cv::DescriptorMatcher*>(matcher);
+	return matcher;
+#else
+	throw_no_features2d();
+#endif
+}
+
+void cveHammingMatcherRelease(emgu::HammingMatcher** matcher)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	delete *matcher;
+	*matcher = 0;
+#else
+	throw_no_features2d();
+#endif
+}
@@ -6,6 +6,10 @@
 
 #include "features2d_c.h"
 
+#ifdef HAVE_OPENCV_FEATURES2D
+#include "opencv2/core/hal/hal.hpp"
+#endif
+
 //ORB
 cv::ORB* cveOrbCreate(int numberOfFeatures, float scaleFactor, int nLevels, int edgeThreshold, int firstLevel, int WTA_K, int scoreType, int patchSize, int fastThreshold, cv::Feature2D** feature2D, cv::Ptr<cv::ORB>** sharedPtr)
 {
@@ -497,75 +501,187 @@ void cveFlannBasedMatcherRelease(cv::FlannBasedMatcher** matcher)
 }
 
 //2D tracker
-int cveVoteForSizeAndOrientation(std::vector<cv::KeyPoint>* modelKeyPoints, std::vector<cv::KeyPoint>* observedKeyPoints, std::vector< std::vector< cv::DMatch > >* matches, cv::Mat* mask, double scaleIncrement, int rotationBins)
-{
 #ifdef HAVE_OPENCV_FEATURES2D
-	CV_Assert(!modelKeyPoints->empty());
-	CV_Assert(!observedKeyPoints->empty());
-	CV_Assert(mask->depth() == CV_8U && mask->channels() == 1);
-	//cv::Mat_<int> indicesMat = (cv::Mat_<int>) cv::cvarrToMat(indices);
-	cv::Mat_<uchar> maskMat = (cv::Mat_<uchar>) *mask;
-	std::vector<float> logScale;
-	std::vector<float> rotations;
-	float s, maxS, minS, r;
-	maxS = -1.0e-10f; minS = 1.0e10f;
-
-	for (int i = 0; i < maskMat.rows; i++)
+//Bin the matches of contiguous stripes, each stripe has its own histogram
+class SizeOrientationBinInvoker : public cv::ParallelLoopBody
+{
+public:
+	SizeOrientationBinInvoker(
+		const float* logScales,
+		const float* rotations,
+		int count,
+		int stripes,
+		double scaleA,
+		double scaleB,
+		int scaleBins,
+		double rotationA,
+		int rotationBins,
+		int* bins,
+		int* histograms)
+		: _logScales(logScales), _rotations(rotations), _count(count), _stripes(stripes),
+		_scaleA(scaleA), _scaleB(scaleB), _scaleBins(scaleBins), _rotationA(rotationA), _rotationBins(rotationBins),
+		_bins(bins), _histograms(histograms)
+	{
+	}
+
+	virtual void operator()(const cv::Range& range) const CV_OVERRIDE
 	{
-		if (maskMat(i, 0))
+		for (int stripe = range.start; stripe < range.end; stripe++)
 		{
-			cv::KeyPoint observedKeyPoint = observedKeyPoints->at(i);
-			cv::KeyPoint modelKeyPoint = modelKeyPoints->at(matches->at(i).at(0).trainIdx);
-			s = log10(observedKeyPoint.size / modelKeyPoint.size);
-			logScale.push_back(s);
-			maxS = s > maxS ? s : maxS;
-			minS = s < minS ? s : minS;
-
-			r = observedKeyPoint.angle - modelKeyPoint.angle;
-			r = r < 0.0f ? r + 360.0f : r;
-			rotations.push_back(r);
+			int start = (int) ((int64) _count * stripe / _stripes);
+			int end = (int) ((int64) _count * (stripe + 1) / _stripes);
+			int* histogram = _histograms + stripe * _scaleBins * _rotationBins;
+			for (int i = start; i < end; i++)
+			{
+				//The bin of a value is computed the same way as cv::calcHist does for uniform ranges, the values out of the ranges are not counted
+				int s = cvFloor(_logScales[i] * _scaleA + _scaleB);
+				int r = cvFloor(_rotations[i] * _rotationA);
+				if ((unsigned) s < (unsigned) _scaleBins && (unsigned) r < (unsigned) _rotationBins)
+				{
+					int bin = s * _rotationBins + r;
+					_bins[i] = bin;
+					histogram[bin]++;
+				}
+				else
+				{
+					_bins[i] = -1;
+				}
+			}
 		}
 	}
 
-	int scaleBinSize = cvCeil((maxS - minS) / log10(scaleIncrement));
-	if (scaleBinSize < 2) scaleBinSize = 2;
-	float scaleRanges[] = { minS, (float)(minS + scaleBinSize * log10(scaleIncrement)) };
+private:
+	const float* _logScales;
+	const float* _rotations;
+	int _count;
+	int _stripes;
+	double _scaleA;
+	double _scaleB;
+	int _scaleBins;
+	double _rotationA;
+	int _rotationBins;
+	int* _bins;
+	int* _histograms;
+};
 
-	cv::Mat_<float> scalesMat(logScale);
-	cv::Mat_<float> rotationsMat(rotations);
-	std::vector<float> flags(logScale.size());
-	cv::Mat flagsMat(flags);
+int emgu::SizeOrientationVoter::vote(double scaleIncrement, int rotationBins, bool parallel)
+{
+	CV_Assert(rotationBins > 0);
+	int count = (int) scaleRatios.size();
+	maxVotes = 0;
+	bins.resize(count);
+	if (count == 0)
+		return 0;
 
-	{  //Perform voting for both scale and orientation
-		int histSize[] = { scaleBinSize, rotationBins };
-		float rotationRanges[] = { 0, 360 };
-		int channels[] = { 0, 1 };
-		const float* ranges[] = { scaleRanges, rotationRanges };
-		double minVal, maxVal;
+	//log10(x) = log(x) / log(10), the log of all the ratios is computed at once with the vectorized kernel of cv::log
+	float* logScales = &scaleRatios[0];
+	cv::hal::log32f(logScales, logScales, count);
+	const float invLog10 = (float) (1.0 / log(10.0));
+	float maxS = -1.0e-10f, minS = 1.0e10f;
+	for (int i = 0; i < count; i++)
+	{
+		float s = logScales[i] * invLog10;
+		logScales[i] = s;
+		maxS = s > maxS ? s : maxS;
+		minS = s < minS ? s : minS;
+	}
+	double logIncrement = log10(scaleIncrement);
+	int scaleBins = cvCeil((maxS - minS) / logIncrement);
+	if (scaleBins < 2) scaleBins = 2;
+	float scaleRange[] = { minS, (float) (minS + scaleBins * logIncrement) };
+	double scaleA = scaleBins / ((double) scaleRange[1] - scaleRange[0]);
+	double scaleB = -scaleA * scaleRange[0];
+	double rotationA = rotationBins / 360.0;
 
-		const cv::Mat_<float> arrs[] = { scalesMat, rotationsMat };
+	//The stripes are large enough for the binning to outweigh the scheduling and the sum of the histograms
+	int histogramSize = scaleBins * rotationBins;
+	int stripes = parallel ? std::max(1, std::min(cv::getNumThreads(), count / 8192)) : 1;
+	histogram.assign(stripes * histogramSize, 0);
+	SizeOrientationBinInvoker invoker(logScales, &rotations[0], count, stripes, scaleA, scaleB, scaleBins, rotationA, rotationBins, &bins[0], &histogram[0]);
+	if (stripes > 1)
+		cv::parallel_for_(cv::Range(0, stripes), invoker);
+	else
+		invoker(cv::Range(0, 1));
+
+	for (int stripe = 1; stripe < stripes; stripe++)
+	{
+		const int* h = &histogram[stripe * histogramSize];
+		for (int b = 0; b < histogramSize; b++)
+			histogram[b] += h[b];
+	}
+	for (int b = 0; b < histogramSize; b++)
+		maxVotes = histogram[b] > maxVotes ? histogram[b] : maxVotes;
+
+	int kept = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (isKept(i))
+			kept++;
+	}
+	return kept;
+}
 
-		cv::MatND hist; //CV_32S
-		cv::calcHist(arrs, 2, channels, cv::Mat(), hist, 2, histSize, ranges, true);
-		cv::minMaxLoc(hist, &minVal, &maxVal);
+static int voteForSizeAndOrientation(emgu::SizeOrientationVoter& voter, std::vector<cv::KeyPoint>* modelKeyPoints, std::vector<cv::KeyPoint>* observedKeyPoints, std::vector< std::vector< cv::DMatch > >* matches, cv::Mat* mask, double scaleIncrement, int rotationBins, bool parallel)
+{
+	CV_Assert(!modelKeyPoints->empty());
+	CV_Assert(!observedKeyPoints->empty());
+	CV_Assert(mask->depth() == CV_8U && mask->channels() == 1);
 
-		cv::threshold(hist, hist, maxVal * 0.5, 0, cv::THRESH_TOZERO);
-		cv::calcBackProject(arrs, 2, channels, hist, flagsMat, ranges);
+	voter.clear();
+	for (int i = 0; i < mask->rows; i++)
+	{
+		if (*mask->ptr<uchar>(i))
+			voter.add(modelKeyPoints->at(matches->at(i).at(0).trainIdx), observedKeyPoints->at(i));
 	}
+	int nonZeroCount = voter.vote(scaleIncrement, rotationBins, parallel);
 
 	int idx = 0;
-	int nonZeroCount = 0;
-	for (int i = 0; i < maskMat.rows; i++)
+	for (int i = 0; i < mask->rows; i++)
 	{
-		if (maskMat(i, 0))
+		uchar* m = mask->ptr<uchar>(i);
+		if (*m)
 		{
-			if (flags[idx++] != 0.0f)
-				nonZeroCount++;
-			else
-				maskMat(i, 0) = 0;
+			if (!voter.isKept(idx++))
+				*m = 0;
 		}
 	}
 	return nonZeroCount;
+}
+#endif
+
+int cveVoteForSizeAndOrientation(std::vector<cv::KeyPoint>* modelKeyPoints, std::vector<cv::KeyPoint>* observedKeyPoints, std::vector< std::vector< cv::DMatch > >* matches, cv::Mat* mask, double scaleIncrement, int rotationBins)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	emgu::SizeOrientationVoter voter;
+	return voteForSizeAndOrientation(voter, modelKeyPoints, observedKeyPoints, matches, mask, scaleIncrement, rotationBins, false);
+#else
+	throw_no_features2d();
+#endif
+}
+
+emgu::SizeOrientationVoter* cveSizeOrientationVoterCreate()
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	return new emgu::SizeOrientationVoter();
+#else
+	throw_no_features2d();
+#endif
+}
+
+int cveSizeOrientationVoterVote(emgu::SizeOrientationVoter* voter, std::vector<cv::KeyPoint>* modelKeyPoints, std::vector<cv::KeyPoint>* observedKeyPoints, std::vector< std::vector< cv::DMatch > >* matches, cv::Mat* mask, double scaleIncrement, int rotationBins, bool parallel)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	return voteForSizeAndOrientation(*voter, modelKeyPoints, observedKeyPoints, matches, mask, scaleIncrement, rotationBins, parallel);
+#else
+	throw_no_features2d();
+#endif
+}
+
+void cveSizeOrientationVoterRelease(emgu::SizeOrientationVoter** voter)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	delete *voter;
+	*voter = 0;
 #else
 	throw_no_features2d();
 #endif
@@ -613,6 +729,121 @@ cv::Algorithm* cveFeature2DGetAlgorithm(cv::Feature2D* feature2D)
 #endif
 }
 
+#ifdef HAVE_OPENCV_FEATURES2D
+//The detectors that only read their parameters in detectAndCompute, such that one instance can process many images concurrently
+static bool isFeature2DReentrant(cv::Feature2D* feature2D)
+{
+	return dynamic_cast<cv::ORB*>(feature2D)
+		|| dynamic_cast<cv::BRISK*>(feature2D)
+		|| dynamic_cast<cv::KAZE*>(feature2D)
+		|| dynamic_cast<cv::AKAZE*>(feature2D)
+		|| dynamic_cast<cv::SIFT*>(feature2D)
+		|| dynamic_cast<cv::FastFeatureDetector*>(feature2D)
+		|| dynamic_cast<cv::AgastFeatureDetector*>(feature2D)
+		|| dynamic_cast<cv::GFTTDetector*>(feature2D);
+}
+
+class DetectAndComputeBatchInvoker : public cv::ParallelLoopBody
+{
+public:
+	DetectAndComputeBatchInvoker(
+		cv::Feature2D* feature2D,
+		const std::vector<cv::Mat>& images,
+		const std::vector<cv::Mat>& masks,
+		std::vector< std::vector<cv::KeyPoint> >& keypoints,
+		std::vector<cv::Mat>& descriptors)
+		: _feature2D(feature2D), _images(images), _masks(masks), _keypoints(keypoints), _descriptors(descriptors)
+	{
+	}
+
+	virtual void operator()(const cv::Range& range) const
+	{
+		for (int i = range.start; i < range.end; i++)
+		{
+			_feature2D->detectAndCompute(
+				_images[i],
+				_masks.empty() ? (cv::InputArray) cv::noArray() : (cv::InputArray) _masks[i],
+				_keypoints[i],
+				_descriptors[i]);
+		}
+	}
+
+private:
+	cv::Feature2D* _feature2D;
+	const std::vector<cv::Mat>& _images;
+	const std::vector<cv::Mat>& _masks;
+	std::vector< std::vector<cv::KeyPoint> >& _keypoints;
+	std::vector<cv::Mat>& _descriptors;
+};
+#endif
+
+void cveFeature2DDetectAndComputeBatch(
+	cv::Feature2D* feature2D,
+	std::vector<cv::Mat>* images,
+	std::vector<cv::Mat>* masks,
+	std::vector<cv::KeyPoint>* keypoints,
+	cv::Mat* descriptors,
+	std::vector<int>* offsets)
+{
+#ifdef HAVE_OPENCV_FEATURES2D
+	int count = (int) images->size();
+	std::vector<cv::Mat> noMasks;
+	const std::vector<cv::Mat>& m = masks ? *masks : noMasks;
+	CV_Assert(m.empty() || (int) m.size() == count);
+
+	std::vector< std::vector<cv::KeyPoint> > imageKeypoints(count);
+	std::vector<cv::Mat> imageDescriptors(count);
+	DetectAndComputeBatchInvoker invoker(feature2D, *images, m, imageKeypoints, imageDescriptors);
+	//One image per stripe, the images do not take the same time to process.
+	//A detector that keeps state between calls, e.g. MSER or SimpleBlobDetector, processes the images one after the other.
+	if (isFeature2DReentrant(feature2D))
+		cv::parallel_for_(cv::Range(0, count), invoker, count);
+	else
+		invoker(cv::Range(0, count));
+
+	//Flatten the results, the keypoints and descriptor rows of image i start at offsets[i]
+	offsets->resize(count + 1);
+	int total = 0;
+	int descriptorCols = 0;
+	int descriptorType = -1;
+	for (int i = 0; i < count; i++)
+	{
+		(*offsets)[i] = total;
+		total += (int) imageKeypoints[i].size();
+		const cv::Mat& d = imageDescriptors[i];
+		if (d.empty())
+			continue;
+		CV_Assert(d.rows == (int) imageKeypoints[i].size());
+		if (descriptorType < 0)
+		{
+			descriptorCols = d.cols;
+			descriptorType = d.type();
+		}
+		CV_Assert(d.cols == descriptorCols && d.type() == descriptorType);
+	}
+	(*offsets)[count] = total;
+
+	keypoints->clear();
+	keypoints->reserve(total);
+	for (int i = 0; i < count; i++)
+		keypoints->insert(keypoints->end(), imageKeypoints[i].begin(), imageKeypoints[i].end());
+
+	if (descriptorType < 0)
+	{
+		descriptors->release();
+		return;
+	}
+	descriptors->create(total, descriptorCols, descriptorType);
+	for (int i = 0; i < count; i++)
+	{
+		if (!imageDescriptors[i].empty())
+			imageDescriptors[i].copyTo(descriptors->rowRange((*offsets)[i], (*offsets)[i + 1]));
+	}
+#else
+	throw_no_features2d();
+#endif
+}
+
 
 /*
 //OpponentColorDescriptorExtractor
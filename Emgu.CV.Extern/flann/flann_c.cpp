@@ -5,6 +5,16 @@
 //----------------------------------------------------------------------------
 
 #include "flann_c.h"
+#include "mappedFile.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
 
 cv::flann::LinearIndexParams* cveLinearIndexParamsCreate(cv::flann::IndexParams** ip)
 {
@@ -204,3 +214,669 @@ void cveFlannIndexRelease(cv::flann::Index** index)
 	throw_no_flann();
 #endif
 }
+
+#ifdef HAVE_OPENCV_FLANN
+namespace
+{
+	//A segment of a FlannDescriptorIndex. It is shared by the snapshots of the index, a copy is made to flag removed descriptors.
+	struct DescriptorSegment
+	{
+		//The descriptors, owned or pointing into the mapped file
+		cv::Mat descriptors;
+		//The ids of the descriptors, in increasing order
+		std::shared_ptr<const std::vector<int> > ids;
+		std::vector<uchar> removed;
+		int removedCount;
+		cv::Ptr<cv::flann::Index> index;
+		std::shared_ptr<emgu::MappedFile> file;
+	};
+
+	//The segments are in increasing order of ids
+	struct DescriptorIndexState
+	{
+		std::vector< std::shared_ptr<const DescriptorSegment> > segments;
+		int type;
+		int cols;
+		int count;
+	};
+
+	const char descriptorIndexMagic[8] = { 'E', 'M', 'G', 'U', 'F', 'D', 'I', 'X' };
+	const int descriptorIndexVersion = 1;
+	//The descriptors of each segment start at a multiple of this offset in the file
+	const size_t descriptorIndexAlignment = 64;
+	//The most neighbors requested from a segment on top of knn, to skip its removed descriptors
+	const int descriptorIndexExtraNeighbors = 32;
+
+	cv::String segmentFileName(const cv::String& fileName, size_t segment)
+	{
+		std::ostringstream ss;
+		ss << fileName << "." << segment << ".flann";
+		return ss.str();
+	}
+
+	void replaceFile(const cv::String& from, const cv::String& to)
+	{
+#ifdef _WIN32
+		//A file that is still mapped can not be removed, but it can be renamed out of the way
+		if (std::remove(to.c_str()) != 0)
+		{
+			cv::String old = to + ".old";
+			std::remove(old.c_str());
+			std::rename(to.c_str(), old.c_str());
+		}
+#endif
+		if (std::rename(from.c_str(), to.c_str()) != 0)
+			CV_Error(cv::Error::StsError, cv::String("Failed to replace file: ") + to);
+	}
+
+	class DescriptorIndexWriter
+	{
+	public:
+		DescriptorIndexWriter(const cv::String& fileName)
+			: file(fopen(fileName.c_str(), "wb")), offset(0), fileName(fileName)
+		{
+			if (!file)
+				CV_Error(cv::Error::StsError, cv::String("Failed to create file: ") + fileName);
+		}
+		~DescriptorIndexWriter()
+		{
+			if (file)
+				fclose(file);
+		}
+		void write(const void* data, size_t size)
+		{
+			if (size > 0 && fwrite(data, 1, size, file) != size)
+				CV_Error(cv::Error::StsError, cv::String("Failed to write file: ") + fileName);
+			offset += size;
+		}
+		template<typename T> void write(const T& value)
+		{
+			write(&value, sizeof(T));
+		}
+		void writeString(const cv::String& s)
+		{
+			write((int) s.size());
+			write(s.data(), s.size());
+		}
+		void align()
+		{
+			static const char zeros[descriptorIndexAlignment] = { 0 };
+			write(zeros, (descriptorIndexAlignment - offset % descriptorIndexAlignment) % descriptorIndexAlignment);
+		}
+		void close()
+		{
+			bool ok = fclose(file) == 0;
+			file = 0;
+			if (!ok)
+				CV_Error(cv::Error::StsError, cv::String("Failed to write file: ") + fileName);
+		}
+	private:
+		FILE* file;
+		size_t offset;
+		cv::String fileName;
+	};
+
+	class DescriptorIndexReader
+	{
+	public:
+		DescriptorIndexReader(const emgu::MappedFile& file)
+			: begin(file.data), current(file.data), end(file.data + file.size)
+		{
+		}
+		const char* read(size_t size)
+		{
+			if ((size_t) (end - current) < size)
+				CV_Error(cv::Error::StsParseError, "The descriptor index file is truncated");
+			const char* p = current;
+			current += size;
+			return p;
+		}
+		template<typename T> T read()
+		{
+			T value;
+			memcpy(&value, read(sizeof(T)), sizeof(T));
+			return value;
+		}
+		cv::String readString()
+		{
+			int size = read<int>();
+			CV_Assert(size >= 0);
+			return cv::String(read(size), size);
+		}
+		void align()
+		{
+			size_t offset = current - begin;
+			read((descriptorIndexAlignment - offset % descriptorIndexAlignment) % descriptorIndexAlignment);
+		}
+	private:
+		const char* begin;
+		const char* current;
+		const char* end;
+	};
+}
+
+struct emgu::FlannDescriptorIndex::Impl
+{
+	int distType;
+	//The id of the next descriptor added
+	int nextId;
+	//The file the loaded segments are mapped from
+	cv::String fileName;
+
+	//The index parameters, to build the segments
+	std::vector<cv::String> paramNames;
+	std::vector<cv::flann::FlannIndexType> paramTypes;
+	std::vector<cv::String> paramStrValues;
+	std::vector<double> paramNumValues;
+
+	//Serializes add, remove and save
+	std::mutex writeMutex;
+	mutable std::mutex stateMutex;
+	std::shared_ptr<const DescriptorIndexState> state;
+
+	std::shared_ptr<const DescriptorIndexState> snapshot() const
+	{
+		std::lock_guard<std::mutex> lock(stateMutex);
+		return state;
+	}
+
+	void publish(const std::shared_ptr<const DescriptorIndexState>& s)
+	{
+		std::lock_guard<std::mutex> lock(stateMutex);
+		state = s;
+	}
+
+	void getParams(cv::flann::IndexParams& params) const
+	{
+		for (size_t i = 0; i < paramNames.size(); i++)
+		{
+			switch (paramTypes[i])
+			{
+			case cv::flann::FLANN_INDEX_TYPE_STRING:
+				params.setString(paramNames[i], paramStrValues[i]);
+				break;
+			case cv::flann::FLANN_INDEX_TYPE_BOOL:
+				params.setBool(paramNames[i], paramNumValues[i] != 0);
+				break;
+			case cv::flann::FLANN_INDEX_TYPE_ALGORITHM:
+				params.setAlgorithm((int) paramNumValues[i]);
+				break;
+			case cv::flann::FLANN_INDEX_TYPE_32F:
+				params.setFloat(paramNames[i], (float) paramNumValues[i]);
+				break;
+			case cv::flann::FLANN_INDEX_TYPE_64F:
+				params.setDouble(paramNames[i], paramNumValues[i]);
+				break;
+			default:
+				params.setInt(paramNames[i], (int) paramNumValues[i]);
+				break;
+			}
+		}
+	}
+
+	std::shared_ptr<DescriptorSegment> buildSegment(const cv::Mat& descriptors, const std::shared_ptr<const std::vector<int> >& ids) const
+	{
+		std::shared_ptr<DescriptorSegment> segment = std::make_shared<DescriptorSegment>();
+		segment->descriptors = descriptors;
+		segment->ids = ids;
+		segment->removed.assign(descriptors.rows, 0);
+		segment->removedCount = 0;
+		cv::flann::IndexParams params;
+		getParams(params);
+		segment->index = cv::makePtr<cv::flann::Index>(descriptors, params, (cvflann::flann_distance_t) distType);
+		return segment;
+	}
+
+	//Build a segment from the descriptors of the segments that have not been removed
+	std::shared_ptr<DescriptorSegment> buildSegment(const std::vector<const DescriptorSegment*>& segments) const
+	{
+		int rows = 0;
+		for (size_t i = 0; i < segments.size(); i++)
+			rows += segments[i]->descriptors.rows - segments[i]->removedCount;
+		const cv::Mat& first = segments[0]->descriptors;
+		cv::Mat descriptors(rows, first.cols, first.type());
+		std::shared_ptr<std::vector<int> > ids = std::make_shared<std::vector<int> >();
+		ids->reserve(rows);
+		for (size_t i = 0; i < segments.size(); i++)
+		{
+			const DescriptorSegment* s = segments[i];
+			for (int j = 0; j < s->descriptors.rows; j++)
+			{
+				if (s->removed[j])
+					continue;
+				s->descriptors.row(j).copyTo(descriptors.row((int) ids->size()));
+				ids->push_back((*s->ids)[j]);
+			}
+		}
+		return buildSegment(descriptors, ids);
+	}
+};
+
+emgu::FlannDescriptorIndex::FlannDescriptorIndex(const cv::flann::IndexParams& params, cvflann::flann_distance_t distType)
+	: impl(new Impl())
+{
+	impl->distType = (int) distType;
+	impl->nextId = 0;
+	params.getAll(impl->paramNames, impl->paramTypes, impl->paramStrValues, impl->paramNumValues);
+	std::shared_ptr<DescriptorIndexState> s = std::make_shared<DescriptorIndexState>();
+	s->type = distType == cvflann::FLANN_DIST_HAMMING ? CV_8U : CV_32F;
+	s->cols = 0;
+	s->count = 0;
+	impl->state = s;
+}
+
+emgu::FlannDescriptorIndex::FlannDescriptorIndex(const cv::String& fileName)
+	: impl(new Impl())
+{
+	std::unique_ptr<Impl> guard(impl);
+	std::shared_ptr<emgu::MappedFile> file = std::make_shared<emgu::MappedFile>();
+	file->open(fileName);
+	DescriptorIndexReader reader(*file);
+	if (memcmp(reader.read(sizeof(descriptorIndexMagic)), descriptorIndexMagic, sizeof(descriptorIndexMagic)) != 0)
+		CV_Error(cv::Error::StsParseError, cv::String("Not a descriptor index file: ") + fileName);
+	if (reader.read<int>() != descriptorIndexVersion)
+		CV_Error(cv::Error::StsParseError, cv::String("Unsupported descriptor index version: ") + fileName);
+
+	std::shared_ptr<DescriptorIndexState> s = std::make_shared<DescriptorIndexState>();
+	impl->distType = reader.read<int>();
+	impl->nextId = reader.read<int>();
+	s->type = reader.read<int>();
+	s->cols = reader.read<int>();
+	s->count = 0;
+	CV_Assert(s->type == CV_8U || s->type == CV_32F);
+	CV_Assert(s->cols >= 0);
+
+	int paramCount = reader.read<int>();
+	CV_Assert(paramCount >= 0);
+	for (int i = 0; i < paramCount; i++)
+	{
+		impl->paramNames.push_back(reader.readString());
+		impl->paramTypes.push_back((cv::flann::FlannIndexType) reader.read<int>());
+		impl->paramStrValues.push_back(reader.readString());
+		impl->paramNumValues.push_back(reader.read<double>());
+	}
+
+	int segmentCount = reader.read<int>();
+	CV_Assert(segmentCount >= 0);
+	size_t rowBytes = s->cols * CV_ELEM_SIZE(s->type);
+	for (int i = 0; i < segmentCount; i++)
+	{
+		std::shared_ptr<DescriptorSegment> segment = std::make_shared<DescriptorSegment>();
+		int rows = reader.read<int>();
+		CV_Assert(rows > 0);
+		segment->removedCount = reader.read<int>();
+		//The ids are not aligned in the file, they are copied out instead of read in place
+		std::shared_ptr<std::vector<int> > ids = std::make_shared<std::vector<int> >(rows);
+		memcpy(&(*ids)[0], reader.read(rows * sizeof(int)), rows * sizeof(int));
+		segment->ids = ids;
+		const uchar* removed = (const uchar*) reader.read(rows);
+		segment->removed.assign(removed, removed + rows);
+		reader.align();
+		//The descriptors are not copied, the pages are read from the file as they are searched
+		segment->descriptors = cv::Mat(rows, s->cols, s->type, (void*) reader.read(rows * rowBytes));
+		segment->file = file;
+		segment->index = cv::makePtr<cv::flann::Index>();
+		if (!segment->index->load(segment->descriptors, segmentFileName(fileName, i)))
+			CV_Error(cv::Error::StsError, cv::String("Failed to load the FLANN index: ") + segmentFileName(fileName, i));
+		s->count += rows - segment->removedCount;
+		s->segments.push_back(segment);
+	}
+	impl->fileName = fileName;
+	impl->state = s;
+	guard.release();
+}
+
+emgu::FlannDescriptorIndex::~FlannDescriptorIndex()
+{
+	delete impl;
+}
+
+int emgu::FlannDescriptorIndex::add(cv::InputArray descriptors)
+{
+	cv::Mat d = descriptors.getMat();
+	std::lock_guard<std::mutex> lock(impl->writeMutex);
+	std::shared_ptr<const DescriptorIndexState> old = impl->snapshot();
+	int firstId = impl->nextId;
+	if (d.empty())
+		return firstId;
+	CV_Assert(d.type() == old->type);
+	CV_Assert(old->segments.empty() || d.cols == old->cols);
+	CV_Assert(d.rows <= INT_MAX - firstId);
+
+	std::shared_ptr<std::vector<int> > ids = std::make_shared<std::vector<int> >(d.rows);
+	for (int i = 0; i < d.rows; i++)
+		(*ids)[i] = firstId + i;
+
+	//The FLANN index is built outside of the state lock, the searches keep running on the previous segments
+	std::shared_ptr<DescriptorIndexState> s = std::make_shared<DescriptorIndexState>(*old);
+	s->cols = d.cols;
+	s->count += d.rows;
+	s->segments.push_back(impl->buildSegment(d.clone(), ids));
+
+	//Merge the last two segments while they are of similar size, the sizes are halving from the first segment to the last one
+	while (s->segments.size() >= 2)
+	{
+		const DescriptorSegment* last = s->segments[s->segments.size() - 1].get();
+		const DescriptorSegment* previous = s->segments[s->segments.size() - 2].get();
+		if ((last->descriptors.rows - last->removedCount) * 2 <= previous->descriptors.rows - previous->removedCount)
+			break;
+		std::vector<const DescriptorSegment*> merged;
+		merged.push_back(previous);
+		merged.push_back(last);
+		std::shared_ptr<const DescriptorSegment> segment = impl->buildSegment(merged);
+		s->segments.pop_back();
+		s->segments.back() = segment;
+	}
+
+	impl->publish(s);
+	impl->nextId += d.rows;
+	return firstId;
+}
+
+//The number of neighbors found in the segment that have not been removed
+static int countNeighbors(const DescriptorSegment& segment, const int* idx, int k)
+{
+	int count = 0;
+	for (int j = 0; j < k; j++)
+	{
+		//FLANN may find fewer than k neighbors
+		if (idx[j] < 0)
+			return INT_MAX;
+		if (!segment.removed[idx[j]])
+			count++;
+	}
+	return count;
+}
+
+//Insert the neighbors found in the segment into the sorted neighbors of a query, the ties keep the neighbor found first
+static void mergeNeighbors(const DescriptorSegment& segment, const int* idx, const float* d, int k, int knn, int* resultIds, float* resultDists)
+{
+	const std::vector<int>& segmentIds = *segment.ids;
+	for (int j = 0; j < k; j++)
+	{
+		int row = idx[j];
+		if (row < 0 || segment.removed[row])
+			continue;
+		if (!(d[j] < resultDists[knn - 1]))
+			break;
+		int p = knn - 1;
+		while (p > 0 && d[j] < resultDists[p - 1])
+		{
+			resultDists[p] = resultDists[p - 1];
+			resultIds[p] = resultIds[p - 1];
+			p--;
+		}
+		resultDists[p] = d[j];
+		resultIds[p] = segmentIds[row];
+	}
+}
+
+static bool segmentIdLess(int id, const std::shared_ptr<const DescriptorSegment>& segment)
+{
+	return id < segment->ids->front();
+}
+
+int emgu::FlannDescriptorIndex::remove(const std::vector<int>& ids)
+{
+	std::lock_guard<std::mutex> lock(impl->writeMutex);
+	std::shared_ptr<const DescriptorIndexState> old = impl->snapshot();
+	const std::vector< std::shared_ptr<const DescriptorSegment> >& segments = old->segments;
+
+	//The segments with removed descriptors are copied, the other ones are shared with the previous state
+	std::vector< std::shared_ptr<DescriptorSegment> > modified(segments.size());
+	int removedCount = 0;
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		int id = ids[i];
+		size_t s = std::upper_bound(segments.begin(), segments.end(), id, segmentIdLess) - segments.begin();
+		if (s == 0)
+			continue;
+		s--;
+		const std::vector<int>& segmentIds = *segments[s]->ids;
+		std::vector<int>::const_iterator it = std::lower_bound(segmentIds.begin(), segmentIds.end(), id);
+		if (it == segmentIds.end() || *it != id)
+			continue;
+		size_t row = it - segmentIds.begin();
+		if (!modified[s])
+			modified[s] = std::make_shared<DescriptorSegment>(*segments[s]);
+		if (modified[s]->removed[row])
+			continue;
+		modified[s]->removed[row] = 1;
+		modified[s]->removedCount++;
+		removedCount++;
+	}
+	if (removedCount == 0)
+		return 0;
+
+	std::shared_ptr<DescriptorIndexState> s = std::make_shared<DescriptorIndexState>();
+	s->type = old->type;
+	s->cols = old->cols;
+	s->count = old->count - removedCount;
+	for (size_t i = 0; i < segments.size(); i++)
+	{
+		std::shared_ptr<DescriptorSegment> segment = modified[i];
+		if (!segment)
+		{
+			s->segments.push_back(segments[i]);
+		}
+		else if (segment->removedCount == segment->descriptors.rows)
+		{
+			continue;
+		}
+		else if (segment->removedCount * 2 > segment->descriptors.rows)
+		{
+			//Most of the neighbors found in the segment would be skipped, it is rebuilt from the remaining descriptors
+			s->segments.push_back(impl->buildSegment(std::vector<const DescriptorSegment*>(1, segment.get())));
+		}
+		else
+		{
+			s->segments.push_back(segment);
+		}
+	}
+	impl->publish(s);
+	return removedCount;
+}
+
+void emgu::FlannDescriptorIndex::knnSearch(cv::InputArray queries, cv::OutputArray ids, cv::OutputArray dists, int knn, int checks, float eps) const
+{
+	CV_Assert(knn > 0);
+	std::shared_ptr<const DescriptorIndexState> s = impl->snapshot();
+	cv::Mat q = queries.getMat();
+	ids.create(q.rows, knn, CV_32S);
+	dists.create(q.rows, knn, CV_32F);
+	cv::Mat idMat = ids.getMat();
+	cv::Mat distMat = dists.getMat();
+	idMat.setTo(cv::Scalar::all(-1));
+	distMat.setTo(cv::Scalar::all(FLT_MAX));
+	if (q.rows == 0 || s->segments.empty())
+		return;
+	CV_Assert(q.type() == s->type && q.cols == s->cols);
+
+	cv::flann::SearchParams params(checks, eps, true);
+	cv::Mat segmentIdx, segmentDists, segmentDists32F;
+	std::vector<int> retry;
+	for (size_t i = 0; i < s->segments.size(); i++)
+	{
+		const DescriptorSegment& segment = *s->segments[i];
+		//knn neighbors are left once all the removed descriptors are skipped. The extra neighbors are capped such that the
+		//searches do not slow down as descriptors are removed, the queries close to more removed descriptors are searched again.
+		int rows = segment.descriptors.rows;
+		int kAll = std::min(knn + segment.removedCount, rows);
+		int k = std::min(knn + std::min(segment.removedCount, descriptorIndexExtraNeighbors), rows);
+		segment.index->knnSearch(q, segmentIdx, segmentDists, k, params);
+		segmentDists.convertTo(segmentDists32F, CV_32F);
+		retry.clear();
+		for (int r = 0; r < q.rows; r++)
+		{
+			const int* idx = segmentIdx.ptr<int>(r);
+			if (k < kAll && countNeighbors(segment, idx, k) < knn)
+				retry.push_back(r);
+			else
+				mergeNeighbors(segment, idx, segmentDists32F.ptr<float>(r), k, knn, idMat.ptr<int>(r), distMat.ptr<float>(r));
+		}
+		if (retry.empty())
+			continue;
+
+		cv::Mat retryQueries((int) retry.size(), q.cols, q.type());
+		for (size_t j = 0; j < retry.size(); j++)
+			q.row(retry[j]).copyTo(retryQueries.row((int) j));
+		segment.index->knnSearch(retryQueries, segmentIdx, segmentDists, kAll, params);
+		segmentDists.convertTo(segmentDists32F, CV_32F);
+		for (size_t j = 0; j < retry.size(); j++)
+			mergeNeighbors(segment, segmentIdx.ptr<int>((int) j), segmentDists32F.ptr<float>((int) j), kAll, knn, idMat.ptr<int>(retry[j]), distMat.ptr<float>(retry[j]));
+	}
+}
+
+void emgu::FlannDescriptorIndex::save(const cv::String& fileName) const
+{
+	//Holding the write lock keeps the state and the next id consistent
+	std::lock_guard<std::mutex> lock(impl->writeMutex);
+	std::shared_ptr<const DescriptorIndexState> s = impl->snapshot();
+
+	//The files are written next to the existing ones then renamed, the loaded segments may still be mapped from them
+	cv::String tmpSuffix = ".tmp";
+	{
+		DescriptorIndexWriter writer(fileName + tmpSuffix);
+		writer.write(descriptorIndexMagic, sizeof(descriptorIndexMagic));
+		writer.write(descriptorIndexVersion);
+		writer.write(impl->distType);
+		writer.write(impl->nextId);
+		writer.write(s->type);
+		writer.write(s->cols);
+		writer.write((int) impl->paramNames.size());
+		for (size_t i = 0; i < impl->paramNames.size(); i++)
+		{
+			writer.writeString(impl->paramNames[i]);
+			writer.write((int) impl->paramTypes[i]);
+			writer.writeString(impl->paramStrValues[i]);
+			writer.write(impl->paramNumValues[i]);
+		}
+		writer.write((int) s->segments.size());
+		for (size_t i = 0; i < s->segments.size(); i++)
+		{
+			const DescriptorSegment& segment = *s->segments[i];
+			const cv::Mat& d = segment.descriptors;
+			writer.write(d.rows);
+			writer.write(segment.removedCount);
+			writer.write(&(*segment.ids)[0], d.rows * sizeof(int));
+			writer.write(&segment.removed[0], d.rows);
+			writer.align();
+			for (int r = 0; r < d.rows; r++)
+				writer.write(d.ptr(r), d.cols * d.elemSize());
+		}
+		writer.close();
+	}
+	for (size_t i = 0; i < s->segments.size(); i++)
+		s->segments[i]->index->save(segmentFileName(fileName, i) + tmpSuffix);
+
+	if (fileName == impl->fileName)
+	{
+		//Windows can not replace a mapped file. The segments mapped from it are copied to memory, the file is unmapped
+		//once the searches running on the previous segments are done.
+		std::shared_ptr<DescriptorIndexState> detached = std::make_shared<DescriptorIndexState>(*s);
+		for (size_t i = 0; i < s->segments.size(); i++)
+		{
+			if (!s->segments[i]->file)
+				continue;
+			std::shared_ptr<DescriptorSegment> segment = std::make_shared<DescriptorSegment>(*s->segments[i]);
+			segment->descriptors = segment->descriptors.clone();
+			segment->file.reset();
+			segment->index = cv::makePtr<cv::flann::Index>();
+			if (!segment->index->load(segment->descriptors, segmentFileName(fileName, i) + tmpSuffix))
+				CV_Error(cv::Error::StsError, cv::String("Failed to load the FLANN index: ") + segmentFileName(fileName, i) + tmpSuffix);
+			detached->segments[i] = segment;
+		}
+		impl->publish(detached);
+		impl->fileName = cv::String();
+		s = detached;
+	}
+
+	for (size_t i = 0; i < s->segments.size(); i++)
+		replaceFile(segmentFileName(fileName, i) + tmpSuffix, segmentFileName(fileName, i));
+	replaceFile(fileName + tmpSuffix, fileName);
+}
+
+int emgu::FlannDescriptorIndex::getCount() const
+{
+	return impl->snapshot()->count;
+}
+
+int emgu::FlannDescriptorIndex::getSegmentCount() const
+{
+	return (int) impl->snapshot()->segments.size();
+}
+#endif
+
+emgu::FlannDescriptorIndex* cveFlannDescriptorIndexCreate(cv::flann::IndexParams* p, int distType)
+{
+#ifdef HAVE_OPENCV_FLANN
+	return new emgu::FlannDescriptorIndex(*p, (cvflann::flann_distance_t) distType);
+#else
+	throw_no_flann();
+#endif
+}
+
+emgu::FlannDescriptorIndex* cveFlannDescriptorIndexLoad(cv::String* fileName)
+{
+#ifdef HAVE_OPENCV_FLANN
+	return new emgu::FlannDescriptorIndex(*fileName);
+#else
+	throw_no_flann();
+#endif
+}
+
+void cveFlannDescriptorIndexRelease(emgu::FlannDescriptorIndex** index)
+{
+#ifdef HAVE_OPENCV_FLANN
+	delete* index;
+	*index = 0;
+#else
+	throw_no_flann();
+#endif
+}
+
+int cveFlannDescriptorIndexAdd(emgu::FlannDescriptorIndex* index, cv::_InputArray* descriptors)
+{
+#ifdef HAVE_OPENCV_FLANN
+	return index->add(*descriptors);
+#else
+	throw_no_flann();
+#endif
+}
+
+int cveFlannDescriptorIndexRemove(emgu::FlannDescriptorIndex* index, std::vector<int>* ids)
+{
+#ifdef HAVE_OPENCV_FLANN
+	return index->remove(*ids);
+#else
+	throw_no_flann();
+#endif
+}
+
+void cveFlannDescriptorIndexKnnSearch(emgu::FlannDescriptorIndex* index, cv::_InputArray* queries, cv::_OutputArray* ids, cv::_OutputArray* dists, int knn, int checks, float eps)
+{
+#ifdef HAVE_OPENCV_FLANN
+	index->knnSearch(*queries, *ids, *dists, knn, checks, eps);
+#else
+	throw_no_flann();
+#endif
+}
+
+void cveFlannDescriptorIndexSave(emgu::FlannDescriptorIndex* index, cv::String* fileName)
+{
+#ifdef HAVE_OPENCV_FLANN
+	index->save(*fileName);
+#else
+	throw_no_flann();
+#endif
+}
+
+void cveFlannDescriptorIndexGetStats(emgu::FlannDescriptorIndex* index, int* count, int* segmentCount)
+{
+#ifdef HAVE_OPENCV_FLANN
+	*count = index->getCount();
+	*segmentCount = index->getSegmentCount();
+#else
+	throw_no_flann();
+#endif
+}
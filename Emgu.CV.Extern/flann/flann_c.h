@@ -12,6 +12,45 @@
 
 #ifdef HAVE_OPENCV_FLANN
 #include "opencv2/flann/flann.hpp"
+
+namespace emgu
+{
+	/*
+	 * A descriptor index that can be updated and persisted without rebuilding it from scratch.
+	 * The descriptors are stored in segments, each with its own FLANN index. Added descriptors form a new segment, that is merged with
+	 * the previous one when they are of similar size, such that there are O(log n) segments. Removed descriptors are flagged and skipped
+	 * by the searches, a segment is rebuilt once more than half of its descriptors are removed. The index is saved to a file that is
+	 * memory mapped on load, the descriptors are read from the page cache as they are searched. Searches can run from many threads,
+	 * concurrently with the updates, each search sees the segments as they were when it started.
+	 */
+	class CV_EXPORTS FlannDescriptorIndex
+	{
+	public:
+		FlannDescriptorIndex(const cv::flann::IndexParams& params, cvflann::flann_distance_t distType);
+		//Load an index saved with save()
+		FlannDescriptorIndex(const cv::String& fileName);
+		~FlannDescriptorIndex();
+
+		//Add the descriptors, one per row. They get consecutive ids, the id of the first one is returned.
+		int add(cv::InputArray descriptors);
+		//Remove the descriptors of the ids, the number of descriptors removed is returned
+		int remove(const std::vector<int>& ids);
+		//Find the knn nearest descriptors of each query. Missing neighbors have an id of -1 and a distance of FLT_MAX.
+		void knnSearch(cv::InputArray queries, cv::OutputArray ids, cv::OutputArray dists, int knn, int checks, float eps) const;
+		//Save the index to fileName. The FLANN index of each segment is saved to fileName.<segment>.flann.
+		void save(const cv::String& fileName) const;
+
+		int getCount() const;
+		int getSegmentCount() const;
+
+	private:
+		struct Impl;
+		Impl* impl;
+
+		FlannDescriptorIndex(const FlannDescriptorIndex&);
+		FlannDescriptorIndex& operator=(const FlannDescriptorIndex&);
+	};
+}
 #else
 static inline CV_NORETURN void throw_no_flann() { CV_Error(cv::Error::StsBadFunc, "The library is compiled without flann support. To use this module, please switch to the full Emgu CV runtime."); }
 
@@ -31,6 +70,11 @@ namespace cv {
 	}
 }
 
+namespace emgu
+{
+	class FlannDescriptorIndex {};
+}
+
 namespace cvflann
 {
 	class flann_centers_init_t {};
@@ -70,4 +114,13 @@ CVAPI(int) cveFlannIndexRadiusSearch(cv::flann::Index* index, cv::_InputArray* q
 
 CVAPI(void) cveFlannIndexRelease(cv::flann::Index** index);
 
+CVAPI(emgu::FlannDescriptorIndex*) cveFlannDescriptorIndexCreate(cv::flann::IndexParams* p, int distType);
+CVAPI(emgu::FlannDescriptorIndex*) cveFlannDescriptorIndexLoad(cv::String* fileName);
+CVAPI(void) cveFlannDescriptorIndexRelease(emgu::FlannDescriptorIndex** index);
+CVAPI(int) cveFlannDescriptorIndexAdd(emgu::FlannDescriptorIndex* index, cv::_InputArray* descriptors);
+CVAPI(int) cveFlannDescriptorIndexRemove(emgu::FlannDescriptorIndex* index, std::vector<int>* ids);
+CVAPI(void) cveFlannDescriptorIndexKnnSearch(emgu::FlannDescriptorIndex* index, cv::_InputArray* queries, cv::_OutputArray* ids, cv::_OutputArray* dists, int knn, int checks, float eps);
+CVAPI(void) cveFlannDescriptorIndexSave(emgu::FlannDescriptorIndex* index, cv::String* fileName);
+CVAPI(void) cveFlannDescriptorIndexGetStats(emgu::FlannDescriptorIndex* index, int* count, int* segmentCount);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------
+//
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//
+//----------------------------------------------------------------------------
+
+#include "mappedFile.h"
+#include <cstdio>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32) && !((defined WINAPI_FAMILY) && (WINAPI_FAMILY != WINAPI_FAMILY_DESKTOP_APP))
+#define EMGU_WIN32_FILE_MAPPING 1
+#endif
+
+emgu::MappedFile::MappedFile()
+	: data(0), size(0), mapping(0)
+{
+}
+
+emgu::MappedFile::~MappedFile()
+{
+#ifdef EMGU_WIN32_FILE_MAPPING
+	if (data)
+		UnmapViewOfFile(data);
+	if (mapping)
+		CloseHandle((HANDLE) mapping);
+#elif !defined(_WIN32)
+	if (data)
+		munmap((void*) data, size);
+#endif
+}
+
+void emgu::MappedFile::open(const cv::String& fileName)
+{
+#ifdef EMGU_WIN32_FILE_MAPPING
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		CV_Error(cv::Error::StsError, cv::String("Failed to open file: ") + fileName);
+	LARGE_INTEGER fileSize;
+	bool ok = GetFileSizeEx(file, &fileSize) != 0;
+	size = ok ? (size_t) fileSize.QuadPart : 0;
+	if (ok && size > 0)
+	{
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping)
+			data = (const char*) MapViewOfFile((HANDLE) mapping, FILE_MAP_READ, 0, 0, 0);
+		ok = data != 0;
+	}
+	CloseHandle(file);
+	if (!ok)
+		CV_Error(cv::Error::StsError, cv::String("Failed to map file: ") + fileName);
+#elif defined(_WIN32)
+	FILE* file = fopen(fileName.c_str(), "rb");
+	if (!file)
+		CV_Error(cv::Error::StsError, cv::String("Failed to open file: ") + fileName);
+	fseek(file, 0, SEEK_END);
+	buffer.resize((size_t) ftell(file));
+	fseek(file, 0, SEEK_SET);
+	size_t read = buffer.empty() ? 0 : fread(&buffer[0], 1, buffer.size(), file);
+	fclose(file);
+	if (read != buffer.size())
+		CV_Error(cv::Error::StsError, cv::String("Failed to read file: ") + fileName);
+	data = buffer.empty() ? 0 : &buffer[0];
+	size = buffer.size();
+#else
+	int file = ::open(fileName.c_str(), O_RDONLY);
+	if (file < 0)
+		CV_Error(cv::Error::StsError, cv::String("Failed to open file: ") + fileName);
+	struct stat st;
+	bool ok = fstat(file, &st) == 0;
+	size = ok ? (size_t) st.st_size : 0;
+	if (ok && size > 0)
+	{
+		void* p = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+		ok = p != MAP_FAILED;
+		if (ok)
+			data = (const char*) p;
+	}
+	::close(file);
+	if (!ok)
+		CV_Error(cv::Error::StsError, cv::String("Failed to map file: ") + fileName);
+#endif
+}
@@ -0,0 +1,42 @@
+//----------------------------------------------------------------------------
+//
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+#ifndef EMGU_MAPPED_FILE_H
+#define EMGU_MAPPED_FILE_H
+
+#include "opencv2/core/core.hpp"
+#include <vector>
+
+namespace emgu
+{
+	/*
+	 * A read only view of a file. The file is memory mapped, such that it is read straight from the page cache
+	 * instead of from a copy in the heap. Windows Store apps can not map files, the file is read into memory instead.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		void open(const cv::String& fileName);
+
+		const char* data;
+		size_t size;
+
+	private:
+		//The file mapping handle on Windows
+		void* mapping;
+		//The content of the file where it can not be mapped
+		std::vector<char> buffer;
+
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+	};
+}
+
+#endif
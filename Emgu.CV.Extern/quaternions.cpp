@@ -21,6 +21,34 @@ void quaternionsRotatePoint(const Quaternions* quaternions, const CvPoint3D64f*
    quaternions->rotatePoint(point, pointDst);
 }
 
+//The 3x3 rotation matrix of the unit quaternions, row major
+static void quaternionsGetRotation(const Quaternions* q, double* r)
+{
+   double w = q->w, x = q->x, y = q->y, z = q->z;
+   r[0] = w*w+x*x-y*y-z*z; r[1] = 2.0*(x*y-w*z); r[2] = 2.0*(x*z+w*y);
+   r[3] = 2.0*(x*y+w*z); r[4] = w*w-x*x+y*y-z*z; r[5] = 2.0*(y*z-w*x);
+   r[6] = 2.0*(x*z-w*y); r[7] = 2.0*(y*z+w*x); r[8] = w*w-x*x-y*y+z*z;
+}
+
+//The matrix M of Quaternions::rotatePoint, p' = p + 2 * M * p, row major. The coefficients are computed the same way,
+//such that the points are rotated to the same values when the quaternions are not normalized.
+static void quaternionsGetPointRotation(const Quaternions* q, double* m)
+{
+   double
+      t2 =   q->w*q->x,
+      t3 =   q->w*q->y,
+      t4 =   q->w*q->z,
+      t5 =  -q->x*q->x,
+      t6 =   q->x*q->y,
+      t7 =   q->x*q->z,
+      t8 =  -q->y*q->y,
+      t9 =   q->y*q->z,
+      t10 = -q->z*q->z;
+   m[0] = t8 + t10; m[1] = t6 - t4; m[2] = t3 + t7;
+   m[3] = t4 + t6; m[4] = t5 + t10; m[5] = t9 - t2;
+   m[6] = t7 - t3; m[7] = t2 + t9; m[8] = t5 + t8;
+}
+
 void quaternionsRotatePoints(const Quaternions* quaternions, const CvMat* pointSrc, CvMat* pointDst)
 {
    cv::Mat p = cv::cvarrToMat(pointSrc);
@@ -36,26 +64,30 @@ void quaternionsRotatePoints(const Quaternions* quaternions, const CvMat* pointS
       quaternionsRotatePoint( quaternions, (CvPoint3D64f*) pIter.ptr, (CvPoint3D64f*) pDstIter.ptr);
    } else 
    {
+      //compute the matrix of rotatePoint once for all the points
+      double m[9];
+      quaternionsGetPointRotation(quaternions, m);
       for(int i = 0; i < p.rows; i++, pIter+=3, pDstIter+=3)
       {
-         quaternionsRotatePoint(quaternions, (CvPoint3D64f*) pIter.ptr, (CvPoint3D64f*)pDstIter.ptr);
+         const double* src = (const double*) pIter.ptr;
+         double* dst = (double*) pDstIter.ptr;
+         double x = src[0], y = src[1], z = src[2];
+         dst[0] = 2.0*( m[0] * x + m[1] * y + m[2] * z ) + x;
+         dst[1] = 2.0*( m[3] * x + m[4] * y + m[5] * z ) + y;
+         dst[2] = 2.0*( m[6] * x + m[7] * y + m[8] * z ) + z;
       }
    }
 }
 
 void quaternionsToRotationMatrix(const Quaternions* quaternions, CvMat* rotation)
 {
-   double w = quaternions->w;
-   double x = quaternions->x;
-   double y = quaternions->y;
-   double z = quaternions->z;
-
    cv::Mat r = cv::cvarrToMat(rotation);
    CV_Assert(r.rows == 3 && r.cols == 3);
+   double m[9];
+   quaternionsGetRotation(quaternions, m);
    cv::MatIterator_<double> rIter = r.begin<double>();
-   *rIter++ = w*w+x*x-y*y-z*z; *rIter++ = 2.0*(x*y-w*z); *rIter++ = 2.0*(x*z+w*y);
-   *rIter++ = 2.0*(x*y+w*z); *rIter++ = w*w-x*x+y*y-z*z; *rIter++ = 2.0*(y*z-w*x);
-   *rIter++ = 2.0*(x*z-w*y); *rIter++ = 2.0*(y*z+w*x); *rIter++ = w*w-x*x-y*y+z*z;
+   for (int i = 0; i < 9; i++)
+      *rIter++ = m[i];
 }
 
 void quaternionsMultiply(const Quaternions* quaternions1, const Quaternions* quaternions2, Quaternions* quaternionsDst)
@@ -78,4 +110,212 @@ void quaternionsRenorm(Quaternions* quaternions) { quaternions->renorm(); }
 void quaternionsSlerp(const Quaternions* qa, const Quaternions* qb, double t, Quaternions* qm)
 {
    qa->slerp(qb, t, qm);
-}
\ No newline at end of file
+}
+
+//----------------------------------------------------------------------------
+//
+//  Batch operations on structure of arrays
+//
+//----------------------------------------------------------------------------
+
+//The scalar kernels process the elements [start, count), the AVX2 kernels process groups of 4 and return the number of elements done.
+static void rotatePointsSoA(const double* m, const Point3D64fSoA* src, Point3D64fSoA* dst, int start, int count)
+{
+   for (int i = start; i < count; i++)
+   {
+      double x = src->x[i], y = src->y[i], z = src->z[i];
+      dst->x[i] = 2.0*( m[0] * x + m[1] * y + m[2] * z ) + x;
+      dst->y[i] = 2.0*( m[3] * x + m[4] * y + m[5] * z ) + y;
+      dst->z[i] = 2.0*( m[6] * x + m[7] * y + m[8] * z ) + z;
+   }
+}
+
+static void batchRotatePoints(const QuaternionsSoA* q, const Point3D64fSoA* src, Point3D64fSoA* dst, int start, int count)
+{
+   Quaternions quaternions;
+   CvPoint3D64f p, pDst;
+   for (int i = start; i < count; i++)
+   {
+      quaternions.w = q->w[i]; quaternions.x = q->x[i]; quaternions.y = q->y[i]; quaternions.z = q->z[i];
+      p.x = src->x[i]; p.y = src->y[i]; p.z = src->z[i];
+      quaternions.rotatePoint(&p, &pDst);
+      dst->x[i] = pDst.x; dst->y[i] = pDst.y; dst->z[i] = pDst.z;
+   }
+}
+
+static void batchMultiply(const QuaternionsSoA* q1, const QuaternionsSoA* q2, QuaternionsSoA* dst, int start, int count)
+{
+   for (int i = start; i < count; i++)
+   {
+      double w1 = q1->w[i], x1 = q1->x[i], y1 = q1->y[i], z1 = q1->z[i];
+      double w2 = q2->w[i], x2 = q2->x[i], y2 = q2->y[i], z2 = q2->z[i];
+      double w = w1*w2 - x1*x2 - y1*y2 - z1*z2;
+      double x = w1*x2 + x1*w2 + y1*z2 - z1*y2;
+      double y = w1*y2 - x1*z2 + y1*w2 + z1*x2;
+      double z = w1*z2 + x1*y2 - y1*x2 + z1*w2;
+      //this is done to improve the numerical stability
+      double scale = 1.0 / sqrt(w*w + x*x + y*y + z*z);
+      dst->w[i] = w * scale; dst->x[i] = x * scale; dst->y[i] = y * scale; dst->z[i] = z * scale;
+   }
+}
+
+static void batchRenorm(QuaternionsSoA* q, int start, int count)
+{
+   for (int i = start; i < count; i++)
+   {
+      double scale = 1.0 / sqrt(q->w[i]*q->w[i] + q->x[i]*q->x[i] + q->y[i]*q->y[i] + q->z[i]*q->z[i]);
+      q->w[i] *= scale; q->x[i] *= scale; q->y[i] *= scale; q->z[i] *= scale;
+   }
+}
+
+#if EMGU_AVX2
+EMGU_TARGET_AVX2 static int rotatePointsSoAAvx2(const double* m, const Point3D64fSoA* src, Point3D64fSoA* dst, int count)
+{
+   __m256d m0 = _mm256_set1_pd(m[0]), m1 = _mm256_set1_pd(m[1]), m2 = _mm256_set1_pd(m[2]);
+   __m256d m3 = _mm256_set1_pd(m[3]), m4 = _mm256_set1_pd(m[4]), m5 = _mm256_set1_pd(m[5]);
+   __m256d m6 = _mm256_set1_pd(m[6]), m7 = _mm256_set1_pd(m[7]), m8 = _mm256_set1_pd(m[8]);
+   __m256d two = _mm256_set1_pd(2.0);
+   int i = 0;
+   for (; i <= count - 4; i += 4)
+   {
+      //same as Quaternions::rotatePoint: p' = p + 2 * M * p
+      __m256d x = _mm256_loadu_pd(src->x + i), y = _mm256_loadu_pd(src->y + i), z = _mm256_loadu_pd(src->z + i);
+      __m256d rx = _mm256_fmadd_pd(m0, x, _mm256_fmadd_pd(m1, y, _mm256_mul_pd(m2, z)));
+      __m256d ry = _mm256_fmadd_pd(m3, x, _mm256_fmadd_pd(m4, y, _mm256_mul_pd(m5, z)));
+      __m256d rz = _mm256_fmadd_pd(m6, x, _mm256_fmadd_pd(m7, y, _mm256_mul_pd(m8, z)));
+      _mm256_storeu_pd(dst->x + i, _mm256_fmadd_pd(two, rx, x));
+      _mm256_storeu_pd(dst->y + i, _mm256_fmadd_pd(two, ry, y));
+      _mm256_storeu_pd(dst->z + i, _mm256_fmadd_pd(two, rz, z));
+   }
+   return i;
+}
+
+EMGU_TARGET_AVX2 static int batchRotatePointsAvx2(const QuaternionsSoA* q, const Point3D64fSoA* src, Point3D64fSoA* dst, int count)
+{
+   __m256d two = _mm256_set1_pd(2.0);
+   int i = 0;
+   for (; i <= count - 4; i += 4)
+   {
+      __m256d w = _mm256_loadu_pd(q->w + i), x = _mm256_loadu_pd(q->x + i), y = _mm256_loadu_pd(q->y + i), z = _mm256_loadu_pd(q->z + i);
+      __m256d px = _mm256_loadu_pd(src->x + i), py = _mm256_loadu_pd(src->y + i), pz = _mm256_loadu_pd(src->z + i);
+      //same as Quaternions::rotatePoint: p' = p + 2 * M * p
+      __m256d t2 = _mm256_mul_pd(w, x), t3 = _mm256_mul_pd(w, y), t4 = _mm256_mul_pd(w, z);
+      __m256d t6 = _mm256_mul_pd(x, y), t7 = _mm256_mul_pd(x, z), t9 = _mm256_mul_pd(y, z);
+      __m256d xx = _mm256_mul_pd(x, x), yy = _mm256_mul_pd(y, y), zz = _mm256_mul_pd(z, z);
+      __m256d t8t10 = _mm256_add_pd(yy, zz), t5t10 = _mm256_add_pd(xx, zz), t5t8 = _mm256_add_pd(xx, yy);
+      __m256d rx = _mm256_fmadd_pd(_mm256_add_pd(t3, t7), pz, _mm256_fmsub_pd(_mm256_sub_pd(t6, t4), py, _mm256_mul_pd(t8t10, px)));
+      __m256d ry = _mm256_fmadd_pd(_mm256_sub_pd(t9, t2), pz, _mm256_fmsub_pd(_mm256_add_pd(t4, t6), px, _mm256_mul_pd(t5t10, py)));
+      __m256d rz = _mm256_fmadd_pd(_mm256_add_pd(t2, t9), py, _mm256_fmsub_pd(_mm256_sub_pd(t7, t3), px, _mm256_mul_pd(t5t8, pz)));
+      _mm256_storeu_pd(dst->x + i, _mm256_fmadd_pd(two, rx, px));
+      _mm256_storeu_pd(dst->y + i, _mm256_fmadd_pd(two, ry, py));
+      _mm256_storeu_pd(dst->z + i, _mm256_fmadd_pd(two, rz, pz));
+   }
+   return i;
+}
+
+EMGU_TARGET_AVX2 static inline void renormAvx2(__m256d& w, __m256d& x, __m256d& y, __m256d& z)
+{
+   __m256d norm = _mm256_sqrt_pd(_mm256_fmadd_pd(w, w, _mm256_fmadd_pd(x, x, _mm256_fmadd_pd(y, y, _mm256_mul_pd(z, z)))));
+   w = _mm256_div_pd(w, norm); x = _mm256_div_pd(x, norm); y = _mm256_div_pd(y, norm); z = _mm256_div_pd(z, norm);
+}
+
+EMGU_TARGET_AVX2 static int batchMultiplyAvx2(const QuaternionsSoA* q1, const QuaternionsSoA* q2, QuaternionsSoA* dst, int count)
+{
+   int i = 0;
+   for (; i <= count - 4; i += 4)
+   {
+      __m256d w1 = _mm256_loadu_pd(q1->w + i), x1 = _mm256_loadu_pd(q1->x + i), y1 = _mm256_loadu_pd(q1->y + i), z1 = _mm256_loadu_pd(q1->z + i);
+      __m256d w2 = _mm256_loadu_pd(q2->w + i), x2 = _mm256_loadu_pd(q2->x + i), y2 = _mm256_loadu_pd(q2->y + i), z2 = _mm256_loadu_pd(q2->z + i);
+      __m256d w = _mm256_fmsub_pd(w1, w2, _mm256_fmadd_pd(x1, x2, _mm256_fmadd_pd(y1, y2, _mm256_mul_pd(z1, z2))));
+      __m256d x = _mm256_fmadd_pd(w1, x2, _mm256_fmadd_pd(x1, w2, _mm256_fmsub_pd(y1, z2, _mm256_mul_pd(z1, y2))));
+      __m256d y = _mm256_fmadd_pd(w1, y2, _mm256_fmadd_pd(y1, w2, _mm256_fmsub_pd(z1, x2, _mm256_mul_pd(x1, z2))));
+      __m256d z = _mm256_fmadd_pd(w1, z2, _mm256_fmadd_pd(z1, w2, _mm256_fmsub_pd(x1, y2, _mm256_mul_pd(y1, x2))));
+      renormAvx2(w, x, y, z);
+      _mm256_storeu_pd(dst->w + i, w); _mm256_storeu_pd(dst->x + i, x); _mm256_storeu_pd(dst->y + i, y); _mm256_storeu_pd(dst->z + i, z);
+   }
+   return i;
+}
+
+EMGU_TARGET_AVX2 static int batchRenormAvx2(QuaternionsSoA* q, int count)
+{
+   int i = 0;
+   for (; i <= count - 4; i += 4)
+   {
+      __m256d w = _mm256_loadu_pd(q->w + i), x = _mm256_loadu_pd(q->x + i), y = _mm256_loadu_pd(q->y + i), z = _mm256_loadu_pd(q->z + i);
+      renormAvx2(w, x, y, z);
+      _mm256_storeu_pd(q->w + i, w); _mm256_storeu_pd(q->x + i, x); _mm256_storeu_pd(q->y + i, y); _mm256_storeu_pd(q->z + i, z);
+   }
+   return i;
+}
+#endif
+
+void quaternionsRotatePointsSoA(const Quaternions* quaternions, const Point3D64fSoA* pointSrc, Point3D64fSoA* pointDst, int count)
+{
+   double m[9];
+   quaternionsGetPointRotation(quaternions, m);
+   int done = 0;
+#if EMGU_AVX2
+   if (simdAVX2) done = rotatePointsSoAAvx2(m, pointSrc, pointDst, count);
+#endif
+   rotatePointsSoA(m, pointSrc, pointDst, done, count);
+}
+
+void quaternionsBatchRotatePoints(const QuaternionsSoA* quaternions, const Point3D64fSoA* pointSrc, Point3D64fSoA* pointDst, int count)
+{
+   int done = 0;
+#if EMGU_AVX2
+   if (simdAVX2) done = batchRotatePointsAvx2(quaternions, pointSrc, pointDst, count);
+#endif
+   batchRotatePoints(quaternions, pointSrc, pointDst, done, count);
+}
+
+void quaternionsBatchMultiply(const QuaternionsSoA* quaternions1, const QuaternionsSoA* quaternions2, QuaternionsSoA* quaternionsDst, int count)
+{
+   int done = 0;
+#if EMGU_AVX2
+   if (simdAVX2) done = batchMultiplyAvx2(quaternions1, quaternions2, quaternionsDst, count);
+#endif
+   batchMultiply(quaternions1, quaternions2, quaternionsDst, done, count);
+}
+
+void quaternionsBatchRenorm(QuaternionsSoA* quaternions, int count)
+{
+   int done = 0;
+#if EMGU_AVX2
+   if (simdAVX2) done = batchRenormAvx2(quaternions, count);
+#endif
+   batchRenorm(quaternions, done, count);
+}
+
+//slerp and the euler conversions are dominated by the trigonometric functions, they reuse the single quaternions code
+void quaternionsBatchSlerp(const QuaternionsSoA* qa, const QuaternionsSoA* qb, double t, QuaternionsSoA* qm, int count)
+{
+   Quaternions a, b, m;
+   for (int i = 0; i < count; i++)
+   {
+      a.w = qa->w[i]; a.x = qa->x[i]; a.y = qa->y[i]; a.z = qa->z[i];
+      b.w = qb->w[i]; b.x = qb->x[i]; b.y = qb->y[i]; b.z = qb->z[i];
+      a.slerp(&b, t, &m);
+      qm->w[i] = m.w; qm->x[i] = m.x; qm->y[i] = m.y; qm->z[i] = m.z;
+   }
+}
+
+void quaternionsBatchToEuler(const QuaternionsSoA* quaternions, Point3D64fSoA* euler, int count)
+{
+   Quaternions q;
+   for (int i = 0; i < count; i++)
+   {
+      q.w = quaternions->w[i]; q.x = quaternions->x[i]; q.y = quaternions->y[i]; q.z = quaternions->z[i];
+      q.getEuler(euler->x + i, euler->y + i, euler->z + i);
+   }
+}
+
+void eulerToQuaternionsBatch(const Point3D64fSoA* euler, QuaternionsSoA* quaternions, int count)
+{
+   Quaternions q;
+   for (int i = 0; i < count; i++)
+   {
+      q.setEuler(euler->x[i], euler->y[i], euler->z[i]);
+      quaternions->w[i] = q.w; quaternions->x[i] = q.x; quaternions->y[i] = q.y; quaternions->z[i] = q.z;
+   }
+}
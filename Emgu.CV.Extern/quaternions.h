@@ -385,4 +385,87 @@ CVAPI(void) quaternionsRenorm(Quaternions* quaternions);
 * @param qm The result of slerp
 **/
 CVAPI(void) quaternionsSlerp(const Quaternions* qa, const Quaternions* qb, double t, Quaternions* qm);
+
+/**
+* @struct  QuaternionsSoA
+*
+* @brief   An array of quaternions stored as structure of arrays, each pointer points to count elements
+*
+**/
+typedef struct QuaternionsSoA
+{
+   double* w;
+   double* x;
+   double* y;
+   double* z;
+} QuaternionsSoA;
+
+/**
+* @struct  Point3D64fSoA
+*
+* @brief   An array of 3D points stored as structure of arrays, each pointer points to count elements
+*
+**/
+typedef struct Point3D64fSoA
+{
+   double* x;
+   double* y;
+   double* z;
+} Point3D64fSoA;
+
+/**
+* @fn   void quaternionsRotatePointsSoA(const Quaternions* quaternions, const Point3D64fSoA* pointSrc, Point3D64fSoA* pointDst, int count)
+*
+* @brief   Rotate count points by the same quaternions, with the same result as quaternionsRotatePoint. The rotation matrix is computed once. In-place operation is supported.
+*
+**/
+CVAPI(void) quaternionsRotatePointsSoA(const Quaternions* quaternions, const Point3D64fSoA* pointSrc, Point3D64fSoA* pointDst, int count);
+
+/**
+* @fn   void quaternionsBatchRotatePoints(const QuaternionsSoA* quaternions, const Point3D64fSoA* pointSrc, Point3D64fSoA* pointDst, int count)
+*
+* @brief   Rotate the i-th point by the i-th quaternions. In-place operation is supported.
+*
+**/
+CVAPI(void) quaternionsBatchRotatePoints(const QuaternionsSoA* quaternions, const Point3D64fSoA* pointSrc, Point3D64fSoA* pointDst, int count);
+
+/**
+* @fn   void quaternionsBatchMultiply(const QuaternionsSoA* quaternions1, const QuaternionsSoA* quaternions2, QuaternionsSoA* quaternionsDst, int count)
+*
+* @brief   Multiply the quaternions element wise, the results are renormalized. In-place operation is supported.
+*
+**/
+CVAPI(void) quaternionsBatchMultiply(const QuaternionsSoA* quaternions1, const QuaternionsSoA* quaternions2, QuaternionsSoA* quaternionsDst, int count);
+
+/**
+* @fn   void quaternionsBatchRenorm(QuaternionsSoA* quaternions, int count)
+*
+* @brief   Renormalize the quaternions such that their norm becomes 1
+*
+**/
+CVAPI(void) quaternionsBatchRenorm(QuaternionsSoA* quaternions, int count);
+
+/**
+* @fn   void quaternionsBatchSlerp(const QuaternionsSoA* qa, const QuaternionsSoA* qb, double t, QuaternionsSoA* qm, int count)
+*
+* @brief   Slerp the quaternions element wise with the same weight t for qb
+*
+**/
+CVAPI(void) quaternionsBatchSlerp(const QuaternionsSoA* qa, const QuaternionsSoA* qb, double t, QuaternionsSoA* qm, int count);
+
+/**
+* @fn   void quaternionsBatchToEuler(const QuaternionsSoA* quaternions, Point3D64fSoA* euler, int count)
+*
+* @brief   Convert the quaternions to euler angles (in radian)
+*
+**/
+CVAPI(void) quaternionsBatchToEuler(const QuaternionsSoA* quaternions, Point3D64fSoA* euler, int count);
+
+/**
+* @fn   void eulerToQuaternionsBatch(const Point3D64fSoA* euler, QuaternionsSoA* quaternions, int count)
+*
+* @brief   Convert the euler angles (in radian) to quaternions
+*
+**/
+CVAPI(void) eulerToQuaternionsBatch(const Point3D64fSoA* euler, QuaternionsSoA* quaternions, int count);
 #endif
\ No newline at end of file
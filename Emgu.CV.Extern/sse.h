@@ -34,6 +34,40 @@
    #if EMGU_SSE2
    const bool simdSSE4_1 = cv::checkHardwareSupport(CV_CPU_SSE4_1);
 
+   //AVX2 and AVX-512 code is compiled per function with a target attribute (gcc / clang) such that
+   //the rest of the library does not require these instruction sets, it must only be called after checking simdAVX2 / simdAVX512
+   #if (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)) && (defined(__x86_64__) || defined(__i386__))
+      #include "immintrin.h"
+      #define EMGU_AVX2 1
+      #define EMGU_TARGET_AVX2 __attribute__((target("avx2,fma")))
+      #define EMGU_AVX512 1
+      #define EMGU_TARGET_AVX512 __attribute__((target("avx512f")))
+      #define EMGU_AVX512_VPOPCNTDQ 1
+      #define EMGU_TARGET_AVX512_VPOPCNTDQ __attribute__((target("avx512f,avx512vpopcntdq")))
+   #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+      #include "immintrin.h"
+      #define EMGU_AVX2 1
+      #define EMGU_TARGET_AVX2
+      #if _MSC_VER >= 1910 //Visual Studio 2017
+         #define EMGU_AVX512 1
+         #define EMGU_TARGET_AVX512
+      #endif
+      #if _MSC_VER >= 1920 //Visual Studio 2019
+         #define EMGU_AVX512_VPOPCNTDQ 1
+         #define EMGU_TARGET_AVX512_VPOPCNTDQ
+      #endif
+   #endif
+
+   #if EMGU_AVX2
+   const bool simdAVX2 = cv::checkHardwareSupport(CV_CPU_AVX2) && cv::checkHardwareSupport(CV_CPU_FMA3);
+   #endif
+   #if EMGU_AVX512
+   const bool simdAVX512 = cv::checkHardwareSupport(CV_CPU_AVX_512F);
+   #endif
+   #if EMGU_AVX512_VPOPCNTDQ
+   const bool simdAVX512VPOPCNTDQ = cv::checkHardwareSupport(CV_CPU_AVX_512F) && cv::checkHardwareSupport(CV_CPU_AVX_512VPOPCNTDQ);
+   #endif
+
    inline __m128d _dot_product(__m128d v0, __m128d v1)
    {
    #if EMGU_SSE4_1
@@ -5,6 +5,10 @@
 //----------------------------------------------------------------------------
 
 #include "tiffio_c.h"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 TIFF* tiffWriterOpen(char* fileName)
 {
@@ -15,6 +19,15 @@ TIFF* tiffWriterOpen(char* fileName)
 #endif
 }
 
+TIFF* tiffWriterOpen2(char* fileName, bool bigTiff)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	return XTIFFOpen(fileName, bigTiff ? "w8" : "w");
+#else
+	throw_no_tiff();
+#endif
+}
+
 int tiffTileRowSize(TIFF* pTiff)
 {
 #ifdef EMGU_CV_WITH_TIFF
@@ -87,20 +100,42 @@ void tiffWriteImage(TIFF* pTiff, IplImage* image)
 #endif
 }
 
+#ifdef EMGU_CV_WITH_TIFF
+//Copy the tile starting at (row, col) into a buffer of a full tile, the part outside of the image is padded with zeros
+static void tiffCopyTile(const cv::Mat& image, int row, int col, const cv::Size& tileSize, unsigned char* buffer)
+{
+	size_t tileStride = tileSize.width * image.elemSize();
+	int rows = std::min(tileSize.height, image.rows - row);
+	size_t rowBytes = std::min(tileSize.width, image.cols - col) * image.elemSize();
+	unsigned char* ptr = buffer;
+	for (int i = 0; i < rows; i++, ptr += tileStride)
+	{
+		memcpy(ptr, image.ptr(row + i, col), rowBytes);
+		if (rowBytes < tileStride)
+			memset(ptr + rowBytes, 0, tileStride - rowBytes);
+	}
+	if (rows < tileSize.height)
+		memset(ptr, 0, (tileSize.height - rows) * tileStride);
+}
+#endif
+
 void tiffWriteTile(TIFF* pTiff, int row, int col, IplImage* tileImage)
 {
 #ifdef EMGU_CV_WITH_TIFF
 	cv::Mat tile = cv::cvarrToMat(tileImage);
 
-	int bufferStride = tile.cols * tile.elemSize();
-	unsigned char* buffer = (unsigned char*)malloc(tile.rows * bufferStride);
-	unsigned char* ptr = buffer;
+	uint32 tileWidth = 0, tileHeight = 0;
+	TIFFGetField(pTiff, TIFFTAG_TILEWIDTH, &tileWidth);
+	TIFFGetField(pTiff, TIFFTAG_TILELENGTH, &tileHeight);
+	cv::Size tileSize(tileWidth, tileHeight);
+	CV_Assert(tile.rows <= tileSize.height && tile.cols <= tileSize.width);
 
-	for (int i = 0; i < tile.rows; i++, ptr += bufferStride)
-		memcpy(ptr, tile.ptr(i), bufferStride);
+	//libtiff always reads a full tile from the buffer, keep one per thread instead of allocating it for every tile
+	static thread_local std::vector<unsigned char> buffer;
+	buffer.resize((size_t) tileSize.area() * tile.elemSize());
+	tiffCopyTile(tile, 0, 0, tileSize, buffer.data());
 
-	TIFFWriteTile(pTiff, buffer, col, row, 0, 0);
-	free(buffer);
+	TIFFWriteTile(pTiff, buffer.data(), col, row, 0, 0);
 #else
 	throw_no_tiff();
 #endif
@@ -116,7 +151,7 @@ void tiffWriteTileInfo(TIFF* pTiff, CvSize* tileSize)
 #endif
 }
 
-void tiffWriteGeoTag(TIFF* pTiff, double* ModelTiepoint, double* ModelPixelScale)
+void tiffWriteGeoTag(TIFF* pTiff, double* ModelTiepoint, double* ModelPixelScale, const char* citation)
 {
 #ifdef EMGU_CV_WITH_TIFF
 	TIFFSetField(pTiff, GTIFF_TIEPOINTS, 6, ModelTiepoint);
@@ -127,6 +162,8 @@ void tiffWriteGeoTag(TIFF* pTiff, double* ModelTiepoint, double* ModelPixelScale
 	GTIFKeySet(gTiff, GTRasterTypeGeoKey, TYPE_SHORT, 1, RasterPixelIsArea);
 	GTIFKeySet(gTiff, GeographicTypeGeoKey, TYPE_SHORT, 1, GCS_WGS_84);
 	GTIFKeySet(gTiff, GeogAngularUnitsGeoKey, TYPE_SHORT, 1, Angular_Degree);
+	if (citation)
+		GTIFKeySet(gTiff, GTCitationGeoKey, TYPE_ASCII, 0, citation);
 	GTIFWriteKeys(gTiff);
 	GTIFFree(gTiff);
 #else
@@ -134,6 +171,323 @@ void tiffWriteGeoTag(TIFF* pTiff, double* ModelTiepoint, double* ModelPixelScale
 #endif
 }
 
+void tiffWriteCompression(TIFF* pTiff, int compression, int compressionLevel)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	if (!TIFFIsCODECConfigured((uint16) compression))
+		CV_Error(cv::Error::StsBadArg, "The compression scheme is not supported by libtiff");
+	TIFFSetField(pTiff, TIFFTAG_COMPRESSION, compression);
+	if (compressionLevel < 0)
+		return;
+	if (compression == COMPRESSION_ADOBE_DEFLATE || compression == COMPRESSION_DEFLATE)
+		TIFFSetField(pTiff, TIFFTAG_ZIPQUALITY, compressionLevel);
+#ifdef TIFFTAG_ZSTD_LEVEL
+	else if (compression == COMPRESSION_ZSTD)
+		TIFFSetField(pTiff, TIFFTAG_ZSTD_LEVEL, compressionLevel);
+#endif
+#else
+	throw_no_tiff();
+#endif
+}
+
+#ifdef EMGU_CV_WITH_TIFF
+//A file in memory, for the tiles encoded by libtiff on the worker threads
+struct TiffMemoryFile
+{
+	std::vector<unsigned char> data;
+	toff_t position;
+};
+
+static tmsize_t tiffMemoryRead(thandle_t handle, void* buffer, tmsize_t size)
+{
+	TiffMemoryFile* file = (TiffMemoryFile*) handle;
+	tmsize_t count = std::max((tmsize_t) 0, std::min(size, (tmsize_t) file->data.size() - (tmsize_t) file->position));
+	if (count > 0)
+		memcpy(buffer, file->data.data() + file->position, count);
+	file->position += count;
+	return count;
+}
+
+static tmsize_t tiffMemoryWrite(thandle_t handle, void* buffer, tmsize_t size)
+{
+	TiffMemoryFile* file = (TiffMemoryFile*) handle;
+	if (file->position + size > file->data.size())
+		file->data.resize((size_t) (file->position + size));
+	memcpy(file->data.data() + file->position, buffer, size);
+	file->position += size;
+	return size;
+}
+
+static toff_t tiffMemorySeek(thandle_t handle, toff_t offset, int whence)
+{
+	TiffMemoryFile* file = (TiffMemoryFile*) handle;
+	if (whence == SEEK_CUR)
+		offset += file->position;
+	else if (whence == SEEK_END)
+		offset += file->data.size();
+	file->position = offset;
+	return offset;
+}
+
+static int tiffMemoryClose(thandle_t handle)
+{
+	return 0;
+}
+
+static toff_t tiffMemorySize(thandle_t handle)
+{
+	return ((TiffMemoryFile*) handle)->data.size();
+}
+
+static int tiffMemoryMap(thandle_t handle, void** base, toff_t* size)
+{
+	return 0;
+}
+
+static void tiffMemoryUnmap(thandle_t handle, void* base, toff_t size)
+{
+}
+
+//Deflate is compressed with zlib, LZW and ZSTD are encoded by libtiff into a file in memory of each thread.
+//A TIFF handle can not be used by more than one thread, libtiff would encode the tiles of the file one by one.
+static bool tiffEncodeTilesInParallel(uint16 compression)
+{
+	return compression == COMPRESSION_ADOBE_DEFLATE || compression == COMPRESSION_DEFLATE || compression == COMPRESSION_LZW
+#ifdef COMPRESSION_ZSTD
+		|| compression == COMPRESSION_ZSTD
+#endif
+		;
+}
+
+//Each stripe prepares a contiguous run of the tiles of a batch, such that libtiff encodes the run with a single handle
+class TiffTileEncodeInvoker : public cv::ParallelLoopBody
+{
+public:
+	const cv::Mat* image;
+	cv::Size tileSize;
+	int tilesAcross;
+	int firstTile;
+	int count;
+	int stripes;
+	size_t tileBytes;
+	unsigned char* raw;
+	//if not null, the tiles are encoded into these buffers
+	std::vector<unsigned char>* encoded;
+	//one file in memory per stripe, kept between the batches
+	TiffMemoryFile* files;
+	uint16 compression;
+	int level;
+	uint16 bitsPerSample;
+	uint16 samplesPerPixel;
+	uint16 photometric;
+
+	void operator()(const cv::Range& stripeRange) const CV_OVERRIDE
+	{
+		for (int stripe = stripeRange.start; stripe < stripeRange.end; stripe++)
+		{
+			cv::Range range(count * stripe / stripes, count * (stripe + 1) / stripes);
+			if (range.start == range.end)
+				continue;
+			for (int i = range.start; i < range.end; i++)
+			{
+				int tile = firstTile + i;
+				tiffCopyTile(*image, (tile / tilesAcross) * tileSize.height, (tile % tilesAcross) * tileSize.width, tileSize, raw + i * tileBytes);
+			}
+			if (!encoded)
+				continue;
+			if (compression == COMPRESSION_ADOBE_DEFLATE || compression == COMPRESSION_DEFLATE)
+				deflate(range);
+			else
+				encode(range, files[stripe]);
+		}
+	}
+
+private:
+	void deflate(const cv::Range& range) const
+	{
+		uLong bound = compressBound((uLong) tileBytes);
+		for (int i = range.start; i < range.end; i++)
+		{
+			encoded[i].resize(bound);
+			uLongf sizeCompressed = bound;
+			if (compress2(encoded[i].data(), &sizeCompressed, raw + i * tileBytes, (uLong) tileBytes, level) != Z_OK)
+				CV_Error(cv::Error::StsError, "Failed to compress the tile");
+			encoded[i].resize(sizeCompressed);
+		}
+	}
+
+	//The tiles of the range are written one above the other in a file in memory, then copied out of it
+	void encode(const cv::Range& range, TiffMemoryFile& file) const
+	{
+		file.data.clear();
+		file.position = 0;
+		TIFF* encoder = TIFFClientOpen("tiles", "w", (thandle_t) &file,
+			tiffMemoryRead, tiffMemoryWrite, tiffMemorySeek, tiffMemoryClose, tiffMemorySize, tiffMemoryMap, tiffMemoryUnmap);
+		if (!encoder)
+			CV_Error(cv::Error::StsError, "Failed to create the tile encoder");
+		TIFFSetField(encoder, TIFFTAG_IMAGEWIDTH, tileSize.width);
+		TIFFSetField(encoder, TIFFTAG_IMAGELENGTH, tileSize.height * (range.end - range.start));
+		TIFFSetField(encoder, TIFFTAG_TILEWIDTH, tileSize.width);
+		TIFFSetField(encoder, TIFFTAG_TILELENGTH, tileSize.height);
+		TIFFSetField(encoder, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+		TIFFSetField(encoder, TIFFTAG_BITSPERSAMPLE, bitsPerSample);
+		TIFFSetField(encoder, TIFFTAG_SAMPLESPERPIXEL, samplesPerPixel);
+		TIFFSetField(encoder, TIFFTAG_PHOTOMETRIC, photometric);
+		TIFFSetField(encoder, TIFFTAG_COMPRESSION, compression);
+#ifdef TIFFTAG_ZSTD_LEVEL
+		if (compression == COMPRESSION_ZSTD && level >= 0)
+			TIFFSetField(encoder, TIFFTAG_ZSTD_LEVEL, level);
+#endif
+		bool ok = true;
+		for (int i = range.start; ok && i < range.end; i++)
+			ok = TIFFWriteEncodedTile(encoder, i - range.start, raw + i * tileBytes, tileBytes) >= 0;
+		for (int i = range.start; ok && i < range.end; i++)
+		{
+			toff_t offset = TIFFGetStrileOffset(encoder, i - range.start);
+			toff_t size = TIFFGetStrileByteCount(encoder, i - range.start);
+			ok = size > 0 && offset + size <= file.data.size();
+			if (ok)
+				encoded[i].assign(file.data.begin() + (size_t) offset, file.data.begin() + (size_t) (offset + size));
+		}
+		TIFFClose(encoder);
+		if (!ok)
+			CV_Error(cv::Error::StsError, "Failed to encode the tile");
+	}
+};
+
+static int tiffGetCompressionLevel(TIFF* pTiff, uint16 compression)
+{
+	int level = -1;
+	if (compression == COMPRESSION_ADOBE_DEFLATE || compression == COMPRESSION_DEFLATE)
+		TIFFGetField(pTiff, TIFFTAG_ZIPQUALITY, &level);
+#ifdef TIFFTAG_ZSTD_LEVEL
+	else if (compression == COMPRESSION_ZSTD)
+		TIFFGetField(pTiff, TIFFTAG_ZSTD_LEVEL, &level);
+#endif
+	return level;
+}
+
+//Write all the tiles of the image to the current directory. The buffers are reused between calls.
+static void tiffWriteTiles(TIFF* pTiff, const cv::Mat& image, std::vector<unsigned char>& rawBuffer, std::vector< std::vector<unsigned char> >& encodedBuffers)
+{
+	uint32 tileWidth = 0, tileHeight = 0;
+	uint16 compression = COMPRESSION_NONE, bitsPerSample = 8, samplesPerPixel = 1, photometric = PHOTOMETRIC_MINISBLACK;
+	TIFFGetField(pTiff, TIFFTAG_TILEWIDTH, &tileWidth);
+	TIFFGetField(pTiff, TIFFTAG_TILELENGTH, &tileHeight);
+	TIFFGetField(pTiff, TIFFTAG_COMPRESSION, &compression);
+	TIFFGetField(pTiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+	TIFFGetField(pTiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+	TIFFGetField(pTiff, TIFFTAG_PHOTOMETRIC, &photometric);
+	if (tileWidth == 0 || tileHeight == 0)
+		CV_Error(cv::Error::StsBadArg, "The tile size must be set before writing a tiled image");
+
+	//JPEG compressed YCbCr tiles are subsampled, let libtiff convert the RGB tiles such that it takes full tiles
+	if (compression == COMPRESSION_JPEG && photometric == PHOTOMETRIC_YCBCR)
+		TIFFSetField(pTiff, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+
+	cv::Size tileSize(tileWidth, tileHeight);
+	size_t tileBytes = (size_t) tileSize.area() * image.elemSize();
+	if (tileBytes != (size_t) TIFFTileSize(pTiff))
+		CV_Error(cv::Error::StsBadArg, "The image does not match the tile size, bits per sample and samples per pixel of the TIFF file");
+	int tilesAcross = (image.cols + tileSize.width - 1) / tileSize.width;
+	int tileCount = tilesAcross * ((image.rows + tileSize.height - 1) / tileSize.height);
+
+	bool parallel = tiffEncodeTilesInParallel(compression);
+	//a run of a few tiles per thread is prepared at a time, then written in order
+	int stripes = std::max(cv::getNumThreads(), 1);
+	int batchSize = std::min(tileCount, stripes * 8);
+	stripes = std::min(stripes, batchSize);
+	rawBuffer.resize(batchSize * tileBytes);
+	if (parallel && encodedBuffers.size() < (size_t) batchSize)
+		encodedBuffers.resize(batchSize);
+	std::vector<TiffMemoryFile> files(stripes);
+
+	TiffTileEncodeInvoker invoker;
+	invoker.image = &image;
+	invoker.tileSize = tileSize;
+	invoker.tilesAcross = tilesAcross;
+	invoker.tileBytes = tileBytes;
+	invoker.raw = rawBuffer.data();
+	invoker.encoded = parallel ? encodedBuffers.data() : 0;
+	invoker.files = files.data();
+	invoker.stripes = stripes;
+	invoker.compression = compression;
+	invoker.level = tiffGetCompressionLevel(pTiff, compression);
+	invoker.bitsPerSample = bitsPerSample;
+	invoker.samplesPerPixel = samplesPerPixel;
+	invoker.photometric = photometric;
+
+	for (int firstTile = 0; firstTile < tileCount; firstTile += batchSize)
+	{
+		int count = std::min(batchSize, tileCount - firstTile);
+		invoker.firstTile = firstTile;
+		invoker.count = count;
+		cv::parallel_for_(cv::Range(0, stripes), invoker, stripes);
+
+		for (int i = 0; i < count; i++)
+		{
+			tmsize_t written;
+			if (parallel)
+				written = TIFFWriteRawTile(pTiff, firstTile + i, invoker.encoded[i].data(), invoker.encoded[i].size());
+			else if (compression == COMPRESSION_NONE)
+				written = TIFFWriteRawTile(pTiff, firstTile + i, invoker.raw + i * tileBytes, tileBytes);
+			else
+				written = TIFFWriteEncodedTile(pTiff, firstTile + i, invoker.raw + i * tileBytes, tileBytes);
+			if (written < 0)
+				CV_Error(cv::Error::StsError, "Failed to write the tile");
+		}
+	}
+}
+#endif
+
+void tiffWriteTiledImage(TIFF* pTiff, IplImage* image, int overviewLevels)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	cv::Mat mat = cv::cvarrToMat(image);
+	CvSize imageSize = cvSize(mat.cols, mat.rows);
+	tiffWriteImageSize(pTiff, &imageSize);
+
+	std::vector<unsigned char> rawBuffer;
+	std::vector< std::vector<unsigned char> > encodedBuffers;
+	tiffWriteTiles(pTiff, mat, rawBuffer, encodedBuffers);
+
+	if (overviewLevels <= 0)
+		return;
+
+	uint16 bitsPerSample = 8, samplesPerPixel = 1, compression = COMPRESSION_NONE;
+	uint32 tileWidth = 0, tileHeight = 0;
+	TIFFGetField(pTiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+	TIFFGetField(pTiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+	TIFFGetField(pTiff, TIFFTAG_COMPRESSION, &compression);
+	TIFFGetField(pTiff, TIFFTAG_TILEWIDTH, &tileWidth);
+	TIFFGetField(pTiff, TIFFTAG_TILELENGTH, &tileHeight);
+	int compressionLevel = tiffGetCompressionLevel(pTiff, compression);
+	CvSize tileSize = cvSize(tileWidth, tileHeight);
+
+	//Each overview is reduced from the previous one and written as a reduced resolution image in the following directory.
+	//The last directory is written by tiffWriterClose
+	cv::Mat overview = mat;
+	for (int i = 0; i < overviewLevels && (overview.cols > (int) tileWidth || overview.rows > (int) tileHeight); i++)
+	{
+		cv::Mat reduced;
+		cv::resize(overview, reduced, cv::Size((overview.cols + 1) / 2, (overview.rows + 1) / 2), 0, 0, cv::INTER_AREA);
+		overview = reduced;
+
+		if (!TIFFWriteDirectory(pTiff))
+			CV_Error(cv::Error::StsError, "Failed to write the tiff directory");
+		TIFFSetField(pTiff, TIFFTAG_SUBFILETYPE, FILETYPE_REDUCEDIMAGE);
+		tiffWriteImageInfo(pTiff, bitsPerSample, samplesPerPixel);
+		tiffWriteCompression(pTiff, compression, compressionLevel);
+		tiffWriteTileInfo(pTiff, &tileSize);
+		imageSize = cvSize(overview.cols, overview.rows);
+		tiffWriteImageSize(pTiff, &imageSize);
+		tiffWriteTiles(pTiff, overview, rawBuffer, encodedBuffers);
+	}
+#else
+	throw_no_tiff();
+#endif
+}
+
 void tiffWriterClose(TIFF** pTiff)
 {
 #ifdef EMGU_CV_WITH_TIFF
@@ -145,3 +499,336 @@ void tiffWriterClose(TIFF** pTiff)
 #endif
 }
 
+#ifdef EMGU_CV_WITH_TIFF
+namespace emgu
+{
+	class TiffReader
+	{
+	public:
+		struct Level
+		{
+			int directory;
+			cv::Size imageSize;
+			//For stripped images, the width of the image by the rows per strip
+			cv::Size tileSize;
+			bool isTiled;
+		};
+
+		TIFF* tiff;
+		int type;
+		std::vector<Level> levels;
+
+		TiffReader(TIFF* tiff, int cacheSizeInTiles)
+			: tiff(tiff), type(-1), currentDirectory(-1), cacheSize(std::max(cacheSizeInTiles, 1))
+		{
+			int directory = 0;
+			do
+			{
+				uint32 subfileType = 0;
+				TIFFGetField(tiff, TIFFTAG_SUBFILETYPE, &subfileType);
+				if (directory == 0 || ((subfileType & FILETYPE_REDUCEDIMAGE) && !(subfileType & FILETYPE_MASK)))
+				{
+					if (directory == 0)
+						type = getType();
+					Level level;
+					level.directory = directory;
+					uint32 width = 0, height = 0;
+					TIFFGetField(tiff, TIFFTAG_IMAGEWIDTH, &width);
+					TIFFGetField(tiff, TIFFTAG_IMAGELENGTH, &height);
+					level.imageSize = cv::Size(width, height);
+					level.isTiled = TIFFIsTiled(tiff) != 0;
+					if (level.isTiled)
+					{
+						uint32 tileWidth = 0, tileHeight = 0;
+						TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &tileWidth);
+						TIFFGetField(tiff, TIFFTAG_TILELENGTH, &tileHeight);
+						level.tileSize = cv::Size(tileWidth, tileHeight);
+					}
+					else
+					{
+						uint32 rowsPerStrip = height;
+						TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+						level.tileSize = cv::Size(width, std::min(rowsPerStrip, height));
+					}
+					levels.push_back(level);
+				}
+				directory++;
+			} while (TIFFReadDirectory(tiff));
+			currentDirectory = directory - 1;
+		}
+
+		~TiffReader()
+		{
+			XTIFFClose(tiff);
+		}
+
+		void setDirectory(int directory)
+		{
+			if (directory == currentDirectory)
+				return;
+			if (!TIFFSetDirectory(tiff, (uint16) directory))
+				CV_Error(cv::Error::StsError, "Failed to read the tiff directory");
+			currentDirectory = directory;
+
+			//let libtiff convert JPEG compressed YCbCr tiles to RGB
+			uint16 compression = COMPRESSION_NONE, photometric = 0;
+			TIFFGetField(tiff, TIFFTAG_COMPRESSION, &compression);
+			TIFFGetField(tiff, TIFFTAG_PHOTOMETRIC, &photometric);
+			if (compression == COMPRESSION_JPEG && photometric == PHOTOMETRIC_YCBCR)
+				TIFFSetField(tiff, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+		}
+
+		void read(int level, const cv::Rect& roi, cv::Mat& dst)
+		{
+			CV_Assert(level >= 0 && level < (int) levels.size());
+			const Level& l = levels[level];
+			CV_Assert(roi.width > 0 && roi.height > 0 && (roi & cv::Rect(cv::Point(0, 0), l.imageSize)) == roi);
+
+			dst.create(roi.size(), type);
+			size_t elemSize = dst.elemSize();
+			size_t tileStride = l.tileSize.width * elemSize;
+			int tilesAcross = (l.imageSize.width + l.tileSize.width - 1) / l.tileSize.width;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			for (int ty = roi.y / l.tileSize.height; ty <= (roi.y + roi.height - 1) / l.tileSize.height; ty++)
+			{
+				for (int tx = roi.x / l.tileSize.width; tx <= (roi.x + roi.width - 1) / l.tileSize.width; tx++)
+				{
+					const unsigned char* tile = getTile(level, ty * tilesAcross + tx);
+					cv::Rect tileRect(tx * l.tileSize.width, ty * l.tileSize.height, l.tileSize.width, l.tileSize.height);
+					cv::Rect r = tileRect & roi;
+					for (int y = r.y; y < r.y + r.height; y++)
+						memcpy(
+							dst.ptr(y - roi.y, r.x - roi.x),
+							tile + (y - tileRect.y) * tileStride + (r.x - tileRect.x) * elemSize,
+							r.width * elemSize);
+				}
+			}
+		}
+
+		std::mutex mutex;
+
+	private:
+		int currentDirectory;
+		int cacheSize;
+		//The keys of the cached tiles, the most recently used first
+		std::list<uint64> lru;
+		std::unordered_map<uint64, std::pair<std::vector<unsigned char>, std::list<uint64>::iterator> > cache;
+
+		int getType()
+		{
+			uint16 bitsPerSample = 1, samplesPerPixel = 1, sampleFormat = SAMPLEFORMAT_UINT, planarConfig = PLANARCONFIG_CONTIG;
+			TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+			TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+			TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
+			TIFFGetFieldDefaulted(tiff, TIFFTAG_PLANARCONFIG, &planarConfig);
+			if (samplesPerPixel > 1 && planarConfig != PLANARCONFIG_CONTIG)
+				CV_Error(cv::Error::StsNotImplemented, "Only tiff with interleaved samples is supported");
+
+			int depth = -1;
+			if (sampleFormat == SAMPLEFORMAT_IEEEFP)
+				depth = bitsPerSample == 32 ? CV_32F : bitsPerSample == 64 ? CV_64F : -1;
+			else if (sampleFormat == SAMPLEFORMAT_INT)
+				depth = bitsPerSample == 8 ? CV_8S : bitsPerSample == 16 ? CV_16S : bitsPerSample == 32 ? CV_32S : -1;
+			else if (sampleFormat == SAMPLEFORMAT_UINT)
+				depth = bitsPerSample == 8 ? CV_8U : bitsPerSample == 16 ? CV_16U : -1;
+			if (depth < 0)
+				CV_Error(cv::Error::StsNotImplemented, "The sample format of the tiff is not supported");
+			return CV_MAKETYPE(depth, samplesPerPixel);
+		}
+
+		//Returns the decoded tile, which is valid until the next call
+		const unsigned char* getTile(int level, int tile)
+		{
+			uint64 key = ((uint64) level << 32) | (uint32) tile;
+			auto cached = cache.find(key);
+			if (cached != cache.end())
+			{
+				lru.splice(lru.begin(), lru, cached->second.second);
+				return cached->second.first.data();
+			}
+
+			//reuse the buffer of the least recently used tile
+			std::vector<unsigned char> buffer;
+			if ((int) cache.size() >= cacheSize)
+			{
+				auto oldest = cache.find(lru.back());
+				buffer.swap(oldest->second.first);
+				cache.erase(oldest);
+				lru.pop_back();
+			}
+
+			const Level& l = levels[level];
+			setDirectory(l.directory);
+			tmsize_t size = l.isTiled ? TIFFTileSize(tiff) : TIFFStripSize(tiff);
+			buffer.resize(size);
+			tmsize_t decoded = l.isTiled
+				? TIFFReadEncodedTile(tiff, tile, buffer.data(), size)
+				: TIFFReadEncodedStrip(tiff, tile, buffer.data(), size);
+			if (decoded < 0)
+				CV_Error(cv::Error::StsError, "Failed to decode the tiff tile");
+
+			lru.push_front(key);
+			std::pair<std::vector<unsigned char>, std::list<uint64>::iterator>& entry = cache[key];
+			entry.first.swap(buffer);
+			entry.second = lru.begin();
+			return entry.first.data();
+		}
+	};
+}
+#endif
+
+emgu::TiffReader* tiffReaderOpen(char* fileName, int cacheSizeInTiles)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	//libtiff memory maps files opened for reading
+	TIFF* tiff = XTIFFOpen(fileName, "r");
+	if (!tiff)
+		CV_Error(cv::Error::StsError, "Failed to open the tiff file");
+	try
+	{
+		return new emgu::TiffReader(tiff, cacheSizeInTiles);
+	}
+	catch (...)
+	{
+		XTIFFClose(tiff);
+		throw;
+	}
+#else
+	throw_no_tiff();
+#endif
+}
+
+void tiffReaderRelease(emgu::TiffReader** reader)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	delete *reader;
+	*reader = 0;
+#else
+	throw_no_tiff();
+#endif
+}
+
+int tiffReaderGetLevelCount(emgu::TiffReader* reader)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	return (int) reader->levels.size();
+#else
+	throw_no_tiff();
+#endif
+}
+
+void tiffReaderGetLevelInfo(emgu::TiffReader* reader, int level, CvSize* imageSize, CvSize* tileSize, bool* isTiled)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	CV_Assert(level >= 0 && level < (int) reader->levels.size());
+	const emgu::TiffReader::Level& l = reader->levels[level];
+	*imageSize = cvSize(l.imageSize.width, l.imageSize.height);
+	*tileSize = cvSize(l.tileSize.width, l.tileSize.height);
+	*isTiled = l.isTiled;
+#else
+	throw_no_tiff();
+#endif
+}
+
+int tiffReaderGetType(emgu::TiffReader* reader)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	return reader->type;
+#else
+	throw_no_tiff();
+#endif
+}
+
+void tiffReaderRead(emgu::TiffReader* reader, int level, CvRect* roi, cv::_OutputArray* dst)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	cv::Rect r(roi->x, roi->y, roi->width, roi->height);
+	if (dst->kind() == cv::_InputArray::MAT)
+	{
+		//decode straight into the caller's Mat
+		cv::Mat& m = dst->getMatRef();
+		reader->read(level, r, m);
+	}
+	else
+	{
+		cv::Mat m;
+		reader->read(level, r, m);
+		m.copyTo(*dst);
+	}
+#else
+	throw_no_tiff();
+#endif
+}
+
+bool tiffReaderGetGeoTag(emgu::TiffReader* reader, double* modelTiepoint, double* modelPixelScale)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	std::lock_guard<std::mutex> lock(reader->mutex);
+	reader->setDirectory(0);
+	uint16 tiepointCount = 0, pixelScaleCount = 0;
+	double* tiepoint = 0;
+	double* pixelScale = 0;
+	if (!TIFFGetField(reader->tiff, GTIFF_TIEPOINTS, &tiepointCount, &tiepoint) || tiepointCount < 6
+		|| !TIFFGetField(reader->tiff, GTIFF_PIXELSCALE, &pixelScaleCount, &pixelScale) || pixelScaleCount < 3)
+		return false;
+	memcpy(modelTiepoint, tiepoint, 6 * sizeof(double));
+	memcpy(modelPixelScale, pixelScale, 3 * sizeof(double));
+	return true;
+#else
+	throw_no_tiff();
+#endif
+}
+
+bool tiffReaderGetGeoKey(emgu::TiffReader* reader, int key, double* value)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	std::lock_guard<std::mutex> lock(reader->mutex);
+	reader->setDirectory(0);
+	GTIF* gTiff = GTIFNew(reader->tiff);
+	int size = 0;
+	tagtype_t type;
+	bool found = false;
+	if (GTIFKeyInfo(gTiff, (geokey_t) key, &size, &type) > 0)
+	{
+		if (type == TYPE_SHORT)
+		{
+			unsigned short v = 0;
+			found = GTIFKeyGet(gTiff, (geokey_t) key, &v, 0, 1) > 0;
+			*value = v;
+		}
+		else if (type == TYPE_DOUBLE)
+		{
+			found = GTIFKeyGet(gTiff, (geokey_t) key, value, 0, 1) > 0;
+		}
+	}
+	GTIFFree(gTiff);
+	return found;
+#else
+	throw_no_tiff();
+#endif
+}
+
+bool tiffReaderGetGeoKeyString(emgu::TiffReader* reader, int key, cv::String* value)
+{
+#ifdef EMGU_CV_WITH_TIFF
+	std::lock_guard<std::mutex> lock(reader->mutex);
+	reader->setDirectory(0);
+	GTIF* gTiff = GTIFNew(reader->tiff);
+	int size = 0;
+	tagtype_t type;
+	bool found = false;
+	int count = GTIFKeyInfo(gTiff, (geokey_t) key, &size, &type);
+	if (count > 0 && type == TYPE_ASCII)
+	{
+		std::vector<char> buffer(count + 1, 0);
+		found = GTIFKeyGet(gTiff, (geokey_t) key, buffer.data(), 0, count) > 0;
+		if (found)
+			*value = cv::String(buffer.data());
+	}
+	GTIFFree(gTiff);
+	return found;
+#else
+	throw_no_tiff();
+#endif
+}
@@ -17,6 +17,7 @@
 #include "geo_tiffp.h"
 #include "geotiffio.h" //writing geotiff
 #include "xtiffio.h"
+#include "zlib.h"
 #else
 #define TIFF void
 static inline CV_NORETURN void throw_no_tiff() { CV_Error(cv::Error::StsBadFunc, "cvextern is compiled without tiff support"); }
@@ -24,6 +25,9 @@ static inline CV_NORETURN void throw_no_tiff() { CV_Error(cv::Error::StsBadFunc,
 
 CVAPI(TIFF*) tiffWriterOpen(char* fileName);
 
+//Open the file for writing, if bigTiff is true, the file is written in BigTIFF format which allows files larger than 4GB
+CVAPI(TIFF*) tiffWriterOpen2(char* fileName, bool bigTiff);
+
 CVAPI(int) tiffTileRowSize(TIFF* pTiff);
 
 CVAPI(int) tiffTileSize(TIFF* pTiff);
@@ -38,9 +42,55 @@ CVAPI(void) tiffWriteTile(TIFF* pTiff, int row, int col, IplImage* tileImage);
 
 CVAPI(void) tiffWriteTileInfo(TIFF* pTiff, CvSize* tileSize);
 
+//Set the compression scheme (one of the COMPRESSION_* values) and the compression level for Deflate and ZSTD, -1 for the default level
+CVAPI(void) tiffWriteCompression(TIFF* pTiff, int compression, int compressionLevel);
+
+/*
+ * Write the whole image as tiles, using the tile size and compression of the current directory. 
+ * Uncompressed, Deflate, LZW and ZSTD tiles are prepared in parallel and written in order with reused buffers, other codecs (e.g. JPEG) are encoded by libtiff one tile at a time.
+ * If overviewLevels > 0, up to overviewLevels reduced resolution images, each half the size of the previous one, are written in their own directories.
+ * The geo tags must be written before this call, they are attached to the full resolution image.
+ */
+CVAPI(void) tiffWriteTiledImage(TIFF* pTiff, IplImage* image, int overviewLevels);
+
 CVAPI(void) tiffWriterClose(TIFF** pTiff);
 
-CVAPI(void) tiffWriteGeoTag(TIFF* pTiff, double* ModelTiepoint, double* ModelPixelScale);
+//If citation is not null, it is written as the GTCitationGeoKey
+CVAPI(void) tiffWriteGeoTag(TIFF* pTiff, double* ModelTiepoint, double* ModelPixelScale, const char* citation);
+
+/*
+ * Windowed reader. Only the tiles (or strips) that intersect the requested region are decoded, 
+ * the decoded tiles are kept in a LRU cache such that panning over a large image does not decode them again.
+ * Level 0 is the full resolution image, the following levels are the reduced resolution images (overviews) of the file.
+ */
+namespace emgu
+{
+   class TiffReader;
+}
+
+CVAPI(emgu::TiffReader*) tiffReaderOpen(char* fileName, int cacheSizeInTiles);
+
+CVAPI(void) tiffReaderRelease(emgu::TiffReader** reader);
+
+CVAPI(int) tiffReaderGetLevelCount(emgu::TiffReader* reader);
+
+//If the level is stored in strips, tileSize is the width of the image by the rows per strip and isTiled is false
+CVAPI(void) tiffReaderGetLevelInfo(emgu::TiffReader* reader, int level, CvSize* imageSize, CvSize* tileSize, bool* isTiled);
+
+//The OpenCV type (depth and channels) of the pixels
+CVAPI(int) tiffReaderGetType(emgu::TiffReader* reader);
+
+//Decode the region of the level into dst, the channels are in the order stored in the file (usually RGB)
+CVAPI(void) tiffReaderRead(emgu::TiffReader* reader, int level, CvRect* roi, cv::_OutputArray* dst);
+
+//Returns false if the file has no model tie point / pixel scale
+CVAPI(bool) tiffReaderGetGeoTag(emgu::TiffReader* reader, double* modelTiepoint, double* modelPixelScale);
+
+//Returns false if the geo key does not exist, short and double keys are returned as double
+CVAPI(bool) tiffReaderGetGeoKey(emgu::TiffReader* reader, int key, double* value);
+
+//Returns false if the geo key does not exist or is not an ascii key
+CVAPI(bool) tiffReaderGetGeoKeyString(emgu::TiffReader* reader, int key, cv::String* value);
 
 #endif
 
@@ -6,6 +6,66 @@
 
 #include "vectors_c.h"
 
+emgu::VectorArena::VectorArena()
+   : inUseCount(0)
+{
+}
+
+emgu::VectorArena::~VectorArena()
+{
+   release();
+}
+
+void emgu::VectorArena::reset()
+{
+   for (size_t i = 0; i < pools.size(); i++)
+      pools[i].pool->reset();
+   inUseCount = 0;
+}
+
+void emgu::VectorArena::release()
+{
+   for (size_t i = 0; i < pools.size(); i++)
+      delete pools[i].pool;
+   pools.clear();
+   inUseCount = 0;
+}
+
+int emgu::VectorArena::getRetainedCount() const
+{
+   size_t count = 0;
+   for (size_t i = 0; i < pools.size(); i++)
+      count += pools[i].pool->retained();
+   return static_cast<int>(count);
+}
+
+emgu::VectorArena* cveVectorArenaCreate()
+{
+   return new emgu::VectorArena();
+}
+
+void cveVectorArenaReset(emgu::VectorArena* arena)
+{
+   arena->reset();
+}
+
+void cveVectorArenaClear(emgu::VectorArena* arena)
+{
+   arena->release();
+}
+
+void cveVectorArenaGetStats(emgu::VectorArena* arena, int* inUse, int* retained)
+{
+   *inUse = arena->getInUseCount();
+   *retained = arena->getRetainedCount();
+}
+
+void cveVectorArenaRelease(emgu::VectorArena** arena)
+{
+   delete *arena;
+   *arena = 0;
+}
+
 void VectorOfDMatchPushMatrix(std::vector<cv::DMatch>* matches, const CvMat* trainIdx, const CvMat* distances, const CvMat* mask)
 {
 	CV_Assert(trainIdx->step == trainIdx->cols * sizeof(int));
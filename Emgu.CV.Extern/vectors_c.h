@@ -8,6 +8,8 @@
 #ifndef EMGU_VECTORS_C_H
 #define EMGU_VECTORS_C_H
 
+#include <deque>
+#include <type_traits>
 #include <vector>
 
 #include "opencv2/opencv_modules.hpp"
@@ -87,6 +89,109 @@ void VectorCopyData(std::vector<dataType>* v, dataType* data)
       memcpy(data, &(*v)[0], v->size() * sizeof(dataType));
 }
 
+namespace emgu
+{
+   /*
+    * Owns the std::vector objects created for a frame. reset() clears all the vectors and keeps them,
+    * together with their storage, for the next frame, so that after the first few frames creating a
+    * vector from the arena does not allocate. The vectors created from the arena must not be released
+    * individually and must not be used after reset(). Not thread safe.
+    */
+   class CV_EXPORTS VectorArena
+   {
+   public:
+      VectorArena();
+      ~VectorArena();
+
+      template<typename T>
+      std::vector<T>* create(int size)
+      {
+         Pool<T>* pool = getPool<T>();
+         if (pool->inUse == pool->items.size())
+            pool->items.push_back(std::vector<T>());
+         std::vector<T>* v = &pool->items[pool->inUse++];
+         if (size > 0)
+            v->resize(size);
+         inUseCount++;
+         return v;
+      }
+
+      //Clear all the vectors, they are recycled by the next calls to create
+      void reset();
+
+      //Free all the vectors and their storage
+      void release();
+
+      int getInUseCount() const { return inUseCount; }
+      int getRetainedCount() const;
+
+   private:
+      struct PoolBase
+      {
+         size_t inUse;
+         PoolBase() : inUse(0) {}
+         virtual ~PoolBase() {}
+         virtual void reset() = 0;
+         virtual size_t retained() const = 0;
+      };
+
+      template<typename T>
+      struct Pool : public PoolBase
+      {
+         //deque keeps the address of the vectors stable when it grows
+         std::deque< std::vector<T> > items;
+
+         virtual void reset()
+         {
+            for (size_t i = 0; i < inUse; i++)
+               items[i].clear();
+            inUse = 0;
+         }
+
+         virtual size_t retained() const { return items.size(); }
+      };
+
+      struct PoolEntry
+      {
+         const void* key;
+         PoolBase* pool;
+      };
+
+      template<typename T>
+      static const void* typeKey()
+      {
+         static const char key = 0;
+         return &key;
+      }
+
+      template<typename T>
+      Pool<T>* getPool()
+      {
+         const void* key = typeKey<T>();
+         for (size_t i = 0; i < pools.size(); i++)
+            if (pools[i].key == key)
+               return static_cast<Pool<T>*>(pools[i].pool);
+         PoolEntry entry;
+         entry.key = key;
+         entry.pool = new Pool<T>();
+         pools.push_back(entry);
+         return static_cast<Pool<T>*>(entry.pool);
+      }
+
+      std::vector<PoolEntry> pools;
+      int inUseCount;
+
+      VectorArena(const VectorArena&);
+      VectorArena& operator=(const VectorArena&);
+   };
+}
+
+CVAPI(emgu::VectorArena*) cveVectorArenaCreate();
+CVAPI(void) cveVectorArenaReset(emgu::VectorArena* arena);
+CVAPI(void) cveVectorArenaClear(emgu::VectorArena* arena);
+CVAPI(void) cveVectorArenaGetStats(emgu::VectorArena* arena, int* inUse, int* retained);
+CVAPI(void) cveVectorArenaRelease(emgu::VectorArena** arena);
+
 //----------------------------------------------------------------------------
 //
 //  Vector of DMatch
@@ -5,48 +5,352 @@
 //----------------------------------------------------------------------------
 
 #include "videoio_c_extra.h"
+#include "sse.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
-void OpenniGetColorPoints(CvCapture* capture, std::vector<ColorPoint>* points, IplImage* maskImg)
+#if EMGU_AVX2
+//For every 8 bit selection, the positions of its set bits in increasing order (the unused positions are 0) and their count
+struct ColorPointsCompactTable
 {
-#ifdef HAVE_OPENCV_VIDEOIO
-	IplImage* pcm = cvRetrieveFrame(capture, CV_CAP_OPENNI_POINT_CLOUD_MAP); //XYZ in meters (CV_32FC3)
-	IplImage* bgr = cvRetrieveFrame(capture, CV_CAP_OPENNI_BGR_IMAGE); //CV_8UC3
+	uint64 positions[256];
+	uchar counts[256];
+
+	ColorPointsCompactTable()
+	{
+		for (int bits = 0; bits < 256; bits++)
+		{
+			uchar p[8] = { 0 };
+			int n = 0;
+			for (int i = 0; i < 8; i++)
+				if (bits & (1 << i))
+					p[n++] = (uchar) i;
+			memcpy(&positions[bits], p, sizeof(p));
+			counts[bits] = (uchar) n;
+		}
+	}
+};
+static const ColorPointsCompactTable colorPointsCompactTable;
+
+//Select bytes 0 - 23 from lo (0 - 15) and hi (16 - 23), an index of 0xFF gives 0
+EMGU_TARGET_AVX2 static inline __m128i colorPointsShuffle24(__m128i lo, __m128i hi, __m128i idx)
+{
+	__m128i fromLo = _mm_or_si128(idx, _mm_cmpgt_epi8(idx, _mm_set1_epi8(15)));
+	__m128i fromHi = _mm_sub_epi8(idx, _mm_set1_epi8(16));
+	return _mm_or_si128(_mm_shuffle_epi8(lo, fromLo), _mm_shuffle_epi8(hi, fromHi));
+}
 
-	int ptCount = pcm->width * pcm->height;
-	CvPoint3D32f* position = (CvPoint3D32f*)pcm->imageData;
-	unsigned char* color = (unsigned char*)bgr->imageData;
+//Move the points of a block of 8 that are selected by bits to the first lanes. The coordinates are gathered with the positions from
+//the table, the colors are shuffled out of the 24 bytes of the block and packed as b | g << 8 | r << 16 in 32 bit lanes
+EMGU_TARGET_AVX2 static inline void colorPointsCompact8(const float* xyz, const uchar* bgr, int bits, __m256& x, __m256& y, __m256& z, __m256i& color)
+{
+	__m128i positions = _mm_loadl_epi64((const __m128i*) &colorPointsCompactTable.positions[bits]);
+	__m256i idx = _mm256_cvtepu8_epi32(positions);
+	idx = _mm256_add_epi32(idx, _mm256_add_epi32(idx, idx));
+	x = _mm256_i32gather_ps(xyz, idx, 4);
+	y = _mm256_i32gather_ps(xyz + 1, idx, 4);
+	z = _mm256_i32gather_ps(xyz + 2, idx, 4);
+
+	__m128i positions3 = _mm_add_epi8(positions, _mm_add_epi8(positions, positions));
+	const __m128i channel = _mm_setr_epi8(0, 1, 2, -1, 0, 1, 2, -1, 0, 1, 2, -1, 0, 1, 2, -1);
+	__m128i idx0 = _mm_or_si128(_mm_add_epi8(_mm_shuffle_epi8(positions3, _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3)), channel), _mm_cmpeq_epi8(channel, _mm_set1_epi8(-1)));
+	__m128i idx1 = _mm_or_si128(_mm_add_epi8(_mm_shuffle_epi8(positions3, _mm_setr_epi8(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7)), channel), _mm_cmpeq_epi8(channel, _mm_set1_epi8(-1)));
+	__m128i lo = _mm_loadu_si128((const __m128i*) bgr);
+	__m128i hi = _mm_loadl_epi64((const __m128i*) (bgr + 16));
+	color = _mm256_inserti128_si256(_mm256_castsi128_si256(colorPointsShuffle24(lo, hi, idx0)), colorPointsShuffle24(lo, hi, idx1), 1);
+}
+#endif
 
-	//int colorIdx = 0;
-	ColorPoint cp;
-	if (maskImg)
+//Writes the points into an array of ColorPoint
+struct ColorPointWriter
+{
+	ColorPoint* dst;
+
+	void put(int idx, const float* xyz, const uchar* bgr) const
 	{
-		unsigned char* mask = (unsigned char*)maskImg->imageData;
-		for (int i = 0; i < ptCount; i++, mask++, position++, color += 3)
-			if (*mask)
-			{
-				memcpy(&cp.position, position, sizeof(CvPoint3D32f));
-				cp.blue = *color;
-				cp.green = *(color + 1);
-				cp.red = *(color + 2);
-				//memcpy(&cp.red, color, 3);
-				points->push_back(cp);
+		ColorPoint& cp = dst[idx];
+		cp.position.x = xyz[0];
+		cp.position.y = xyz[1];
+		cp.position.z = xyz[2];
+		cp.blue = bgr[0];
+		cp.green = bgr[1];
+		cp.red = bgr[2];
+	}
 
-			}
+	void putRange(int idx, const float* xyz, const uchar* bgr, int count) const
+	{
+		for (int i = 0; i < count; i++, xyz += 3, bgr += 3)
+			put(idx + i, xyz, bgr);
 	}
-	else
+
+#if EMGU_AVX2
+	//Transpose the compacted lanes into 16 byte records and store the first count of them
+	EMGU_TARGET_AVX2 void putCompact8(int idx, __m256 x, __m256 y, __m256 z, __m256i color, int count) const
+	{
+		static_assert(sizeof(ColorPoint) == 16, "ColorPoint is expected to be 16 bytes");
+		__m256 c = _mm256_castsi256_ps(color);
+		__m256 xy0 = _mm256_unpacklo_ps(x, y), xy1 = _mm256_unpackhi_ps(x, y);
+		__m256 zc0 = _mm256_unpacklo_ps(z, c), zc1 = _mm256_unpackhi_ps(z, c);
+		__m256 records[4] = {
+			_mm256_shuffle_ps(xy0, zc0, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xy0, zc0, _MM_SHUFFLE(3, 2, 3, 2)),
+			_mm256_shuffle_ps(xy1, zc1, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xy1, zc1, _MM_SHUFFLE(3, 2, 3, 2)) };
+		float* d = (float*) (dst + idx);
+		for (int i = 0; i < count; i++, d += 4)
+			_mm_storeu_ps(d, i < 4 ? _mm256_castps256_ps128(records[i]) : _mm256_extractf128_ps(records[i - 4], 1));
+	}
+#endif
+};
+
+//Writes the points into separated coordinate and color arrays
+struct ColorPointSoAWriter
+{
+	ColorPointsSoA dst;
+
+	void put(int idx, const float* xyz, const uchar* bgr) const
+	{
+		dst.x[idx] = xyz[0];
+		dst.y[idx] = xyz[1];
+		dst.z[idx] = xyz[2];
+		dst.blue[idx] = bgr[0];
+		dst.green[idx] = bgr[1];
+		dst.red[idx] = bgr[2];
+	}
+
+	void putRange(int idx, const float* xyz, const uchar* bgr, int count) const
 	{
-		for (int i = 0; i < ptCount; i++, position++, color += 3)
+		float* x = dst.x + idx;
+		float* y = dst.y + idx;
+		float* z = dst.z + idx;
+		uchar* b = dst.blue + idx;
+		uchar* g = dst.green + idx;
+		uchar* r = dst.red + idx;
+		for (int i = 0; i < count; i++)
 		{
-			memcpy(&cp.position, position, sizeof(CvPoint3D32f));
-			cp.blue = *color;
-			cp.green = *(color + 1);
-			cp.red = *(color + 2);
-			//memcpy(&cp.red, color, 3);
-			points->push_back(cp);
+			x[i] = xyz[i * 3];
+			y[i] = xyz[i * 3 + 1];
+			z[i] = xyz[i * 3 + 2];
+			b[i] = bgr[i * 3];
+			g[i] = bgr[i * 3 + 1];
+			r[i] = bgr[i * 3 + 2];
+		}
+	}
+
+#if EMGU_AVX2
+	//Store the first count lanes, the masked stores and the copies never touch the points of the following rows
+	EMGU_TARGET_AVX2 void putCompact8(int idx, __m256 x, __m256 y, __m256 z, __m256i color, int count) const
+	{
+		__m256i lanes = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		_mm256_maskstore_ps(dst.x + idx, lanes, x);
+		_mm256_maskstore_ps(dst.y + idx, lanes, y);
+		_mm256_maskstore_ps(dst.z + idx, lanes, z);
+
+		//b0-3 g0-3 r0-3 in each 128 bit lane, then b0-7 g0-7 r0-7
+		__m256i bgr = _mm256_shuffle_epi8(color, _mm256_setr_epi8(
+			0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, -1, -1, -1, -1,
+			0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, -1, -1, -1, -1));
+		bgr = _mm256_permutevar8x32_epi32(bgr, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+		uchar channels[32];
+		_mm256_storeu_si256((__m256i*) channels, bgr);
+		memcpy(dst.blue + idx, channels, count);
+		memcpy(dst.green + idx, channels + 8, count);
+		memcpy(dst.red + idx, channels + 16, count);
+	}
+#endif
+};
 
+#if EMGU_AVX2
+//Writes the selected points of the first columns of a row in blocks of 16, the blocks where only some points are selected are compacted
+//8 points at a time. Returns the number of columns processed
+template<typename Writer>
+EMGU_TARGET_AVX2 static int colorPointsRowAvx2(const Writer& writer, int& out, const float* xyz, const uchar* bgr, const uchar* mask, int cols)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int x = 0;
+	for (; x <= cols - 16; x += 16)
+	{
+		int selected = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (mask + x)), zero)) & 0xFFFF;
+		if (selected == 0)
+			continue;
+		if (selected == 0xFFFF)
+		{
+			writer.putRange(out, xyz + x * 3, bgr + x * 3, 16);
+			out += 16;
+			continue;
+		}
+		for (int half = 0; half < 16; half += 8)
+		{
+			int bits = (selected >> half) & 0xFF;
+			if (bits == 0)
+				continue;
+			int count = colorPointsCompactTable.counts[bits];
+			__m256 px, py, pz;
+			__m256i color;
+			colorPointsCompact8(xyz + (x + half) * 3, bgr + (x + half) * 3, bits, px, py, pz, color);
+			writer.putCompact8(out, px, py, pz, color, count);
+			out += count;
 		}
 	}
+	return x;
+}
+#endif
+
+//Each row writes its points starting from its offset in the exclusive prefix sum of the per row counts
+template<typename Writer>
+class ColorPointsInvoker : public cv::ParallelLoopBody
+{
+public:
+	ColorPointsInvoker(const cv::Mat& pointCloud, const cv::Mat& bgr, const cv::Mat& mask, const std::vector<int>& offsets, const Writer& writer)
+		: _pointCloud(pointCloud), _bgr(bgr), _mask(mask), _offsets(offsets), _writer(writer)
+	{
+	}
+
+	virtual void operator()(const cv::Range& range) const
+	{
+		int cols = _pointCloud.cols;
+		for (int row = range.start; row < range.end; row++)
+		{
+			const float* xyz = _pointCloud.ptr<float>(row);
+			const uchar* bgr = _bgr.ptr<uchar>(row);
+			int out = _offsets[row];
+			if (_mask.empty())
+			{
+				_writer.putRange(out, xyz, bgr, cols);
+				continue;
+			}
+
+			const uchar* mask = _mask.ptr<uchar>(row);
+			int x = 0;
+#if EMGU_AVX2
+			if (simdAVX2)
+				x = colorPointsRowAvx2(_writer, out, xyz, bgr, mask, cols);
+#endif
+			for (; x < cols; x++)
+				if (mask[x])
+					_writer.put(out++, xyz + x * 3, bgr + x * 3);
+		}
+	}
+
+private:
+	const cv::Mat& _pointCloud;
+	const cv::Mat& _bgr;
+	const cv::Mat& _mask;
+	const std::vector<int>& _offsets;
+	Writer _writer;
+};
+
+class ColorPointsCountInvoker : public cv::ParallelLoopBody
+{
+public:
+	ColorPointsCountInvoker(const cv::Mat& mask, std::vector<int>& counts)
+		: _mask(mask), _counts(counts)
+	{
+	}
+
+	virtual void operator()(const cv::Range& range) const
+	{
+		for (int row = range.start; row < range.end; row++)
+			_counts[row + 1] = cv::countNonZero(_mask.row(row));
+	}
+
+private:
+	const cv::Mat& _mask;
+	std::vector<int>& _counts;
+};
+
+//Count the selected points of every row, offsets receives the exclusive prefix sum (rows + 1 values)
+static int colorPointsOffsets(const cv::Mat& pointCloud, const cv::Mat& bgr, const cv::Mat& mask, std::vector<int>& offsets)
+{
+	CV_Assert(pointCloud.type() == CV_32FC3 && bgr.type() == CV_8UC3 && pointCloud.size() == bgr.size());
+	CV_Assert(mask.empty() || (mask.type() == CV_8UC1 && mask.size() == pointCloud.size()));
+
+	offsets.resize(pointCloud.rows + 1);
+	if (mask.empty())
+	{
+		for (int row = 0; row <= pointCloud.rows; row++)
+			offsets[row] = row * pointCloud.cols;
+	}
+	else
+	{
+		offsets[0] = 0;
+		cv::parallel_for_(cv::Range(0, mask.rows), ColorPointsCountInvoker(mask, offsets));
+		for (int row = 0; row < mask.rows; row++)
+			offsets[row + 1] += offsets[row];
+	}
+	return offsets.back();
+}
+
+template<typename Writer>
+static void colorPointsWrite(const cv::Mat& pointCloud, const cv::Mat& bgr, const cv::Mat& mask, const std::vector<int>& offsets, const Writer& writer)
+{
+	cv::parallel_for_(
+		cv::Range(0, pointCloud.rows),
+		ColorPointsInvoker<Writer>(pointCloud, bgr, mask, offsets, writer),
+		//roughly 64K points per stripe
+		std::max(1.0, static_cast<double>(pointCloud.total()) / (1 << 16)));
+}
+
+int cveGetColorPoints(cv::_InputArray* pointCloud, cv::_InputArray* bgr, cv::_InputArray* mask, ColorPoint* points, int capacity)
+{
+	cv::Mat pcm = pointCloud->getMat();
+	cv::Mat color = bgr->getMat();
+	cv::Mat maskMat = mask ? mask->getMat() : cv::Mat();
+
+	std::vector<int> offsets;
+	int count = colorPointsOffsets(pcm, color, maskMat, offsets);
+	if (points && count > 0)
+	{
+		if (capacity < count)
+			CV_Error(cv::Error::StsOutOfRange, "The capacity of the output buffer is smaller than the number of points");
+		ColorPointWriter writer = { points };
+		colorPointsWrite(pcm, color, maskMat, offsets, writer);
+	}
+	return count;
+}
+
+int cveGetColorPointsSoA(cv::_InputArray* pointCloud, cv::_InputArray* bgr, cv::_InputArray* mask, ColorPointsSoA* points, int capacity)
+{
+	cv::Mat pcm = pointCloud->getMat();
+	cv::Mat color = bgr->getMat();
+	cv::Mat maskMat = mask ? mask->getMat() : cv::Mat();
+
+	std::vector<int> offsets;
+	int count = colorPointsOffsets(pcm, color, maskMat, offsets);
+	if (points && count > 0)
+	{
+		CV_Assert(points->x && points->y && points->z && points->blue && points->green && points->red);
+		if (capacity < count)
+			CV_Error(cv::Error::StsOutOfRange, "The capacity of the output buffer is smaller than the number of points");
+		ColorPointSoAWriter writer = { *points };
+		colorPointsWrite(pcm, color, maskMat, offsets, writer);
+	}
+	return count;
+}
+
+void OpenniGetColorPoints(CvCapture* capture, std::vector<ColorPoint>* points, IplImage* maskImg)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	IplImage* pcm = cvRetrieveFrame(capture, CV_CAP_OPENNI_POINT_CLOUD_MAP); //XYZ in meters (CV_32FC3)
+	IplImage* bgr = cvRetrieveFrame(capture, CV_CAP_OPENNI_BGR_IMAGE); //CV_8UC3
+
+	cv::Mat pcmMat = cv::cvarrToMat(pcm);
+	cv::Mat bgrMat = cv::cvarrToMat(bgr);
+	cv::Mat maskMat = maskImg ? cv::cvarrToMat(maskImg) : cv::Mat();
+
+	//Size the output once, then fill it in parallel
+	std::vector<int> offsets;
+	int count = colorPointsOffsets(pcmMat, bgrMat, maskMat, offsets);
+	size_t start = points->size();
+	points->resize(start + count);
+	if (count > 0)
+	{
+		ColorPointWriter writer = { &(*points)[start] };
+		colorPointsWrite(pcmMat, bgrMat, maskMat, offsets, writer);
+	}
 #else
 	throw_no_videoio();
 #endif
@@ -171,6 +475,666 @@ bool cveVideoCaptureWaitAny(std::vector<cv::VideoCapture>* streams, std::vector<
 #endif
 }
 
+#ifdef HAVE_OPENCV_VIDEOIO
+//A fixed size ring of decoded frames, read from head. The Mats are swapped in and out such that their buffers are reused.
+//Not thread safe, guarded by the mutex of the owner.
+struct FrameRing
+{
+	std::vector<cv::Mat> frames;
+	std::vector<double> timestamps;
+	int head;
+	int count;
+
+	FrameRing(int capacity)
+		: frames(capacity), timestamps(capacity), head(0), count(0)
+	{
+	}
+
+	int capacity() const
+	{
+		return static_cast<int>(frames.size());
+	}
+
+	bool full() const
+	{
+		return count == capacity();
+	}
+
+	//Swap frame in at the tail, replacing the oldest frame if the ring is full. Returns false if a frame has been replaced.
+	bool push(cv::Mat& frame, double timestamp)
+	{
+		int tail = (head + count) % capacity();
+		cv::swap(frame, frames[tail]);
+		timestamps[tail] = timestamp;
+		if (count == capacity())
+		{
+			head = (head + 1) % capacity();
+			return false;
+		}
+		count++;
+		return true;
+	}
+
+	//Swap the oldest frame out into frame, the ring must not be empty
+	void pop(cv::Mat& frame, double* timestamp)
+	{
+		cv::Mat& slot = frames[head];
+		cv::swap(frame, slot);
+		//The decoder writes into the recycled Mat in place, it must not share its buffer with anything else
+		if (!slot.u || slot.u->refcount > 1 || slot.isSubmatrix())
+			slot.release();
+		if (timestamp)
+			*timestamp = timestamps[head];
+		head = (head + 1) % capacity();
+		count--;
+	}
+};
+
+struct emgu::PrefetchVideoCapture::Impl
+{
+	cv::VideoCapture* capture;
+	bool latestOnly;
+
+	FrameRing ring;
+	//The frame being decoded, only touched by the decoder thread
+	cv::Mat decoding;
+
+	int64 decoded;
+	int64 delivered;
+	int64 dropped;
+	bool stopRequested;
+	bool finished;
+	cv::String error;
+
+	std::mutex mutex;
+	std::condition_variable frameReady;
+	std::condition_variable slotFree;
+	std::thread decoder;
+
+	Impl(cv::VideoCapture* cap, int capacity, bool latest)
+		: capture(cap), latestOnly(latest), ring(latest ? 1 : capacity),
+		decoded(0), delivered(0), dropped(0), stopRequested(false), finished(false)
+	{
+		decoder = std::thread(&Impl::run, this);
+	}
+
+	void run()
+	{
+		cv::String message;
+		for (;;)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (stopRequested)
+					break;
+			}
+
+			bool grabbed = false;
+			try
+			{
+				grabbed = capture->read(decoding) && !decoding.empty();
+			}
+			catch (const std::exception& e)
+			{
+				message = e.what();
+			}
+
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!grabbed)
+			{
+				error = message;
+				break;
+			}
+			decoded++;
+
+			if (!latestOnly)
+				slotFree.wait(lock, [this] { return stopRequested || !ring.full(); });
+			if (stopRequested)
+				break;
+
+			//Replaced the oldest frame before it has been read
+			if (!ring.push(decoding, 0))
+				dropped++;
+			frameReady.notify_one();
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		finished = true;
+		frameReady.notify_all();
+	}
+
+	bool read(cv::Mat& frame, int timeoutMs)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto ready = [this] { return ring.count > 0 || finished; };
+		if (timeoutMs < 0)
+			frameReady.wait(lock, ready);
+		else if (!frameReady.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready))
+			return false;
+
+		if (ring.count == 0)
+		{
+			if (!error.empty())
+			{
+				//Report the decoder failure once, on the reading thread
+				cv::String message = error;
+				error.clear();
+				lock.unlock();
+				CV_Error(cv::Error::StsError, message);
+			}
+			return false;
+		}
+
+		ring.pop(frame, 0);
+		delivered++;
+		slotFree.notify_one();
+		return true;
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopRequested = true;
+			slotFree.notify_all();
+		}
+		if (decoder.joinable())
+			decoder.join();
+	}
+};
+
+emgu::PrefetchVideoCapture::PrefetchVideoCapture(cv::VideoCapture* capture, int capacity, bool latestOnly)
+{
+	CV_Assert(capture && capacity > 0);
+	impl = new Impl(capture, capacity, latestOnly);
+}
+
+emgu::PrefetchVideoCapture::~PrefetchVideoCapture()
+{
+	impl->stop();
+	delete impl;
+}
+
+bool emgu::PrefetchVideoCapture::read(cv::Mat& frame, int timeoutMs)
+{
+	return impl->read(frame, timeoutMs);
+}
+
+bool emgu::PrefetchVideoCapture::isEndOfStream() const
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	return impl->finished && impl->ring.count == 0;
+}
+
+void emgu::PrefetchVideoCapture::getStats(int* queueDepth, int64* decoded, int64* delivered, int64* dropped) const
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	*queueDepth = impl->ring.count;
+	*decoded = impl->decoded;
+	*delivered = impl->delivered;
+	*dropped = impl->dropped;
+}
+
+void emgu::PrefetchVideoCapture::stop()
+{
+	impl->stop();
+}
+#endif
+
+emgu::PrefetchVideoCapture* cvePrefetchVideoCaptureCreate(cv::VideoCapture* capture, int capacity, bool latestOnly)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return new emgu::PrefetchVideoCapture(capture, capacity, latestOnly);
+#else
+	throw_no_videoio();
+#endif
+}
+void cvePrefetchVideoCaptureRelease(emgu::PrefetchVideoCapture** prefetch)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	delete *prefetch;
+	*prefetch = 0;
+#else
+	throw_no_videoio();
+#endif
+}
+bool cvePrefetchVideoCaptureRead(emgu::PrefetchVideoCapture* prefetch, cv::Mat* frame, int timeoutMs)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return prefetch->read(*frame, timeoutMs);
+#else
+	throw_no_videoio();
+#endif
+}
+bool cvePrefetchVideoCaptureIsEndOfStream(emgu::PrefetchVideoCapture* prefetch)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return prefetch->isEndOfStream();
+#else
+	throw_no_videoio();
+#endif
+}
+void cvePrefetchVideoCaptureGetStats(emgu::PrefetchVideoCapture* prefetch, int* queueDepth, int64* decoded, int64* delivered, int64* dropped)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	prefetch->getStats(queueDepth, decoded, delivered, dropped);
+#else
+	throw_no_videoio();
+#endif
+}
+void cvePrefetchVideoCaptureStop(emgu::PrefetchVideoCapture* prefetch)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	prefetch->stop();
+#else
+	throw_no_videoio();
+#endif
+}
+
+#ifdef HAVE_OPENCV_VIDEOIO
+struct emgu::VideoCaptureMultiplexer::Impl
+{
+	struct Stream
+	{
+		cv::VideoCapture capture;
+		FrameRing ring;
+		//The frame being decoded, only touched by the thread currently servicing the stream
+		cv::Mat decoding;
+		bool finished;
+		//The ring is full and the stream is waiting for the consumer before it is decoded again
+		bool parked;
+		int64 decoded;
+		int64 delivered;
+		int64 dropped;
+
+		Stream(const cv::VideoCapture& cap, int capacity)
+			: capture(cap), ring(capacity), finished(false), parked(false), decoded(0), delivered(0), dropped(0)
+		{
+		}
+	};
+
+	std::vector<Stream*> streams;
+	bool dropWhenFull;
+	bool waitAny;
+
+	//Streams waiting to be decoded by a worker, in round robin order
+	std::deque<int> pending;
+	int queuedFrames;
+	int finishedCount;
+	//The stream to look at first on the next read
+	int nextStream;
+	bool stopRequested;
+
+	mutable std::mutex mutex;
+	std::condition_variable frameReady;
+	std::condition_variable slotFree;
+	std::condition_variable workAvailable;
+	std::vector<std::thread> threads;
+
+	Impl(const std::vector<cv::VideoCapture>& captures, int perStreamCapacity, bool drop, int workerCount)
+		: dropWhenFull(drop), waitAny(!captures.empty()), queuedFrames(0), finishedCount(0), nextStream(0), stopRequested(false)
+	{
+		for (size_t i = 0; i < captures.size(); i++)
+		{
+			Stream* s = new Stream(captures[i], perStreamCapacity);
+			streams.push_back(s);
+			if (!s->capture.isOpened())
+			{
+				s->finished = true;
+				finishedCount++;
+				continue;
+			}
+			pending.push_back(static_cast<int>(i));
+			//waitAny is only implemented by the V4L backend
+			cv::String backend = s->capture.getBackendName();
+			if (backend != "V4L2" && backend != "V4L")
+				waitAny = false;
+		}
+
+		if (waitAny)
+		{
+			threads.push_back(std::thread(&Impl::runWaitAny, this));
+		}
+		else
+		{
+			if (workerCount <= 0)
+				workerCount = cv::getNumberOfCPUs();
+			workerCount = std::max(1, std::min(workerCount, static_cast<int>(streams.size())));
+			for (int i = 0; i < workerCount; i++)
+				threads.push_back(std::thread(&Impl::runWorker, this));
+		}
+	}
+
+	~Impl()
+	{
+		for (size_t i = 0; i < streams.size(); i++)
+			delete streams[i];
+	}
+
+	//Called with the mutex locked after a stream has been read
+	void onDecoded(int index, bool grabbed, double timestamp)
+	{
+		Stream& s = *streams[index];
+		if (!grabbed)
+		{
+			s.finished = true;
+			finishedCount++;
+			frameReady.notify_all();
+			return;
+		}
+		s.decoded++;
+		if (s.ring.push(s.decoding, timestamp))
+			queuedFrames++;
+		else
+			s.dropped++;
+		frameReady.notify_one();
+	}
+
+	static bool readStream(Stream& s, bool retrieve, double* timestamp)
+	{
+		try
+		{
+			bool grabbed = retrieve ? s.capture.retrieve(s.decoding) : s.capture.read(s.decoding);
+			if (!grabbed || s.decoding.empty())
+				return false;
+			*timestamp = s.capture.get(cv::CAP_PROP_POS_MSEC);
+			return true;
+		}
+		catch (const std::exception&)
+		{
+			//A failing stream is ended, it must not bring down the others
+			return false;
+		}
+	}
+
+	void runWorker()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			workAvailable.wait(lock, [this] { return stopRequested || !pending.empty(); });
+			if (stopRequested)
+				break;
+
+			int index = pending.front();
+			pending.pop_front();
+			Stream& s = *streams[index];
+
+			lock.unlock();
+			double timestamp = 0;
+			bool grabbed = readStream(s, false, &timestamp);
+			lock.lock();
+
+			onDecoded(index, grabbed, timestamp);
+			if (s.finished)
+				continue;
+			if (dropWhenFull || !s.ring.full())
+			{
+				pending.push_back(index);
+				workAvailable.notify_one();
+			}
+			else
+				s.parked = true;
+		}
+	}
+
+	void runWaitAny()
+	{
+		std::vector<cv::VideoCapture> active;
+		std::vector<int> activeIndex;
+		for (size_t i = 0; i < streams.size(); i++)
+			if (!streams[i]->finished)
+			{
+				active.push_back(streams[i]->capture);
+				activeIndex.push_back(static_cast<int>(i));
+			}
+
+		std::vector<int> ready;
+		while (!active.empty())
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (stopRequested)
+					return;
+			}
+
+			try
+			{
+				//Wake up regularly to check for stop requests
+				if (!cv::VideoCapture::waitAny(active, ready, 100000000))
+					continue;
+			}
+			catch (const cv::Exception&)
+			{
+				//The backend does not support waitAny after all, service the remaining streams from this thread
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					waitAny = false;
+					pending.assign(activeIndex.begin(), activeIndex.end());
+				}
+				runWorker();
+				return;
+			}
+
+			bool anyFinished = false;
+			for (size_t i = 0; i < ready.size(); i++)
+			{
+				int index = activeIndex[ready[i]];
+				Stream& s = *streams[index];
+				double timestamp = 0;
+				bool grabbed = readStream(s, true, &timestamp);
+
+				std::unique_lock<std::mutex> lock(mutex);
+				if (grabbed && !dropWhenFull)
+					slotFree.wait(lock, [this, &s] { return stopRequested || !s.ring.full(); });
+				if (stopRequested)
+					return;
+				onDecoded(index, grabbed, timestamp);
+				anyFinished |= s.finished;
+			}
+
+			if (anyFinished)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (int i = static_cast<int>(active.size()) - 1; i >= 0; i--)
+					if (streams[activeIndex[i]]->finished)
+					{
+						active.erase(active.begin() + i);
+						activeIndex.erase(activeIndex.begin() + i);
+					}
+			}
+		}
+	}
+
+	bool read(int* streamIndex, double* timestamp, cv::Mat& frame, int timeoutMs)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto ready = [this] { return queuedFrames > 0 || finishedCount == static_cast<int>(streams.size()); };
+		if (timeoutMs < 0)
+			frameReady.wait(lock, ready);
+		else if (!frameReady.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready))
+			return false;
+		if (queuedFrames == 0)
+			return false;
+
+		int count = static_cast<int>(streams.size());
+		int index = nextStream;
+		while (streams[index]->ring.count == 0)
+			index = (index + 1) % count;
+		nextStream = (index + 1) % count;
+
+		Stream& s = *streams[index];
+		s.ring.pop(frame, timestamp);
+		s.delivered++;
+		queuedFrames--;
+		*streamIndex = index;
+
+		if (s.parked)
+		{
+			s.parked = false;
+			pending.push_back(index);
+			workAvailable.notify_one();
+		}
+		slotFree.notify_all();
+		return true;
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopRequested = true;
+			workAvailable.notify_all();
+			slotFree.notify_all();
+		}
+		for (size_t i = 0; i < threads.size(); i++)
+			if (threads[i].joinable())
+				threads[i].join();
+
+		//The streams that are no longer decoded count as ended
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t i = 0; i < streams.size(); i++)
+			if (!streams[i]->finished)
+			{
+				streams[i]->finished = true;
+				finishedCount++;
+			}
+		frameReady.notify_all();
+	}
+};
+
+emgu::VideoCaptureMultiplexer::VideoCaptureMultiplexer(const std::vector<cv::VideoCapture>& captures, int perStreamCapacity, bool dropWhenFull, int workerCount)
+{
+	CV_Assert(perStreamCapacity > 0);
+	impl = new Impl(captures, perStreamCapacity, dropWhenFull, workerCount);
+}
+
+emgu::VideoCaptureMultiplexer::~VideoCaptureMultiplexer()
+{
+	impl->stop();
+	delete impl;
+}
+
+bool emgu::VideoCaptureMultiplexer::read(int* streamIndex, double* timestamp, cv::Mat& frame, int timeoutMs)
+{
+	return impl->read(streamIndex, timestamp, frame, timeoutMs);
+}
+
+int emgu::VideoCaptureMultiplexer::getStreamCount() const
+{
+	return static_cast<int>(impl->streams.size());
+}
+
+bool emgu::VideoCaptureMultiplexer::usesWaitAny() const
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	return impl->waitAny;
+}
+
+bool emgu::VideoCaptureMultiplexer::isStreamFinished(int streamIndex) const
+{
+	CV_Assert(streamIndex >= 0 && streamIndex < getStreamCount());
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	return impl->streams[streamIndex]->finished;
+}
+
+bool emgu::VideoCaptureMultiplexer::isEndOfStream() const
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	return impl->finishedCount == static_cast<int>(impl->streams.size()) && impl->queuedFrames == 0;
+}
+
+void emgu::VideoCaptureMultiplexer::getStats(int streamIndex, int* queueDepth, int64* decoded, int64* delivered, int64* dropped) const
+{
+	CV_Assert(streamIndex >= 0 && streamIndex < getStreamCount());
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	const Impl::Stream& s = *impl->streams[streamIndex];
+	*queueDepth = s.ring.count;
+	*decoded = s.decoded;
+	*delivered = s.delivered;
+	*dropped = s.dropped;
+}
+
+void emgu::VideoCaptureMultiplexer::stop()
+{
+	impl->stop();
+}
+#endif
+
+emgu::VideoCaptureMultiplexer* cveVideoCaptureMultiplexerCreate(std::vector<cv::VideoCapture>* captures, int perStreamCapacity, bool dropWhenFull, int workerCount)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return new emgu::VideoCaptureMultiplexer(*captures, perStreamCapacity, dropWhenFull, workerCount);
+#else
+	throw_no_videoio();
+#endif
+}
+void cveVideoCaptureMultiplexerRelease(emgu::VideoCaptureMultiplexer** multiplexer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	delete *multiplexer;
+	*multiplexer = 0;
+#else
+	throw_no_videoio();
+#endif
+}
+bool cveVideoCaptureMultiplexerRead(emgu::VideoCaptureMultiplexer* multiplexer, int* streamIndex, double* timestamp, cv::Mat* frame, int timeoutMs)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return multiplexer->read(streamIndex, timestamp, *frame, timeoutMs);
+#else
+	throw_no_videoio();
+#endif
+}
+int cveVideoCaptureMultiplexerGetStreamCount(emgu::VideoCaptureMultiplexer* multiplexer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return multiplexer->getStreamCount();
+#else
+	throw_no_videoio();
+#endif
+}
+bool cveVideoCaptureMultiplexerUsesWaitAny(emgu::VideoCaptureMultiplexer* multiplexer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return multiplexer->usesWaitAny();
+#else
+	throw_no_videoio();
+#endif
+}
+bool cveVideoCaptureMultiplexerIsStreamFinished(emgu::VideoCaptureMultiplexer* multiplexer, int streamIndex)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return multiplexer->isStreamFinished(streamIndex);
+#else
+	throw_no_videoio();
+#endif
+}
+bool cveVideoCaptureMultiplexerIsEndOfStream(emgu::VideoCaptureMultiplexer* multiplexer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return multiplexer->isEndOfStream();
+#else
+	throw_no_videoio();
+#endif
+}
+void cveVideoCaptureMultiplexerGetStats(emgu::VideoCaptureMultiplexer* multiplexer, int streamIndex, int* queueDepth, int64* decoded, int64* delivered, int64* dropped)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	multiplexer->getStats(streamIndex, queueDepth, decoded, delivered, dropped);
+#else
+	throw_no_videoio();
+#endif
+}
+void cveVideoCaptureMultiplexerStop(emgu::VideoCaptureMultiplexer* multiplexer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	multiplexer->stop();
+#else
+	throw_no_videoio();
+#endif
+}
+
 #if WINAPI_FAMILY
 void cveWinrtSetFrameContainer(::Windows::UI::Xaml::Controls::Image^ image)
 {
@@ -289,6 +1253,229 @@ void cveVideoWriterGetBackendName(cv::VideoWriter* writer, cv::String* name)
 #endif
 }
 
+#ifdef HAVE_OPENCV_VIDEOIO
+struct emgu::AsyncVideoWriter::Impl
+{
+	cv::VideoWriter* writer;
+	int maxBlockMs;
+	int highWaterMark;
+
+	FrameRing ring;
+	//The frame being encoded, only touched by the encoder thread
+	cv::Mat encoding;
+	bool encoderBusy;
+
+	int maxQueueDepth;
+	int64 written;
+	int64 dropped;
+	bool stopRequested;
+	bool finished;
+	cv::String error;
+
+	std::mutex mutex;
+	std::condition_variable frameQueued;
+	std::condition_variable slotFree;
+	std::condition_variable drained;
+	std::thread encoder;
+
+	Impl(cv::VideoWriter* w, int capacity, int maxBlock, int highWater)
+		: writer(w), maxBlockMs(maxBlock), highWaterMark(highWater), ring(capacity), encoderBusy(false),
+		maxQueueDepth(0), written(0), dropped(0), stopRequested(false), finished(false)
+	{
+		encoder = std::thread(&Impl::run, this);
+	}
+
+	void run()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			frameQueued.wait(lock, [this] { return stopRequested || ring.count > 0; });
+			//The queued frames are always encoded before the thread exits
+			if (ring.count == 0)
+				break;
+
+			//The previously encoded buffer goes back to the ring, to be handed to a producer
+			ring.pop(encoding, 0);
+			slotFree.notify_one();
+
+			if (!error.empty())
+			{
+				dropped++;
+				if (ring.count == 0)
+					drained.notify_all();
+				continue;
+			}
+
+			encoderBusy = true;
+			lock.unlock();
+			cv::String message;
+			try
+			{
+				writer->write(encoding);
+			}
+			catch (const std::exception& e)
+			{
+				message = e.what();
+			}
+			lock.lock();
+			encoderBusy = false;
+
+			if (message.empty())
+				written++;
+			else
+			{
+				error = message;
+				dropped++;
+			}
+			if (ring.count == 0)
+				drained.notify_all();
+		}
+		finished = true;
+		drained.notify_all();
+	}
+
+	//Called with the mutex locked
+	void throwIfFailed(std::unique_lock<std::mutex>& lock)
+	{
+		if (error.empty())
+			return;
+		cv::String message = error;
+		lock.unlock();
+		CV_Error(cv::Error::StsError, message);
+	}
+
+	int write(cv::Mat& frame)
+	{
+		CV_Assert(!frame.empty());
+		std::unique_lock<std::mutex> lock(mutex);
+		throwIfFailed(lock);
+		CV_Assert(!stopRequested);
+
+		auto hasRoom = [this] { return !ring.full() || !error.empty(); };
+		if (maxBlockMs < 0)
+			slotFree.wait(lock, hasRoom);
+		else if (!slotFree.wait_for(lock, std::chrono::milliseconds(maxBlockMs), hasRoom))
+		{
+			dropped++;
+			return ASYNC_WRITE_DROPPED;
+		}
+		throwIfFailed(lock);
+
+		ring.push(frame, 0);
+		maxQueueDepth = std::max(maxQueueDepth, ring.count);
+		frameQueued.notify_one();
+		return highWaterMark > 0 && ring.count == highWaterMark ? ASYNC_WRITE_HIGH_WATER : ASYNC_WRITE_QUEUED;
+	}
+
+	void flush()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		drained.wait(lock, [this] { return (ring.count == 0 && !encoderBusy) || finished; });
+		throwIfFailed(lock);
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopRequested = true;
+			frameQueued.notify_all();
+		}
+		if (encoder.joinable())
+			encoder.join();
+	}
+};
+
+emgu::AsyncVideoWriter::AsyncVideoWriter(cv::VideoWriter* writer, int capacity, int maxBlockMs, int highWaterMark)
+{
+	CV_Assert(writer && writer->isOpened() && capacity > 0);
+	impl = new Impl(writer, capacity, maxBlockMs, highWaterMark);
+}
+
+emgu::AsyncVideoWriter::~AsyncVideoWriter()
+{
+	impl->stop();
+	delete impl;
+}
+
+int emgu::AsyncVideoWriter::write(cv::Mat& frame)
+{
+	return impl->write(frame);
+}
+
+void emgu::AsyncVideoWriter::flush()
+{
+	impl->flush();
+}
+
+void emgu::AsyncVideoWriter::close()
+{
+	impl->stop();
+	std::unique_lock<std::mutex> lock(impl->mutex);
+	impl->throwIfFailed(lock);
+}
+
+void emgu::AsyncVideoWriter::getStats(int* queueDepth, int* maxQueueDepth, int64* written, int64* dropped) const
+{
+	std::lock_guard<std::mutex> lock(impl->mutex);
+	*queueDepth = impl->ring.count;
+	*maxQueueDepth = impl->maxQueueDepth;
+	*written = impl->written;
+	*dropped = impl->dropped;
+}
+#endif
+
+emgu::AsyncVideoWriter* cveAsyncVideoWriterCreate(cv::VideoWriter* writer, int capacity, int maxBlockMs, int highWaterMark)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return new emgu::AsyncVideoWriter(writer, capacity, maxBlockMs, highWaterMark);
+#else
+	throw_no_videoio();
+#endif
+}
+void cveAsyncVideoWriterRelease(emgu::AsyncVideoWriter** writer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	delete *writer;
+	*writer = 0;
+#else
+	throw_no_videoio();
+#endif
+}
+int cveAsyncVideoWriterWrite(emgu::AsyncVideoWriter* writer, cv::Mat* frame)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	return writer->write(*frame);
+#else
+	throw_no_videoio();
+#endif
+}
+void cveAsyncVideoWriterFlush(emgu::AsyncVideoWriter* writer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	writer->flush();
+#else
+	throw_no_videoio();
+#endif
+}
+void cveAsyncVideoWriterClose(emgu::AsyncVideoWriter* writer)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	writer->close();
+#else
+	throw_no_videoio();
+#endif
+}
+void cveAsyncVideoWriterGetStats(emgu::AsyncVideoWriter* writer, int* queueDepth, int* maxQueueDepth, int64* written, int64* dropped)
+{
+#ifdef HAVE_OPENCV_VIDEOIO
+	writer->getStats(queueDepth, maxQueueDepth, written, dropped);
+#else
+	throw_no_videoio();
+#endif
+}
+
 
 void cveGetBackendName(int api, cv::String* name)
 {
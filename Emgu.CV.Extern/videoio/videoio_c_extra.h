@@ -66,6 +66,27 @@ CVAPI(void) OpenniGetColorPoints(
                                  IplImage* mask // CV_8UC1
                                  );
 
+/**
+* @struct  ColorPointsSoA
+*
+* @brief   An array of colored points stored as structure of arrays, each pointer points to capacity elements
+*/
+typedef struct ColorPointsSoA
+{
+   float* x;
+   float* y;
+   float* z;
+   unsigned char* blue;
+   unsigned char* green;
+   unsigned char* red;
+} ColorPointsSoA;
+
+//Extract the colored points from a point cloud (CV_32FC3) and a color image (CV_8UC3) of the same size, row by row.
+//Only the points with a non zero mask (CV_8UC1, can be empty) are extracted. Returns the number of points selected by the mask,
+//if points is null only the number of points is computed, otherwise capacity must be large enough to hold them.
+CVAPI(int) cveGetColorPoints(cv::_InputArray* pointCloud, cv::_InputArray* bgr, cv::_InputArray* mask, ColorPoint* points, int capacity);
+CVAPI(int) cveGetColorPointsSoA(cv::_InputArray* pointCloud, cv::_InputArray* bgr, cv::_InputArray* mask, ColorPointsSoA* points, int capacity);
+
 CVAPI(cv::VideoCapture*) cveVideoCaptureCreateFromDevice(int device, int apiPreference, std::vector< int >* params);
 CVAPI(cv::VideoCapture*) cveVideoCaptureCreateFromFile(cv::String* fileName, int apiPreference, std::vector< int >* params);
 
@@ -81,6 +102,99 @@ CVAPI(void) cveVideoCaptureGetBackendName(cv::VideoCapture* capture, cv::String*
 
 CVAPI(bool) cveVideoCaptureWaitAny(std::vector<cv::VideoCapture>* streams, std::vector<int>* readyIndex, int timeoutNs);
 
+namespace emgu
+{
+	/*
+	 * Decode frames from a VideoCapture on a dedicated thread into a bounded ring of pooled Mats.
+	 * In the default mode the decoder waits when the ring is full, such that no frame is lost.
+	 * In latest frame only mode the ring holds a single frame that is replaced by every newly decoded one,
+	 * the frames replaced before being read are counted as dropped.
+	 * The VideoCapture is borrowed, it must outlive this object and must not be used while the decoder is running.
+	 */
+	class CV_EXPORTS PrefetchVideoCapture
+	{
+	public:
+		PrefetchVideoCapture(cv::VideoCapture* capture, int capacity, bool latestOnly);
+		~PrefetchVideoCapture();
+
+		//Swap the oldest queued frame into frame. timeoutMs < 0 waits forever, 0 returns immediately.
+		//Returns false if no frame is available within the timeout or if the end of the stream has been reached.
+		bool read(cv::Mat& frame, int timeoutMs);
+
+		//True if the decoder has stopped and all the decoded frames have been read
+		bool isEndOfStream() const;
+
+		void getStats(int* queueDepth, int64* decoded, int64* delivered, int64* dropped) const;
+
+		//Stop the decoder thread, the frames already queued can still be read
+		void stop();
+
+	private:
+		struct Impl;
+		Impl* impl;
+
+		PrefetchVideoCapture(const PrefetchVideoCapture&);
+		PrefetchVideoCapture& operator=(const PrefetchVideoCapture&);
+	};
+}
+
+CVAPI(emgu::PrefetchVideoCapture*) cvePrefetchVideoCaptureCreate(cv::VideoCapture* capture, int capacity, bool latestOnly);
+CVAPI(void) cvePrefetchVideoCaptureRelease(emgu::PrefetchVideoCapture** prefetch);
+CVAPI(bool) cvePrefetchVideoCaptureRead(emgu::PrefetchVideoCapture* prefetch, cv::Mat* frame, int timeoutMs);
+CVAPI(bool) cvePrefetchVideoCaptureIsEndOfStream(emgu::PrefetchVideoCapture* prefetch);
+CVAPI(void) cvePrefetchVideoCaptureGetStats(emgu::PrefetchVideoCapture* prefetch, int* queueDepth, int64* decoded, int64* delivered, int64* dropped);
+CVAPI(void) cvePrefetchVideoCaptureStop(emgu::PrefetchVideoCapture* prefetch);
+
+namespace emgu
+{
+	/*
+	 * Service many VideoCaptures without one thread per stream. If all the captures use the V4L backend a single thread
+	 * grabs with cv::VideoCapture::waitAny, otherwise a pool of worker threads reads the streams in round robin order.
+	 * Each stream has its own bounded ring of pooled Mats. Frames are delivered through a single read function
+	 * that visits the streams in round robin order, such that a fast stream can not starve the others.
+	 * When the ring of a stream is full its decoding either waits (backpressure) or replaces the oldest frame (dropWhenFull).
+	 */
+	class CV_EXPORTS VideoCaptureMultiplexer
+	{
+	public:
+		//The captures are shallow copied: the multiplexer shares their backends and keeps them alive.
+		//workerCount <= 0 uses one worker per CPU, up to the number of streams.
+		VideoCaptureMultiplexer(const std::vector<cv::VideoCapture>& captures, int perStreamCapacity, bool dropWhenFull, int workerCount);
+		~VideoCaptureMultiplexer();
+
+		//Swap the next frame into frame. timeoutMs < 0 waits forever, 0 returns immediately.
+		//Returns false if no frame is available within the timeout or if all the streams have ended.
+		bool read(int* streamIndex, double* timestamp, cv::Mat& frame, int timeoutMs);
+
+		int getStreamCount() const;
+		bool usesWaitAny() const;
+		bool isStreamFinished(int streamIndex) const;
+		//True if all the streams have ended and all the decoded frames have been read
+		bool isEndOfStream() const;
+		void getStats(int streamIndex, int* queueDepth, int64* decoded, int64* delivered, int64* dropped) const;
+
+		//Stop the decoding threads, the frames already queued can still be read
+		void stop();
+
+	private:
+		struct Impl;
+		Impl* impl;
+
+		VideoCaptureMultiplexer(const VideoCaptureMultiplexer&);
+		VideoCaptureMultiplexer& operator=(const VideoCaptureMultiplexer&);
+	};
+}
+
+CVAPI(emgu::VideoCaptureMultiplexer*) cveVideoCaptureMultiplexerCreate(std::vector<cv::VideoCapture>* captures, int perStreamCapacity, bool dropWhenFull, int workerCount);
+CVAPI(void) cveVideoCaptureMultiplexerRelease(emgu::VideoCaptureMultiplexer** multiplexer);
+CVAPI(bool) cveVideoCaptureMultiplexerRead(emgu::VideoCaptureMultiplexer* multiplexer, int* streamIndex, double* timestamp, cv::Mat* frame, int timeoutMs);
+CVAPI(int) cveVideoCaptureMultiplexerGetStreamCount(emgu::VideoCaptureMultiplexer* multiplexer);
+CVAPI(bool) cveVideoCaptureMultiplexerUsesWaitAny(emgu::VideoCaptureMultiplexer* multiplexer);
+CVAPI(bool) cveVideoCaptureMultiplexerIsStreamFinished(emgu::VideoCaptureMultiplexer* multiplexer, int streamIndex);
+CVAPI(bool) cveVideoCaptureMultiplexerIsEndOfStream(emgu::VideoCaptureMultiplexer* multiplexer);
+CVAPI(void) cveVideoCaptureMultiplexerGetStats(emgu::VideoCaptureMultiplexer* multiplexer, int streamIndex, int* queueDepth, int64* decoded, int64* delivered, int64* dropped);
+CVAPI(void) cveVideoCaptureMultiplexerStop(emgu::VideoCaptureMultiplexer* multiplexer);
+
 #if WINAPI_FAMILY
 CVAPI(void) cveWinrtSetFrameContainer(::Windows::UI::Xaml::Controls::Image^ image);
 typedef void (CV_CDECL *CvWinrtMessageLoopCallback)();
@@ -100,6 +214,58 @@ CVAPI(void) cveVideoWriterWrite(cv::VideoWriter* writer, cv::_InputArray* image)
 CVAPI(int) cveVideoWriterFourcc(char c1, char c2, char c3, char c4);
 CVAPI(void) cveVideoWriterGetBackendName(cv::VideoWriter* writer, cv::String* name);
 
+namespace emgu
+{
+	/*
+	 * Encode frames on a dedicated thread. Frames are moved into a bounded ring of pooled Mats by swapping buffers, not copied.
+	 * A producer waits at most maxBlockMs for room in the ring (forever if maxBlockMs < 0), after that the frame is dropped.
+	 * An encoding error is kept and raised by the following write / flush call, the frames queued after it are dropped.
+	 * The VideoWriter is borrowed, it must outlive this object and must not be used while the encoder is running.
+	 */
+	class CV_EXPORTS AsyncVideoWriter
+	{
+	public:
+		//The values are mirrored by the AsyncVideoWriteResult enum on the managed side
+		enum WriteResult
+		{
+			//The queue stayed full for maxBlockMs, the frame has not been taken
+			ASYNC_WRITE_DROPPED = 0,
+			ASYNC_WRITE_QUEUED = 1,
+			//The frame has been queued and the queue depth reached the high water mark
+			ASYNC_WRITE_HIGH_WATER = 2
+		};
+
+		//highWaterMark <= 0 disables the high water notification
+		AsyncVideoWriter(cv::VideoWriter* writer, int capacity, int maxBlockMs, int highWaterMark);
+		~AsyncVideoWriter();
+
+		//Swap frame into the queue. If the frame is queued, frame receives a recycled buffer of undefined content, or is emptied.
+		int write(cv::Mat& frame);
+
+		//Block until all the queued frames have been encoded
+		void flush();
+
+		//Flush and stop the encoder thread
+		void close();
+
+		void getStats(int* queueDepth, int* maxQueueDepth, int64* written, int64* dropped) const;
+
+	private:
+		struct Impl;
+		Impl* impl;
+
+		AsyncVideoWriter(const AsyncVideoWriter&);
+		AsyncVideoWriter& operator=(const AsyncVideoWriter&);
+	};
+}
+
+CVAPI(emgu::AsyncVideoWriter*) cveAsyncVideoWriterCreate(cv::VideoWriter* writer, int capacity, int maxBlockMs, int highWaterMark);
+CVAPI(void) cveAsyncVideoWriterRelease(emgu::AsyncVideoWriter** writer);
+CVAPI(int) cveAsyncVideoWriterWrite(emgu::AsyncVideoWriter* writer, cv::Mat* frame);
+CVAPI(void) cveAsyncVideoWriterFlush(emgu::AsyncVideoWriter* writer);
+CVAPI(void) cveAsyncVideoWriterClose(emgu::AsyncVideoWriter* writer);
+CVAPI(void) cveAsyncVideoWriterGetStats(emgu::AsyncVideoWriter* writer, int* queueDepth, int* maxQueueDepth, int64* written, int64* dropped);
+
 CVAPI(void) cveGetBackendName(int api, cv::String* name);
 CVAPI(void) cveGetBackends(std::vector<int>* backends);
 CVAPI(void) cveGetCameraBackends(std::vector<int>* backends);
@@ -39,4 +39,240 @@ void zlib_uncompress(Byte* dataUncompressed, int* sizeDataUncompressed, Byte* co
    default:
       *sizeDataUncompressed = (int) sizeUncompressed;
    }
-}
\ No newline at end of file
+}
+z_stream* zlib_deflate_create(int compressionLevel)
+{
+   z_stream* stream = new z_stream();
+   memset(stream, 0, sizeof(z_stream));
+   if (deflateInit(stream, compressionLevel) != Z_OK)
+   {
+      delete stream;
+      CV_Error(CV_StsError, "Failed to initialize the deflate stream\n");
+   }
+   return stream;
+}
+
+bool zlib_deflate(z_stream* stream, Byte* input, int sizeInput, Byte* output, int sizeOutput, int* inputConsumed, int* outputProduced, bool finish)
+{
+   stream->next_in = input;
+   stream->avail_in = sizeInput;
+   stream->next_out = output;
+   stream->avail_out = sizeOutput;
+   int z_result = deflate(stream, finish ? Z_FINISH : Z_NO_FLUSH);
+   if (z_result == Z_STREAM_ERROR)
+      CV_Error(CV_StsError, "Inconsistent deflate stream state\n");
+   *inputConsumed = sizeInput - (int)stream->avail_in;
+   *outputProduced = sizeOutput - (int)stream->avail_out;
+   return z_result == Z_STREAM_END;
+}
+
+void zlib_deflate_release(z_stream** stream)
+{
+   if (*stream)
+   {
+      deflateEnd(*stream);
+      delete *stream;
+      *stream = 0;
+   }
+}
+
+z_stream* zlib_inflate_create()
+{
+   z_stream* stream = new z_stream();
+   memset(stream, 0, sizeof(z_stream));
+   if (inflateInit(stream) != Z_OK)
+   {
+      delete stream;
+      CV_Error(CV_StsError, "Failed to initialize the inflate stream\n");
+   }
+   return stream;
+}
+
+bool zlib_inflate(z_stream* stream, Byte* input, int sizeInput, Byte* output, int sizeOutput, int* inputConsumed, int* outputProduced)
+{
+   stream->next_in = input;
+   stream->avail_in = sizeInput;
+   stream->next_out = output;
+   stream->avail_out = sizeOutput;
+   int z_result = inflate(stream, Z_NO_FLUSH);
+   switch(z_result)
+   {
+   case Z_NEED_DICT:
+   case Z_DATA_ERROR:
+      CV_Error( CV_StsError, "Corrupted compressed data\n");
+      break;
+   case Z_MEM_ERROR:
+      CV_Error( CV_StsError, "Out of memory\n");
+      break;
+   case Z_STREAM_ERROR:
+      CV_Error( CV_StsError, "Inconsistent inflate stream state\n");
+      break;
+   }
+   *inputConsumed = sizeInput - (int)stream->avail_in;
+   *outputProduced = sizeOutput - (int)stream->avail_out;
+   return z_result == Z_STREAM_END;
+}
+
+void zlib_inflate_release(z_stream** stream)
+{
+   if (*stream)
+   {
+      inflateEnd(*stream);
+      delete *stream;
+      *stream = 0;
+   }
+}
+
+/*
+ * Layout of the block compressed data, all integers are little endian:
+ * "EZB1" | uint32 blockSize | uint64 original size | uint32 block count | uint32 compressed size of each block | blocks
+ */
+static const int ZLIB_BLOCK_HEADER_SIZE = 4 + 4 + 8 + 4;
+
+static void zlibWriteLE(Byte* dst, uint64 value, int bytes)
+{
+   for (int i = 0; i < bytes; i++)
+      dst[i] = (Byte)(value >> (8 * i));
+}
+
+static uint64 zlibReadLE(const Byte* src, int bytes)
+{
+   uint64 value = 0;
+   for (int i = 0; i < bytes; i++)
+      value |= ((uint64) src[i]) << (8 * i);
+   return value;
+}
+
+static int64 zlibBlockCount(int64 length, int blockSize)
+{
+   return (length + blockSize - 1) / blockSize;
+}
+
+int64 zlib_parallel_compress_bound(int64 length, int blockSize)
+{
+   CV_Assert(blockSize > 0);
+   int64 blockCount = zlibBlockCount(length, blockSize);
+   return ZLIB_BLOCK_HEADER_SIZE + blockCount * 4 + blockCount * (int64) compressBound(blockSize);
+}
+
+class ZlibBlockCompressInvoker : public cv::ParallelLoopBody
+{
+public:
+   const Byte* original;
+   int64 sizeOriginal;
+   int blockSize;
+   int level;
+   Byte* slots;
+   uLong blockBound;
+   uLongf* compressedSizes;
+
+   void operator()(const cv::Range& range) const CV_OVERRIDE
+   {
+      for (int i = range.start; i < range.end; i++)
+      {
+         int64 offset = (int64) i * blockSize;
+         uLong length = (uLong) std::min((int64) blockSize, sizeOriginal - offset);
+         uLongf sizeCompressed = blockBound;
+         if (compress2(slots + (size_t) i * blockBound, &sizeCompressed, original + offset, length, level) != Z_OK)
+            CV_Error(CV_StsError, "Failed to compress a block\n");
+         compressedSizes[i] = sizeCompressed;
+      }
+   }
+};
+
+void zlib_parallel_compress(Byte* dataCompressed, int64* sizeDataCompressed, Byte* dataOriginal, int64 sizeDataOriginal, int compressionLevel, int blockSize)
+{
+   if (*sizeDataCompressed < zlib_parallel_compress_bound(sizeDataOriginal, blockSize))
+      CV_Error(CV_StsError, "Output buffer wasn't large enough\n");
+
+   int blockCount = (int) zlibBlockCount(sizeDataOriginal, blockSize);
+   uLong blockBound = compressBound(blockSize);
+
+   //Blocks are compressed in parallel into fixed size slots of the output buffer, 
+   //then packed one after another. A packed block never starts after its slot, so it can be moved in place.
+   Byte* blocks = dataCompressed + ZLIB_BLOCK_HEADER_SIZE + (size_t) blockCount * 4;
+   std::vector<uLongf> compressedSizes(blockCount);
+   ZlibBlockCompressInvoker invoker;
+   invoker.original = dataOriginal;
+   invoker.sizeOriginal = sizeDataOriginal;
+   invoker.blockSize = blockSize;
+   invoker.level = compressionLevel;
+   invoker.slots = blocks;
+   invoker.blockBound = blockBound;
+   invoker.compressedSizes = compressedSizes.data();
+   cv::parallel_for_(cv::Range(0, blockCount), invoker);
+
+   Byte* dst = dataCompressed;
+   memcpy(dst, "EZB1", 4);
+   zlibWriteLE(dst + 4, (uint64) blockSize, 4);
+   zlibWriteLE(dst + 8, (uint64) sizeDataOriginal, 8);
+   zlibWriteLE(dst + 16, (uint64) blockCount, 4);
+   dst += ZLIB_BLOCK_HEADER_SIZE;
+   for (int i = 0; i < blockCount; i++, dst += 4)
+      zlibWriteLE(dst, compressedSizes[i], 4);
+   for (int i = 0; i < blockCount; i++)
+   {
+      memmove(dst, blocks + (size_t) i * blockBound, compressedSizes[i]);
+      dst += compressedSizes[i];
+   }
+   *sizeDataCompressed = (int64) (dst - dataCompressed);
+}
+
+int64 zlib_parallel_uncompressed_size(Byte* compressedData, int64 sizeDataCompressed)
+{
+   if (sizeDataCompressed < ZLIB_BLOCK_HEADER_SIZE || memcmp(compressedData, "EZB1", 4) != 0)
+      CV_Error(CV_StsError, "The data is not block compressed\n");
+   return (int64) zlibReadLE(compressedData + 8, 8);
+}
+
+class ZlibBlockUncompressInvoker : public cv::ParallelLoopBody
+{
+public:
+   const Byte* compressed;
+   const int64* offsets;
+   Byte* uncompressed;
+   int64 sizeUncompressed;
+   int blockSize;
+
+   void operator()(const cv::Range& range) const CV_OVERRIDE
+   {
+      for (int i = range.start; i < range.end; i++)
+      {
+         int64 offset = (int64) i * blockSize;
+         uLongf length = (uLongf) std::min((int64) blockSize, sizeUncompressed - offset);
+         uLongf expected = length;
+         if (uncompress(uncompressed + offset, &length, compressed + offsets[i], (uLong) (offsets[i + 1] - offsets[i])) != Z_OK || length != expected)
+            CV_Error(CV_StsError, "Corrupted compressed block\n");
+      }
+   }
+};
+
+void zlib_parallel_uncompress(Byte* dataUncompressed, int64* sizeDataUncompressed, Byte* compressedData, int64 sizeDataCompressed)
+{
+   int64 sizeOriginal = zlib_parallel_uncompressed_size(compressedData, sizeDataCompressed);
+   if (*sizeDataUncompressed < sizeOriginal)
+      CV_Error(CV_StsError, "Output buffer wasn't large enough\n");
+
+   int blockSize = (int) zlibReadLE(compressedData + 4, 4);
+   int blockCount = (int) zlibReadLE(compressedData + 16, 4);
+   if (blockSize <= 0 || blockCount != zlibBlockCount(sizeOriginal, blockSize)
+      || ZLIB_BLOCK_HEADER_SIZE + (int64) blockCount * 4 > sizeDataCompressed)
+      CV_Error(CV_StsError, "Corrupted block compression header\n");
+
+   std::vector<int64> offsets(blockCount + 1);
+   offsets[0] = ZLIB_BLOCK_HEADER_SIZE + (int64) blockCount * 4;
+   for (int i = 0; i < blockCount; i++)
+      offsets[i + 1] = offsets[i] + (int64) zlibReadLE(compressedData + ZLIB_BLOCK_HEADER_SIZE + i * 4, 4);
+   if (offsets[blockCount] > sizeDataCompressed)
+      CV_Error(CV_StsError, "Corrupted block compression index\n");
+
+   ZlibBlockUncompressInvoker invoker;
+   invoker.compressed = compressedData;
+   invoker.offsets = offsets.data();
+   invoker.uncompressed = dataUncompressed;
+   invoker.sizeUncompressed = sizeOriginal;
+   invoker.blockSize = blockSize;
+   cv::parallel_for_(cv::Range(0, blockCount), invoker);
+
+   *sizeDataUncompressed = sizeOriginal;
+}
@@ -16,4 +16,24 @@ CVAPI(int) zlib_compress_bound(int length);
 CVAPI(void) zlib_compress2(Byte* dataCompressed, int* sizeDataCompressed, Byte* dataOriginal, int sizeDataOriginal, int compressionLevel);
 CVAPI(void) zlib_uncompress(Byte* dataUncompressed, int* sizeDataUncompressed, Byte* compressedData, int sizeDataCompressed);
 
+/* Streaming (chunked) compression, the caller feeds the input and drains the output in chunks of any size */
+CVAPI(z_stream*) zlib_deflate_create(int compressionLevel);
+//Returns true when finish is set and all the compressed data has been written to the output
+CVAPI(bool) zlib_deflate(z_stream* stream, Byte* input, int sizeInput, Byte* output, int sizeOutput, int* inputConsumed, int* outputProduced, bool finish);
+CVAPI(void) zlib_deflate_release(z_stream** stream);
+CVAPI(z_stream*) zlib_inflate_create();
+//Returns true when the end of the compressed stream has been reached
+CVAPI(bool) zlib_inflate(z_stream* stream, Byte* input, int sizeInput, Byte* output, int sizeOutput, int* inputConsumed, int* outputProduced);
+CVAPI(void) zlib_inflate_release(z_stream** stream);
+
+/*
+ * Parallel block compression. The data is split into blocks of blockSize bytes that are compressed independently
+ * on all cores. The result is a small header, an index of the compressed size of each block and the compressed blocks.
+ */
+CVAPI(int64) zlib_parallel_compress_bound(int64 length, int blockSize);
+CVAPI(void) zlib_parallel_compress(Byte* dataCompressed, int64* sizeDataCompressed, Byte* dataOriginal, int64 sizeDataOriginal, int compressionLevel, int blockSize);
+//Returns the size of the original data stored in the header of the block compressed data
+CVAPI(int64) zlib_parallel_uncompressed_size(Byte* compressedData, int64 sizeDataCompressed);
+CVAPI(void) zlib_parallel_uncompress(Byte* dataUncompressed, int64* sizeDataUncompressed, Byte* compressedData, int64 sizeDataCompressed);
+
 #endif
\ No newline at end of file
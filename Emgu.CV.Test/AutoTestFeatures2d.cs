@@ -642,5 +642,292 @@ namespace Emgu.CV.Test
             SimpleBlobDetector detector = new SimpleBlobDetector(p);
             MKeyPoint[] keypoints = detector.Detect(box);
         }
+
+        [Test]
+        public void TestDetectAndComputeBatch()
+        {
+            Mat box = EmguAssert.LoadMat("box.png");
+            Mat boxInScene = EmguAssert.LoadMat("box_in_scene.png");
+            Mat[] images = new Mat[] { box, boxInScene, new Mat(100, 100, DepthType.Cv8U, 1), box };
+
+            using (ORB detector = new ORB(500))
+            using (VectorOfMat vImages = new VectorOfMat(images))
+            using (VectorOfKeyPoint keyPoints = new VectorOfKeyPoint())
+            using (Mat descriptors = new Mat())
+            using (VectorOfInt offsets = new VectorOfInt())
+            {
+                detector.DetectAndComputeBatch(vImages, null, keyPoints, descriptors, offsets);
+                int[] offsetArray = offsets.ToArray();
+                EmguAssert.AreEqual(images.Length + 1, offsetArray.Length);
+                EmguAssert.AreEqual(keyPoints.Size, offsetArray[images.Length]);
+                EmguAssert.AreEqual(keyPoints.Size, descriptors.Rows);
+                //No keypoint on the blank image
+                EmguAssert.AreEqual(offsetArray[2], offsetArray[3]);
+
+                //The results match the ones of one image at a time
+                for (int i = 0; i < images.Length; i++)
+                {
+                    using (VectorOfKeyPoint kpts = new VectorOfKeyPoint())
+                    using (Mat d = new Mat())
+                    {
+                        detector.DetectAndCompute(images[i], null, kpts, d, false);
+                        EmguAssert.AreEqual(kpts.Size, offsetArray[i + 1] - offsetArray[i]);
+                        if (kpts.Size > 0)
+                        {
+                            using (Mat rows = new Mat(descriptors, new Emgu.CV.Structure.Range(offsetArray[i], offsetArray[i + 1]), Emgu.CV.Structure.Range.All))
+                                EmguAssert.AreEqual(0.0, CvInvoke.Norm(d, rows, NormType.L1));
+                        }
+                    }
+                }
+            }
+        }
+
+        [Test]
+        public void TestHammingMatcher()
+        {
+            Mat box = EmguAssert.LoadMat("box.png");
+            Mat boxInScene = EmguAssert.LoadMat("box_in_scene.png");
+
+            using (ORB detector = new ORB(500))
+            using (VectorOfKeyPoint modelKeyPoints = new VectorOfKeyPoint())
+            using (VectorOfKeyPoint observedKeyPoints = new VectorOfKeyPoint())
+            using (Mat modelDescriptors = new Mat())
+            using (Mat observedDescriptors = new Mat())
+            using (BFMatcher bf = new BFMatcher(DistanceType.Hamming))
+            using (HammingMatcher hm = new HammingMatcher())
+            using (VectorOfVectorOfDMatch bfMatches = new VectorOfVectorOfDMatch())
+            using (VectorOfVectorOfDMatch hmMatches = new VectorOfVectorOfDMatch())
+            {
+                detector.DetectAndCompute(box, null, modelKeyPoints, modelDescriptors, false);
+                detector.DetectAndCompute(boxInScene, null, observedKeyPoints, observedDescriptors, false);
+
+                bf.Add(modelDescriptors);
+                hm.Add(modelDescriptors);
+                bf.KnnMatch(observedDescriptors, bfMatches, 2, null);
+                hm.KnnMatch(observedDescriptors, hmMatches, 2, null);
+
+                AssertSameMatches(bfMatches, hmMatches);
+            }
+        }
+
+        [Test]
+        public void TestHammingMatcherOddTrainRows()
+        {
+            Mat box = EmguAssert.LoadMat("box.png");
+            Mat boxInScene = EmguAssert.LoadMat("box_in_scene.png");
+
+            using (ORB detector = new ORB(500))
+            using (VectorOfKeyPoint modelKeyPoints = new VectorOfKeyPoint())
+            using (VectorOfKeyPoint observedKeyPoints = new VectorOfKeyPoint())
+            using (Mat modelDescriptors = new Mat())
+            using (Mat observedDescriptors = new Mat())
+            using (BFMatcher bf = new BFMatcher(DistanceType.Hamming))
+            using (HammingMatcher hm = new HammingMatcher())
+            using (VectorOfVectorOfDMatch bfMatches = new VectorOfVectorOfDMatch())
+            using (VectorOfVectorOfDMatch hmMatches = new VectorOfVectorOfDMatch())
+            {
+                detector.DetectAndCompute(box, null, modelKeyPoints, modelDescriptors, false);
+                detector.DetectAndCompute(boxInScene, null, observedKeyPoints, observedDescriptors, false);
+
+                //Two train images with an odd number of rows, such that the last row of each image is a tail row of the SIMD kernels
+                int rows = modelDescriptors.Rows;
+                int firstRows = (rows / 2) | 1;
+                int secondRows = ((rows - firstRows) & 1) == 1 ? rows - firstRows : rows - firstRows - 1;
+                EmguAssert.IsTrue(firstRows % 2 == 1 && secondRows % 2 == 1);
+                using (Mat first = new Mat(modelDescriptors, new Emgu.CV.Structure.Range(0, firstRows), Emgu.CV.Structure.Range.All))
+                using (Mat second = new Mat(modelDescriptors, new Emgu.CV.Structure.Range(firstRows, firstRows + secondRows), Emgu.CV.Structure.Range.All))
+                {
+                    bf.Add(first);
+                    bf.Add(second);
+                    hm.Add(first);
+                    hm.Add(second);
+                }
+
+                bf.KnnMatch(observedDescriptors, bfMatches, 5, null);
+                hm.KnnMatch(observedDescriptors, hmMatches, 5, null);
+                AssertSameMatches(bfMatches, hmMatches);
+            }
+        }
+
+        private static void AssertSameMatches(VectorOfVectorOfDMatch expectedMatches, VectorOfVectorOfDMatch resultMatches)
+        {
+            //Both matchers break ties in favor of the lower train index, the matches must be identical
+            MDMatch[][] expected = expectedMatches.ToArrayOfArray();
+            MDMatch[][] result = resultMatches.ToArrayOfArray();
+            EmguAssert.AreEqual(expected.Length, result.Length);
+            for (int i = 0; i < expected.Length; i++)
+            {
+                EmguAssert.AreEqual(expected[i].Length, result[i].Length);
+                for (int j = 0; j < expected[i].Length; j++)
+                {
+                    EmguAssert.AreEqual(expected[i][j].QueryIdx, result[i][j].QueryIdx);
+                    EmguAssert.AreEqual(expected[i][j].TrainIdx, result[i][j].TrainIdx);
+                    EmguAssert.AreEqual(expected[i][j].ImgIdx, result[i][j].ImgIdx);
+                    EmguAssert.AreEqual(expected[i][j].Distance, result[i][j].Distance);
+                }
+            }
+        }
+
+        [Test]
+        public void TestFeatureMatchPipeline()
+        {
+            Mat box = EmguAssert.LoadMat("box.png");
+            Mat boxInScene = EmguAssert.LoadMat("box_in_scene.png");
+
+            using (ORB detector = new ORB(500))
+            using (VectorOfKeyPoint modelKeyPoints = new VectorOfKeyPoint())
+            using (VectorOfKeyPoint observedKeyPoints = new VectorOfKeyPoint())
+            using (Mat modelDescriptors = new Mat())
+            using (Mat observedDescriptors = new Mat())
+            using (BFMatcher matcher = new BFMatcher(DistanceType.Hamming))
+            using (VectorOfVectorOfDMatch matches = new VectorOfVectorOfDMatch())
+            using (Mat mask = new Mat())
+            using (FeatureMatchPipeline pipeline = new FeatureMatchPipeline(0.8, 1.5, 20, 2))
+            using (VectorOfDMatch inliers = new VectorOfDMatch())
+            {
+                detector.DetectAndCompute(box, null, modelKeyPoints, modelDescriptors, false);
+                detector.DetectAndCompute(boxInScene, null, observedKeyPoints, observedDescriptors, false);
+                matcher.Add(modelDescriptors);
+
+                //The step by step pipeline
+                Mat expected = null;
+                matcher.KnnMatch(observedDescriptors, matches, 2, null);
+                mask.Create(matches.Size, 1, DepthType.Cv8U, 1);
+                mask.SetTo(new MCvScalar(255));
+                Features2DToolbox.VoteForUniqueness(matches, 0.8, mask);
+                int nonZeroCount = CvInvoke.CountNonZero(mask);
+                if (nonZeroCount >= 4)
+                {
+                    nonZeroCount = Features2DToolbox.VoteForSizeAndOrientation(modelKeyPoints, observedKeyPoints, matches, mask, 1.5, 20);
+                    if (nonZeroCount >= 4)
+                        expected = Features2DToolbox.GetHomographyMatrixFromMatchedFeatures(modelKeyPoints, observedKeyPoints, matches, mask, 2);
+                }
+                EmguAssert.IsTrue(expected != null);
+
+                using (Mat homography = pipeline.Match(matcher, modelKeyPoints, observedKeyPoints, observedDescriptors, inliers))
+                {
+                    EmguAssert.IsTrue(homography != null);
+                    EmguAssert.IsTrue(CvInvoke.Norm(expected, homography, NormType.L2) < 1.0e-6);
+                }
+                EmguAssert.AreEqual(CvInvoke.CountNonZero(mask), inliers.Size);
+                byte[] maskData = new byte[mask.Rows];
+                mask.CopyTo(maskData);
+                MDMatch[] inlierArray = inliers.ToArray();
+                foreach (MDMatch m in inlierArray)
+                    EmguAssert.IsTrue(maskData[m.QueryIdx] != 0);
+
+                double[] stageTimes = pipeline.StageTimes;
+                EmguAssert.AreEqual(4, stageTimes.Length);
+                EmguAssert.WriteLine(String.Format("knn match: {0} ms, uniqueness: {1} ms, vote: {2} ms, homography: {3} ms", stageTimes[0], stageTimes[1], stageTimes[2], stageTimes[3]));
+                expected.Dispose();
+            }
+        }
+
+        [Test]
+        public void TestSizeOrientationVoter()
+        {
+            Mat box = EmguAssert.LoadMat("box.png");
+            Mat boxInScene = EmguAssert.LoadMat("box_in_scene.png");
+
+            using (ORB detector = new ORB(2000))
+            using (VectorOfKeyPoint modelKeyPoints = new VectorOfKeyPoint())
+            using (VectorOfKeyPoint observedKeyPoints = new VectorOfKeyPoint())
+            using (Mat modelDescriptors = new Mat())
+            using (Mat observedDescriptors = new Mat())
+            using (BFMatcher matcher = new BFMatcher(DistanceType.Hamming))
+            using (VectorOfVectorOfDMatch matches = new VectorOfVectorOfDMatch())
+            using (Mat mask = new Mat())
+            using (Mat voterMask = new Mat())
+            using (SizeOrientationVoter voter = new SizeOrientationVoter())
+            {
+                detector.DetectAndCompute(box, null, modelKeyPoints, modelDescriptors, false);
+                detector.DetectAndCompute(boxInScene, null, observedKeyPoints, observedDescriptors, false);
+                matcher.Add(modelDescriptors);
+                matcher.KnnMatch(observedDescriptors, matches, 2, null);
+
+                mask.Create(matches.Size, 1, DepthType.Cv8U, 1);
+                mask.SetTo(new MCvScalar(255));
+                int expected = Features2DToolbox.VoteForSizeAndOrientation(modelKeyPoints, observedKeyPoints, matches, mask, 1.5, 20);
+                EmguAssert.IsTrue(expected > 0);
+
+                //The workspace is reused, the sequential and parallel votes give the same mask
+                foreach (bool parallel in new bool[] { false, true, false })
+                {
+                    voterMask.Create(matches.Size, 1, DepthType.Cv8U, 1);
+                    voterMask.SetTo(new MCvScalar(255));
+                    EmguAssert.AreEqual(expected, voter.Vote(modelKeyPoints, observedKeyPoints, matches, voterMask, 1.5, 20, parallel));
+                    EmguAssert.AreEqual(0.0, CvInvoke.Norm(mask, voterMask, NormType.L1));
+                }
+            }
+        }
+
+        [Test]
+        public void TestSizeOrientationVoterParallel()
+        {
+            //Enough matches for several stripes of 8192 matches, most of them agree on a scale of 2 and a rotation of 30 degrees
+            int matchCount = 40000;
+            Random r = new Random(0);
+            MKeyPoint[] modelPoints = new MKeyPoint[500];
+            for (int i = 0; i < modelPoints.Length; i++)
+            {
+                modelPoints[i].Point = new PointF(r.Next(640), r.Next(480));
+                modelPoints[i].Size = 10 + (float)r.NextDouble() * 20;
+                modelPoints[i].Angle = (float)r.NextDouble() * 360;
+            }
+            MKeyPoint[] observedPoints = new MKeyPoint[matchCount];
+            MDMatch[][] matchArray = new MDMatch[matchCount][];
+            for (int i = 0; i < matchCount; i++)
+            {
+                MDMatch m = new MDMatch();
+                m.QueryIdx = i;
+                m.TrainIdx = r.Next(modelPoints.Length);
+                matchArray[i] = new MDMatch[] { m };
+
+                observedPoints[i].Point = new PointF(r.Next(640), r.Next(480));
+                if (r.Next(10) < 6)
+                {
+                    observedPoints[i].Size = modelPoints[m.TrainIdx].Size * (float)(2 + (r.NextDouble() - 0.5) * 0.2);
+                    observedPoints[i].Angle = (modelPoints[m.TrainIdx].Angle + 30 + (float)(r.NextDouble() - 0.5) * 6 + 360) % 360;
+                }
+                else
+                {
+                    observedPoints[i].Size = 1 + (float)r.NextDouble() * 100;
+                    observedPoints[i].Angle = (float)r.NextDouble() * 360;
+                }
+            }
+
+            int numThreads = CvInvoke.NumThreads;
+            try
+            {
+                CvInvoke.NumThreads = 4;
+                using (VectorOfKeyPoint modelKeyPoints = new VectorOfKeyPoint(modelPoints))
+                using (VectorOfKeyPoint observedKeyPoints = new VectorOfKeyPoint(observedPoints))
+                using (VectorOfVectorOfDMatch matches = new VectorOfVectorOfDMatch(matchArray))
+                using (Mat mask = new Mat(matchCount, 1, DepthType.Cv8U, 1))
+                using (Mat voterMask = new Mat())
+                using (SizeOrientationVoter voter = new SizeOrientationVoter())
+                {
+                    //Some of the matches are already rejected
+                    byte[] maskData = new byte[matchCount];
+                    for (int i = 0; i < matchCount; i++)
+                        maskData[i] = (byte)(i % 10 == 0 ? 0 : 255);
+                    mask.SetTo(maskData);
+                    int expected = Features2DToolbox.VoteForSizeAndOrientation(modelKeyPoints, observedKeyPoints, matches, mask, 1.5, 20);
+                    EmguAssert.IsTrue(expected > matchCount / 4 && expected < matchCount * 9 / 10);
+
+                    foreach (bool parallel in new bool[] { true, false, true })
+                    {
+                        voterMask.Create(matchCount, 1, DepthType.Cv8U, 1);
+                        voterMask.SetTo(maskData);
+                        EmguAssert.AreEqual(expected, voter.Vote(modelKeyPoints, observedKeyPoints, matches, voterMask, 1.5, 20, parallel));
+                        EmguAssert.AreEqual(0.0, CvInvoke.Norm(mask, voterMask, NormType.L1));
+                    }
+                }
+            }
+            finally
+            {
+                CvInvoke.NumThreads = numThreads;
+            }
+        }
     }
 }
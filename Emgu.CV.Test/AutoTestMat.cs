@@ -227,6 +227,69 @@ namespace Emgu.CV.Test
             }
         }
 
+        [TestAttribute]
+        public void TestMatPoolAllocator()
+        {
+            using (MatPoolAllocator allocator = new MatPoolAllocator(64 * 1024 * 1024, 2))
+            {
+                for (int i = 0; i < 10; i++)
+                {
+                    using (Mat m = new Mat())
+                    {
+                        allocator.Attach(m);
+                        m.Create(1080, 1920, DepthType.Cv8U, 3);
+                        m.SetTo(new MCvScalar(i));
+                    }
+                }
+                EmguAssert.IsTrue(allocator.Misses == 1);
+                EmguAssert.IsTrue(allocator.Hits == 9);
+                EmguAssert.IsTrue(allocator.BytesRetained >= 1080 * 1920 * 3);
+
+                allocator.Trim();
+                EmguAssert.IsTrue(allocator.BytesRetained == 0);
+            }
+        }
+
+        [TestAttribute]
+        public void TestCommandBuffer()
+        {
+            const int tileCount = 16;
+            using (CommandBuffer buffer = new CommandBuffer())
+            {
+                //register 0: input, register 1: output, register 2: scratch
+                buffer
+                    .CvtColor(0, 2, ColorConversion.Bgr2Gray)
+                    .GaussianBlur(2, 2, new Size(3, 3), 0)
+                    .Threshold(2, 1, 100, 255, ThresholdType.Binary);
+                EmguAssert.IsTrue(buffer.Count == 3);
+                EmguAssert.IsTrue(buffer.RegisterCount == 3);
+
+                Mat[] mats = new Mat[tileCount * 2];
+                for (int i = 0; i < tileCount; i++)
+                {
+                    mats[i * 2] = new Mat(64, 64, DepthType.Cv8U, 3);
+                    mats[i * 2].SetTo(new MCvScalar(i * 16, i * 16, i * 16));
+                    mats[i * 2 + 1] = new Mat();
+                }
+
+                buffer.Execute(mats, tileCount, true);
+
+                for (int i = 0; i < tileCount; i++)
+                {
+                    using (Mat expected = new Mat())
+                    {
+                        CvInvoke.CvtColor(mats[i * 2], expected, ColorConversion.Bgr2Gray);
+                        CvInvoke.GaussianBlur(expected, expected, new Size(3, 3), 0);
+                        CvInvoke.Threshold(expected, expected, 100, 255, ThresholdType.Binary);
+                        EmguAssert.IsTrue(expected.Equals(mats[i * 2 + 1]));
+                    }
+                }
+
+                foreach (Mat m in mats)
+                    m.Dispose();
+            }
+        }
+
         [TestAttribute]
         public void TestQuality()
         {
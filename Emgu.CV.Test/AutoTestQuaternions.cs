@@ -323,5 +323,97 @@ namespace Emgu.CV.Test
          deltaDegree = Math.Abs(y / Math.PI * 180.0 - 0.0);
          EmguAssert.IsTrue(deltaDegree <= epsilon);
       }
+
+      [Test]
+      public void TestQuaternionsArray()
+      {
+         double epsilon = 1.0e-12;
+         Random r = new Random();
+         //odd count to cover the remainder of the vectorized loops
+         int count = 103;
+         QuaternionsArray q1 = new QuaternionsArray(count);
+         QuaternionsArray q2 = new QuaternionsArray(count);
+         Point3D64fArray points = new Point3D64fArray(count);
+         for (int i = 0; i < count; i++)
+         {
+            Quaternions q = new Quaternions();
+            q.SetEuler(r.NextDouble(), r.NextDouble(), r.NextDouble());
+            q1[i] = q;
+            q.SetEuler(r.NextDouble(), r.NextDouble(), r.NextDouble());
+            q2[i] = q;
+            points[i] = new MCvPoint3D64f(r.NextDouble() * 10, r.NextDouble() * 10, r.NextDouble() * 10);
+         }
+
+         QuaternionsArray product = new QuaternionsArray(count);
+         q1.Multiply(q2, product);
+         Point3D64fArray rotated = new Point3D64fArray(count);
+         q1.RotatePoints(points, rotated);
+         Point3D64fArray rotatedByOne = new Point3D64fArray(count);
+         q2[0].RotatePoints(points, rotatedByOne);
+         for (int i = 0; i < count; i++)
+         {
+            Quaternions expected = q1[i] * q2[i];
+            EmguAssert.IsTrue(Math.Abs(product[i].W - expected.W) < epsilon);
+            EmguAssert.IsTrue(Math.Abs(product[i].X - expected.X) < epsilon);
+            EmguAssert.IsTrue(Math.Abs(product[i].Y - expected.Y) < epsilon);
+            EmguAssert.IsTrue(Math.Abs(product[i].Z - expected.Z) < epsilon);
+
+            MCvPoint3D64f delta = rotated[i] - q1[i].RotatePoint(points[i]);
+            EmguAssert.IsTrue(Math.Abs(delta.X) < epsilon && Math.Abs(delta.Y) < epsilon && Math.Abs(delta.Z) < epsilon);
+            delta = rotatedByOne[i] - q2[0].RotatePoint(points[i]);
+            EmguAssert.IsTrue(Math.Abs(delta.X) < epsilon && Math.Abs(delta.Y) < epsilon && Math.Abs(delta.Z) < epsilon);
+         }
+
+         Point3D64fArray euler = new Point3D64fArray(count);
+         q1.GetEuler(euler);
+         for (int i = 0; i < count; i++)
+         {
+            double x = 0, y = 0, z = 0;
+            q1[i].GetEuler(ref x, ref y, ref z);
+            EmguAssert.IsTrue(Math.Abs(euler[i].X - x) < epsilon);
+            EmguAssert.IsTrue(Math.Abs(euler[i].Y - y) < epsilon);
+            EmguAssert.IsTrue(Math.Abs(euler[i].Z - z) < epsilon);
+         }
+      }
+
+      [Test]
+      public void TestQuaternionsRotatePointsNotNormalized()
+      {
+         //The points rotated at once give the same result as rotating them one by one, even if the quaternions are not normalized
+         Quaternions q = new Quaternions();
+         q.W = 1.5;
+         q.X = -0.7;
+         q.Y = 2.0;
+         q.Z = 0.3;
+         Random r = new Random(0);
+         int count = 11;
+         Matrix<double> points = new Matrix<double>(count, 3);
+         Point3D64fArray pointsArray = new Point3D64fArray(count);
+         for (int i = 0; i < count; i++)
+         {
+            MCvPoint3D64f p = new MCvPoint3D64f(r.NextDouble() * 10, r.NextDouble() * 10, r.NextDouble() * 10);
+            points[i, 0] = p.X;
+            points[i, 1] = p.Y;
+            points[i, 2] = p.Z;
+            pointsArray[i] = p;
+         }
+
+         Matrix<double> rotated = new Matrix<double>(count, 3);
+         q.RotatePoints(points, rotated);
+         Point3D64fArray rotatedArray = new Point3D64fArray(count);
+         q.RotatePoints(pointsArray, rotatedArray);
+         for (int i = 0; i < count; i++)
+         {
+            MCvPoint3D64f expected = q.RotatePoint(pointsArray[i]);
+            EmguAssert.AreEqual(expected.X, rotated[i, 0]);
+            EmguAssert.AreEqual(expected.Y, rotated[i, 1]);
+            EmguAssert.AreEqual(expected.Z, rotated[i, 2]);
+
+            //The vectorized loop may fuse the multiply and add
+            double tolerance = 1.0e-12 * (1.0 + Math.Abs(expected.X) + Math.Abs(expected.Y) + Math.Abs(expected.Z));
+            MCvPoint3D64f delta = rotatedArray[i] - expected;
+            EmguAssert.IsTrue(Math.Abs(delta.X) < tolerance && Math.Abs(delta.Y) < tolerance && Math.Abs(delta.Z) < tolerance);
+         }
+      }
    }
 }
\ No newline at end of file
@@ -1401,6 +1401,71 @@ namespace Emgu.CV.Test
             EmguAssert.IsTrue(distances[0, 0] == 0.0);
         }
 
+        [Test]
+        public void TestFlannDescriptorIndex()
+        {
+            float[][] features = new float[100][];
+            for (int i = 0; i < features.Length; i++)
+                features[i] = new float[] { (float)i };
+            String fileName = Path.Combine(Path.GetTempPath(), "descriptorIndex.bin");
+
+            using (Flann.KdTreeIndexParams p = new KdTreeIndexParams(4))
+            using (Flann.DescriptorIndex index = new Flann.DescriptorIndex(p))
+            {
+                //Add the descriptors in batches, the ids follow the order they are added
+                for (int i = 0; i < features.Length; i += 10)
+                {
+                    float[][] batch = new float[10][];
+                    Array.Copy(features, i, batch, 0, batch.Length);
+                    EmguAssert.AreEqual(i, index.Add(CvToolbox.GetMatrixFromArrays(batch)));
+                }
+                EmguAssert.AreEqual(100, index.Count);
+                EmguAssert.IsTrue(index.SegmentCount < 10);
+
+                EmguAssert.AreEqual(2, index.Remove(50, 51, 1000));
+                EmguAssert.AreEqual(98, index.Count);
+
+                float[][] queries = new float[][] { new float[] { 50.2f } };
+                Matrix<int> ids = new Matrix<int>(1, 3);
+                Matrix<float> distances = new Matrix<float>(1, 3);
+                index.KnnSearch(CvToolbox.GetMatrixFromArrays(queries), ids, distances, 3);
+                EmguAssert.AreEqual(49, ids[0, 0]);
+                EmguAssert.AreEqual(52, ids[0, 1]);
+
+                index.Save(fileName);
+            }
+
+            using (Flann.DescriptorIndex index = new Flann.DescriptorIndex(fileName))
+            {
+                EmguAssert.AreEqual(98, index.Count);
+                EmguAssert.AreEqual(100, index.Add(CvToolbox.GetMatrixFromArrays(new float[][] { new float[] { 50.0f } })));
+
+                float[][] queries = new float[][] { new float[] { 50.2f } };
+                Matrix<int> ids = new Matrix<int>(1, 1);
+                Matrix<float> distances = new Matrix<float>(1, 1);
+                index.KnnSearch(CvToolbox.GetMatrixFromArrays(queries), ids, distances, 1);
+                EmguAssert.AreEqual(100, ids[0, 0]);
+
+                //Save over the file the index is mapped from
+                index.Save(fileName);
+                index.KnnSearch(CvToolbox.GetMatrixFromArrays(queries), ids, distances, 1);
+                EmguAssert.AreEqual(100, ids[0, 0]);
+            }
+
+            using (Flann.DescriptorIndex index = new Flann.DescriptorIndex(fileName))
+            {
+                EmguAssert.AreEqual(99, index.Count);
+                float[][] queries = new float[][] { new float[] { 50.2f } };
+                Matrix<int> ids = new Matrix<int>(1, 3);
+                Matrix<float> distances = new Matrix<float>(1, 3);
+                index.KnnSearch(CvToolbox.GetMatrixFromArrays(queries), ids, distances, 3);
+                EmguAssert.AreEqual(100, ids[0, 0]);
+                EmguAssert.AreEqual(49, ids[0, 1]);
+                EmguAssert.AreEqual(52, ids[0, 2]);
+                EmguAssert.AreEqual(101, index.Add(CvToolbox.GetMatrixFromArrays(new float[][] { new float[] { 0.0f } })));
+            }
+        }
+
         /*
         [Test]
         public void TestEigenObjectRecognizer()
@@ -2403,6 +2468,68 @@ namespace Emgu.CV.Test
             File.Delete(fi.FullName);
         }
 
+        [Test]
+        public void TestAsyncVideoWriter()
+        {
+            int numberOfFrames = 30;
+            int width = 300;
+            int height = 200;
+            String fileName = GetTempFileName() + ".avi";
+
+            using (VideoWriter writer = new VideoWriter(fileName, VideoWriter.Fourcc('M', 'J', 'P', 'G'), 5, new Size(width, height), true))
+            using (AsyncVideoWriter asyncWriter = new AsyncVideoWriter(writer, 4, -1, 2))
+            using (Mat frame = new Mat())
+            {
+                for (int i = 0; i < numberOfFrames; i++)
+                {
+                    //The buffer handed back by Write is recycled, it may be empty
+                    frame.Create(height, width, DepthType.Cv8U, 3);
+                    CvInvoke.Randu(frame, new MCvScalar(), new MCvScalar(255, 255, 255));
+                    EmguAssert.IsTrue(asyncWriter.Write(frame));
+                }
+                asyncWriter.Close();
+                EmguAssert.AreEqual((long)numberOfFrames, asyncWriter.WrittenCount);
+                EmguAssert.AreEqual(0L, asyncWriter.DroppedCount);
+                EmguAssert.IsTrue(asyncWriter.MaxQueueDepth <= 4);
+            }
+
+            FileInfo fi = new FileInfo(fileName);
+            EmguAssert.IsTrue(fi.Exists && fi.Length != 0, "File should not be empty");
+            using (VideoCapture capture = new VideoCapture(fileName))
+            using (Mat frame = new Mat())
+            {
+                int count = 0;
+                while (capture.Read(frame))
+                    count++;
+                EmguAssert.AreEqual(numberOfFrames, count);
+            }
+            File.Delete(fi.FullName);
+
+            //Encoding full HD noise is much slower than copying it into the recycled buffer: the producer fills the queue up to
+            //its capacity, passing the high water mark on the way, then waits for the encoder
+            String largeFileName = GetTempFileName() + ".avi";
+            using (VideoWriter writer = new VideoWriter(largeFileName, VideoWriter.Fourcc('M', 'J', 'P', 'G'), 5, new Size(1920, 1080), true))
+            using (AsyncVideoWriter asyncWriter = new AsyncVideoWriter(writer, 4, -1, 2))
+            using (Mat noise = new Mat(1080, 1920, DepthType.Cv8U, 3))
+            using (Mat frame = new Mat())
+            {
+                CvInvoke.Randu(noise, new MCvScalar(), new MCvScalar(255, 255, 255));
+                int highWaterCount = 0;
+                asyncWriter.QueueHighWater += (sender, e) => highWaterCount++;
+                for (int i = 0; i < 12; i++)
+                {
+                    noise.CopyTo(frame);
+                    EmguAssert.IsTrue(asyncWriter.Write(frame));
+                }
+                EmguAssert.AreEqual(4, asyncWriter.MaxQueueDepth);
+                EmguAssert.IsTrue(highWaterCount > 0);
+                asyncWriter.Close();
+                EmguAssert.AreEqual(12L, asyncWriter.WrittenCount);
+                EmguAssert.AreEqual(0L, asyncWriter.DroppedCount);
+            }
+            File.Delete(largeFileName);
+        }
+
         [Test]
         public void TestVideoWriterMSMF()
         {
@@ -2581,6 +2708,229 @@ namespace Emgu.CV.Test
               File.Delete(fileName);
         }*/
 
+        [Test]
+        public void TestTileTiffWriterCompression()
+        {
+            Image<Bgr, Byte> image = new Image<Bgr, byte>(300, 200);
+            image.SetRandUniform(new MCvScalar(), new MCvScalar(255, 255, 255));
+            //Smooth the noise a bit such that the tiles actually compress
+            CvInvoke.GaussianBlur(image, image, new Size(5, 5), 0);
+            Size tileSize = new Size(32, 32);
+            String fileName = Path.Combine(Path.GetTempPath(), "tileCompression.tiff");
+
+            foreach (TiffCompression compression in new TiffCompression[] { TiffCompression.None, TiffCompression.Lzw, TiffCompression.Deflate, TiffCompression.Zstd })
+            {
+                bool exceptionCaught = false;
+                try
+                {
+                    using (TileTiffWriter<Bgr, Byte> writer = new TileTiffWriter<Bgr, byte>(fileName, image.Size, tileSize, compression, -1, 2))
+                    {
+                        EmguAssert.IsTrue(tileSize == writer.TileSize, "Tile size not equals");
+                        writer.WriteImage(image);
+                    }
+                }
+                catch (CvException)
+                {
+                    //libtiff may be built without ZSTD
+                    exceptionCaught = true;
+                }
+                if (exceptionCaught)
+                {
+                    EmguAssert.AreEqual(TiffCompression.Zstd, compression);
+                    continue;
+                }
+
+                //The full image is followed by the overviews, each reduced from the previous one
+                Mat[] pages = CvInvoke.Imreadmulti(fileName);
+                try
+                {
+                    EmguAssert.AreEqual(3, pages.Length);
+                    Mat expected = image.Mat.Clone();
+                    for (int i = 0; i < pages.Length; i++)
+                    {
+                        if (i > 0)
+                        {
+                            Mat reduced = new Mat();
+                            CvInvoke.Resize(expected, reduced, new Size((expected.Cols + 1) / 2, (expected.Rows + 1) / 2), 0, 0, Inter.Area);
+                            expected.Dispose();
+                            expected = reduced;
+                        }
+                        EmguAssert.IsTrue(expected.Size == pages[i].Size, String.Format("{0}: the size of page {1} is wrong", compression, i));
+                        EmguAssert.AreEqual(0.0, CvInvoke.Norm(expected, pages[i], NormType.C), String.Format("{0}: the pixels of page {1} are different", compression, i));
+                    }
+                    expected.Dispose();
+                }
+                finally
+                {
+                    foreach (Mat page in pages)
+                        page.Dispose();
+                }
+            }
+            if (File.Exists(fileName))
+                File.Delete(fileName);
+        }
+
+        //Read each level whole, then random regions of random levels, and compare them with the expected pixels
+        private static void CheckTiffReader(TiffReader reader, Mat[] expected)
+        {
+            EmguAssert.AreEqual(expected.Length, reader.LevelCount);
+            EmguAssert.AreEqual(DepthType.Cv8U, reader.Depth);
+            EmguAssert.AreEqual(3, reader.NumberOfChannels);
+            for (int level = 0; level < expected.Length; level++)
+            {
+                TiffLevelInfo info = reader.GetLevelInfo(level);
+                EmguAssert.IsTrue(expected[level].Size == info.ImageSize, String.Format("The size of level {0} is wrong", level));
+                using (Mat m = reader.Read(new Rectangle(Point.Empty, info.ImageSize), level))
+                    EmguAssert.AreEqual(0.0, CvInvoke.Norm(expected[level], m, NormType.C));
+            }
+
+            Random r = new Random(0);
+            using (Mat dst = new Mat())
+            {
+                for (int i = 0; i < 200; i++)
+                {
+                    int level = r.Next(expected.Length);
+                    Size size = expected[level].Size;
+                    int width = r.Next(1, Math.Min(size.Width, 120) + 1);
+                    int height = r.Next(1, Math.Min(size.Height, 90) + 1);
+                    Rectangle roi = new Rectangle(r.Next(size.Width - width + 1), r.Next(size.Height - height + 1), width, height);
+                    reader.Read(roi, dst, level);
+                    using (Mat expectedRoi = new Mat(expected[level], roi))
+                        EmguAssert.AreEqual(0.0, CvInvoke.Norm(expectedRoi, dst, NormType.C), String.Format("Level {0}, region {1} is wrong", level, roi));
+                }
+            }
+
+            bool exceptionCaught = false;
+            try
+            {
+                Size size = expected[0].Size;
+                reader.Read(new Rectangle(size.Width - 10, 0, 20, 10));
+            }
+            catch (CvException)
+            {
+                exceptionCaught = true;
+            }
+            EmguAssert.IsTrue(exceptionCaught, "A region outside of the image should not be read");
+        }
+
+        [Test]
+        public void TestTiffReader()
+        {
+            Image<Bgr, Byte> image = new Image<Bgr, byte>(517, 333);
+            image.SetRandUniform(new MCvScalar(), new MCvScalar(255, 255, 255));
+            String fileName = Path.Combine(Path.GetTempPath(), "tiffReader.tiff");
+
+            //The reader returns the channels in the order of the file, RGB, each overview is reduced from the previous level
+            Mat[] expected = new Mat[3];
+            using (Image<Rgb, Byte> rgb = image.Convert<Rgb, Byte>())
+                expected[0] = rgb.Mat.Clone();
+            for (int i = 1; i < expected.Length; i++)
+            {
+                expected[i] = new Mat();
+                CvInvoke.Resize(expected[i - 1], expected[i], new Size((expected[i - 1].Cols + 1) / 2, (expected[i - 1].Rows + 1) / 2), 0, 0, Inter.Area);
+            }
+
+            try
+            {
+                Size tileSize = new Size(48, 32);
+                using (TileTiffWriter<Bgr, Byte> writer = new TileTiffWriter<Bgr, byte>(fileName, image.Size, tileSize, TiffCompression.Deflate, -1, expected.Length - 1))
+                    writer.WriteImage(image);
+
+                //A cache of a few tiles, such that the tiles are evicted and decoded again
+                using (TiffReader reader = new TiffReader(fileName, 3))
+                {
+                    for (int level = 0; level < expected.Length; level++)
+                    {
+                        TiffLevelInfo info = reader.GetLevelInfo(level);
+                        EmguAssert.IsTrue(info.IsTiled);
+                        EmguAssert.IsTrue(tileSize == info.TileSize);
+                    }
+                    CheckTiffReader(reader, expected);
+                }
+
+                //The image written by lines is stored in strips, without overviews
+                using (TiffWriter<Bgr, Byte> writer = new TiffWriter<Bgr, byte>(fileName))
+                    writer.WriteImage(image);
+                using (TiffReader reader = new TiffReader(fileName, 3))
+                {
+                    EmguAssert.IsFalse(reader.GetLevelInfo().IsTiled);
+                    CheckTiffReader(reader, new Mat[] { expected[0] });
+                }
+            }
+            finally
+            {
+                foreach (Mat m in expected)
+                    m.Dispose();
+                if (File.Exists(fileName))
+                    File.Delete(fileName);
+            }
+        }
+
+        [Test]
+        public void TestTiffGeoTagRoundTrip()
+        {
+            Image<Bgr, Byte> image = new Image<Bgr, byte>(200, 150);
+            image.SetRandUniform(new MCvScalar(), new MCvScalar(255, 255, 255));
+            String fileName = Path.Combine(Path.GetTempPath(), "tiffGeoTag.tiff");
+            double[] modelTiepoint = new double[] { 0, 0, 0, 151.2093, -33.8688, 0 };
+            double[] modelPixelScale = new double[] { 0.001, 0.002, 0 };
+            String citation = "WGS 84 test citation";
+
+            try
+            {
+                //The geo tags are written before the image, the overview is written in its own directory after them
+                using (TileTiffWriter<Bgr, Byte> writer = new TileTiffWriter<Bgr, byte>(fileName, image.Size, new Size(64, 64), TiffCompression.Deflate, -1, 1))
+                {
+                    writer.WriteGeoTag(modelTiepoint, modelPixelScale, citation);
+                    writer.WriteImage(image);
+                }
+
+                using (TiffReader reader = new TiffReader(fileName))
+                {
+                    double[] tiepoint, pixelScale;
+                    EmguAssert.IsTrue(reader.TryGetGeoTag(out tiepoint, out pixelScale));
+                    EmguAssert.IsTrue(modelTiepoint.SequenceEqual(tiepoint));
+                    EmguAssert.IsTrue(modelPixelScale.SequenceEqual(pixelScale));
+
+                    //The keys written by WriteGeoTag: a geographic model, pixels as areas, WGS 84 in degrees
+                    double value;
+                    EmguAssert.IsTrue(reader.TryGetGeoKey(1024, out value)); //GTModelTypeGeoKey
+                    EmguAssert.AreEqual(2.0, value); //ModelTypeGeographic
+                    EmguAssert.IsTrue(reader.TryGetGeoKey(1025, out value)); //GTRasterTypeGeoKey
+                    EmguAssert.AreEqual(1.0, value); //RasterPixelIsArea
+                    EmguAssert.IsTrue(reader.TryGetGeoKey(2048, out value)); //GeographicTypeGeoKey
+                    EmguAssert.AreEqual(4326.0, value); //GCS_WGS_84
+                    EmguAssert.IsTrue(reader.TryGetGeoKey(2054, out value)); //GeogAngularUnitsGeoKey
+                    EmguAssert.AreEqual(9102.0, value); //Angular_Degree
+
+                    String text;
+                    EmguAssert.IsTrue(reader.TryGetGeoKey(1026, out text)); //GTCitationGeoKey
+                    EmguAssert.AreEqual(citation, text);
+
+                    //Missing keys, and a numeric key read as a string
+                    EmguAssert.IsFalse(reader.TryGetGeoKey(3072, out value)); //ProjectedCSTypeGeoKey
+                    EmguAssert.IsFalse(reader.TryGetGeoKey(3073, out text)); //PCSCitationGeoKey
+                    EmguAssert.IsFalse(reader.TryGetGeoKey(1024, out text));
+                }
+
+                //A file without geo information
+                using (TiffWriter<Bgr, Byte> writer = new TiffWriter<Bgr, byte>(fileName))
+                    writer.WriteImage(image);
+                using (TiffReader reader = new TiffReader(fileName))
+                {
+                    double[] tiepoint, pixelScale;
+                    double value;
+                    EmguAssert.IsFalse(reader.TryGetGeoTag(out tiepoint, out pixelScale));
+                    EmguAssert.IsFalse(reader.TryGetGeoKey(1024, out value));
+                }
+            }
+            finally
+            {
+                if (File.Exists(fileName))
+                    File.Delete(fileName);
+            }
+        }
+
         [Test]
         public void TestDataLogger()
         {
@@ -2604,6 +2954,228 @@ namespace Emgu.CV.Test
             }
         }
 
+        [Test]
+        public void TestDataLoggerAsync()
+        {
+            int received = 0;
+            using (DataLogger logger = new DataLogger(1, 1024, sizeof(int), DataLogger.OverflowPolicy.DropNewest, 32))
+            {
+                logger.OnBatchReceived +=
+                    delegate (object sender, DataBatchEventArgs e)
+                    {
+                        EmguAssert.IsTrue(e.RecordSize == sizeof(int));
+                        System.Threading.Interlocked.Add(ref received, e.Count);
+                    };
+
+                IntPtr data = Marshal.AllocHGlobal(sizeof(int));
+                for (int i = 0; i < 500; i++)
+                {
+                    Marshal.WriteInt32(data, i);
+                    logger.Log(data, 1);
+                }
+                Marshal.FreeHGlobal(data);
+
+                logger.Flush();
+                EmguAssert.IsTrue(logger.EnqueuedCount + logger.DroppedCount == 500);
+                EmguAssert.IsTrue(logger.DispatchedCount == logger.EnqueuedCount);
+                EmguAssert.IsTrue(received == logger.DispatchedCount);
+            }
+        }
+
+        [Test]
+        public void TestZlibBlockCompression()
+        {
+            using (Mat m = new Mat(2048, 2048, DepthType.Cv8U, 3))
+            {
+                CvInvoke.Randu(m, new MCvScalar(), new MCvScalar(20, 20, 20));
+                Byte[] raw = m.GetRawData();
+
+                Byte[] blocks = ZlibBlockCompression.Compress(m, 6, 256 * 1024);
+                EmguAssert.AreEqual(raw.Length, ZlibBlockCompression.GetUncompressedSize(blocks));
+                using (Mat m2 = new Mat(m.Size, DepthType.Cv8U, 3))
+                {
+                    ZlibBlockCompression.Uncompress(blocks, m2);
+                    EmguAssert.IsTrue(m.Equals(m2));
+                }
+
+                using (MemoryStream ms = new MemoryStream())
+                {
+                    using (ZlibStream zs = new ZlibStream(ms, System.IO.Compression.CompressionMode.Compress, 6, 4096, true))
+                    {
+                        zs.Write(m);
+                    }
+                    ms.Position = 0;
+                    using (ZlibStream zs = new ZlibStream(ms, System.IO.Compression.CompressionMode.Decompress, 6, 4096, true))
+                    using (Mat m3 = new Mat(m.Size, DepthType.Cv8U, 3))
+                    {
+                        zs.Read(m3);
+                        EmguAssert.IsTrue(m.Equals(m3));
+                        EmguAssert.AreEqual(0, zs.Read(new Byte[16], 0, 16));
+                    }
+                }
+            }
+        }
+
+        [Test]
+        public void TestZlibStreamChunks()
+        {
+            //Many times the chunk size, half of it random such that some chunks of compressed data are full
+            Byte[] original = new Byte[(1 << 20) + 12345];
+            Random r = new Random(0);
+            for (int i = 0; i < original.Length; i++)
+                original[i] = (i / 4096) % 2 == 0 ? (Byte)r.Next(256) : (Byte)(i % 7);
+            int chunkSize = 16 * 1024;
+
+            using (MemoryStream ms = new MemoryStream())
+            {
+                //Written and read back in pieces that do not line up with the chunks
+                using (ZlibStream zs = new ZlibStream(ms, System.IO.Compression.CompressionMode.Compress, 6, chunkSize, true))
+                {
+                    for (int offset = 0; offset < original.Length; offset += 10007)
+                        zs.Write(original, offset, Math.Min(10007, original.Length - offset));
+                }
+                EmguAssert.IsTrue(ms.Length > 4 * chunkSize);
+
+                ms.Position = 0;
+                Byte[] result = new Byte[original.Length];
+                using (ZlibStream zs = new ZlibStream(ms, System.IO.Compression.CompressionMode.Decompress, 6, chunkSize, true))
+                {
+                    int total = 0;
+                    int read;
+                    while ((read = zs.Read(result, total, Math.Min(7777, result.Length - total))) > 0)
+                        total += read;
+                    EmguAssert.AreEqual(original.Length, total);
+                    EmguAssert.AreEqual(0, zs.Read(new Byte[16], 0, 16));
+                }
+                EmguAssert.IsTrue(original.SequenceEqual(result));
+            }
+        }
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        private static extern int zlib_compress_bound(int length);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        private static extern void zlib_compress2(IntPtr dataCompressed, ref int sizeDataCompressed, IntPtr dataOriginal, int sizeDataOriginal, int compressionLevel);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        private static extern void zlib_uncompress(IntPtr dataUncompressed, ref int sizeDataUncompressed, IntPtr compressedData, int sizeDataCompressed);
+
+        //The MB/s of the action processing the given number of bytes, after a warm up run
+        private static double MeasureThroughput(Action action, long bytes, int iterations)
+        {
+            action();
+            Stopwatch watch = Stopwatch.StartNew();
+            for (int i = 0; i < iterations; i++)
+                action();
+            watch.Stop();
+            return (double)bytes * iterations / (1 << 20) / watch.Elapsed.TotalSeconds;
+        }
+
+        //The average milliseconds of the action, after a warm up run
+        private static double MeasureMilliseconds(Action action, int iterations)
+        {
+            action();
+            Stopwatch watch = Stopwatch.StartNew();
+            for (int i = 0; i < iterations; i++)
+                action();
+            watch.Stop();
+            return watch.Elapsed.TotalMilliseconds / iterations;
+        }
+
+        [Test]
+        public void TestZlibBlockCompressionThroughput()
+        {
+            using (Mat m = new Mat(2048, 2048, DepthType.Cv8U, 3))
+            {
+                CvInvoke.Randu(m, new MCvScalar(), new MCvScalar(20, 20, 20));
+                Byte[] raw = m.GetRawData();
+                Byte[] oneShot = new Byte[zlib_compress_bound(raw.Length)];
+                Byte[] uncompressed = new Byte[raw.Length];
+                Byte[] blocks = null;
+                int oneShotSize = 0;
+                int iterations = 5;
+
+                GCHandle rawHandle = GCHandle.Alloc(raw, GCHandleType.Pinned);
+                GCHandle oneShotHandle = GCHandle.Alloc(oneShot, GCHandleType.Pinned);
+                GCHandle uncompressedHandle = GCHandle.Alloc(uncompressed, GCHandleType.Pinned);
+                try
+                {
+                    //The same payload and compression level through the one-shot zlib calls and the parallel blocks
+                    double oneShotCompress = MeasureThroughput(delegate
+                    {
+                        oneShotSize = oneShot.Length;
+                        zlib_compress2(oneShotHandle.AddrOfPinnedObject(), ref oneShotSize, rawHandle.AddrOfPinnedObject(), raw.Length, 6);
+                    }, raw.Length, iterations);
+                    double blockCompress = MeasureThroughput(delegate
+                    {
+                        blocks = ZlibBlockCompression.Compress(rawHandle.AddrOfPinnedObject(), raw.Length, 6);
+                    }, raw.Length, iterations);
+
+                    double oneShotUncompress = MeasureThroughput(delegate
+                    {
+                        int size = uncompressed.Length;
+                        zlib_uncompress(uncompressedHandle.AddrOfPinnedObject(), ref size, oneShotHandle.AddrOfPinnedObject(), oneShotSize);
+                        EmguAssert.AreEqual(raw.Length, size);
+                    }, raw.Length, iterations);
+                    EmguAssert.IsTrue(raw.SequenceEqual(uncompressed));
+
+                    Array.Clear(uncompressed, 0, uncompressed.Length);
+                    double blockUncompress = MeasureThroughput(delegate
+                    {
+                        EmguAssert.AreEqual((long)raw.Length, ZlibBlockCompression.Uncompress(blocks, uncompressedHandle.AddrOfPinnedObject(), uncompressed.Length));
+                    }, raw.Length, iterations);
+                    EmguAssert.IsTrue(raw.SequenceEqual(uncompressed));
+
+                    Trace.WriteLine(String.Format(
+                        "{0} bytes, {1} threads. zlib one shot: {2} bytes, compress {3:F1} MB/s, uncompress {4:F1} MB/s; parallel blocks: {5} bytes, compress {6:F1} MB/s, uncompress {7:F1} MB/s",
+                        raw.Length, CvInvoke.NumThreads, oneShotSize, oneShotCompress, oneShotUncompress, blocks.Length, blockCompress, blockUncompress));
+                }
+                finally
+                {
+                    rawHandle.Free();
+                    oneShotHandle.Free();
+                    uncompressedHandle.Free();
+                }
+            }
+        }
+
+        [Test]
+        public void TestDnnBlobFromImagesFusedPerformance()
+        {
+            //A batch of 1080p frames to a 640x640 network input
+            Mat[] images = new Mat[8];
+            for (int i = 0; i < images.Length; i++)
+            {
+                images[i] = new Mat(1080, 1920, DepthType.Cv8U, 3);
+                CvInvoke.Randu(images[i], new MCvScalar(), new MCvScalar(255, 255, 255));
+            }
+            Size size = new Size(640, 640);
+            int iterations = 10;
+
+            using (VectorOfMat vm = new VectorOfMat(images))
+            using (Mat blob = new Mat())
+            using (Mat fusedBlob = new Mat())
+            {
+                foreach (bool crop in new bool[] { false, true })
+                {
+                    ImagePaddingMode mode = crop ? ImagePaddingMode.CropCenter : ImagePaddingMode.Null;
+                    double multiPassMs = MeasureMilliseconds(delegate
+                    {
+                        DnnInvoke.BlobFromImages(vm, blob, 1.0 / 255, size, new MCvScalar(), true, crop);
+                    }, iterations);
+                    double fusedMs = MeasureMilliseconds(delegate
+                    {
+                        DnnInvoke.BlobFromImagesFused(vm, fusedBlob, 1.0 / 255, size, new MCvScalar(), true, mode);
+                    }, iterations);
+                    EmguAssert.IsTrue(CvInvoke.Norm(blob, fusedBlob, NormType.C) <= 1.01 / 255);
+
+                    Trace.WriteLine(String.Format(
+                        "{0} images {1}x{2} to {3}x{4}, {5}, {6} threads. BlobFromImages: {7:F2} ms, BlobFromImagesFused: {8:F2} ms",
+                        images.Length, images[0].Width, images[0].Height, size.Width, size.Height, mode, CvInvoke.NumThreads, multiPassMs, fusedMs));
+                }
+            }
+        }
+
         [Test]
         public void Test_VectorOfFloat()
         {
@@ -2726,6 +3298,73 @@ namespace Emgu.CV.Test
 
         }
 
+        [Test]
+        public void TestVectorArena()
+        {
+            using (VectorArena arena = new VectorArena())
+            {
+                for (int frame = 0; frame < 3; frame++)
+                {
+                    for (int i = 0; i < 10; i++)
+                    {
+                        using (VectorOfPoint points = new VectorOfPoint(arena))
+                        using (VectorOfRect rects = new VectorOfRect(arena, 2))
+                        {
+                            EmguAssert.AreEqual(0, points.Size);
+                            EmguAssert.AreEqual(2, rects.Size);
+                            points.Push(new Point[] { new Point(i, frame), new Point(frame, i) });
+                            EmguAssert.AreEqual(2, points.Size);
+                        }
+                    }
+                    EmguAssert.AreEqual(20, arena.InUseCount);
+                    EmguAssert.AreEqual(20, arena.RetainedCount);
+                    arena.Reset();
+                    EmguAssert.AreEqual(0, arena.InUseCount);
+                }
+                arena.Clear();
+                EmguAssert.AreEqual(0, arena.RetainedCount);
+            }
+        }
+
+        [Test]
+        public void TestVectorOfVectorFlatten()
+        {
+            using (Mat m = new Mat(480, 640, DepthType.Cv8U, 1))
+            using (VectorOfVectorOfPoint contours = new VectorOfVectorOfPoint())
+            {
+                m.SetTo(new MCvScalar());
+                for (int i = 0; i < 100; i++)
+                    CvInvoke.Circle(m, new Point(20 + (i % 10) * 60, 20 + (i / 10) * 45), 10, new MCvScalar(255), -1);
+                CvInvoke.FindContours(m, contours, null, RetrType.List, ChainApproxMethod.ChainApproxNone);
+
+                int[] offsets;
+                Point[] points = contours.Flatten(out offsets);
+                EmguAssert.AreEqual(contours.Size + 1, offsets.Length);
+                EmguAssert.AreEqual(contours.TotalItemCount, points.Length);
+                for (int i = 0; i < contours.Size; i++)
+                {
+                    using (VectorOfPoint contour = contours[i])
+                    {
+                        Point[] p = contour.ToArray();
+                        EmguAssert.AreEqual(p.Length, offsets[i + 1] - offsets[i]);
+                        for (int j = 0; j < p.Length; j++)
+                            EmguAssert.IsTrue(p[j] == points[offsets[i] + j]);
+                    }
+                }
+
+                using (VectorOfVectorOfPoint copy = new VectorOfVectorOfPoint(points, offsets))
+                {
+                    EmguAssert.AreEqual(contours.Size, copy.Size);
+                    int[] copyOffsets;
+                    Point[] copyPoints = copy.Flatten(out copyOffsets);
+                    for (int i = 0; i < offsets.Length; i++)
+                        EmguAssert.AreEqual(offsets[i], copyOffsets[i]);
+                    for (int i = 0; i < points.Length; i++)
+                        EmguAssert.IsTrue(points[i] == copyPoints[i]);
+                }
+            }
+        }
+
         [Test]
         public void TestRotationMatrix2D()
         {
@@ -3625,6 +4264,545 @@ namespace Emgu.CV.Test
             */
         }
 
+        [Test]
+        public void TestDnnBatchExecutor()
+        {
+            CheckAndDownloadFile("bvlc_googlenet.caffemodel", "http://dl.caffe.berkeleyvision.org/");
+            Mat img = EmguAssert.LoadMat("space_shuttle.jpg");
+            Size inputSize = new Size(224, 224);
+            MCvScalar mean = new MCvScalar(104, 117, 123);
+
+            //Distinct images: crops of different regions, some of them flipped, all resized to the input size
+            Mat[] images = new Mat[8];
+            for (int i = 0; i < images.Length; i++)
+            {
+                Rectangle roi = new Rectangle(i * img.Width / 32, i * img.Height / 32, img.Width / 2, img.Height / 2);
+                images[i] = new Mat();
+                using (Mat crop = new Mat(img, roi))
+                    CvInvoke.Resize(crop, images[i], inputSize);
+                if (i % 2 == 1)
+                    CvInvoke.Flip(images[i], images[i], FlipType.Horizontal);
+            }
+
+            using (Dnn.Net net = DnnInvoke.ReadNetFromCaffe("bvlc_googlenet.prototxt", "bvlc_googlenet.caffemodel"))
+            {
+                //The reference outputs, one forward pass per image
+                Mat[] expected = new Mat[images.Length];
+                for (int i = 0; i < images.Length; i++)
+                {
+                    using (Mat blob = DnnInvoke.BlobFromImage(images[i], 1.0, inputSize, mean))
+                    {
+                        net.SetInput(blob);
+                        using (Mat prob = net.Forward("prob"))
+                            expected[i] = prob.Clone();
+                    }
+                }
+                //The images must give different outputs for the order of the slices to be checked
+                for (int i = 1; i < images.Length; i++)
+                    EmguAssert.IsTrue(CvInvoke.Norm(expected[i], expected[i - 1], NormType.C) > 1.0e-3);
+
+                //Resize nothing, such that a mis-sized image is rejected
+                using (DnnBatchExecutor executor = new DnnBatchExecutor(net, 4, 200, 1.0, new Size(), mean, false, false, DepthType.Cv32F, new String[] { "prob" }))
+                {
+                    //Submitted from one thread within the wait time, such that the requests are coalesced into batches
+                    Mat[][] callbackOutputs = new Mat[images.Length][];
+                    String[] callbackErrors = new String[images.Length];
+                    DnnBatchRequest[] requests = new DnnBatchRequest[images.Length];
+                    using (System.Threading.CountdownEvent callbacks = new System.Threading.CountdownEvent(images.Length))
+                    {
+                        for (int i = 0; i < images.Length; i++)
+                        {
+                            int index = i;
+                            requests[i] = executor.Submit(images[i], (outputs, error) =>
+                            {
+                                callbackOutputs[index] = outputs;
+                                callbackErrors[index] = error;
+                                callbacks.Signal();
+                            });
+                        }
+                        EmguAssert.IsTrue(callbacks.Wait(60000));
+                    }
+
+                    for (int i = 0; i < images.Length; i++)
+                    {
+                        Mat[] outputs = requests[i].GetOutputs();
+                        requests[i].Dispose();
+                        EmguAssert.AreEqual(1, outputs.Length);
+                        EmguAssert.AreEqual(1, outputs[0].SizeOfDimension[0]);
+                        EmguAssert.AreEqual(1000, outputs[0].SizeOfDimension[1]);
+                        //The slice of each request is the output of its own image
+                        EmguAssert.IsTrue(CvInvoke.Norm(outputs[0], expected[i], NormType.C) < 1.0e-4);
+
+                        EmguAssert.IsTrue(callbackErrors[i] == null);
+                        EmguAssert.AreEqual(1, callbackOutputs[i].Length);
+                        EmguAssert.IsTrue(CvInvoke.Norm(callbackOutputs[i][0], outputs[0], NormType.C) == 0);
+                    }
+                    EmguAssert.AreEqual((long) images.Length, executor.RequestCount);
+                    EmguAssert.IsTrue(executor.BatchCount <= images.Length);
+                    Trace.WriteLine(String.Format("Average batch size: {0}, average latency: {1}ms, average inference: {2}ms",
+                        executor.AverageBatchSize, executor.AverageLatencyMs, executor.AverageInferenceMs));
+
+                    //An image of another size is rejected by Submit, the executor keeps running
+                    bool exceptionCaught = false;
+                    using (Mat misSized = new Mat(img, new Rectangle(0, 0, 200, 200)))
+                    {
+                        try
+                        {
+                            executor.Submit(misSized, (outputs, error) => { EmguAssert.IsTrue(false); });
+                        }
+                        catch (CvException)
+                        {
+                            exceptionCaught = true;
+                        }
+                    }
+                    EmguAssert.IsTrue(exceptionCaught);
+
+                    Mat[] output = executor.Infer(images[0]);
+                    EmguAssert.IsTrue(CvInvoke.Norm(output[0], expected[0], NormType.C) < 1.0e-4);
+                }
+            }
+        }
+
+        //The rows of a [1, 1, N, 7] DetectionOutput blob with a confidence above the threshold
+        private static float[][] GetDetections(Mat detection, float confidenceThreshold)
+        {
+            int[] dim = detection.SizeOfDimension;
+            float[] values = new float[dim[2] * dim[3]];
+            Marshal.Copy(detection.DataPointer, values, 0, values.Length);
+            List<float[]> rows = new List<float[]>();
+            for (int i = 0; i < dim[2]; i++)
+            {
+                float[] row = new float[dim[3]];
+                Array.Copy(values, i * dim[3], row, 0, dim[3]);
+                //Every row of a request is tagged with the image index 0
+                EmguAssert.AreEqual(0.0f, row[0]);
+                if (row[2] > confidenceThreshold)
+                    rows.Add(row);
+            }
+            return rows.ToArray();
+        }
+
+        [Test]
+        public void TestDnnBatchExecutorDetections()
+        {
+            String ssdFile = "VGG_VOC0712_SSD_300x300_iter_120000.caffemodel";
+            String ssdProtoFile = "VGG_VOC0712_SSD_300x300_iter_120000.prototxt";
+            String emguS3Base = "https://s3.amazonaws.com/emgu-public/";
+            CheckAndDownloadFile(ssdFile, emguS3Base);
+            CheckAndDownloadFile(ssdProtoFile, emguS3Base);
+
+            Size inputSize = new Size(300, 300);
+            MCvScalar mean = new MCvScalar(104, 117, 123);
+            float confidenceThreshold = 0.5f;
+
+            //Distinct images, such that the detections of each request can be told apart
+            Mat dog = EmguAssert.LoadMat("dog416.png");
+            Mat pedestrian = EmguAssert.LoadMat("pedestrian.png");
+            Mat[] images = new Mat[] { dog, pedestrian, new Mat(), new Mat() };
+            CvInvoke.Flip(dog, images[2], FlipType.Horizontal);
+            CvInvoke.Flip(pedestrian, images[3], FlipType.Horizontal);
+
+            using (Dnn.Net net = DnnInvoke.ReadNetFromCaffe(ssdProtoFile, ssdFile))
+            {
+                String outputName = net.UnconnectedOutLayersNames[0];
+
+                //The reference detections, one forward pass per image
+                float[][][] expected = new float[images.Length][][];
+                for (int i = 0; i < images.Length; i++)
+                {
+                    using (Mat blob = DnnInvoke.BlobFromImage(images[i], 1.0, inputSize, mean))
+                    {
+                        net.SetInput(blob);
+                        using (Mat detection = net.Forward(outputName))
+                            expected[i] = GetDetections(detection, confidenceThreshold);
+                    }
+                }
+                EmguAssert.IsTrue(expected[0].Length > 0);
+
+                //The DetectionOutput blob of a batch is [1, 1, N, 7], it is split on the image index of its rows
+                using (DnnBatchExecutor executor = new DnnBatchExecutor(net, images.Length, 1000, 1.0, inputSize, mean, false, false, DepthType.Cv32F, new String[] { outputName }))
+                {
+                    DnnBatchRequest[] requests = new DnnBatchRequest[images.Length];
+                    for (int i = 0; i < images.Length; i++)
+                        requests[i] = executor.Submit(images[i]);
+
+                    for (int i = 0; i < images.Length; i++)
+                    {
+                        Mat[] outputs = requests[i].GetOutputs();
+                        requests[i].Dispose();
+                        EmguAssert.AreEqual(1, outputs.Length);
+                        int[] dim = outputs[0].SizeOfDimension;
+                        EmguAssert.AreEqual(4, dim.Length);
+                        EmguAssert.AreEqual(7, dim[3]);
+
+                        float[][] detections = GetDetections(outputs[0], confidenceThreshold);
+                        EmguAssert.AreEqual(expected[i].Length, detections.Length);
+                        for (int j = 0; j < detections.Length; j++)
+                        {
+                            //Same class, close confidence and box
+                            EmguAssert.AreEqual(expected[i][j][1], detections[j][1]);
+                            for (int k = 2; k < 7; k++)
+                                EmguAssert.IsTrue(Math.Abs(expected[i][j][k] - detections[j][k]) < 1.0e-3);
+                        }
+                    }
+                    EmguAssert.AreEqual((long) images.Length, executor.RequestCount);
+                    //The requests were coalesced, otherwise the split on the image index is not exercised
+                    EmguAssert.IsTrue(executor.BatchCount < images.Length);
+                }
+            }
+        }
+
+        [Test]
+        public void TestDnnBlobFromImagesFused()
+        {
+            Mat img = EmguAssert.LoadMat("space_shuttle.jpg");
+            Mat[] images = new Mat[] { img, img, img, img };
+            Size size = new Size(300, 300);
+            MCvScalar mean = new MCvScalar(104, 117, 123);
+
+            using (VectorOfMat vm = new VectorOfMat(images))
+            {
+                foreach (bool crop in new bool[] { false, true })
+                    foreach (bool swapRB in new bool[] { false, true })
+                        using (Mat expected = DnnInvoke.BlobFromImages(images, 1.0 / 255, size, mean, swapRB, crop))
+                        using (Mat blob = new Mat())
+                        {
+                            DnnInvoke.BlobFromImagesFused(vm, blob, 1.0 / 255, size, mean, swapRB,
+                                crop ? ImagePaddingMode.CropCenter : ImagePaddingMode.Null);
+
+                            EmguAssert.IsTrue(expected.SizeOfDimension.SequenceEqual(blob.SizeOfDimension));
+                            //The fused kernel interpolates in floating point, allow one level of difference
+                            EmguAssert.IsTrue(CvInvoke.Norm(expected, blob, NormType.C) <= 1.01 / 255);
+
+                            //The blob is reused when its shape does not change
+                            IntPtr data = blob.DataPointer;
+                            DnnInvoke.BlobFromImagesFused(vm, blob, 1.0 / 255, size, mean, swapRB, ImagePaddingMode.Letterbox, new MCvScalar(114, 114, 114));
+                            EmguAssert.IsTrue(data == blob.DataPointer);
+                        }
+
+                //Letterbox: a 400 x 200 image is resized to 300 x 150 and placed in the middle, with 75 rows of padding above and below.
+                //The padding value is given in the channel order of the image, the mean in the channel order of the blob
+                MCvScalar padding = new MCvScalar(114, 50, 200);
+                using (Mat wide = new Mat(200, 400, DepthType.Cv8U, 3))
+                using (Mat resized = new Mat())
+                using (Mat padded = new Mat(size, DepthType.Cv8U, 3))
+                {
+                    CvInvoke.Randu(wide, new MCvScalar(), new MCvScalar(255, 255, 255));
+                    CvInvoke.Resize(wide, resized, new Size(300, 150));
+                    padded.SetTo(padding);
+                    using (Mat roi = new Mat(padded, new Rectangle(0, 75, 300, 150)))
+                        resized.CopyTo(roi);
+
+                    foreach (bool swapRB in new bool[] { false, true })
+                        using (Mat expected = DnnInvoke.BlobFromImages(new Mat[] { padded }, 1.0 / 255, size, mean, swapRB))
+                        using (Mat blob = new Mat())
+                        using (VectorOfMat blobImages = new VectorOfMat())
+                        {
+                            DnnInvoke.BlobFromImagesFused(wide, blob, 1.0 / 255, size, mean, swapRB, ImagePaddingMode.Letterbox, padding);
+                            EmguAssert.IsTrue(CvInvoke.Norm(expected, blob, NormType.C) <= 1.01 / 255);
+
+                            DnnInvoke.ImagesFromBlob(blob, blobImages);
+                            float[,,] values = (float[,,])blobImages[0].GetData();
+                            double[] paddingValues = padding.ToArray();
+                            double[] meanValues = mean.ToArray();
+                            for (int c = 0; c < 3; c++)
+                            {
+                                double expectedPadding = (paddingValues[swapRB ? 2 - c : c] - meanValues[c]) / 255;
+                                foreach (Point p in new Point[] { new Point(0, 0), new Point(299, 74), new Point(150, 225), new Point(299, 299) })
+                                    EmguAssert.IsTrue(Math.Abs(values[p.Y, p.X, c] - expectedPadding) < 1.0e-6);
+                            }
+                        }
+                }
+
+                //The 8-bit and half precision blobs are the 32-bit blob converted, 8-bit with rounding and saturation
+                using (Mat blob32 = new Mat())
+                using (Mat blob = new Mat())
+                using (Mat converted = new Mat())
+                {
+                    foreach (bool crop in new bool[] { false, true })
+                        using (Mat expected = DnnInvoke.BlobFromImages(images, 1.0, size, new MCvScalar(), true, crop, DepthType.Cv8U))
+                        {
+                            ImagePaddingMode mode = crop ? ImagePaddingMode.CropCenter : ImagePaddingMode.Null;
+                            DnnInvoke.BlobFromImagesFused(vm, blob, 1.0, size, new MCvScalar(), true, mode, new MCvScalar(), DepthType.Cv8U);
+                            EmguAssert.AreEqual(DepthType.Cv8U, blob.Depth);
+                            EmguAssert.IsTrue(CvInvoke.Norm(expected, blob, NormType.C) <= 1);
+
+                            DnnInvoke.BlobFromImagesFused(vm, blob32, 1.0, size, new MCvScalar(), true, mode);
+                            blob32.ConvertTo(converted, DepthType.Cv8U);
+                            EmguAssert.AreEqual(0.0, CvInvoke.Norm(converted, blob, NormType.C));
+                        }
+
+                    DnnInvoke.BlobFromImagesFused(vm, blob, 1.0 / 255, size, mean, true, ImagePaddingMode.Letterbox, padding, DepthType.Cv16F);
+                    EmguAssert.AreEqual(DepthType.Cv16F, blob.Depth);
+                    DnnInvoke.BlobFromImagesFused(vm, blob32, 1.0 / 255, size, mean, true, ImagePaddingMode.Letterbox, padding);
+                    blob.ConvertTo(converted, DepthType.Cv32F);
+                    //The values are within [-0.5, 1], half precision keeps 11 significant bits
+                    EmguAssert.IsTrue(CvInvoke.Norm(blob32, converted, NormType.C) <= 1.0e-3);
+                }
+            }
+        }
+
+        [Test]
+        public void TestDnnDecodeDetections()
+        {
+            //A YOLOv8 head [1, 4 + 2, 3]: two overlapping boxes of class 0 and a box of class 1 on top of them
+            float[] head = new float[]
+            {
+                100, 104, 300, //cx
+                300, 302, 300, //cy
+                40, 40, 40, //w
+                40, 40, 40, //h
+                0.9f, 0.8f, 0.1f, //class 0
+                0.1f, 0.2f, 0.7f //class 1
+            };
+            GCHandle handle = GCHandle.Alloc(head, GCHandleType.Pinned);
+            try
+            {
+                using (Mat output = new Mat(new int[] { 1, 6, 3 }, DepthType.Cv32F, handle.AddrOfPinnedObject()))
+                using (VectorOfRect boxes = new VectorOfRect())
+                using (VectorOfFloat scores = new VectorOfFloat())
+                using (VectorOfInt classIds = new VectorOfInt())
+                {
+                    DnnInvoke.DecodeDetections(output, DetectionHeadLayout.YoloV8, new Size(640, 640), boxes, scores, classIds, 0.5f, 0.45f, true, 0);
+                    EmguAssert.AreEqual(2, boxes.Size);
+                    EmguAssert.AreEqual(0.9f, scores[0]);
+                    EmguAssert.AreEqual(0, classIds[0]);
+                    EmguAssert.AreEqual(new Rectangle(80, 280, 40, 40), boxes[0]);
+                    EmguAssert.AreEqual(1, classIds[1]);
+
+                    //Map the boxes back to a 1280 x 720 image letterboxed into the 640 x 640 input
+                    DnnInvoke.DecodeDetections(output, DetectionHeadLayout.YoloV8, new Size(640, 640), boxes, scores, classIds, 0.5f, 0.45f, true, 1, new Size(1280, 720), ImagePaddingMode.Letterbox);
+                    EmguAssert.AreEqual(1, boxes.Size);
+                    EmguAssert.AreEqual(new Rectangle(160, 280, 80, 80), boxes[0]);
+                }
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+
+        [Test]
+        public void TestDnnDecodeDetectionsYoloV5()
+        {
+            //A YOLOv5 head [1, 4, 5 + 2]: cx, cy, w, h, objectness, class 0, class 1
+            float[] head = new float[]
+            {
+                100, 100, 20, 40, 0.9f, 0.9f, 0.1f,
+                //Overlaps the first box with a lower score, suppressed
+                102, 100, 20, 40, 0.9f, 0.8f, 0.1f,
+                //The objectness is below the threshold, skipped whatever its class scores
+                300, 200, 50, 50, 0.3f, 0.0f, 1.0f,
+                300, 200, 50, 50, 0.8f, 0.2f, 0.9f
+            };
+            using (Mat output = CreateTensor(head, 1, 4, 7))
+            using (VectorOfRect boxes = new VectorOfRect())
+            using (VectorOfFloat scores = new VectorOfFloat())
+            using (VectorOfInt classIds = new VectorOfInt())
+            {
+                DnnInvoke.DecodeDetections(output, DetectionHeadLayout.YoloV5, new Size(640, 640), boxes, scores, classIds, 0.5f, 0.45f);
+                EmguAssert.AreEqual(2, boxes.Size);
+                //The score is the objectness times the class score
+                EmguAssert.IsTrue(Math.Abs(scores[0] - 0.81f) < 1.0e-6f);
+                EmguAssert.AreEqual(0, classIds[0]);
+                EmguAssert.AreEqual(new Rectangle(90, 80, 20, 40), boxes[0]);
+                EmguAssert.IsTrue(Math.Abs(scores[1] - 0.72f) < 1.0e-6f);
+                EmguAssert.AreEqual(1, classIds[1]);
+                EmguAssert.AreEqual(new Rectangle(275, 175, 50, 50), boxes[1]);
+            }
+        }
+
+        [Test]
+        public void TestDnnDecodeDetectionsSsd()
+        {
+            //A DetectionOutput blob [1, 1, 5, 7]: image id, class id, score, x1, y1, x2, y2 normalized to [0, 1]
+            float[] head = new float[]
+            {
+                0, 15, 0.95f, 0.1f, 0.2f, 0.3f, 0.6f,
+                //Overlaps the first box with a lower score, suppressed
+                0, 15, 0.6f, 0.11f, 0.2f, 0.3f, 0.6f,
+                //The second image of the batch is not decoded
+                1, 7, 0.99f, 0.1f, 0.1f, 0.2f, 0.2f,
+                //Below the threshold
+                0, 7, 0.3f, 0.6f, 0.6f, 0.7f, 0.7f,
+                0, 2, 0.7f, 0.5f, 0.5f, 1.0f, 1.0f
+            };
+            using (Mat output = CreateTensor(head, 1, 1, 5, 7))
+            using (VectorOfRect boxes = new VectorOfRect())
+            using (VectorOfFloat scores = new VectorOfFloat())
+            using (VectorOfInt classIds = new VectorOfInt())
+            {
+                DnnInvoke.DecodeDetections(output, DetectionHeadLayout.Ssd, new Size(300, 300), boxes, scores, classIds, 0.5f, 0.45f);
+                EmguAssert.AreEqual(2, boxes.Size);
+                EmguAssert.AreEqual(0.95f, scores[0]);
+                EmguAssert.AreEqual(15, classIds[0]);
+                EmguAssert.AreEqual(new Rectangle(30, 60, 60, 120), boxes[0]);
+                EmguAssert.AreEqual(0.7f, scores[1]);
+                EmguAssert.AreEqual(2, classIds[1]);
+                EmguAssert.AreEqual(new Rectangle(150, 150, 150, 150), boxes[1]);
+
+                //The 600 x 300 image has been resized to the 300 x 300 input
+                DnnInvoke.DecodeDetections(output, DetectionHeadLayout.Ssd, new Size(300, 300), boxes, scores, classIds, 0.5f, 0.45f, true, 0, new Size(600, 300));
+                EmguAssert.AreEqual(2, boxes.Size);
+                EmguAssert.AreEqual(new Rectangle(60, 60, 120, 120), boxes[0]);
+                EmguAssert.AreEqual(new Rectangle(300, 150, 300, 150), boxes[1]);
+            }
+        }
+
+        [Test]
+        public void TestDnnDecodeDetectionsRetinaNet()
+        {
+            //The box regressions [4, 4]: dx, dy, dw, dh relative to the anchors
+            float[] regressions = new float[]
+            {
+                0.1f, 0.2f, (float) Math.Log(2), 0,
+                0, 0, 0, 0,
+                //The width scale is clamped to exp(log(1000 / 16)) = 62.5
+                0, 0, 100, 0,
+                0, 0, 0, 0
+            };
+            //The class probabilities [4, 2]
+            float[] probabilities = new float[]
+            {
+                0.9f, 0.1f,
+                0.2f, 0.8f,
+                0.6f, 0.3f,
+                //Below the threshold
+                0.2f, 0.1f
+            };
+            //The anchors [4, 4]: x1, y1, x2, y2
+            float[] anchorBoxes = new float[]
+            {
+                100, 100, 200, 200,
+                300, 300, 340, 380,
+                0, 0, 4, 4,
+                500, 500, 540, 540
+            };
+            using (VectorOfMat outputs = new VectorOfMat())
+            using (Mat anchors = CreateTensor(anchorBoxes, 4, 4))
+            using (VectorOfRect boxes = new VectorOfRect())
+            using (VectorOfFloat scores = new VectorOfFloat())
+            using (VectorOfInt classIds = new VectorOfInt())
+            {
+                using (Mat regressionBlob = CreateTensor(regressions, 4, 4))
+                using (Mat probabilityBlob = CreateTensor(probabilities, 4, 2))
+                    outputs.Push(new Mat[] { regressionBlob, probabilityBlob });
+
+                DnnInvoke.DecodeDetections(outputs, DetectionHeadLayout.RetinaNet, new Size(640, 640), boxes, scores, classIds, 0.5f, 0.45f, true, 0, new Size(), ImagePaddingMode.Null, anchors);
+                EmguAssert.AreEqual(3, boxes.Size);
+                //Center (150 + 0.1 * 100, 150 + 0.2 * 100), size (100 * 2, 100)
+                EmguAssert.AreEqual(0.9f, scores[0]);
+                EmguAssert.AreEqual(0, classIds[0]);
+                EmguAssert.AreEqual(new Rectangle(60, 120, 200, 100), boxes[0]);
+                //A zero regression keeps the anchor
+                EmguAssert.AreEqual(0.8f, scores[1]);
+                EmguAssert.AreEqual(1, classIds[1]);
+                EmguAssert.AreEqual(new Rectangle(300, 300, 40, 80), boxes[1]);
+                //Center (2, 2), width 4 * 62.5, then clipped to the input
+                EmguAssert.AreEqual(0.6f, scores[2]);
+                EmguAssert.AreEqual(new Rectangle(0, 0, 127, 4), boxes[2]);
+
+                //Without anchors the boxes are already decoded, x1, y1, x2, y2
+                DnnInvoke.DecodeDetections(outputs, DetectionHeadLayout.RetinaNet, new Size(640, 640), boxes, scores, classIds, 0.5f, 0, true, 1);
+                EmguAssert.AreEqual(1, boxes.Size);
+                EmguAssert.AreEqual(0.9f, scores[0]);
+                EmguAssert.AreEqual(new Rectangle(0, 0, 1, 0), boxes[0]);
+            }
+        }
+
+        private static Mat CreateTensor(float[] data, params int[] sizes)
+        {
+            GCHandle handle = GCHandle.Alloc(data, GCHandleType.Pinned);
+            try
+            {
+                using (Mat tensor = new Mat(sizes, DepthType.Cv32F, handle.AddrOfPinnedObject()))
+                    return tensor.Clone();
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+
+        [Test]
+        public void TestDnnNetProfiler()
+        {
+            CheckAndDownloadFile("bvlc_googlenet.caffemodel", "http://dl.caffe.berkeleyvision.org/");
+            Mat img = EmguAssert.LoadMat("space_shuttle.jpg");
+
+            using (Dnn.Net net = DnnInvoke.ReadNetFromCaffe("bvlc_googlenet.prototxt", "bvlc_googlenet.caffemodel"))
+            using (NetProfiler profiler = new NetProfiler(net, 8))
+            using (Mat blob = DnnInvoke.BlobFromImage(img, 1.0, new Size(224, 224), new MCvScalar(104, 117, 123)))
+            {
+                for (int i = 0; i < 10; i++)
+                {
+                    Mat[] outputs = profiler.Forward(blob, new String[] { "prob" });
+                    EmguAssert.AreEqual(1000, outputs[0].SizeOfDimension[1]);
+                }
+
+                long count;
+                double meanMs, p50Ms, p90Ms, p99Ms, maxMs;
+                profiler.GetForwardStats(out count, out meanMs, out p50Ms, out p90Ms, out p99Ms, out maxMs);
+                EmguAssert.AreEqual(10L, count);
+                EmguAssert.IsTrue(p50Ms <= p90Ms && p90Ms <= p99Ms && p99Ms <= maxMs);
+
+                NetLayerProfile[] layers = profiler.GetLayerProfiles();
+                EmguAssert.AreEqual(net.LayerNames.Length, layers.Length);
+                NetLayerProfile conv1 = layers.First(l => l.Name.Equals("conv1/7x7_s2"));
+                EmguAssert.AreEqual("Convolution", conv1.Type);
+                EmguAssert.IsTrue(conv1.MeanMs > 0);
+                EmguAssert.IsTrue(conv1.WeightBytes > 0);
+                EmguAssert.IsTrue(conv1.Shapes.StartsWith("1x3x224x224 -> 1x64x112x112"));
+                foreach (NetLayerProfile layer in layers.OrderByDescending(l => l.MeanMs).Take(5))
+                    Trace.WriteLine(String.Format("{0} ({1}): {2}ms p99 {3}ms, {4} bytes", layer.Name, layer.Type, layer.MeanMs, layer.P99Ms, layer.BlobBytes));
+
+                String traceFile = Path.Combine(Path.GetTempPath(), "googlenet_trace.json");
+                profiler.ExportChromeTrace(traceFile);
+                EmguAssert.IsTrue(File.ReadAllText(traceFile).Contains("\"conv1/7x7_s2\""));
+
+                profiler.Reset();
+                EmguAssert.AreEqual(0, profiler.GetLayerProfiles().Length);
+            }
+        }
+
+        [Test]
+        public void TestDnnNetPool()
+        {
+            CheckAndDownloadFile("bvlc_googlenet.caffemodel", "http://dl.caffe.berkeleyvision.org/");
+            Mat img = EmguAssert.LoadMat("space_shuttle.jpg");
+            Mat inputBlob = DnnInvoke.BlobFromImage(img, 1.0, new Size(224, 224), new MCvScalar(104, 117, 123));
+
+            int numThreads = CvInvoke.NumThreads;
+            using (NetPool pool = new NetPool("caffe", File.ReadAllBytes("bvlc_googlenet.caffemodel"), File.ReadAllBytes("bvlc_googlenet.prototxt"), 2, 1))
+            {
+                //The process wide thread count is left to the caller
+                EmguAssert.AreEqual(numThreads, CvInvoke.NumThreads);
+
+                Mat[] probs = new Mat[6];
+                Parallel.For(0, probs.Length, i =>
+                {
+                    using (NetPoolLease lease = pool.Acquire())
+                    {
+                        lease.Net.SetInput(inputBlob, "data");
+                        probs[i] = lease.Net.Forward("prob").Clone();
+                    }
+                });
+                foreach (Mat prob in probs)
+                    EmguAssert.IsTrue(CvInvoke.Norm(prob, probs[0], NormType.L1) < 1.0e-3);
+
+                int instanceCount, availableCount;
+                long leaseCount, waitCount;
+                pool.GetStats(out instanceCount, out availableCount, out leaseCount, out waitCount);
+                EmguAssert.IsTrue(instanceCount <= 2);
+                EmguAssert.AreEqual(instanceCount, availableCount);
+                EmguAssert.AreEqual(6L, leaseCount);
+
+                using (NetPoolLease lease0 = pool.Acquire())
+                using (NetPoolLease lease1 = pool.Acquire())
+                    EmguAssert.IsTrue(pool.Acquire(10) == null);
+            }
+        }
+
         private static void CheckAndDownloadFile(String fileName, String url)
         {
             //String emguS3Base = "https://s3.amazonaws.com/emgu-public/";
@@ -4227,6 +5405,126 @@ namespace Emgu.CV.Test
             }
         }
 
+        [Test]
+        public static void TestPrefetchVideoCapture()
+        {
+            int expectedCount = 0;
+            using (VideoCapture capture = new VideoCapture("tree.avi"))
+            using (Mat frame = new Mat())
+            {
+                while (capture.Read(frame))
+                    expectedCount++;
+            }
+
+            using (VideoCapture capture = new VideoCapture("tree.avi"))
+            using (PrefetchVideoCapture prefetch = new PrefetchVideoCapture(capture, 3))
+            using (Mat frame = new Mat())
+            {
+                int frameCount = 0;
+                while (prefetch.Read(frame, 5000))
+                {
+                    EmguAssert.IsFalse(frame.IsEmpty);
+                    EmguAssert.IsTrue(prefetch.QueueDepth <= 3);
+                    frameCount++;
+                }
+                EmguAssert.IsTrue(prefetch.IsEndOfStream);
+                EmguAssert.AreEqual(expectedCount, frameCount);
+                EmguAssert.AreEqual(0L, prefetch.DroppedCount);
+                EmguAssert.AreEqual((long)frameCount, prefetch.DeliveredCount);
+            }
+
+            using (VideoCapture capture = new VideoCapture("tree.avi"))
+            using (PrefetchVideoCapture prefetch = new PrefetchVideoCapture(capture, 1, true))
+            using (Mat frame = new Mat())
+            {
+                while (prefetch.Read(frame, 5000))
+                    System.Threading.Thread.Sleep(5);
+                EmguAssert.AreEqual(prefetch.DecodedCount, prefetch.DeliveredCount + prefetch.DroppedCount);
+            }
+        }
+
+        [Test]
+        public void TestGetColorPoints()
+        {
+            //The columns are not a multiple of the SIMD block, the mask has fully masked out, fully selected and partially selected blocks
+            int rows = 48, cols = 75;
+            using (Mat pointCloud = new Mat(rows, cols, DepthType.Cv32F, 3))
+            using (Mat bgr = new Mat(rows, cols, DepthType.Cv8U, 3))
+            using (Mat mask = new Mat(rows, cols, DepthType.Cv8U, 1))
+            {
+                CvInvoke.Randu(pointCloud, new MCvScalar(-1, -1, 0), new MCvScalar(1, 1, 5));
+                CvInvoke.Randu(bgr, new MCvScalar(), new MCvScalar(255, 255, 255));
+                CvInvoke.Randu(mask, new MCvScalar(), new MCvScalar(2));
+                using (Mat masked = new Mat(mask, new Rectangle(0, 0, 16, rows)))
+                    masked.SetTo(new MCvScalar(0));
+                using (Mat selected = new Mat(mask, new Rectangle(16, 0, 16, rows)))
+                    selected.SetTo(new MCvScalar(255));
+
+                int expected = CvInvoke.CountNonZero(mask);
+                EmguAssert.AreEqual(expected, CvInvoke.GetColorPoints(pointCloud, bgr, mask, (ColorPoint[])null));
+                EmguAssert.AreEqual(rows * cols, CvInvoke.GetColorPoints(pointCloud, bgr, null, (ColorPoint[])null));
+
+                ColorPoint[] points = new ColorPoint[expected];
+                ColorPointArray pointArray = new ColorPointArray(expected);
+                EmguAssert.AreEqual(expected, CvInvoke.GetColorPoints(pointCloud, bgr, mask, points));
+                EmguAssert.AreEqual(expected, CvInvoke.GetColorPoints(pointCloud, bgr, mask, pointArray));
+
+                float[,,] xyz = (float[,,])pointCloud.GetData();
+                byte[,,] color = (byte[,,])bgr.GetData();
+                byte[,] m = (byte[,])mask.GetData();
+                int idx = 0;
+                for (int i = 0; i < rows; i++)
+                    for (int j = 0; j < cols; j++)
+                    {
+                        if (m[i, j] == 0)
+                            continue;
+                        EmguAssert.IsTrue(points[idx].Position.X == xyz[i, j, 0] && points[idx].Position.Y == xyz[i, j, 1] && points[idx].Position.Z == xyz[i, j, 2]);
+                        EmguAssert.IsTrue(points[idx].Blue == color[i, j, 0] && points[idx].Green == color[i, j, 1] && points[idx].Red == color[i, j, 2]);
+                        EmguAssert.IsTrue(pointArray.X[idx] == xyz[i, j, 0] && pointArray.Y[idx] == xyz[i, j, 1] && pointArray.Z[idx] == xyz[i, j, 2]);
+                        EmguAssert.IsTrue(pointArray.Blue[idx] == color[i, j, 0] && pointArray.Green[idx] == color[i, j, 1] && pointArray.Red[idx] == color[i, j, 2]);
+                        idx++;
+                    }
+            }
+        }
+
+        [Test]
+        public static void TestVideoCaptureMultiplexer()
+        {
+            int expectedCount = 0;
+            using (VideoCapture capture = new VideoCapture("tree.avi"))
+            using (Mat frame = new Mat())
+            {
+                while (capture.Read(frame))
+                    expectedCount++;
+            }
+
+            VideoCapture[] captures = new VideoCapture[4];
+            for (int i = 0; i < captures.Length; i++)
+                captures[i] = new VideoCapture("tree.avi");
+
+            using (VideoCaptureMultiplexer multiplexer = new VideoCaptureMultiplexer(captures, 2, false, 2))
+            using (Mat frame = new Mat())
+            {
+                foreach (VideoCapture capture in captures)
+                    capture.Dispose();
+
+                int[] frameCount = new int[multiplexer.StreamCount];
+                int streamIndex;
+                double timestamp;
+                while (multiplexer.Read(out streamIndex, out timestamp, frame, 5000))
+                {
+                    EmguAssert.IsFalse(frame.IsEmpty);
+                    frameCount[streamIndex]++;
+                }
+                EmguAssert.IsTrue(multiplexer.IsEndOfStream);
+                for (int i = 0; i < frameCount.Length; i++)
+                {
+                    EmguAssert.IsTrue(multiplexer.IsStreamFinished(i));
+                    EmguAssert.AreEqual(expectedCount, frameCount[i]);
+                }
+            }
+        }
+
         [Test]
         public static void TestIntensityTransform()
         {
@@ -0,0 +1,356 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Drawing;
+using System.Runtime.InteropServices;
+using Emgu.CV.CvEnum;
+using Emgu.CV.Structure;
+using Emgu.Util;
+
+namespace Emgu.CV
+{
+    /// <summary>
+    /// A list of operations recorded against "registers", the indices into the array of Mat passed to Execute.
+    /// The whole chain is executed in a single native call, which avoids the per function call overhead when processing many small images.
+    /// Registers with index larger than or equal to the number of Mat provided are scratch images allocated for the duration of the call.
+    /// A scratch register must be written by a command before it is read, SetTo does not count as a write as it keeps the size and type of its destination.
+    /// </summary>
+    public class CommandBuffer : UnmanagedObject
+    {
+        /// <summary>
+        /// The operations that can be recorded
+        /// </summary>
+        public enum Operation
+        {
+            /// <summary>
+            /// dst = src1
+            /// </summary>
+            Copy = 0,
+            /// <summary>
+            /// dst = src1 + src2
+            /// </summary>
+            Add,
+            /// <summary>
+            /// dst = src1 - src2
+            /// </summary>
+            Subtract,
+            /// <summary>
+            /// dst = src1 * src2 * scale
+            /// </summary>
+            Multiply,
+            /// <summary>
+            /// dst = src1 / src2 * scale
+            /// </summary>
+            Divide,
+            /// <summary>
+            /// dst = |src1 - src2|
+            /// </summary>
+            AbsDiff,
+            /// <summary>
+            /// dst = min(src1, src2)
+            /// </summary>
+            Min,
+            /// <summary>
+            /// dst = max(src1, src2)
+            /// </summary>
+            Max,
+            /// <summary>
+            /// dst = src1 &amp; src2
+            /// </summary>
+            BitwiseAnd,
+            /// <summary>
+            /// dst = src1 | src2
+            /// </summary>
+            BitwiseOr,
+            /// <summary>
+            /// dst = src1 ^ src2
+            /// </summary>
+            BitwiseXor,
+            /// <summary>
+            /// dst = ~src1
+            /// </summary>
+            BitwiseNot,
+            /// <summary>
+            /// dst = src1 * alpha + src2 * beta + gamma
+            /// </summary>
+            AddWeighted,
+            /// <summary>
+            /// dst = src1 * alpha + beta, converted to the specific depth
+            /// </summary>
+            ConvertTo,
+            /// <summary>
+            /// Set all the pixels of dst to the scalar value
+            /// </summary>
+            SetTo,
+            /// <summary>
+            /// Threshold
+            /// </summary>
+            Threshold,
+            /// <summary>
+            /// Color conversion
+            /// </summary>
+            CvtColor,
+            /// <summary>
+            /// Gaussian blur
+            /// </summary>
+            GaussianBlur,
+            /// <summary>
+            /// Box blur
+            /// </summary>
+            Blur,
+            /// <summary>
+            /// Median blur
+            /// </summary>
+            MedianBlur,
+            /// <summary>
+            /// Resize
+            /// </summary>
+            Resize,
+            /// <summary>
+            /// Sobel
+            /// </summary>
+            Sobel
+        }
+
+        /// <summary>
+        /// Create an empty command buffer
+        /// </summary>
+        public CommandBuffer()
+        {
+            _ptr = CvInvoke.cveCommandBufferCreate();
+        }
+
+        /// <summary>
+        /// Record an operation
+        /// </summary>
+        /// <param name="op">The operation</param>
+        /// <param name="src1">The register of the first source</param>
+        /// <param name="src2">The register of the second source, ignored by unary operations</param>
+        /// <param name="dst">The register of the destination</param>
+        /// <param name="doubleParams">Up to 4 double parameters of the operation</param>
+        /// <param name="intParams">Up to 4 integer parameters of the operation</param>
+        /// <returns>This command buffer, such that the calls can be chained</returns>
+        public CommandBuffer Record(Operation op, int src1, int src2, int dst, double[] doubleParams = null, int[] intParams = null)
+        {
+            double[] d = new double[4];
+            int[] i = new int[4];
+            if (doubleParams != null)
+                Array.Copy(doubleParams, d, Math.Min(doubleParams.Length, 4));
+            if (intParams != null)
+                Array.Copy(intParams, i, Math.Min(intParams.Length, 4));
+            CvInvoke.cveCommandBufferRecord(_ptr, op, src1, src2, dst, d, i);
+            return this;
+        }
+
+        /// <summary>
+        /// Record dst = src
+        /// </summary>
+        public CommandBuffer Copy(int src, int dst)
+        {
+            return Record(Operation.Copy, src, -1, dst);
+        }
+
+        /// <summary>
+        /// Record dst = src1 + src2
+        /// </summary>
+        public CommandBuffer Add(int src1, int src2, int dst, DepthType dtype = DepthType.Default)
+        {
+            return Record(Operation.Add, src1, src2, dst, null, new int[] { (int)dtype });
+        }
+
+        /// <summary>
+        /// Record dst = src1 - src2
+        /// </summary>
+        public CommandBuffer Subtract(int src1, int src2, int dst, DepthType dtype = DepthType.Default)
+        {
+            return Record(Operation.Subtract, src1, src2, dst, null, new int[] { (int)dtype });
+        }
+
+        /// <summary>
+        /// Record dst = src1 * src2 * scale
+        /// </summary>
+        public CommandBuffer Multiply(int src1, int src2, int dst, double scale = 1.0, DepthType dtype = DepthType.Default)
+        {
+            return Record(Operation.Multiply, src1, src2, dst, new double[] { scale }, new int[] { (int)dtype });
+        }
+
+        /// <summary>
+        /// Record dst = src1 / src2 * scale
+        /// </summary>
+        public CommandBuffer Divide(int src1, int src2, int dst, double scale = 1.0, DepthType dtype = DepthType.Default)
+        {
+            return Record(Operation.Divide, src1, src2, dst, new double[] { scale }, new int[] { (int)dtype });
+        }
+
+        /// <summary>
+        /// Record dst = |src1 - src2|
+        /// </summary>
+        public CommandBuffer AbsDiff(int src1, int src2, int dst)
+        {
+            return Record(Operation.AbsDiff, src1, src2, dst);
+        }
+
+        /// <summary>
+        /// Record dst = src1 * alpha + src2 * beta + gamma
+        /// </summary>
+        public CommandBuffer AddWeighted(int src1, double alpha, int src2, double beta, double gamma, int dst, DepthType dtype = DepthType.Default)
+        {
+            return Record(Operation.AddWeighted, src1, src2, dst, new double[] { alpha, beta, gamma }, new int[] { (int)dtype });
+        }
+
+        /// <summary>
+        /// Record dst = src * alpha + beta, converted to the specific depth
+        /// </summary>
+        public CommandBuffer ConvertTo(int src, int dst, DepthType rtype, double alpha = 1.0, double beta = 0.0)
+        {
+            return Record(Operation.ConvertTo, src, -1, dst, new double[] { alpha, beta }, new int[] { (int)rtype });
+        }
+
+        /// <summary>
+        /// Record setting all the pixels of dst to the specific value
+        /// </summary>
+        public CommandBuffer SetTo(int dst, MCvScalar value)
+        {
+            return Record(Operation.SetTo, -1, -1, dst, value.ToArray());
+        }
+
+        /// <summary>
+        /// Record a threshold
+        /// </summary>
+        public CommandBuffer Threshold(int src, int dst, double threshold, double maxValue, ThresholdType thresholdType)
+        {
+            return Record(Operation.Threshold, src, -1, dst, new double[] { threshold, maxValue }, new int[] { (int)thresholdType });
+        }
+
+        /// <summary>
+        /// Record a color conversion
+        /// </summary>
+        public CommandBuffer CvtColor(int src, int dst, ColorConversion code, int dstCn = 0)
+        {
+            return Record(Operation.CvtColor, src, -1, dst, null, new int[] { (int)code, dstCn });
+        }
+
+        /// <summary>
+        /// Record a Gaussian blur
+        /// </summary>
+        public CommandBuffer GaussianBlur(int src, int dst, Size ksize, double sigmaX, double sigmaY = 0, BorderType borderType = BorderType.Reflect101)
+        {
+            return Record(Operation.GaussianBlur, src, -1, dst, new double[] { sigmaX, sigmaY }, new int[] { ksize.Width, ksize.Height, (int)borderType });
+        }
+
+        /// <summary>
+        /// Record a box blur
+        /// </summary>
+        public CommandBuffer Blur(int src, int dst, Size ksize, BorderType borderType = BorderType.Reflect101)
+        {
+            return Record(Operation.Blur, src, -1, dst, null, new int[] { ksize.Width, ksize.Height, (int)borderType });
+        }
+
+        /// <summary>
+        /// Record a median blur
+        /// </summary>
+        public CommandBuffer MedianBlur(int src, int dst, int ksize)
+        {
+            return Record(Operation.MedianBlur, src, -1, dst, null, new int[] { ksize });
+        }
+
+        /// <summary>
+        /// Record a resize
+        /// </summary>
+        public CommandBuffer Resize(int src, int dst, Size dsize, double fx = 0, double fy = 0, Inter interpolation = Inter.Linear)
+        {
+            return Record(Operation.Resize, src, -1, dst, new double[] { fx, fy }, new int[] { dsize.Width, dsize.Height, (int)interpolation });
+        }
+
+        /// <summary>
+        /// Record a Sobel operation
+        /// </summary>
+        public CommandBuffer Sobel(int src, int dst, DepthType ddepth, int xorder, int yorder, int kSize = 3, double scale = 1, double delta = 0)
+        {
+            return Record(Operation.Sobel, src, -1, dst, new double[] { scale, delta }, new int[] { (int)ddepth, xorder, yorder, kSize });
+        }
+
+        /// <summary>
+        /// Remove all the recorded operations
+        /// </summary>
+        public void Clear()
+        {
+            CvInvoke.cveCommandBufferClear(_ptr);
+        }
+
+        /// <summary>
+        /// The number of recorded operations
+        /// </summary>
+        public int Count
+        {
+            get { return CvInvoke.cveCommandBufferGetCount(_ptr); }
+        }
+
+        /// <summary>
+        /// The number of registers referenced by the recorded operations
+        /// </summary>
+        public int RegisterCount
+        {
+            get { return CvInvoke.cveCommandBufferGetRegisterCount(_ptr); }
+        }
+
+        /// <summary>
+        /// Execute the recorded operations, where register i refers to mats[i]
+        /// </summary>
+        /// <param name="mats">The registers</param>
+        public void Execute(params Mat[] mats)
+        {
+            Execute(mats, 1, false);
+        }
+
+        /// <summary>
+        /// Execute the recorded operations on a number of independent tiles.
+        /// The registers of tile t are mats[t * n] ... mats[t * n + n - 1] where n = mats.Length / tileCount
+        /// </summary>
+        /// <param name="mats">The registers of all the tiles</param>
+        /// <param name="tileCount">The number of tiles</param>
+        /// <param name="parallel">If true, the tiles will be processed in parallel</param>
+        public void Execute(Mat[] mats, int tileCount, bool parallel)
+        {
+            IntPtr[] ptrs = new IntPtr[mats.Length];
+            for (int i = 0; i < mats.Length; i++)
+                ptrs[i] = mats[i].Ptr;
+            CvInvoke.cveCommandBufferExecute(_ptr, ptrs, ptrs.Length, tileCount, parallel);
+        }
+
+        /// <summary>
+        /// Release the unmanaged memory associated with this command buffer.
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                CvInvoke.cveCommandBufferRelease(ref _ptr);
+        }
+    }
+
+    public static partial class CvInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveCommandBufferCreate();
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveCommandBufferRelease(ref IntPtr buffer);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveCommandBufferRecord(IntPtr buffer, CommandBuffer.Operation op, int src1, int src2, int dst, double[] doubleParams, int[] intParams);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveCommandBufferClear(IntPtr buffer);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern int cveCommandBufferGetCount(IntPtr buffer);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern int cveCommandBufferGetRegisterCount(IntPtr buffer);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveCommandBufferExecute(
+            IntPtr buffer,
+            IntPtr[] mats,
+            int count,
+            int tileCount,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool parallel);
+    }
+}
@@ -1694,7 +1694,7 @@ namespace Emgu.CV
         }
     }
 
-    internal static class MatInvoke
+    internal static partial class MatInvoke
     {
         static MatInvoke()
         {
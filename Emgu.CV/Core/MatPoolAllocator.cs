@@ -0,0 +1,158 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.Util;
+
+namespace Emgu.CV
+{
+    /// <summary>
+    /// A thread safe pool allocator for the host memory of Mat and UMat. Released buffers are bucketed by size class
+    /// and reused by the following allocations, avoiding the cost of malloc / free and of page faulting fresh buffers.
+    /// </summary>
+    /// <remarks>The allocator must not be disposed while any Mat / UMat allocated with it is still alive.</remarks>
+    public class MatPoolAllocator : UnmanagedObject
+    {
+        private IntPtr _matAllocator;
+
+        /// <summary>
+        /// Create a pool allocator
+        /// </summary>
+        /// <param name="highWaterMark">The maximum number of bytes the pool will retain. Buffers released beyond this limit are returned to the system.</param>
+        /// <param name="threadCacheBlocks">The maximum number of buffers of each size class that are cached per thread without locking. Use 0 to disable the per-thread cache.</param>
+        public MatPoolAllocator(long highWaterMark = 256L * 1024 * 1024, int threadCacheBlocks = 4)
+        {
+            _ptr = MatInvoke.cveMatPoolAllocatorCreate(new IntPtr(highWaterMark), threadCacheBlocks, ref _matAllocator);
+        }
+
+        /// <summary>
+        /// Get or set the maximum number of bytes the pool will retain.
+        /// </summary>
+        public long HighWaterMark
+        {
+            get { return MatInvoke.cveMatPoolAllocatorGetHighWaterMark(_ptr).ToInt64(); }
+            set { MatInvoke.cveMatPoolAllocatorSetHighWaterMark(_ptr, new IntPtr(value)); }
+        }
+
+        /// <summary>
+        /// The number of allocations served from the pool
+        /// </summary>
+        public long Hits
+        {
+            get
+            {
+                long hits = 0, misses = 0, bytesRetained = 0;
+                MatInvoke.cveMatPoolAllocatorGetStats(_ptr, ref hits, ref misses, ref bytesRetained);
+                return hits;
+            }
+        }
+
+        /// <summary>
+        /// The number of allocations that have to be served by the system
+        /// </summary>
+        public long Misses
+        {
+            get
+            {
+                long hits = 0, misses = 0, bytesRetained = 0;
+                MatInvoke.cveMatPoolAllocatorGetStats(_ptr, ref hits, ref misses, ref bytesRetained);
+                return misses;
+            }
+        }
+
+        /// <summary>
+        /// The number of bytes currently retained by the pool
+        /// </summary>
+        public long BytesRetained
+        {
+            get
+            {
+                long hits = 0, misses = 0, bytesRetained = 0;
+                MatInvoke.cveMatPoolAllocatorGetStats(_ptr, ref hits, ref misses, ref bytesRetained);
+                return bytesRetained;
+            }
+        }
+
+        /// <summary>
+        /// Release the buffers kept in the shared pool and in the cache of the calling thread back to the system.
+        /// </summary>
+        public void Trim()
+        {
+            MatInvoke.cveMatPoolAllocatorTrim(_ptr);
+        }
+
+        /// <summary>
+        /// Use this allocator for the data of the Mat. It must be called before the data of the Mat is created.
+        /// </summary>
+        /// <param name="mat">The Mat</param>
+        public void Attach(Mat mat)
+        {
+            MatInvoke.cveMatSetAllocator(mat, _matAllocator);
+        }
+
+        /// <summary>
+        /// Use this allocator for the host data of the UMat. It must be called before the data of the UMat is created.
+        /// </summary>
+        /// <param name="umat">The UMat</param>
+        /// <returns>False if the UMat data is managed by the OpenCL allocator, in which case the UMat is not modified.</returns>
+        public bool Attach(UMat umat)
+        {
+            return UMatInvoke.cveUMatSetAllocator(umat, _matAllocator);
+        }
+
+        /// <summary>
+        /// Install this allocator as the default allocator of all Mat, and of UMat when OpenCL is not in use.
+        /// </summary>
+        public void SetAsDefault()
+        {
+            MatInvoke.cveMatSetDefaultAllocator(_matAllocator);
+        }
+
+        /// <summary>
+        /// Restore the default OpenCV allocator.
+        /// </summary>
+        public static void ResetDefault()
+        {
+            MatInvoke.cveMatSetDefaultAllocator(IntPtr.Zero);
+        }
+
+        /// <summary>
+        /// Release the unmanaged memory associated with this allocator. If this is the default allocator, the default OpenCV allocator is restored.
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                MatInvoke.cveMatPoolAllocatorRelease(ref _ptr);
+            _matAllocator = IntPtr.Zero;
+        }
+    }
+
+    internal static partial class MatInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveMatPoolAllocatorCreate(IntPtr highWaterMark, int threadCacheBlocks, ref IntPtr matAllocator);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveMatPoolAllocatorRelease(ref IntPtr allocator);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveMatPoolAllocatorGetStats(IntPtr allocator, ref long hits, ref long misses, ref long bytesRetained);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveMatPoolAllocatorSetHighWaterMark(IntPtr allocator, IntPtr highWaterMark);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveMatPoolAllocatorGetHighWaterMark(IntPtr allocator);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveMatPoolAllocatorTrim(IntPtr allocator);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveMatSetDefaultAllocator(IntPtr allocator);
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveMatSetAllocator(IntPtr mat, IntPtr allocator);
+    }
+
+    internal static partial class UMatInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cveUMatSetAllocator(IntPtr umat, IntPtr allocator);
+    }
+}
@@ -1111,7 +1111,7 @@ namespace Emgu.CV
         }
     }
 
-    internal static class UMatInvoke
+    internal static partial class UMatInvoke
     {
         static UMatInvoke()
         {
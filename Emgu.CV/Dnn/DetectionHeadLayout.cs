@@ -0,0 +1,31 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+
+namespace Emgu.CV.Dnn
+{
+    /// <summary>
+    /// The layout of the raw output of a detection network
+    /// </summary>
+    public enum DetectionHeadLayout
+    {
+        /// <summary>
+        /// One output [1, N, 5 + C]: cx, cy, w, h, objectness and the class scores, in input pixels
+        /// </summary>
+        YoloV5 = 0,
+        /// <summary>
+        /// One output [1, 4 + C, N]: cx, cy, w, h and the class scores, in input pixels
+        /// </summary>
+        YoloV8 = 1,
+        /// <summary>
+        /// One DetectionOutput layer [1, 1, N, 7]: image id, class id, score, x1, y1, x2, y2 normalized to [0, 1]. Only the first image is decoded.
+        /// </summary>
+        Ssd = 2,
+        /// <summary>
+        /// Two outputs: the boxes [N, 4] (x1, y1, x2, y2 in input pixels, or regressions relative to the anchors if anchors are given) and the class probabilities [N, C]
+        /// </summary>
+        RetinaNet = 3
+    }
+}
@@ -0,0 +1,374 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Collections.Generic;
+using System.Drawing;
+using System.Runtime.InteropServices;
+using Emgu.CV.Structure;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV.Dnn
+{
+    /// <summary>
+    /// Run a network on the images submitted from many threads with dynamic batching: the pending images are coalesced
+    /// into a single blob and the network runs one forward pass for up to maxBatchSize images.
+    /// </summary>
+    /// <remarks>The network is shared with the native executor thread, it must not be used by other threads while the executor is alive. The Net object itself can be disposed.</remarks>
+    public class DnnBatchExecutor : UnmanagedObject
+    {
+        /// <summary>
+        /// Start the executor thread
+        /// </summary>
+        /// <param name="net">The network to run</param>
+        /// <param name="maxBatchSize">The maximum number of images in a forward pass</param>
+        /// <param name="maxWaitMs">The maximum time in milliseconds a request waits for other requests to fill its batch</param>
+        /// <param name="scaleFactor">Multiplier for images values.</param>
+        /// <param name="size">Spatial size for output image</param>
+        /// <param name="mean">Scalar with mean values which are subtracted from channels. Values are intended to be in (mean-R, mean-G, mean-B) order if image has BGR ordering and swapRB is true.</param>
+        /// <param name="swapRB">Flag which indicates that swap first and last channels in 3-channel image is necessary.</param>
+        /// <param name="crop">Flag which indicates whether image will be cropped after resize or not</param>
+        /// <param name="ddepth">Depth of the input blob. Choose CV_32F or CV_8U.</param>
+        /// <param name="outputNames">The names of the layers to output. Use null for the unconnected output layers of the network.</param>
+        public DnnBatchExecutor(
+            Net net,
+            int maxBatchSize = 8,
+            int maxWaitMs = 5,
+            double scaleFactor = 1.0,
+            Size size = new Size(),
+            MCvScalar mean = new MCvScalar(),
+            bool swapRB = false,
+            bool crop = false,
+            CvEnum.DepthType ddepth = CvEnum.DepthType.Cv32F,
+            String[] outputNames = null)
+        {
+            if (outputNames == null)
+            {
+                _ptr = DnnInvoke.cveDnnBatchExecutorCreate(net, maxBatchSize, maxWaitMs, scaleFactor, ref size, ref mean, swapRB, crop, ddepth, IntPtr.Zero);
+            }
+            else
+            {
+                using (VectorOfCvString vcs = new VectorOfCvString(outputNames))
+                    _ptr = DnnInvoke.cveDnnBatchExecutorCreate(net, maxBatchSize, maxWaitMs, scaleFactor, ref size, ref mean, swapRB, crop, ddepth, vcs);
+            }
+        }
+
+        /// <summary>
+        /// Queue a copy of the image for inference and return immediately
+        /// </summary>
+        /// <param name="image">The input image. It must have the type of the first submitted image, and its size if the executor does not resize the images.</param>
+        /// <returns>The pending request, use it to wait for and get the outputs</returns>
+        public DnnBatchRequest Submit(IInputArray image)
+        {
+            using (InputArray iaImage = image.GetInputArray())
+            {
+                IntPtr sharedPtr = IntPtr.Zero;
+                IntPtr ptr = DnnInvoke.cveDnnBatchExecutorSubmit(_ptr, iaImage, null, 0, ref sharedPtr);
+                return new DnnBatchRequest(sharedPtr, ptr);
+            }
+        }
+
+        /// <summary>
+        /// Queue a copy of the image for inference and return immediately. The callback is raised from the native executor thread once the request has completed.
+        /// </summary>
+        /// <param name="image">The input image. It must have the type of the first submitted image, and its size if the executor does not resize the images.</param>
+        /// <param name="onCompleted">Called with the outputs, one blob per output layer with a batch size of 1, and a null error message; or with null outputs and the error message if the forward pass failed. It must not throw.</param>
+        /// <returns>The pending request, it can be disposed right away if the callback is enough</returns>
+        public DnnBatchRequest Submit(IInputArray image, Action<Mat[], String> onCompleted)
+        {
+            int callbackId = DnnBatchCallbackHelper.Register(onCompleted);
+            try
+            {
+                using (InputArray iaImage = image.GetInputArray())
+                {
+                    IntPtr sharedPtr = IntPtr.Zero;
+                    IntPtr ptr = DnnInvoke.cveDnnBatchExecutorSubmit(_ptr, iaImage, DnnBatchCallbackHelper.Handler, callbackId, ref sharedPtr);
+                    return new DnnBatchRequest(sharedPtr, ptr);
+                }
+            }
+            catch
+            {
+                //The image has been rejected, the callback will never be raised
+                DnnBatchCallbackHelper.Unregister(callbackId);
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Run the network on a single image as part of a batch, blocking until the batch has completed
+        /// </summary>
+        /// <param name="image">The input image</param>
+        /// <returns>One blob per output layer, with a batch size of 1</returns>
+        public Mat[] Infer(IInputArray image)
+        {
+            using (DnnBatchRequest request = Submit(image))
+                return request.GetOutputs();
+        }
+
+        private void GetStats(out long requestCount, out long batchCount, out double totalLatencyMs, out double maxLatencyMs, out double totalInferenceMs)
+        {
+            requestCount = 0;
+            batchCount = 0;
+            totalLatencyMs = 0;
+            maxLatencyMs = 0;
+            totalInferenceMs = 0;
+            DnnInvoke.cveDnnBatchExecutorGetStats(_ptr, ref requestCount, ref batchCount, ref totalLatencyMs, ref maxLatencyMs, ref totalInferenceMs);
+        }
+
+        /// <summary>
+        /// The number of requests completed so far
+        /// </summary>
+        public long RequestCount
+        {
+            get
+            {
+                long requestCount, batchCount;
+                double totalLatencyMs, maxLatencyMs, totalInferenceMs;
+                GetStats(out requestCount, out batchCount, out totalLatencyMs, out maxLatencyMs, out totalInferenceMs);
+                return requestCount;
+            }
+        }
+
+        /// <summary>
+        /// The number of forward passes run so far
+        /// </summary>
+        public long BatchCount
+        {
+            get
+            {
+                long requestCount, batchCount;
+                double totalLatencyMs, maxLatencyMs, totalInferenceMs;
+                GetStats(out requestCount, out batchCount, out totalLatencyMs, out maxLatencyMs, out totalInferenceMs);
+                return batchCount;
+            }
+        }
+
+        /// <summary>
+        /// The average number of images per forward pass
+        /// </summary>
+        public double AverageBatchSize
+        {
+            get
+            {
+                long requestCount, batchCount;
+                double totalLatencyMs, maxLatencyMs, totalInferenceMs;
+                GetStats(out requestCount, out batchCount, out totalLatencyMs, out maxLatencyMs, out totalInferenceMs);
+                return batchCount == 0 ? 0 : (double) requestCount / batchCount;
+            }
+        }
+
+        /// <summary>
+        /// The average time in milliseconds from the submission of a request to its completion
+        /// </summary>
+        public double AverageLatencyMs
+        {
+            get
+            {
+                long requestCount, batchCount;
+                double totalLatencyMs, maxLatencyMs, totalInferenceMs;
+                GetStats(out requestCount, out batchCount, out totalLatencyMs, out maxLatencyMs, out totalInferenceMs);
+                return requestCount == 0 ? 0 : totalLatencyMs / requestCount;
+            }
+        }
+
+        /// <summary>
+        /// The maximum time in milliseconds from the submission of a request to its completion
+        /// </summary>
+        public double MaxLatencyMs
+        {
+            get
+            {
+                long requestCount, batchCount;
+                double totalLatencyMs, maxLatencyMs, totalInferenceMs;
+                GetStats(out requestCount, out batchCount, out totalLatencyMs, out maxLatencyMs, out totalInferenceMs);
+                return maxLatencyMs;
+            }
+        }
+
+        /// <summary>
+        /// The average time in milliseconds of a batch, including the blob creation, the forward pass and the split of the outputs
+        /// </summary>
+        public double AverageInferenceMs
+        {
+            get
+            {
+                long requestCount, batchCount;
+                double totalLatencyMs, maxLatencyMs, totalInferenceMs;
+                GetStats(out requestCount, out batchCount, out totalLatencyMs, out maxLatencyMs, out totalInferenceMs);
+                return batchCount == 0 ? 0 : totalInferenceMs / batchCount;
+            }
+        }
+
+        /// <summary>
+        /// Complete the queued requests, stop the executor thread and release the unmanaged memory
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                DnnInvoke.cveDnnBatchExecutorRelease(ref _ptr);
+        }
+    }
+
+    /// <summary>
+    /// A request pending on a DnnBatchExecutor
+    /// </summary>
+    public class DnnBatchRequest : SharedPtrObject
+    {
+        internal DnnBatchRequest(IntPtr sharedPtr, IntPtr ptr)
+        {
+            _sharedPtr = sharedPtr;
+            _ptr = ptr;
+        }
+
+        /// <summary>
+        /// Wait for the batch of this request to complete
+        /// </summary>
+        /// <param name="timeoutMs">The maximum time to wait in milliseconds, use a negative value to wait as long as needed</param>
+        /// <returns>True if the request has completed</returns>
+        public bool Wait(int timeoutMs = -1)
+        {
+            return DnnInvoke.cveDnnBatchRequestWait(_ptr, timeoutMs);
+        }
+
+        /// <summary>
+        /// Wait for the request to complete and get its outputs. If the forward pass failed, the error is raised as an exception.
+        /// </summary>
+        /// <param name="outputs">One blob per output layer, with a batch size of 1. The [1, 1, N, 7] detections of an SSD DetectionOutput layer are split on their image index column, which is set to 0. Any other output whose first dimension is not the batch size is not split, every request of the batch gets all of it.</param>
+        public void GetOutputs(VectorOfMat outputs)
+        {
+            DnnInvoke.cveDnnBatchRequestGetOutputs(_ptr, outputs);
+        }
+
+        /// <summary>
+        /// Wait for the request to complete and get its outputs. If the forward pass failed, the error is raised as an exception.
+        /// </summary>
+        /// <returns>One blob per output layer, with a batch size of 1</returns>
+        public Mat[] GetOutputs()
+        {
+            using (VectorOfMat outputs = new VectorOfMat())
+            {
+                GetOutputs(outputs);
+                return ToArray(outputs);
+            }
+        }
+
+        internal static Mat[] ToArray(VectorOfMat outputs)
+        {
+            Mat[] result = new Mat[outputs.Size];
+            for (int i = 0; i < result.Length; i++)
+            {
+                Mat m = new Mat();
+                CvInvoke.Swap(m, outputs[i]);
+                result[i] = m;
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Release the unmanaged memory associated with this request
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (!IntPtr.Zero.Equals(_sharedPtr))
+            {
+                DnnInvoke.cveDnnBatchRequestRelease(ref _sharedPtr);
+                _ptr = IntPtr.Zero;
+            }
+        }
+    }
+
+    internal static class DnnBatchCallbackHelper
+    {
+        [UnmanagedFunctionPointer(CvInvoke.CvCallingConvention)]
+        public delegate void BatchCallback(IntPtr outputs, IntPtr error, int callbackId);
+
+        public static BatchCallback Handler = BatchHandler;
+
+        private static readonly Dictionary<int, Action<Mat[], String>> _callbacks = new Dictionary<int, Action<Mat[], String>>();
+
+        private static int _lastCallbackId = 0;
+
+        public static int Register(Action<Mat[], String> callback)
+        {
+            lock (_callbacks)
+            {
+                int callbackId = unchecked(++_lastCallbackId);
+                _callbacks.Add(callbackId, callback);
+                return callbackId;
+            }
+        }
+
+        public static void Unregister(int callbackId)
+        {
+            lock (_callbacks)
+                _callbacks.Remove(callbackId);
+        }
+
+#if __IOS__
+      //[ObjCRuntime.MonoPInvokeCallback(typeof(DnnBatchCallbackHelper.BatchCallback))]
+#endif
+        public static void BatchHandler(IntPtr outputs, IntPtr error, int callbackId)
+        {
+            Action<Mat[], String> callback;
+            lock (_callbacks)
+            {
+                if (!_callbacks.TryGetValue(callbackId, out callback))
+                    return;
+                _callbacks.Remove(callbackId);
+            }
+
+            if (error != IntPtr.Zero)
+            {
+                callback(null, Marshal.PtrToStringAnsi(error));
+                return;
+            }
+            //The vector is owned by the executor thread, the blobs are swapped out of it
+            using (VectorOfMat vm = new VectorOfMat(outputs, false))
+                callback(DnnBatchRequest.ToArray(vm), null);
+        }
+    }
+
+    public static partial class DnnInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveDnnBatchExecutorCreate(
+            IntPtr net,
+            int maxBatchSize,
+            int maxWaitMs,
+            double scaleFactor,
+            ref Size size,
+            ref MCvScalar mean,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool swapRB,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool crop,
+            CvEnum.DepthType ddepth,
+            IntPtr outputNames);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnBatchExecutorRelease(ref IntPtr executor);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveDnnBatchExecutorSubmit(
+            IntPtr executor,
+            IntPtr image,
+            DnnBatchCallbackHelper.BatchCallback callback,
+            int callbackId,
+            ref IntPtr sharedPtr);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnBatchExecutorGetStats(IntPtr executor, ref long requestCount, ref long batchCount, ref double totalLatencyMs, ref double maxLatencyMs, ref double totalInferenceMs);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cveDnnBatchRequestWait(IntPtr request, int timeoutMs);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnBatchRequestGetOutputs(IntPtr request, IntPtr outputs);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnBatchRequestRelease(ref IntPtr request);
+    }
+}
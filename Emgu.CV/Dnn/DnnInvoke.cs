@@ -159,6 +159,148 @@ namespace Emgu.CV.Dnn
             bool crop,
             CvEnum.DepthType ddepth);
 
+        /// <summary>
+        /// Creates 4-dimensional blob from series of images in a single pass. Resize, crop or letterbox, swapRB, mean subtraction, scaling and
+        /// the conversion to NCHW layout are done together, row by row in parallel, and written directly into <paramref name="blob"/>.
+        /// </summary>
+        /// <param name="images">Input images (all with the same depth, CV_8U or CV_32F, and 1-, 3- or 4-channels).</param>
+        /// <param name="blob">The 4-dimensional blob with NCHW dimensions order. It is only reallocated if its shape or depth changes, such that it can be reused from frame to frame.</param>
+        /// <param name="scaleFactor">Multiplier for images values.</param>
+        /// <param name="size">Spatial size for output image</param>
+        /// <param name="mean">Scalar with mean values which are subtracted from channels. Values are intended to be in (mean-R, mean-G, mean-B) order if image has BGR ordering and swapRB is true.</param>
+        /// <param name="swapRB">Flag which indicates that swap first and last channels in 3-channel image is necessary.</param>
+        /// <param name="paddingMode">How the images are fitted into <paramref name="size"/></param>
+        /// <param name="paddingValue">The value of the letterbox borders, in the channel order of the input images</param>
+        /// <param name="ddepth">Depth of output blob: CV_32F, CV_16F, CV_8U or CV_8S. Integer outputs are saturated.</param>
+        public static void BlobFromImagesFused(
+            Mat[] images,
+            Mat blob,
+            double scaleFactor = 1.0,
+            Size size = new Size(),
+            MCvScalar mean = new MCvScalar(),
+            bool swapRB = false,
+            ImagePaddingMode paddingMode = ImagePaddingMode.Null,
+            MCvScalar paddingValue = new MCvScalar(),
+            CvEnum.DepthType ddepth = CvEnum.DepthType.Cv32F)
+        {
+            using (VectorOfMat vm = new VectorOfMat(images))
+            {
+                BlobFromImagesFused(vm, blob, scaleFactor, size, mean, swapRB, paddingMode, paddingValue, ddepth);
+            }
+        }
+
+        /// <summary>
+        /// Creates 4-dimensional blob from series of images in a single pass. Resize, crop or letterbox, swapRB, mean subtraction, scaling and
+        /// the conversion to NCHW layout are done together, row by row in parallel, and written directly into <paramref name="blob"/>.
+        /// </summary>
+        /// <param name="images">Input images (all with the same depth, CV_8U or CV_32F, and 1-, 3- or 4-channels).</param>
+        /// <param name="blob">The 4-dimensional blob with NCHW dimensions order. It is only reallocated if its shape or depth changes, such that it can be reused from frame to frame.</param>
+        /// <param name="scaleFactor">Multiplier for images values.</param>
+        /// <param name="size">Spatial size for output image</param>
+        /// <param name="mean">Scalar with mean values which are subtracted from channels. Values are intended to be in (mean-R, mean-G, mean-B) order if image has BGR ordering and swapRB is true.</param>
+        /// <param name="swapRB">Flag which indicates that swap first and last channels in 3-channel image is necessary.</param>
+        /// <param name="paddingMode">How the images are fitted into <paramref name="size"/></param>
+        /// <param name="paddingValue">The value of the letterbox borders, in the channel order of the input images</param>
+        /// <param name="ddepth">Depth of output blob: CV_32F, CV_16F, CV_8U or CV_8S. Integer outputs are saturated.</param>
+        /// <remarks>The bilinear interpolation is computed in floating point, the result can differ by one level from BlobFromImages on 8-bit images.</remarks>
+        public static void BlobFromImagesFused(
+            IInputArrayOfArrays images,
+            Mat blob,
+            double scaleFactor = 1.0,
+            Size size = new Size(),
+            MCvScalar mean = new MCvScalar(),
+            bool swapRB = false,
+            ImagePaddingMode paddingMode = ImagePaddingMode.Null,
+            MCvScalar paddingValue = new MCvScalar(),
+            CvEnum.DepthType ddepth = CvEnum.DepthType.Cv32F)
+        {
+            using (InputArray iaImages = images.GetInputArray())
+            {
+                cveDnnBlobFromImagesFused(iaImages, blob, scaleFactor, ref size, ref mean, swapRB, paddingMode, ref paddingValue, ddepth);
+            }
+        }
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        private static extern void cveDnnBlobFromImagesFused(
+            IntPtr images,
+            IntPtr blob,
+            double scalefactor,
+            ref Size size,
+            ref MCvScalar mean,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool swapRB,
+            ImagePaddingMode paddingMode,
+            ref MCvScalar paddingValue,
+            CvEnum.DepthType ddepth);
+
+        /// <summary>
+        /// Decode the raw output of a detection network and run non maximum suppression in native code.
+        /// The candidates below the confidence threshold are dropped before the suppression.
+        /// </summary>
+        /// <param name="outputs">The output blobs of the network, as returned by Net.Forward</param>
+        /// <param name="headLayout">The layout of the output blobs</param>
+        /// <param name="inputSize">The spatial size of the network input blob, the boxes are decoded in this coordinate system</param>
+        /// <param name="boxes">The detected boxes, in image coordinates if imageSize is given</param>
+        /// <param name="scores">The scores of the detections, in decreasing order</param>
+        /// <param name="classIds">The class indices of the detections</param>
+        /// <param name="confThreshold">The minimum score of a detection</param>
+        /// <param name="nmsThreshold">The IoU above which the box with the lower score is suppressed. Use 0 to skip the suppression.</param>
+        /// <param name="classAware">If true, boxes are only suppressed by boxes of the same class</param>
+        /// <param name="topK">The maximum number of detections, use 0 to keep all of them</param>
+        /// <param name="imageSize">The size of the image the blob has been created from. Use an empty size to keep the boxes in network input coordinates.</param>
+        /// <param name="paddingMode">How the image has been fitted into the blob</param>
+        /// <param name="anchors">For the RetinaNet layout only: the anchors [N, 4] (x1, y1, x2, y2) the boxes are regressed from, or null if the boxes are already decoded</param>
+        public static void DecodeDetections(
+            IInputArrayOfArrays outputs,
+            DetectionHeadLayout headLayout,
+            Size inputSize,
+            VectorOfRect boxes,
+            VectorOfFloat scores,
+            VectorOfInt classIds,
+            float confThreshold = 0.25f,
+            float nmsThreshold = 0.45f,
+            bool classAware = true,
+            int topK = 0,
+            Size imageSize = new Size(),
+            ImagePaddingMode paddingMode = ImagePaddingMode.Null,
+            Mat anchors = null)
+        {
+            using (InputArray iaOutputs = outputs.GetInputArray())
+            {
+                cveDnnDecodeDetections(
+                    iaOutputs,
+                    headLayout,
+                    anchors == null ? IntPtr.Zero : anchors.Ptr,
+                    confThreshold,
+                    nmsThreshold,
+                    classAware,
+                    topK,
+                    ref inputSize,
+                    ref imageSize,
+                    paddingMode,
+                    boxes,
+                    scores,
+                    classIds);
+            }
+        }
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        private static extern void cveDnnDecodeDetections(
+            IntPtr outputs,
+            DetectionHeadLayout headLayout,
+            IntPtr anchors,
+            float confThreshold,
+            float nmsThreshold,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool classAware,
+            int topK,
+            ref Size inputSize,
+            ref Size imageSize,
+            ImagePaddingMode paddingMode,
+            IntPtr boxes,
+            IntPtr scores,
+            IntPtr classIds);
+
         /// <summary>
         /// Parse a 4D blob and output the images it contains as 2D arrays through a simpler data structure (std::vector&lt;cv::Mat&gt;).
         /// </summary>
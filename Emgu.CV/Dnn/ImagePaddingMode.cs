@@ -0,0 +1,27 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+
+namespace Emgu.CV.Dnn
+{
+    /// <summary>
+    /// How an image is fitted into the spatial size of a blob
+    /// </summary>
+    public enum ImagePaddingMode
+    {
+        /// <summary>
+        /// Resize the image to the blob size, ignoring the aspect ratio
+        /// </summary>
+        Null = 0,
+        /// <summary>
+        /// Resize the image such that it covers the blob keeping its aspect ratio, then crop its center
+        /// </summary>
+        CropCenter = 1,
+        /// <summary>
+        /// Resize the image such that it fits in the blob keeping its aspect ratio, then pad the borders with the padding value
+        /// </summary>
+        Letterbox = 2
+    }
+}
@@ -0,0 +1,167 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV.Dnn
+{
+    /// <summary>
+    /// A pool of networks parsed from the same in memory model. A Net can not run forward passes concurrently,
+    /// the pool leases each instance to a single thread at a time such that threads run their forward passes in parallel.
+    /// </summary>
+    /// <remarks>Instances are only parsed when all the existing instances are leased, up to maxInstances. The instances do not share their weights,
+    /// each one holds its own copy: the memory used by the pool grows linearly with the number of instances, plan maxInstances for the size of the model.
+    /// The pool keeps a copy of the model buffers to parse the instances, until maxInstances instances exist.</remarks>
+    public class NetPool : UnmanagedObject
+    {
+        /// <summary>
+        /// Create a pool of networks from a model in memory
+        /// </summary>
+        /// <param name="framework">Name of origin framework, e.g. "onnx", "caffe", "tensorflow"</param>
+        /// <param name="bufferModel">The binary model, it is copied into the pool</param>
+        /// <param name="bufferConfig">The text configuration of the model, or null if the framework does not need one</param>
+        /// <param name="maxInstances">The maximum number of networks. Use 0 for the number of CPUs divided by threadsPerInstance. Each network holds its own copy of the weights.</param>
+        /// <param name="threadsPerInstance">The number of threads a forward pass uses, only used to compute the default maxInstances. Use 0 for CvInvoke.NumThreads, the number of threads every forward pass runs on. OpenCV's thread count is process wide and is not changed by the pool: to run more instances at the same time, lower CvInvoke.NumThreads and pass the same value here.</param>
+        public NetPool(String framework, byte[] bufferModel, byte[] bufferConfig = null, int maxInstances = 0, int threadsPerInstance = 0)
+        {
+            GCHandle modelHandle = GCHandle.Alloc(bufferModel, GCHandleType.Pinned);
+            GCHandle configHandle = GCHandle.Alloc(bufferConfig, GCHandleType.Pinned);
+            try
+            {
+                using (CvString csFramework = new CvString(framework))
+                    _ptr = DnnInvoke.cveDnnNetPoolCreate(
+                        csFramework,
+                        modelHandle.AddrOfPinnedObject(),
+                        bufferModel.Length,
+                        configHandle.AddrOfPinnedObject(),
+                        bufferConfig == null ? 0 : bufferConfig.Length,
+                        maxInstances,
+                        threadsPerInstance);
+            }
+            finally
+            {
+                modelHandle.Free();
+                configHandle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Lease a network. The lease must be disposed to return the network to the pool.
+        /// </summary>
+        /// <param name="timeoutMs">The maximum time to wait for a network in milliseconds. Use a negative value to wait as long as needed.</param>
+        /// <returns>The lease, or null if the timeout expired</returns>
+        public NetPoolLease Acquire(int timeoutMs = -1)
+        {
+            int index = -1;
+            IntPtr netPtr = DnnInvoke.cveDnnNetPoolAcquire(_ptr, timeoutMs, ref index);
+            if (netPtr == IntPtr.Zero)
+                return null;
+            return new NetPoolLease(this, new Net(netPtr), index);
+        }
+
+        internal void Return(int index)
+        {
+            DnnInvoke.cveDnnNetPoolReturn(_ptr, index);
+        }
+
+        /// <summary>
+        /// Get the statistics of the pool
+        /// </summary>
+        /// <param name="instanceCount">The number of networks parsed so far</param>
+        /// <param name="availableCount">The number of parsed networks that are not leased</param>
+        /// <param name="leaseCount">The number of leases so far</param>
+        /// <param name="waitCount">The number of leases that had to wait for a network to be returned</param>
+        public void GetStats(out int instanceCount, out int availableCount, out long leaseCount, out long waitCount)
+        {
+            instanceCount = 0;
+            availableCount = 0;
+            leaseCount = 0;
+            waitCount = 0;
+            DnnInvoke.cveDnnNetPoolGetStats(_ptr, ref instanceCount, ref availableCount, ref leaseCount, ref waitCount);
+        }
+
+        /// <summary>
+        /// Release the networks of the pool. The leases that are still held keep their network alive.
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                DnnInvoke.cveDnnNetPoolRelease(ref _ptr);
+        }
+    }
+
+    /// <summary>
+    /// A network leased from a NetPool, dispose it to return the network to the pool
+    /// </summary>
+    public class NetPoolLease : DisposableObject
+    {
+        private NetPool _pool;
+        private Net _net;
+        private int _index;
+
+        internal NetPoolLease(NetPool pool, Net net, int index)
+        {
+            _pool = pool;
+            _net = net;
+            _index = index;
+        }
+
+        /// <summary>
+        /// The leased network. It must only be used by the thread holding the lease, and not after the lease has been disposed.
+        /// </summary>
+        public Net Net
+        {
+            get { return _net; }
+        }
+
+        /// <summary>
+        /// Return the network to the pool
+        /// </summary>
+        protected override void ReleaseManagedResources()
+        {
+            if (_net != null)
+            {
+                _net.Dispose();
+                _net = null;
+                if (_pool.Ptr != IntPtr.Zero)
+                    _pool.Return(_index);
+            }
+        }
+
+        /// <summary>
+        /// Release the unmanaged resources
+        /// </summary>
+        protected override void DisposeObject()
+        {
+        }
+    }
+
+    public static partial class DnnInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveDnnNetPoolCreate(
+            IntPtr framework,
+            IntPtr bufferModel,
+            int lenModel,
+            IntPtr bufferConfig,
+            int lenConfig,
+            int maxInstances,
+            int threadsPerInstance);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetPoolRelease(ref IntPtr pool);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveDnnNetPoolAcquire(IntPtr pool, int timeoutMs, ref int index);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetPoolReturn(IntPtr pool, int index);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetPoolGetStats(IntPtr pool, ref int instanceCount, ref int availableCount, ref long leaseCount, ref long waitCount);
+    }
+}
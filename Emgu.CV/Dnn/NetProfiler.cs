@@ -0,0 +1,277 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV.Dnn
+{
+    /// <summary>
+    /// Profile the forward passes of a network: the wall time of each layer, its input / output shapes, the memory of its blobs and its target are recorded
+    /// for the last historySize passes. The percentiles of the layer times can be queried and the passes exported as a Chrome trace-event timeline.
+    /// </summary>
+    /// <remarks>The forward passes must be run from one thread at a time, the statistics can be read from any thread.</remarks>
+    public class NetProfiler : UnmanagedObject
+    {
+        /// <summary>
+        /// Create a profiler for the network
+        /// </summary>
+        /// <param name="net">The network to profile. It must not be disposed before this object.</param>
+        /// <param name="historySize">The number of forward passes kept to compute the percentiles and the timeline</param>
+        /// <param name="backend">The preferable backend of the network, it is set on the network and reported with every pass</param>
+        /// <param name="target">The preferable target of the network, it is set on the network and reported with every pass</param>
+        public NetProfiler(Net net, int historySize = 100, Backend backend = Backend.Default, Target target = Target.Cpu)
+        {
+            _ptr = DnnInvoke.cveDnnNetProfilerCreate(net, historySize, backend, target);
+        }
+
+        /// <summary>
+        /// Set the inputs of the network, run a forward pass and record its profile
+        /// </summary>
+        /// <param name="inputs">The input blobs, in the order of the network inputs</param>
+        /// <param name="inputNames">The names of the inputs. Use null for a network with a single input.</param>
+        /// <param name="outputs">The output blobs</param>
+        /// <param name="outputNames">The names of the layers to output. Use null for the unconnected output layers of the network.</param>
+        public void Forward(VectorOfMat inputs, String[] inputNames, VectorOfMat outputs, String[] outputNames = null)
+        {
+            using (VectorOfCvString vInputNames = inputNames == null ? null : new VectorOfCvString(inputNames))
+            using (VectorOfCvString vOutputNames = outputNames == null ? null : new VectorOfCvString(outputNames))
+            {
+                DnnInvoke.cveDnnNetProfilerForward(
+                    _ptr,
+                    inputs,
+                    vInputNames == null ? IntPtr.Zero : vInputNames.Ptr,
+                    outputs,
+                    vOutputNames == null ? IntPtr.Zero : vOutputNames.Ptr);
+            }
+        }
+
+        /// <summary>
+        /// Set the single input of the network, run a forward pass and record its profile
+        /// </summary>
+        /// <param name="input">The input blob</param>
+        /// <param name="outputNames">The names of the layers to output. Use null for the unconnected output layers of the network.</param>
+        /// <returns>One blob per output layer</returns>
+        public Mat[] Forward(Mat input, String[] outputNames = null)
+        {
+            using (VectorOfMat inputs = new VectorOfMat(input))
+            using (VectorOfMat outputs = new VectorOfMat())
+            {
+                Forward(inputs, null, outputs, outputNames);
+                Mat[] result = new Mat[outputs.Size];
+                for (int i = 0; i < result.Length; i++)
+                {
+                    Mat m = new Mat();
+                    CvInvoke.Swap(m, outputs[i]);
+                    result[i] = m;
+                }
+                return result;
+            }
+        }
+
+        /// <summary>
+        /// Get the profile of every layer, in the order of the network layers, computed over the recorded passes
+        /// </summary>
+        /// <returns>The layer profiles, empty if no pass has been recorded</returns>
+        public NetLayerProfile[] GetLayerProfiles()
+        {
+            using (VectorOfCvString names = new VectorOfCvString())
+            using (VectorOfCvString types = new VectorOfCvString())
+            using (VectorOfCvString shapes = new VectorOfCvString())
+            using (VectorOfInt targets = new VectorOfInt())
+            using (Mat stats = new Mat())
+            {
+                DnnInvoke.cveDnnNetProfilerGetLayerStats(_ptr, names, types, shapes, targets, stats);
+                String[] nameArray = names.ToArray();
+                String[] typeArray = types.ToArray();
+                String[] shapeArray = shapes.ToArray();
+                int[] targetArray = targets.ToArray();
+                double[] statArray = new double[nameArray.Length * 7];
+                if (statArray.Length > 0)
+                    stats.CopyTo(statArray);
+
+                NetLayerProfile[] result = new NetLayerProfile[nameArray.Length];
+                for (int i = 0; i < result.Length; i++)
+                {
+                    int row = i * 7;
+                    result[i] = new NetLayerProfile(
+                        nameArray[i],
+                        typeArray[i],
+                        shapeArray[i],
+                        (Target) targetArray[i],
+                        statArray[row],
+                        statArray[row + 1],
+                        statArray[row + 2],
+                        statArray[row + 3],
+                        statArray[row + 4],
+                        (long) statArray[row + 5],
+                        (long) statArray[row + 6]);
+                }
+                return result;
+            }
+        }
+
+        /// <summary>
+        /// Get the statistics of the whole forward passes
+        /// </summary>
+        /// <param name="count">The number of passes run since the creation or the last reset of the profiler</param>
+        /// <param name="meanMs">The mean time of the recorded passes in milliseconds</param>
+        /// <param name="p50Ms">The median time of the recorded passes in milliseconds</param>
+        /// <param name="p90Ms">The 90th percentile of the time of the recorded passes in milliseconds</param>
+        /// <param name="p99Ms">The 99th percentile of the time of the recorded passes in milliseconds</param>
+        /// <param name="maxMs">The maximum time of the recorded passes in milliseconds</param>
+        public void GetForwardStats(out long count, out double meanMs, out double p50Ms, out double p90Ms, out double p99Ms, out double maxMs)
+        {
+            count = 0;
+            meanMs = 0;
+            p50Ms = 0;
+            p90Ms = 0;
+            p99Ms = 0;
+            maxMs = 0;
+            DnnInvoke.cveDnnNetProfilerGetForwardStats(_ptr, ref count, ref meanMs, ref p50Ms, ref p90Ms, ref p99Ms, ref maxMs);
+        }
+
+        /// <summary>
+        /// Get the recorded passes as Chrome trace-event JSON, that can be loaded in chrome://tracing or https://ui.perfetto.dev
+        /// </summary>
+        /// <returns>The trace-event JSON</returns>
+        public String GetChromeTrace()
+        {
+            using (CvString s = new CvString())
+            {
+                DnnInvoke.cveDnnNetProfilerGetChromeTrace(_ptr, s);
+                return s.ToString();
+            }
+        }
+
+        /// <summary>
+        /// Write the recorded passes to a Chrome trace-event JSON file
+        /// </summary>
+        /// <param name="fileName">The name of the JSON file</param>
+        public void ExportChromeTrace(String fileName)
+        {
+            File.WriteAllText(fileName, GetChromeTrace());
+        }
+
+        /// <summary>
+        /// Discard the recorded passes
+        /// </summary>
+        public void Reset()
+        {
+            DnnInvoke.cveDnnNetProfilerReset(_ptr);
+        }
+
+        /// <summary>
+        /// Release the unmanaged memory associated with this profiler
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                DnnInvoke.cveDnnNetProfilerRelease(ref _ptr);
+        }
+    }
+
+    /// <summary>
+    /// The profile of a network layer over the passes recorded by a NetProfiler
+    /// </summary>
+    public class NetLayerProfile
+    {
+        internal NetLayerProfile(String name, String type, String shapes, Target target, double meanMs, double p50Ms, double p90Ms, double p99Ms, double maxMs, long blobBytes, long weightBytes)
+        {
+            Name = name;
+            Type = type;
+            Shapes = shapes;
+            Target = target;
+            MeanMs = meanMs;
+            P50Ms = p50Ms;
+            P90Ms = p90Ms;
+            P99Ms = p99Ms;
+            MaxMs = maxMs;
+            BlobBytes = blobBytes;
+            WeightBytes = weightBytes;
+        }
+
+        /// <summary>
+        /// The name of the layer
+        /// </summary>
+        public String Name { get; private set; }
+
+        /// <summary>
+        /// The type of the layer
+        /// </summary>
+        public String Type { get; private set; }
+
+        /// <summary>
+        /// The input and output shapes of the last pass, e.g. "1x3x224x224 -> 1x64x112x112". Empty if they can not be inferred from the input shapes.
+        /// </summary>
+        public String Shapes { get; private set; }
+
+        /// <summary>
+        /// The target the layer has been run on
+        /// </summary>
+        public Target Target { get; private set; }
+
+        /// <summary>
+        /// The mean time in milliseconds. It is 0 for a layer that has been fused into another one.
+        /// </summary>
+        public double MeanMs { get; private set; }
+
+        /// <summary>
+        /// The median time in milliseconds
+        /// </summary>
+        public double P50Ms { get; private set; }
+
+        /// <summary>
+        /// The 90th percentile of the time in milliseconds
+        /// </summary>
+        public double P90Ms { get; private set; }
+
+        /// <summary>
+        /// The 99th percentile of the time in milliseconds
+        /// </summary>
+        public double P99Ms { get; private set; }
+
+        /// <summary>
+        /// The maximum time in milliseconds
+        /// </summary>
+        public double MaxMs { get; private set; }
+
+        /// <summary>
+        /// The bytes of the output and internal blobs of the layer
+        /// </summary>
+        public long BlobBytes { get; private set; }
+
+        /// <summary>
+        /// The bytes of the weights of the layer
+        /// </summary>
+        public long WeightBytes { get; private set; }
+    }
+
+    public static partial class DnnInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveDnnNetProfilerCreate(IntPtr net, int historySize, Backend backend, Target target);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetProfilerRelease(ref IntPtr profiler);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetProfilerForward(IntPtr profiler, IntPtr inputs, IntPtr inputNames, IntPtr outputs, IntPtr outputNames);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetProfilerGetLayerStats(IntPtr profiler, IntPtr names, IntPtr types, IntPtr shapes, IntPtr targets, IntPtr stats);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetProfilerGetForwardStats(IntPtr profiler, ref long count, ref double meanMs, ref double p50Ms, ref double p90Ms, ref double p99Ms, ref double maxMs);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetProfilerGetChromeTrace(IntPtr profiler, IntPtr trace);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDnnNetProfilerReset(IntPtr profiler);
+    }
+}
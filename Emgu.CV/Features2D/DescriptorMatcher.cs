@@ -92,6 +92,14 @@ namespace Emgu.CV.Features2D
             get { return Features2DInvoke.cveDescriptorMatcherGetAlgorithm(_ptr); }
         }
 
+        /// <summary>
+        /// The pointer to the native cv::DescriptorMatcher
+        /// </summary>
+        internal IntPtr DescriptorMatcherPtr
+        {
+            get { return _descriptorMatcherPtr; }
+        }
+
         /// <summary>
         /// Reset the native pointer upon object disposal
         /// </summary>
@@ -68,6 +68,26 @@ namespace Emgu.CV.Features2D
                 Features2DInvoke.cveFeature2DDetectAndCompute(_ptr, iaImage, iaMask, keyPoints, oaDescriptors, useProvidedKeyPoints);
         }
 
+        /// <summary>
+        /// Detect keypoints and compute their descriptors on many images in a single call. The images are processed in parallel
+        /// for the detectors that support it (ORB, BRISK, KAZE, AKAZE, SIFT, FAST, AGAST, GFTT), the other detectors process them one after the other.
+        /// </summary>
+        /// <param name="images">The images</param>
+        /// <param name="masks">The optional masks, one per image, can be null if not needed</param>
+        /// <param name="keyPoints">The keypoints of all the images, one image after the other</param>
+        /// <param name="descriptors">The descriptors of all the images, one row per keypoint</param>
+        /// <param name="offsets">The index of the first keypoint and descriptor row of every image, followed by the total number of keypoints. The keypoints of image i are in [offsets[i], offsets[i + 1]).</param>
+        public void DetectAndComputeBatch(VectorOfMat images, VectorOfMat masks, VectorOfKeyPoint keyPoints, Mat descriptors, VectorOfInt offsets)
+        {
+            Features2DInvoke.cveFeature2DDetectAndComputeBatch(
+                _feature2D,
+                images,
+                masks == null ? IntPtr.Zero : masks.Ptr,
+                keyPoints,
+                descriptors,
+                offsets);
+        }
+
         /// <summary>
         /// Reset the pointers
         /// </summary>
@@ -150,6 +170,15 @@ namespace Emgu.CV.Features2D
             [MarshalAs(CvInvoke.BoolMarshalType)]
             bool useProvidedKeyPoints);
 
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveFeature2DDetectAndComputeBatch(
+            IntPtr feature2D,
+            IntPtr images,
+            IntPtr masks,
+            IntPtr keypoints,
+            IntPtr descriptors,
+            IntPtr offsets);
+
         [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
         internal static extern void cveFeature2DDetect(
            IntPtr detector,
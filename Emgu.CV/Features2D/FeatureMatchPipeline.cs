@@ -0,0 +1,117 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV.Features2D
+{
+    /// <summary>
+    /// Find an object in an image with a single native call: the observed descriptors are matched to the model with a knn match,
+    /// filtered with the uniqueness test and the size and orientation vote, then the homography is found with RANSAC.
+    /// It gives the same result as calling DescriptorMatcher.KnnMatch, Features2DToolbox.VoteForUniqueness, Features2DToolbox.VoteForSizeAndOrientation
+    /// and Features2DToolbox.GetHomographyMatrixFromMatchedFeatures in sequence.
+    /// </summary>
+    /// <remarks>The scratch buffers are reused between the calls, an instance must only be used from one thread at a time.</remarks>
+    public class FeatureMatchPipeline : UnmanagedObject
+    {
+        private double[] _stageTimes = new double[4];
+
+        /// <summary>
+        /// Create a feature matching pipeline
+        /// </summary>
+        /// <param name="uniquenessThreshold">The distance ratio below which a match is considered unique, a good number will be 0.8</param>
+        /// <param name="scaleIncrement">The scale difference between neighbor bins of the size vote, a good value might be 1.5</param>
+        /// <param name="rotationBins">The number of bins of the orientation vote, a good value might be 20</param>
+        /// <param name="ransacReprojThreshold">The maximum allowed reprojection error to treat a point pair as an inlier</param>
+        public FeatureMatchPipeline(double uniquenessThreshold = 0.8, double scaleIncrement = 1.5, int rotationBins = 20, double ransacReprojThreshold = 2)
+        {
+            _ptr = Features2DInvoke.cveFeatureMatchPipelineCreate(uniquenessThreshold, scaleIncrement, rotationBins, ransacReprojThreshold);
+        }
+
+        /// <summary>
+        /// Match the observed descriptors and find the homography from the model to the observed image
+        /// </summary>
+        /// <param name="matcher">The descriptor matcher, the model descriptors must have been added to it</param>
+        /// <param name="modelKeyPoints">The model keypoints, in the order of the model descriptors</param>
+        /// <param name="observedKeyPoints">The observed keypoints</param>
+        /// <param name="observedDescriptors">The observed descriptors</param>
+        /// <param name="inliers">The matches kept by RANSAC, the query index is the observed keypoint and the train index is the model keypoint. Use null if not needed.</param>
+        /// <returns>The homography matrix, null if it cannot be found</returns>
+        public Mat Match(
+            DescriptorMatcher matcher,
+            VectorOfKeyPoint modelKeyPoints,
+            VectorOfKeyPoint observedKeyPoints,
+            IInputArray observedDescriptors,
+            VectorOfDMatch inliers = null)
+        {
+            Mat homography = new Mat();
+            bool found;
+            using (InputArray iaObservedDescriptors = observedDescriptors.GetInputArray())
+            using (VectorOfDMatch vInliers = inliers == null ? new VectorOfDMatch() : null)
+            {
+                found = Features2DInvoke.cveFeatureMatchPipelineMatch(
+                    _ptr,
+                    matcher.DescriptorMatcherPtr,
+                    modelKeyPoints,
+                    observedKeyPoints,
+                    iaObservedDescriptors,
+                    homography,
+                    inliers == null ? vInliers : inliers,
+                    _stageTimes);
+            }
+            if (found)
+            {
+                return homography;
+            }
+            else
+            {
+                homography.Dispose();
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// The time in milliseconds of each stage of the last Match call: the knn match, the uniqueness test, the size and orientation vote and the homography.
+        /// The stages that have not been reached are 0.
+        /// </summary>
+        public double[] StageTimes
+        {
+            get { return (double[])_stageTimes.Clone(); }
+        }
+
+        /// <summary>
+        /// Release the unmanaged memory associated with this pipeline
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                Features2DInvoke.cveFeatureMatchPipelineRelease(ref _ptr);
+        }
+    }
+
+    public static partial class Features2DInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveFeatureMatchPipelineCreate(double uniquenessThreshold, double scaleIncrement, int rotationBins, double ransacThreshold);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cveFeatureMatchPipelineMatch(
+            IntPtr pipeline,
+            IntPtr matcher,
+            IntPtr modelKeyPoints,
+            IntPtr observedKeyPoints,
+            IntPtr observedDescriptors,
+            IntPtr homography,
+            IntPtr inliers,
+            [Out] double[] stageMs);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveFeatureMatchPipelineRelease(ref IntPtr pipeline);
+    }
+}
@@ -0,0 +1,45 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV;
+using Emgu.Util;
+
+namespace Emgu.CV.Features2D
+{
+    /// <summary>
+    /// Brute force matcher for binary descriptors (ORB, BRISK, AKAZE...) with the Hamming distance.
+    /// It returns the same matches as a BFMatcher with DistanceType.Hamming, the distances are computed with SIMD popcount kernels selected at runtime.
+    /// </summary>
+    public class HammingMatcher : DescriptorMatcher
+    {
+        /// <summary>
+        /// Create a Hamming matcher
+        /// </summary>
+        public HammingMatcher()
+        {
+            _ptr = Features2DInvoke.cveHammingMatcherCreate(ref _descriptorMatcherPtr);
+        }
+
+        /// <summary>
+        /// Release the unmanaged resource associated with the HammingMatcher
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (IntPtr.Zero != _ptr)
+                Features2DInvoke.cveHammingMatcherRelease(ref _ptr);
+            base.DisposeObject();
+        }
+    }
+
+    public static partial class Features2DInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveHammingMatcherCreate(ref IntPtr dmPtr);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveHammingMatcherRelease(ref IntPtr matcher);
+    }
+}
@@ -0,0 +1,81 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV.Features2D
+{
+    /// <summary>
+    /// The workspace of the size and orientation vote. It gives the same result as Features2DToolbox.VoteForSizeAndOrientation,
+    /// its buffers are reused from one vote to the next, and the binning of large sets of matches can run in parallel.
+    /// </summary>
+    /// <remarks>An instance must only be used from one thread at a time.</remarks>
+    public class SizeOrientationVoter : UnmanagedObject
+    {
+        /// <summary>
+        /// Create the workspace of the size and orientation vote
+        /// </summary>
+        public SizeOrientationVoter()
+        {
+            _ptr = Features2DInvoke.cveSizeOrientationVoterCreate();
+        }
+
+        /// <summary>
+        /// Eliminate the matched features whose scale and rotation do not agree with the majority's scale and rotation.
+        /// </summary>
+        /// <param name="modelKeyPoints">The keypoints from the model image</param>
+        /// <param name="observedKeyPoints">The keypoints from the observed image</param>
+        /// <param name="matches">Matches. Each matches[i] is k or less matches for the same query descriptor.</param>
+        /// <param name="mask">This is both input and output. This matrix indicates which row is valid for the matches.</param>
+        /// <param name="scaleIncrement">This determines the different in scale for neighbor hood bins, a good value might be 1.5</param>
+        /// <param name="rotationBins">The numbers of bins for rotation, a good value might be 20</param>
+        /// <param name="parallel">If true, large sets of matches are binned in parallel</param>
+        /// <returns>The number of non-zero elements in the resulting mask</returns>
+        public int Vote(
+            VectorOfKeyPoint modelKeyPoints,
+            VectorOfKeyPoint observedKeyPoints,
+            VectorOfVectorOfDMatch matches,
+            Mat mask,
+            double scaleIncrement,
+            int rotationBins,
+            bool parallel = false)
+        {
+            return Features2DInvoke.cveSizeOrientationVoterVote(_ptr, modelKeyPoints, observedKeyPoints, matches, mask, scaleIncrement, rotationBins, parallel);
+        }
+
+        /// <summary>
+        /// Release the unmanaged memory associated with this workspace
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                Features2DInvoke.cveSizeOrientationVoterRelease(ref _ptr);
+        }
+    }
+
+    public static partial class Features2DInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveSizeOrientationVoterCreate();
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern int cveSizeOrientationVoterVote(
+            IntPtr voter,
+            IntPtr modelKeyPoints,
+            IntPtr observedKeyPoints,
+            IntPtr matches,
+            IntPtr mask,
+            double scaleIncrement,
+            int rotationBins,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool parallel);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveSizeOrientationVoterRelease(ref IntPtr voter);
+    }
+}
@@ -0,0 +1,154 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV.Flann
+{
+    /// <summary>
+    /// A descriptor index that can be updated and saved without being rebuilt from scratch.
+    /// The descriptors are stored in segments, each with its own flann index. Adding descriptors only builds the index of the new segment,
+    /// the small segments are merged as the index grows. Removed descriptors are skipped by the searches until their segment is rebuilt.
+    /// </summary>
+    /// <remarks>The searches can run from many threads, concurrently with the updates. A saved index is memory mapped when it is loaded.</remarks>
+    public class DescriptorIndex : UnmanagedObject
+    {
+        /// <summary>
+        /// Create an empty descriptor index
+        /// </summary>
+        /// <param name="ip">The parameters of the flann index of each segment</param>
+        /// <param name="distType">The distance type. The descriptors must be of type Cv8U for Hamming, Cv32F otherwise.</param>
+        public DescriptorIndex(IIndexParams ip, DistType distType = DistType.L2)
+        {
+            _ptr = FlannInvoke.cveFlannDescriptorIndexCreate(ip.IndexParamPtr, distType);
+        }
+
+        /// <summary>
+        /// Load a descriptor index saved with the Save function
+        /// </summary>
+        /// <param name="fileName">The name of the file the index has been saved to</param>
+        public DescriptorIndex(String fileName)
+        {
+            using (CvString s = new CvString(fileName))
+                _ptr = FlannInvoke.cveFlannDescriptorIndexLoad(s);
+        }
+
+        /// <summary>
+        /// Add descriptors to the index. They are given consecutive ids.
+        /// </summary>
+        /// <param name="descriptors">The descriptors, one per row</param>
+        /// <returns>The id of the first descriptor</returns>
+        public int Add(IInputArray descriptors)
+        {
+            using (InputArray iaDescriptors = descriptors.GetInputArray())
+                return FlannInvoke.cveFlannDescriptorIndexAdd(_ptr, iaDescriptors);
+        }
+
+        /// <summary>
+        /// Remove descriptors from the index
+        /// </summary>
+        /// <param name="ids">The ids of the descriptors to remove. The ids that are not in the index are ignored.</param>
+        /// <returns>The number of descriptors removed</returns>
+        public int Remove(params int[] ids)
+        {
+            using (VectorOfInt vIds = new VectorOfInt(ids))
+                return FlannInvoke.cveFlannDescriptorIndexRemove(_ptr, vIds);
+        }
+
+        /// <summary>
+        /// Perform k-nearest-neighbours (KNN) search
+        /// </summary>
+        /// <param name="queries">A row by row matrix of descriptors to be query for nearest neighbours</param>
+        /// <param name="ids">The ids of the k-nearest neighbours, -1 if the index has less than knn descriptors</param>
+        /// <param name="distances">The distances to the neighbours, the square of the Euclidean distance for L2</param>
+        /// <param name="knn">Number of nearest neighbors to search for</param>
+        /// <param name="checks">The number of times the tree(s) in the index should be recursively traversed</param>
+        /// <param name="eps">The search epsilon</param>
+        public void KnnSearch(IInputArray queries, IOutputArray ids, IOutputArray distances, int knn, int checks = 32, float eps = 0)
+        {
+            using (InputArray iaQueries = queries.GetInputArray())
+            using (OutputArray oaIds = ids.GetOutputArray())
+            using (OutputArray oaDistances = distances.GetOutputArray())
+                FlannInvoke.cveFlannDescriptorIndexKnnSearch(_ptr, iaQueries, oaIds, oaDistances, knn, checks, eps);
+        }
+
+        /// <summary>
+        /// Save the index. The flann index of each segment is saved next to it, in fileName.&lt;segment&gt;.flann
+        /// </summary>
+        /// <param name="fileName">The name of the file</param>
+        public void Save(String fileName)
+        {
+            using (CvString s = new CvString(fileName))
+                FlannInvoke.cveFlannDescriptorIndexSave(_ptr, s);
+        }
+
+        /// <summary>
+        /// Get the number of descriptors in the index
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                int count = 0;
+                int segmentCount = 0;
+                FlannInvoke.cveFlannDescriptorIndexGetStats(_ptr, ref count, ref segmentCount);
+                return count;
+            }
+        }
+
+        /// <summary>
+        /// Get the number of segments of the index
+        /// </summary>
+        public int SegmentCount
+        {
+            get
+            {
+                int count = 0;
+                int segmentCount = 0;
+                FlannInvoke.cveFlannDescriptorIndexGetStats(_ptr, ref count, ref segmentCount);
+                return segmentCount;
+            }
+        }
+
+        /// <summary>
+        /// Release the unmanaged memory associated with this descriptor index
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                FlannInvoke.cveFlannDescriptorIndexRelease(ref _ptr);
+        }
+    }
+
+    internal static partial class FlannInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveFlannDescriptorIndexCreate(IntPtr ip, Emgu.CV.Flann.DistType distType);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveFlannDescriptorIndexLoad(IntPtr fileName);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveFlannDescriptorIndexRelease(ref IntPtr index);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern int cveFlannDescriptorIndexAdd(IntPtr index, IntPtr descriptors);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern int cveFlannDescriptorIndexRemove(IntPtr index, IntPtr ids);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveFlannDescriptorIndexKnnSearch(IntPtr index, IntPtr queries, IntPtr ids, IntPtr dists, int knn, int checks, float eps);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveFlannDescriptorIndexSave(IntPtr index, IntPtr fileName);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveFlannDescriptorIndexGetStats(IntPtr index, ref int count, ref int segmentCount);
+    }
+}
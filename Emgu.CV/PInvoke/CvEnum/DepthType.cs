@@ -42,6 +42,10 @@ namespace Emgu.CV.CvEnum
         /// <summary>
         /// double
         /// </summary>
-        Cv64F = 6
+        Cv64F = 6,
+        /// <summary>
+        /// Half precision float
+        /// </summary>
+        Cv16F = 7
     }
 }
@@ -0,0 +1,192 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV.Structure;
+
+namespace Emgu.CV
+{
+   /// <summary>
+   /// An array of colored points stored as structure of arrays: one array per coordinate and per color channel
+   /// </summary>
+   public class ColorPointArray
+   {
+      private readonly float[] _x;
+      private readonly float[] _y;
+      private readonly float[] _z;
+      private readonly byte[] _blue;
+      private readonly byte[] _green;
+      private readonly byte[] _red;
+
+      /// <summary>
+      /// Create an array that can hold up to <paramref name="capacity"/> points
+      /// </summary>
+      /// <param name="capacity">The maximum number of points</param>
+      public ColorPointArray(int capacity)
+      {
+         _x = new float[capacity];
+         _y = new float[capacity];
+         _z = new float[capacity];
+         _blue = new byte[capacity];
+         _green = new byte[capacity];
+         _red = new byte[capacity];
+      }
+
+      /// <summary>
+      /// The maximum number of points the array can hold
+      /// </summary>
+      public int Capacity
+      {
+         get { return _x.Length; }
+      }
+
+      /// <summary>
+      /// The X coordinates in meters
+      /// </summary>
+      public float[] X { get { return _x; } }
+
+      /// <summary>
+      /// The Y coordinates in meters
+      /// </summary>
+      public float[] Y { get { return _y; } }
+
+      /// <summary>
+      /// The Z coordinates in meters
+      /// </summary>
+      public float[] Z { get { return _z; } }
+
+      /// <summary>
+      /// The blue colors
+      /// </summary>
+      public byte[] Blue { get { return _blue; } }
+
+      /// <summary>
+      /// The green colors
+      /// </summary>
+      public byte[] Green { get { return _green; } }
+
+      /// <summary>
+      /// The red colors
+      /// </summary>
+      public byte[] Red { get { return _red; } }
+
+      /// <summary>
+      /// Get the point at the specific index
+      /// </summary>
+      /// <param name="index">The index</param>
+      public ColorPoint this[int index]
+      {
+         get
+         {
+            ColorPoint cp = new ColorPoint();
+            cp.Position = new MCvPoint3D32f(_x[index], _y[index], _z[index]);
+            cp.Blue = _blue[index];
+            cp.Green = _green[index];
+            cp.Red = _red[index];
+            return cp;
+         }
+      }
+
+      internal class Pinned : IDisposable
+      {
+         private GCHandle _x, _y, _z, _blue, _green, _red;
+         public ColorPointsSoA SoA;
+
+         public Pinned(ColorPointArray p)
+         {
+            _x = GCHandle.Alloc(p._x, GCHandleType.Pinned);
+            _y = GCHandle.Alloc(p._y, GCHandleType.Pinned);
+            _z = GCHandle.Alloc(p._z, GCHandleType.Pinned);
+            _blue = GCHandle.Alloc(p._blue, GCHandleType.Pinned);
+            _green = GCHandle.Alloc(p._green, GCHandleType.Pinned);
+            _red = GCHandle.Alloc(p._red, GCHandleType.Pinned);
+            SoA.X = _x.AddrOfPinnedObject();
+            SoA.Y = _y.AddrOfPinnedObject();
+            SoA.Z = _z.AddrOfPinnedObject();
+            SoA.Blue = _blue.AddrOfPinnedObject();
+            SoA.Green = _green.AddrOfPinnedObject();
+            SoA.Red = _red.AddrOfPinnedObject();
+         }
+
+         public void Dispose()
+         {
+            _x.Free();
+            _y.Free();
+            _z.Free();
+            _blue.Free();
+            _green.Free();
+            _red.Free();
+         }
+      }
+   }
+
+   /// <summary>
+   /// The pointers to the components of the colored points array, the same layout as the native ColorPointsSoA
+   /// </summary>
+   [StructLayout(LayoutKind.Sequential)]
+   internal struct ColorPointsSoA
+   {
+      public IntPtr X;
+      public IntPtr Y;
+      public IntPtr Z;
+      public IntPtr Blue;
+      public IntPtr Green;
+      public IntPtr Red;
+   }
+
+   public static partial class CvInvoke
+   {
+      /// <summary>
+      /// Extract the colored points from a point cloud and a color image of the same size, row by row. The rows are processed in parallel.
+      /// </summary>
+      /// <param name="pointCloud">The point cloud (CV_32FC3), XYZ in meters. e.g. the OpenNI point cloud map</param>
+      /// <param name="bgr">The color image (CV_8UC3)</param>
+      /// <param name="mask">Only the points with a non zero mask value (CV_8UC1) are extracted. Use null to extract all the points</param>
+      /// <param name="points">The preallocated buffer to write the points to. Use null to only compute the number of points</param>
+      /// <returns>The number of points selected by the mask</returns>
+      public static int GetColorPoints(IInputArray pointCloud, IInputArray bgr, IInputArray mask, ColorPoint[] points)
+      {
+         using (InputArray iaPointCloud = pointCloud.GetInputArray())
+         using (InputArray iaBgr = bgr.GetInputArray())
+         using (InputArray iaMask = mask == null ? InputArray.GetEmpty() : mask.GetInputArray())
+         {
+            if (points == null)
+               return cveGetColorPoints(iaPointCloud, iaBgr, iaMask, IntPtr.Zero, 0);
+            GCHandle handle = GCHandle.Alloc(points, GCHandleType.Pinned);
+            try
+            {
+               return cveGetColorPoints(iaPointCloud, iaBgr, iaMask, handle.AddrOfPinnedObject(), points.Length);
+            }
+            finally
+            {
+               handle.Free();
+            }
+         }
+      }
+
+      /// <summary>
+      /// Extract the colored points from a point cloud and a color image of the same size, row by row, into separated coordinate and color arrays. The rows are processed in parallel.
+      /// </summary>
+      /// <param name="pointCloud">The point cloud (CV_32FC3), XYZ in meters. e.g. the OpenNI point cloud map</param>
+      /// <param name="bgr">The color image (CV_8UC3)</param>
+      /// <param name="mask">Only the points with a non zero mask value (CV_8UC1) are extracted. Use null to extract all the points</param>
+      /// <param name="points">The preallocated buffer to write the points to</param>
+      /// <returns>The number of points written to <paramref name="points"/></returns>
+      public static int GetColorPoints(IInputArray pointCloud, IInputArray bgr, IInputArray mask, ColorPointArray points)
+      {
+         using (InputArray iaPointCloud = pointCloud.GetInputArray())
+         using (InputArray iaBgr = bgr.GetInputArray())
+         using (InputArray iaMask = mask == null ? InputArray.GetEmpty() : mask.GetInputArray())
+         using (ColorPointArray.Pinned p = new ColorPointArray.Pinned(points))
+            return cveGetColorPointsSoA(iaPointCloud, iaBgr, iaMask, ref p.SoA, points.Capacity);
+      }
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern int cveGetColorPoints(IntPtr pointCloud, IntPtr bgr, IntPtr mask, IntPtr points, int capacity);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern int cveGetColorPointsSoA(IntPtr pointCloud, IntPtr bgr, IntPtr mask, ref ColorPointsSoA points, int capacity);
+   }
+}
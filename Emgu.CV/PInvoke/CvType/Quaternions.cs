@@ -132,6 +132,20 @@ namespace Emgu.CV
          CvInvoke.quaternionsRotatePoints(ref this, pointsSrc, pointsDst);
       }
 
+      /// <summary>
+      /// Rotate the points in <paramref name="pointsSrc"/> and save the result in <paramref name="pointsDst"/>. The rotation matrix is computed only once. In-place operation is supported.
+      /// </summary>
+      /// <param name="pointsSrc">The points to be rotated</param>
+      /// <param name="pointsDst">The result of the rotation, should be the same size as <paramref name="pointsSrc"/>, can be <paramref name="pointsSrc"/> as well for inplace rotation</param>
+      public void RotatePoints(Point3D64fArray pointsSrc, Point3D64fArray pointsDst)
+      {
+         if (pointsSrc.Count != pointsDst.Count)
+            throw new ArgumentException("The source and destination must have the same number of points");
+         using (Point3D64fArray.Pinned src = new Point3D64fArray.Pinned(pointsSrc))
+         using (Point3D64fArray.Pinned dst = new Point3D64fArray.Pinned(pointsDst))
+            CvInvoke.quaternionsRotatePointsSoA(ref this, ref src.SoA, ref dst.SoA, pointsSrc.Count);
+      }
+
       /// <summary>
       /// Rotate the specific point and return the result
       /// </summary>
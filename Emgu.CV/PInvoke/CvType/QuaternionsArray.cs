@@ -0,0 +1,341 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV.Structure;
+
+namespace Emgu.CV
+{
+   /// <summary>
+   /// An array of unit quaternions stored as structure of arrays, such that the batch operations can be vectorized
+   /// </summary>
+   public class QuaternionsArray
+   {
+      private readonly double[] _w;
+      private readonly double[] _x;
+      private readonly double[] _y;
+      private readonly double[] _z;
+
+      /// <summary>
+      /// Create an array of <paramref name="count"/> quaternions, all initialized to the identity rotation
+      /// </summary>
+      /// <param name="count">The number of quaternions</param>
+      public QuaternionsArray(int count)
+      {
+         _w = new double[count];
+         _x = new double[count];
+         _y = new double[count];
+         _z = new double[count];
+         for (int i = 0; i < count; i++)
+            _w[i] = 1.0;
+      }
+
+      /// <summary>
+      /// Create an array of quaternions from the values of <paramref name="quaternions"/>
+      /// </summary>
+      /// <param name="quaternions">The quaternions</param>
+      public QuaternionsArray(Quaternions[] quaternions)
+         : this(quaternions.Length)
+      {
+         for (int i = 0; i < quaternions.Length; i++)
+            this[i] = quaternions[i];
+      }
+
+      /// <summary>
+      /// The number of quaternions
+      /// </summary>
+      public int Count
+      {
+         get { return _w.Length; }
+      }
+
+      /// <summary>
+      /// The W components
+      /// </summary>
+      public double[] W { get { return _w; } }
+
+      /// <summary>
+      /// The X components
+      /// </summary>
+      public double[] X { get { return _x; } }
+
+      /// <summary>
+      /// The Y components
+      /// </summary>
+      public double[] Y { get { return _y; } }
+
+      /// <summary>
+      /// The Z components
+      /// </summary>
+      public double[] Z { get { return _z; } }
+
+      /// <summary>
+      /// Get or set the quaternions at the specific index
+      /// </summary>
+      /// <param name="index">The index</param>
+      public Quaternions this[int index]
+      {
+         get { return new Quaternions(_w[index], _x[index], _y[index], _z[index]); }
+         set
+         {
+            _w[index] = value.W;
+            _x[index] = value.X;
+            _y[index] = value.Y;
+            _z[index] = value.Z;
+         }
+      }
+
+      /// <summary>
+      /// Renormalize all the quaternions such that their norm becomes 1
+      /// </summary>
+      public void Renorm()
+      {
+         using (Pinned p = new Pinned(this))
+            CvInvoke.quaternionsBatchRenorm(ref p.SoA, Count);
+      }
+
+      /// <summary>
+      /// Multiply the quaternions element wise with <paramref name="other"/> and save the renormalized results in <paramref name="dst"/>. In-place operation is supported.
+      /// </summary>
+      /// <param name="other">The other quaternions, must have the same count</param>
+      /// <param name="dst">The result, must have the same count. Can be this or <paramref name="other"/></param>
+      public void Multiply(QuaternionsArray other, QuaternionsArray dst)
+      {
+         CheckCount(other.Count);
+         CheckCount(dst.Count);
+         using (Pinned p1 = new Pinned(this))
+         using (Pinned p2 = new Pinned(other))
+         using (Pinned pDst = new Pinned(dst))
+            CvInvoke.quaternionsBatchMultiply(ref p1.SoA, ref p2.SoA, ref pDst.SoA, Count);
+      }
+
+      /// <summary>
+      /// Slerp the quaternions element wise with <paramref name="other"/>
+      /// </summary>
+      /// <param name="other">The other quaternions, must have the same count</param>
+      /// <param name="weightForOther">The weight for the other quaternions</param>
+      /// <param name="dst">The result, must have the same count</param>
+      public void Slerp(QuaternionsArray other, double weightForOther, QuaternionsArray dst)
+      {
+         CheckCount(other.Count);
+         CheckCount(dst.Count);
+         using (Pinned p1 = new Pinned(this))
+         using (Pinned p2 = new Pinned(other))
+         using (Pinned pDst = new Pinned(dst))
+            CvInvoke.quaternionsBatchSlerp(ref p1.SoA, ref p2.SoA, weightForOther, ref pDst.SoA, Count);
+      }
+
+      /// <summary>
+      /// Rotate the i-th point by the i-th quaternions. In-place operation is supported.
+      /// </summary>
+      /// <param name="pointsSrc">The points to be rotated, must have the same count</param>
+      /// <param name="pointsDst">The rotated points, must have the same count. Can be <paramref name="pointsSrc"/></param>
+      public void RotatePoints(Point3D64fArray pointsSrc, Point3D64fArray pointsDst)
+      {
+         CheckCount(pointsSrc.Count);
+         CheckCount(pointsDst.Count);
+         using (Pinned q = new Pinned(this))
+         using (Point3D64fArray.Pinned src = new Point3D64fArray.Pinned(pointsSrc))
+         using (Point3D64fArray.Pinned dst = new Point3D64fArray.Pinned(pointsDst))
+            CvInvoke.quaternionsBatchRotatePoints(ref q.SoA, ref src.SoA, ref dst.SoA, Count);
+      }
+
+      /// <summary>
+      /// Get the equivalent euler angles (in radian) of all the quaternions
+      /// </summary>
+      /// <param name="euler">The euler angles, must have the same count</param>
+      public void GetEuler(Point3D64fArray euler)
+      {
+         CheckCount(euler.Count);
+         using (Pinned q = new Pinned(this))
+         using (Point3D64fArray.Pinned e = new Point3D64fArray.Pinned(euler))
+            CvInvoke.quaternionsBatchToEuler(ref q.SoA, ref e.SoA, Count);
+      }
+
+      /// <summary>
+      /// Set the value of the quaternions using the euler angles (in radian)
+      /// </summary>
+      /// <param name="euler">The euler angles, must have the same count</param>
+      public void SetEuler(Point3D64fArray euler)
+      {
+         CheckCount(euler.Count);
+         using (Pinned q = new Pinned(this))
+         using (Point3D64fArray.Pinned e = new Point3D64fArray.Pinned(euler))
+            CvInvoke.eulerToQuaternionsBatch(ref e.SoA, ref q.SoA, Count);
+      }
+
+      private void CheckCount(int count)
+      {
+         if (count != Count)
+            throw new ArgumentException(String.Format("The number of elements {0} does not match the number of quaternions {1}", count, Count));
+      }
+
+      internal class Pinned : IDisposable
+      {
+         private GCHandle _w, _x, _y, _z;
+         public QuaternionsSoA SoA;
+
+         public Pinned(QuaternionsArray q)
+         {
+            _w = GCHandle.Alloc(q._w, GCHandleType.Pinned);
+            _x = GCHandle.Alloc(q._x, GCHandleType.Pinned);
+            _y = GCHandle.Alloc(q._y, GCHandleType.Pinned);
+            _z = GCHandle.Alloc(q._z, GCHandleType.Pinned);
+            SoA.W = _w.AddrOfPinnedObject();
+            SoA.X = _x.AddrOfPinnedObject();
+            SoA.Y = _y.AddrOfPinnedObject();
+            SoA.Z = _z.AddrOfPinnedObject();
+         }
+
+         public void Dispose()
+         {
+            _w.Free();
+            _x.Free();
+            _y.Free();
+            _z.Free();
+         }
+      }
+   }
+
+   /// <summary>
+   /// An array of 3D points stored as structure of arrays
+   /// </summary>
+   public class Point3D64fArray
+   {
+      private readonly double[] _x;
+      private readonly double[] _y;
+      private readonly double[] _z;
+
+      /// <summary>
+      /// Create an array of <paramref name="count"/> points, all initialized to zero
+      /// </summary>
+      /// <param name="count">The number of points</param>
+      public Point3D64fArray(int count)
+      {
+         _x = new double[count];
+         _y = new double[count];
+         _z = new double[count];
+      }
+
+      /// <summary>
+      /// Create an array of points from the values of <paramref name="points"/>
+      /// </summary>
+      /// <param name="points">The points</param>
+      public Point3D64fArray(MCvPoint3D64f[] points)
+         : this(points.Length)
+      {
+         for (int i = 0; i < points.Length; i++)
+            this[i] = points[i];
+      }
+
+      /// <summary>
+      /// The number of points
+      /// </summary>
+      public int Count
+      {
+         get { return _x.Length; }
+      }
+
+      /// <summary>
+      /// The X coordinates
+      /// </summary>
+      public double[] X { get { return _x; } }
+
+      /// <summary>
+      /// The Y coordinates
+      /// </summary>
+      public double[] Y { get { return _y; } }
+
+      /// <summary>
+      /// The Z coordinates
+      /// </summary>
+      public double[] Z { get { return _z; } }
+
+      /// <summary>
+      /// Get or set the point at the specific index
+      /// </summary>
+      /// <param name="index">The index</param>
+      public MCvPoint3D64f this[int index]
+      {
+         get { return new MCvPoint3D64f(_x[index], _y[index], _z[index]); }
+         set
+         {
+            _x[index] = value.X;
+            _y[index] = value.Y;
+            _z[index] = value.Z;
+         }
+      }
+
+      internal class Pinned : IDisposable
+      {
+         private GCHandle _x, _y, _z;
+         public Point3D64fSoA SoA;
+
+         public Pinned(Point3D64fArray p)
+         {
+            _x = GCHandle.Alloc(p._x, GCHandleType.Pinned);
+            _y = GCHandle.Alloc(p._y, GCHandleType.Pinned);
+            _z = GCHandle.Alloc(p._z, GCHandleType.Pinned);
+            SoA.X = _x.AddrOfPinnedObject();
+            SoA.Y = _y.AddrOfPinnedObject();
+            SoA.Z = _z.AddrOfPinnedObject();
+         }
+
+         public void Dispose()
+         {
+            _x.Free();
+            _y.Free();
+            _z.Free();
+         }
+      }
+   }
+
+   /// <summary>
+   /// The pointers to the components of the quaternions array, the same layout as the native QuaternionsSoA
+   /// </summary>
+   [StructLayout(LayoutKind.Sequential)]
+   internal struct QuaternionsSoA
+   {
+      public IntPtr W;
+      public IntPtr X;
+      public IntPtr Y;
+      public IntPtr Z;
+   }
+
+   /// <summary>
+   /// The pointers to the coordinates of the points array, the same layout as the native Point3D64fSoA
+   /// </summary>
+   [StructLayout(LayoutKind.Sequential)]
+   internal struct Point3D64fSoA
+   {
+      public IntPtr X;
+      public IntPtr Y;
+      public IntPtr Z;
+   }
+
+   public static partial class CvInvoke
+   {
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void quaternionsRotatePointsSoA(ref Quaternions quaternions, ref Point3D64fSoA pointSrc, ref Point3D64fSoA pointDst, int count);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void quaternionsBatchRotatePoints(ref QuaternionsSoA quaternions, ref Point3D64fSoA pointSrc, ref Point3D64fSoA pointDst, int count);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void quaternionsBatchMultiply(ref QuaternionsSoA quaternions1, ref QuaternionsSoA quaternions2, ref QuaternionsSoA quaternionsDst, int count);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void quaternionsBatchRenorm(ref QuaternionsSoA quaternions, int count);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void quaternionsBatchSlerp(ref QuaternionsSoA qa, ref QuaternionsSoA qb, double t, ref QuaternionsSoA qm, int count);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void quaternionsBatchToEuler(ref QuaternionsSoA quaternions, ref Point3D64fSoA euler, int count);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void eulerToQuaternionsBatch(ref Point3D64fSoA euler, ref QuaternionsSoA quaternions, int count);
+   }
+}
@@ -0,0 +1,211 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.       
+//----------------------------------------------------------------------------
+
+using System;
+using System.Drawing;
+using System.Runtime.InteropServices;
+using Emgu.CV.CvEnum;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV.Tiff
+{
+   internal static partial class TIFFInvoke
+   {
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern IntPtr tiffReaderOpen(
+         [MarshalAs(CvInvoke.StringMarshalType)]
+         string fileName,
+         int cacheSizeInTiles);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void tiffReaderRelease(ref IntPtr reader);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern int tiffReaderGetLevelCount(IntPtr reader);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void tiffReaderGetLevelInfo(
+         IntPtr reader,
+         int level,
+         ref Size imageSize,
+         ref Size tileSize,
+         [MarshalAs(CvInvoke.BoolMarshalType)]
+         ref bool isTiled);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern int tiffReaderGetType(IntPtr reader);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern void tiffReaderRead(IntPtr reader, int level, ref Rectangle roi, IntPtr dst);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      [return: MarshalAs(CvInvoke.BoolMarshalType)]
+      internal static extern bool tiffReaderGetGeoTag(
+         IntPtr reader,
+         [Out] double[] modelTiepoint,
+         [Out] double[] modelPixelScale);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      [return: MarshalAs(CvInvoke.BoolMarshalType)]
+      internal static extern bool tiffReaderGetGeoKey(IntPtr reader, int key, ref double value);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      [return: MarshalAs(CvInvoke.BoolMarshalType)]
+      internal static extern bool tiffReaderGetGeoKeyString(IntPtr reader, int key, IntPtr value);
+   }
+
+   /// <summary>
+   /// The layout of one resolution level of a tiff file
+   /// </summary>
+   public struct TiffLevelInfo
+   {
+      /// <summary>
+      /// The size of the image at this level
+      /// </summary>
+      public Size ImageSize;
+
+      /// <summary>
+      /// The size of the tiles. For images stored in strips, the width of the image by the rows per strip.
+      /// </summary>
+      public Size TileSize;
+
+      /// <summary>
+      /// True if the image is stored in tiles, false if it is stored in strips
+      /// </summary>
+      public bool IsTiled;
+   }
+
+   /// <summary>
+   /// A reader for large tiff and geotiff files. Only the tiles that intersect the requested region are decoded,
+   /// the most recently used tiles are cached.
+   /// </summary>
+   public class TiffReader : UnmanagedObject
+   {
+      static TiffReader()
+      {
+         CvInvoke.Init();
+      }
+
+      /// <summary>
+      /// Open a tiff file for reading
+      /// </summary>
+      /// <param name="fileName">The name of the file</param>
+      /// <param name="cacheSizeInTiles">The maximum number of decoded tiles that are cached</param>
+      public TiffReader(String fileName, int cacheSizeInTiles = 64)
+      {
+         _ptr = TIFFInvoke.tiffReaderOpen(fileName, cacheSizeInTiles);
+      }
+
+      /// <summary>
+      /// The number of resolution levels. Level 0 is the full resolution image, the following levels are the overviews stored in the file.
+      /// </summary>
+      public int LevelCount
+      {
+         get { return TIFFInvoke.tiffReaderGetLevelCount(_ptr); }
+      }
+
+      /// <summary>
+      /// Get the image size and tile layout of the specific level
+      /// </summary>
+      /// <param name="level">The resolution level</param>
+      /// <returns>The layout of the level</returns>
+      public TiffLevelInfo GetLevelInfo(int level = 0)
+      {
+         TiffLevelInfo info = new TiffLevelInfo();
+         TIFFInvoke.tiffReaderGetLevelInfo(_ptr, level, ref info.ImageSize, ref info.TileSize, ref info.IsTiled);
+         return info;
+      }
+
+      /// <summary>
+      /// The depth of the pixels
+      /// </summary>
+      public DepthType Depth
+      {
+         get { return (DepthType)(TIFFInvoke.tiffReaderGetType(_ptr) & 7); }
+      }
+
+      /// <summary>
+      /// The number of channels, in the order stored in the file (usually RGB)
+      /// </summary>
+      public int NumberOfChannels
+      {
+         get { return (TIFFInvoke.tiffReaderGetType(_ptr) >> 3) + 1; }
+      }
+
+      /// <summary>
+      /// Decode the region of the image into <paramref name="dst"/>. If <paramref name="dst"/> is a Mat of the right size and type, the pixels are decoded into it without reallocation.
+      /// </summary>
+      /// <param name="roi">The region to be read, in the coordinates of the level</param>
+      /// <param name="dst">The destination</param>
+      /// <param name="level">The resolution level</param>
+      public void Read(Rectangle roi, IOutputArray dst, int level = 0)
+      {
+         using (OutputArray oaDst = dst.GetOutputArray())
+            TIFFInvoke.tiffReaderRead(_ptr, level, ref roi, oaDst);
+      }
+
+      /// <summary>
+      /// Decode the region of the image
+      /// </summary>
+      /// <param name="roi">The region to be read, in the coordinates of the level</param>
+      /// <param name="level">The resolution level</param>
+      /// <returns>The pixels of the region</returns>
+      public Mat Read(Rectangle roi, int level = 0)
+      {
+         Mat m = new Mat();
+         Read(roi, m, level);
+         return m;
+      }
+
+      /// <summary>
+      /// Get the geo information of the tiff file
+      /// </summary>
+      /// <param name="modelTiepoint">Model Tie Point, an array of size 6</param>
+      /// <param name="modelPixelScale">Model pixel scale, an array of size 3</param>
+      /// <returns>False if the file does not contain the geo information</returns>
+      public bool TryGetGeoTag(out double[] modelTiepoint, out double[] modelPixelScale)
+      {
+         modelTiepoint = new double[6];
+         modelPixelScale = new double[3];
+         return TIFFInvoke.tiffReaderGetGeoTag(_ptr, modelTiepoint, modelPixelScale);
+      }
+
+      /// <summary>
+      /// Get the value of a numeric geo key
+      /// </summary>
+      /// <param name="key">The geo key id, e.g. 1024 for GTModelTypeGeoKey</param>
+      /// <param name="value">The value of the key</param>
+      /// <returns>False if the key does not exist</returns>
+      public bool TryGetGeoKey(int key, out double value)
+      {
+         value = 0;
+         return TIFFInvoke.tiffReaderGetGeoKey(_ptr, key, ref value);
+      }
+
+      /// <summary>
+      /// Get the value of an ascii geo key
+      /// </summary>
+      /// <param name="key">The geo key id, e.g. 1026 for GTCitationGeoKey</param>
+      /// <param name="value">The value of the key</param>
+      /// <returns>False if the key does not exist</returns>
+      public bool TryGetGeoKey(int key, out String value)
+      {
+         using (CvString s = new CvString())
+         {
+            bool found = TIFFInvoke.tiffReaderGetGeoKeyString(_ptr, key, s);
+            value = found ? s.ToString() : null;
+            return found;
+         }
+      }
+
+      /// <summary>
+      /// Release the reader and close the file
+      /// </summary>
+      protected override void DisposeObject()
+      {
+         TIFFInvoke.tiffReaderRelease(ref _ptr);
+      }
+   }
+}
@@ -23,11 +23,23 @@ namespace Emgu.CV.Tiff
          [MarshalAs(CvInvoke.StringMarshalType)]
          string fileSpec);
 
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      internal static extern IntPtr tiffWriterOpen2(
+         [MarshalAs(CvInvoke.StringMarshalType)]
+         string fileSpec,
+         [MarshalAs(CvInvoke.BoolMarshalType)]
+         bool bigTiff);
+
       [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
       internal static extern void tiffWriterClose(ref IntPtr pTiff);
 
       [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
-      internal static extern void tiffWriteGeoTag(IntPtr pTiff, IntPtr modelTiepoint, IntPtr ModelPixelScale);
+      internal static extern void tiffWriteGeoTag(
+         IntPtr pTiff,
+         IntPtr modelTiepoint,
+         IntPtr ModelPixelScale,
+         [MarshalAs(CvInvoke.StringMarshalType)]
+         string citation);
 
       [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
       internal static extern void tiffWriteImage(IntPtr pTiff, IntPtr image);
@@ -55,8 +67,18 @@ namespace Emgu.CV.Tiff
       /// </summary>
       /// <param name="fileName">The file name to be saved</param>
       public TiffWriter(String fileName)
+         : this(fileName, false)
+      {
+      }
+
+      /// <summary>
+      /// Create a tiff writer to save an image
+      /// </summary>
+      /// <param name="fileName">The file name to be saved</param>
+      /// <param name="bigTiff">If true, the file is written in BigTIFF format, which is required for files larger than 4GB</param>
+      public TiffWriter(String fileName, bool bigTiff)
       {
-         _ptr = TIFFInvoke.tiffWriterOpen(fileName);
+         _ptr = TIFFInvoke.tiffWriterOpen2(fileName, bigTiff);
          TIFFInvoke.tiffWriteImageInfo(_ptr, Image<TColor, TDepth>.SizeOfElement * 8, new TColor().Dimension);
       }
 
@@ -70,14 +92,14 @@ namespace Emgu.CV.Tiff
             || (typeof(TColor) == typeof(Rgb) && typeof(TDepth) == typeof(Byte))
             || (typeof(TColor) == typeof(Rgba) && typeof(TDepth) == typeof(Byte)))
          {
-            TIFFInvoke.tiffWriteImage(_ptr, image);
+            WriteIplImage(image);
          }
          else if ((typeof(TColor) == typeof(Bgra) && typeof(TDepth) == typeof(Byte)))
          {
             //swap the B and R channel since geotiff assume RGBA for 4 channels image of depth Byte
             using (Image<Rgba, Byte> rgba = (image as Image<Bgra, Byte>).Convert<Rgba, Byte>())
             {
-               TIFFInvoke.tiffWriteImage(_ptr, rgba);
+               WriteIplImage(rgba);
             }
          }
          else if ((typeof(TColor) == typeof(Bgr) && typeof(TDepth) == typeof(Byte)))
@@ -85,7 +107,7 @@ namespace Emgu.CV.Tiff
             //swap the B and R channel since geotiff assume RGB for 3 channels image of depth Byte
             using (Image<Rgb, Byte> rgb = (image as Image<Bgr, Byte>).Convert<Rgb, Byte>())
             {
-               TIFFInvoke.tiffWriteImage(_ptr, rgb);
+               WriteIplImage(rgb);
             }
          }
          else
@@ -94,12 +116,22 @@ namespace Emgu.CV.Tiff
          }
       }
 
+      /// <summary>
+      /// Write the image data, the channels are already in the order expected by geotiff
+      /// </summary>
+      /// <param name="image">Pointer to the IplImage</param>
+      protected virtual void WriteIplImage(IntPtr image)
+      {
+         TIFFInvoke.tiffWriteImage(_ptr, image);
+      }
+
       /// <summary>
       /// Write the geo information into the tiff file
       /// </summary>
       /// <param name="modelTiepoint">Model Tie Point, an array of size 6</param>
       /// <param name="modelPixelScale">Model pixel scale, an array of size 3</param>
-      public void WriteGeoTag(double[] modelTiepoint, double[] modelPixelScale)
+      /// <param name="citation">If not null, it is written as the GTCitationGeoKey (1026)</param>
+      public void WriteGeoTag(double[] modelTiepoint, double[] modelPixelScale, String citation = null)
       {
          Debug.Assert(modelTiepoint.Length == 6, "Model Tiepoint should have length of 6");
          Debug.Assert(modelPixelScale.Length == 3, "Model Pixel Scale should have length of 3");
@@ -107,7 +139,7 @@ namespace Emgu.CV.Tiff
          GCHandle tiepointHandle = GCHandle.Alloc(modelTiepoint, GCHandleType.Pinned);
          GCHandle pixelScaleHandle = GCHandle.Alloc(modelPixelScale, GCHandleType.Pinned);
 
-         TIFFInvoke.tiffWriteGeoTag(_ptr, tiepointHandle.AddrOfPinnedObject(), pixelScaleHandle.AddrOfPinnedObject());
+         TIFFInvoke.tiffWriteGeoTag(_ptr, tiepointHandle.AddrOfPinnedObject(), pixelScaleHandle.AddrOfPinnedObject(), citation);
 
          tiepointHandle.Free();
          pixelScaleHandle.Free();
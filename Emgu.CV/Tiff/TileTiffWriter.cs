@@ -28,9 +28,38 @@ namespace Emgu.CV.Tiff
 
       [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
       public static extern void tiffWriteImageSize(IntPtr pTiff, ref Size imageSize);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      public static extern void tiffWriteCompression(IntPtr pTiff, TiffCompression compression, int compressionLevel);
+
+      [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+      public static extern void tiffWriteTiledImage(IntPtr pTiff, IntPtr image, int overviewLevels);
       #endregion
    }
 
+   /// <summary>
+   /// The compression scheme of the tiff tiles
+   /// </summary>
+   public enum TiffCompression
+   {
+      /// <summary>
+      /// No compression
+      /// </summary>
+      None = 1,
+      /// <summary>
+      /// LZW, the tiles are compressed in parallel
+      /// </summary>
+      Lzw = 5,
+      /// <summary>
+      /// Deflate (zip), the tiles are compressed in parallel
+      /// </summary>
+      Deflate = 8,
+      /// <summary>
+      /// ZSTD, the tiles are compressed in parallel. Only available if libtiff is built with ZSTD support.
+      /// </summary>
+      Zstd = 50000
+   }
+
    /// <summary>
    /// A writer for writing GeoTiff
    /// </summary>
@@ -48,12 +77,31 @@ namespace Emgu.CV.Tiff
       /// <param name="imageSize">The size of the image</param>
       /// <param name="tileSize">The tile size in pixels</param>
       public TileTiffWriter(String fileName, Size imageSize, Size tileSize)
-         : base(fileName)
+         : this(fileName, imageSize, tileSize, TiffCompression.None)
+      {
+      }
+
+      /// <summary>
+      /// Create a TitleTiffWriter that compresses the tiles.
+      /// </summary>
+      /// <param name="fileName">The name of the file to be written to</param>
+      /// <param name="imageSize">The size of the image</param>
+      /// <param name="tileSize">The tile size in pixels, the width and height must be multiples of 16</param>
+      /// <param name="compression">The compression scheme of the tiles</param>
+      /// <param name="compressionLevel">The compression level for Deflate (1-9) and ZSTD (1-22), -1 for the default level</param>
+      /// <param name="overviewLevels">The maximum number of reduced resolution images written after the full image, each half the size of the previous one</param>
+      /// <param name="bigTiff">If true, the file is written in BigTIFF format, which is required for files larger than 4GB</param>
+      public TileTiffWriter(String fileName, Size imageSize, Size tileSize, TiffCompression compression, int compressionLevel = -1, int overviewLevels = 0, bool bigTiff = false)
+         : base(fileName, bigTiff)
       {
+         _overviewLevels = overviewLevels;
          TIFFInvoke.tiffWriteImageSize(_ptr, ref imageSize);
          TIFFInvoke.tiffWriteTileInfo(_ptr, ref tileSize);
+         TIFFInvoke.tiffWriteCompression(_ptr, compression, compressionLevel);
       }
 
+      private int _overviewLevels;
+
       /// <summary>
       /// Write a tile into the tile tiff
       /// </summary>
@@ -100,32 +148,13 @@ namespace Emgu.CV.Tiff
       }
 
       /// <summary>
-      /// Write the whole image as tile tiff
+      /// Write the whole image as tile tiff, followed by the overviews. The tiles are prepared on all the cores and written in order.
+      /// If there are overviews, the geo tag must be written before the image.
       /// </summary>
-      /// <param name="image">The image to be written</param>
-      public override void WriteImage(Image<TColor, TDepth> image)
+      /// <param name="image">Pointer to the IplImage</param>
+      protected override void WriteIplImage(IntPtr image)
       {
-         Rectangle originalROI = image.ROI;
-         int sizeOfElement = Image<TColor, TDepth>.SizeOfElement;
-         int tileRowSizeInBytes = TileRowSizeInBytes;
-         Size tileSize = TileSize;
-         Size imageSize = originalROI.Equals(Rectangle.Empty) ? image.Size : originalROI.Size;
-
-         for (int row = 0; row < image.Height; row += tileSize.Height)
-         {
-            int rowsToCopy = tileSize.Height < (imageSize.Height - row) ? tileSize.Height : (imageSize.Height - row);
-
-            for (int col = 0; col < imageSize.Width; col += tileSize.Width)
-            {
-               int actualRowLength = ((col + tileSize.Width) <= imageSize.Width) ? tileRowSizeInBytes : (imageSize.Width % tileSize.Width) * sizeOfElement;
-
-               image.ROI = new Rectangle(originalROI.Y + col, originalROI.X + row, actualRowLength / sizeOfElement, rowsToCopy);
-
-               WriteTile(row, col, image);
-            }
-         }
-
-         image.ROI = originalROI;
+         TIFFInvoke.tiffWriteTiledImage(_ptr, image, _overviewLevels);
       }
    }
 }
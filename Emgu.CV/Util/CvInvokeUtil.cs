@@ -15,6 +15,9 @@ namespace Emgu.CV
         [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
         internal static extern IntPtr cveDataLoggerCreate(int logLevel, int loggerId);
 
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveDataLoggerCreateAsync(int logLevel, int loggerId, int capacity, int recordSize, Util.DataLogger.OverflowPolicy overflowPolicy, int batchSize);
+
         [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
         internal static extern void cveDataLoggerRelease(ref IntPtr logger);
 
@@ -23,12 +26,23 @@ namespace Emgu.CV
            IntPtr logger,
            Util.DataLoggerHelper.DataCallback messageCallback);
 
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDataLoggerRegisterBatchCallback(
+           IntPtr logger,
+           Util.DataLoggerHelper.DataBatchCallback batchCallback);
+
         [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
         internal static extern void cveDataLoggerLog(
            IntPtr logger,
            IntPtr data,
            int logLevel);
 
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDataLoggerFlush(IntPtr logger);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveDataLoggerGetStats(IntPtr logger, ref long enqueued, ref long dispatched, ref long dropped);
+
         [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
         internal static extern IntPtr cvGetImageSubRect(IntPtr imagePtr, ref Rectangle rect);
 
@@ -49,5 +63,46 @@ namespace Emgu.CV
 
         [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
         internal static extern void zlib_uncompress(IntPtr dataUncompressed, ref int sizeDataUncompressed, IntPtr compressedData, int sizeDataCompressed);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr zlib_deflate_create(int compressionLevel);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool zlib_deflate(
+            IntPtr stream,
+            IntPtr input,
+            int sizeInput,
+            IntPtr output,
+            int sizeOutput,
+            ref int inputConsumed,
+            ref int outputProduced,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool finish);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void zlib_deflate_release(ref IntPtr stream);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr zlib_inflate_create();
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool zlib_inflate(IntPtr stream, IntPtr input, int sizeInput, IntPtr output, int sizeOutput, ref int inputConsumed, ref int outputProduced);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void zlib_inflate_release(ref IntPtr stream);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern long zlib_parallel_compress_bound(long length, int blockSize);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void zlib_parallel_compress(IntPtr dataCompressed, ref long sizeDataCompressed, IntPtr dataOriginal, long sizeDataOriginal, int compressionLevel, int blockSize);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern long zlib_parallel_uncompressed_size(IntPtr compressedData, long sizeDataCompressed);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void zlib_parallel_uncompress(IntPtr dataUncompressed, ref long sizeDataUncompressed, IntPtr compressedData, long sizeDataCompressed);
     }
 }
\ No newline at end of file
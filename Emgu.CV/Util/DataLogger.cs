@@ -33,6 +33,51 @@ namespace Emgu.CV.Util
             DataLoggerHelper.OnDataReceived += this.HelperDataHandler;
         }
 
+        /// <summary>
+        /// Create an asynchronous DataLogger. The logged data is copied into a lock-free ring buffer and the callbacks are
+        /// raised in batches from a dispatcher thread, such that the logging thread never waits for the managed handlers.
+        /// </summary>
+        /// <param name="logLevel">The log level.</param>
+        /// <param name="capacity">The number of records the ring buffer can hold. It will be rounded up to a power of 2.</param>
+        /// <param name="recordSize">The size of a record in bytes. Log copies this many bytes from the data pointer; messages are truncated to recordSize - 1 characters.</param>
+        /// <param name="overflowPolicy">What to do when the ring buffer is full</param>
+        /// <param name="batchSize">The maximum number of records delivered per batch</param>
+        public DataLogger(int logLevel, int capacity, int recordSize, OverflowPolicy overflowPolicy = OverflowPolicy.DropNewest, int batchSize = 64)
+        {
+            lock (typeof(DataLoggerHelper))
+            {
+                _loggerId = DataLoggerHelper.TotalLoggerCount;
+                DataLoggerHelper.TotalLoggerCount++;
+            }
+
+            _ptr = CvInvoke.cveDataLoggerCreateAsync(logLevel, _loggerId, capacity, recordSize, overflowPolicy, batchSize);
+            CvInvoke.cveDataLoggerRegisterCallback(_ptr, DataLoggerHelper.Handler);
+            CvInvoke.cveDataLoggerRegisterBatchCallback(_ptr, DataLoggerHelper.BatchHandler);
+            DataLoggerHelper.OnDataReceived += this.HelperDataHandler;
+            DataLoggerHelper.OnBatchReceived += this.HelperBatchHandler;
+        }
+
+        /// <summary>
+        /// The policy of an asynchronous DataLogger when its ring buffer is full
+        /// </summary>
+        public enum OverflowPolicy
+        {
+            /// <summary>
+            /// Discard the incoming record
+            /// </summary>
+            DropNewest = 0,
+            /// <summary>
+            /// Discard the oldest queued record to make room for the incoming one
+            /// </summary>
+            OverwriteOldest = 1
+        }
+
+        /// <summary>
+        /// The event that will be raised, from the dispatcher thread, with a batch of records when the DataLogger is asynchronous.
+        /// If there is no handler registered to this event, OnDataReceived will be raised for every record of the batch instead.
+        /// </summary>
+        public event EventHandler<DataBatchEventArgs> OnBatchReceived;
+
         /// <summary>
         /// The event that will be raised when the unmanaged code send over data
         /// </summary>
@@ -46,6 +91,69 @@ namespace Emgu.CV.Util
             }
         }
 
+        private void HelperBatchHandler(IntPtr records, int count, int recordSize, int loggerId)
+        {
+            if (loggerId != _loggerId)
+                return;
+
+            if (OnBatchReceived != null)
+            {
+                OnBatchReceived(this, new DataBatchEventArgs(records, count, recordSize));
+            }
+            else if (OnDataReceived != null)
+            {
+                for (int i = 0; i < count; i++)
+                    OnDataReceived(this, new EventArgs<IntPtr>(new IntPtr(records.ToInt64() + (long)i * recordSize)));
+            }
+        }
+
+        /// <summary>
+        /// Block until all the records logged so far have been dispatched. No-op if the DataLogger is synchronous.
+        /// </summary>
+        public void Flush()
+        {
+            CvInvoke.cveDataLoggerFlush(_ptr);
+        }
+
+        /// <summary>
+        /// The number of records accepted by the ring buffer of an asynchronous DataLogger
+        /// </summary>
+        public long EnqueuedCount
+        {
+            get
+            {
+                long enqueued = 0, dispatched = 0, dropped = 0;
+                CvInvoke.cveDataLoggerGetStats(_ptr, ref enqueued, ref dispatched, ref dropped);
+                return enqueued;
+            }
+        }
+
+        /// <summary>
+        /// The number of records delivered to the callbacks by an asynchronous DataLogger
+        /// </summary>
+        public long DispatchedCount
+        {
+            get
+            {
+                long enqueued = 0, dispatched = 0, dropped = 0;
+                CvInvoke.cveDataLoggerGetStats(_ptr, ref enqueued, ref dispatched, ref dropped);
+                return dispatched;
+            }
+        }
+
+        /// <summary>
+        /// The number of records dropped or overwritten because the ring buffer of an asynchronous DataLogger was full
+        /// </summary>
+        public long DroppedCount
+        {
+            get
+            {
+                long enqueued = 0, dispatched = 0, dropped = 0;
+                CvInvoke.cveDataLoggerGetStats(_ptr, ref enqueued, ref dispatched, ref dropped);
+                return dropped;
+            }
+        }
+
         /// <summary>
         /// Log some data
         /// </summary>
@@ -64,7 +172,42 @@ namespace Emgu.CV.Util
             if (_ptr != IntPtr.Zero)
                 CvInvoke.cveDataLoggerRelease(ref _ptr);
             DataLoggerHelper.OnDataReceived -= this.HelperDataHandler;
+            DataLoggerHelper.OnBatchReceived -= this.HelperBatchHandler;
+        }
+    }
+
+    /// <summary>
+    /// A batch of fixed size records delivered by an asynchronous DataLogger
+    /// </summary>
+    public class DataBatchEventArgs : EventArgs
+    {
+        /// <summary>
+        /// Create the event args for a batch of records
+        /// </summary>
+        /// <param name="records">Pointer to the first record</param>
+        /// <param name="count">The number of records</param>
+        /// <param name="recordSize">The size of a record in bytes</param>
+        public DataBatchEventArgs(IntPtr records, int count, int recordSize)
+        {
+            Records = records;
+            Count = count;
+            RecordSize = recordSize;
         }
+
+        /// <summary>
+        /// Pointer to the first record. The records are stored consecutively and are only valid during the event.
+        /// </summary>
+        public IntPtr Records { get; private set; }
+
+        /// <summary>
+        /// The number of records
+        /// </summary>
+        public int Count { get; private set; }
+
+        /// <summary>
+        /// The size of a record in bytes
+        /// </summary>
+        public int RecordSize { get; private set; }
     }
 
     /// <summary>
@@ -189,6 +332,25 @@ namespace Emgu.CV.Util
                 OnDataReceived(data, loggerId);
         }
 
+        /// <summary>
+        /// The event that will be raised when the unmanaged code send over a batch of records
+        /// </summary>
+        public static event DataBatchCallback OnBatchReceived;
+
+        [UnmanagedFunctionPointer(CvInvoke.CvCallingConvention)]
+        public delegate void DataBatchCallback(IntPtr records, int count, int recordSize, int loggerId);
+
+        public static DataBatchCallback BatchHandler = DataBatchHandler;
+
+#if __IOS__
+      //[ObjCRuntime.MonoPInvokeCallback(typeof(DataLoggerHelper.DataBatchCallback))]
+#endif
+        public static void DataBatchHandler(IntPtr records, int count, int recordSize, int loggerId)
+        {
+            if (OnBatchReceived != null)
+                OnBatchReceived(records, count, recordSize, loggerId);
+        }
+
         public static volatile int TotalLoggerCount = 0;
     }
 }
@@ -0,0 +1,99 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.Util;
+
+namespace Emgu.CV.Util
+{
+    /// <summary>
+    /// A frame scoped owner of standard vectors. Vectors created with the VectorOfXXX(VectorArena, int) constructors are kept by the arena,
+    /// Reset clears them and recycles the vectors, together with their storage, for the next frame.
+    /// Once the arena has warmed up, creating the temporary vectors of a frame does not allocate any memory.
+    /// </summary>
+    /// <remarks>The arena is not thread safe. The vectors created from the arena must not be used after Reset is called.</remarks>
+    public class VectorArena : UnmanagedObject
+    {
+        /// <summary>
+        /// Create an empty arena
+        /// </summary>
+        public VectorArena()
+        {
+            _ptr = CvInvoke.cveVectorArenaCreate();
+        }
+
+        /// <summary>
+        /// Clear all the vectors created from this arena, they will be reused by the following creations.
+        /// </summary>
+        public void Reset()
+        {
+            CvInvoke.cveVectorArenaReset(_ptr);
+        }
+
+        /// <summary>
+        /// Free all the vectors created from this arena and their storage.
+        /// </summary>
+        public void Clear()
+        {
+            CvInvoke.cveVectorArenaClear(_ptr);
+        }
+
+        /// <summary>
+        /// The number of vectors created since the last reset
+        /// </summary>
+        public int InUseCount
+        {
+            get
+            {
+                int inUse = 0, retained = 0;
+                CvInvoke.cveVectorArenaGetStats(_ptr, ref inUse, ref retained);
+                return inUse;
+            }
+        }
+
+        /// <summary>
+        /// The number of vectors held by the arena, including those available for reuse
+        /// </summary>
+        public int RetainedCount
+        {
+            get
+            {
+                int inUse = 0, retained = 0;
+                CvInvoke.cveVectorArenaGetStats(_ptr, ref inUse, ref retained);
+                return retained;
+            }
+        }
+
+        /// <summary>
+        /// Release the arena and all the vectors created from it
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                CvInvoke.cveVectorArenaRelease(ref _ptr);
+        }
+    }
+}
+
+namespace Emgu.CV
+{
+    public static partial class CvInvoke
+    {
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveVectorArenaCreate();
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveVectorArenaReset(IntPtr arena);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveVectorArenaClear(IntPtr arena);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveVectorArenaGetStats(IntPtr arena, ref int inUse, ref int retained);
+
+        [DllImport(CvInvoke.ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveVectorArenaRelease(ref IntPtr arena);
+    }
+}
@@ -0,0 +1,157 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace Emgu.CV.Util
+{
+    /// <summary>
+    /// Use zlib included in OpenCV to compress large buffers on all cores. The data is split into blocks that are compressed independently,
+    /// the result contains a small index such that the blocks can also be decompressed in parallel.
+    /// </summary>
+    /// <remarks>The output is not compatible with the one-shot zlib format produced by the serialization of CvArray.</remarks>
+    public static class ZlibBlockCompression
+    {
+        /// <summary>
+        /// The default block size, 1MB
+        /// </summary>
+        public const int DefaultBlockSize = 1 << 20;
+
+        /// <summary>
+        /// Compress the unmanaged data
+        /// </summary>
+        /// <param name="data">Pointer to the data to be compressed</param>
+        /// <param name="length">The size of the data in bytes</param>
+        /// <param name="compressionLevel">The compression level, 0-9 where 0 mean no compression at all</param>
+        /// <param name="blockSize">The size of the blocks that will be compressed independently</param>
+        /// <returns>The compressed bytes</returns>
+        public static Byte[] Compress(IntPtr data, long length, int compressionLevel = 6, int blockSize = DefaultBlockSize)
+        {
+            long bound = CvInvoke.zlib_parallel_compress_bound(length, blockSize);
+            Byte[] result = new Byte[bound];
+            GCHandle resultHandle = GCHandle.Alloc(result, GCHandleType.Pinned);
+            long compressedSize = bound;
+            try
+            {
+                CvInvoke.zlib_parallel_compress(resultHandle.AddrOfPinnedObject(), ref compressedSize, data, length, compressionLevel, blockSize);
+            }
+            finally
+            {
+                resultHandle.Free();
+            }
+            Array.Resize(ref result, (int)compressedSize);
+            return result;
+        }
+
+        /// <summary>
+        /// Compress the data
+        /// </summary>
+        /// <param name="original">The data to be compressed</param>
+        /// <param name="compressionLevel">The compression level, 0-9 where 0 mean no compression at all</param>
+        /// <param name="blockSize">The size of the blocks that will be compressed independently</param>
+        /// <returns>The compressed bytes</returns>
+        public static Byte[] Compress(Byte[] original, int compressionLevel = 6, int blockSize = DefaultBlockSize)
+        {
+            GCHandle originalHandle = GCHandle.Alloc(original, GCHandleType.Pinned);
+            try
+            {
+                return Compress(originalHandle.AddrOfPinnedObject(), original.Length, compressionLevel, blockSize);
+            }
+            finally
+            {
+                originalHandle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Compress the pixels of a continuous Mat, without copying them to managed memory
+        /// </summary>
+        /// <param name="mat">The Mat, must be continuous</param>
+        /// <param name="compressionLevel">The compression level, 0-9 where 0 mean no compression at all</param>
+        /// <param name="blockSize">The size of the blocks that will be compressed independently</param>
+        /// <returns>The compressed bytes</returns>
+        public static Byte[] Compress(Mat mat, int compressionLevel = 6, int blockSize = DefaultBlockSize)
+        {
+            if (!mat.IsContinuous)
+                throw new ArgumentException("Only continuous Mat can be compressed");
+            return Compress(mat.DataPointer, mat.Total.ToInt64() * mat.ElementSize, compressionLevel, blockSize);
+        }
+
+        /// <summary>
+        /// Get the size of the original data from the block compressed data
+        /// </summary>
+        /// <param name="compressedData">The block compressed data</param>
+        /// <returns>The size of the original data in bytes</returns>
+        public static long GetUncompressedSize(Byte[] compressedData)
+        {
+            GCHandle compressedHandle = GCHandle.Alloc(compressedData, GCHandleType.Pinned);
+            try
+            {
+                return CvInvoke.zlib_parallel_uncompressed_size(compressedHandle.AddrOfPinnedObject(), compressedData.Length);
+            }
+            finally
+            {
+                compressedHandle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Decompress the data into an unmanaged buffer
+        /// </summary>
+        /// <param name="compressedData">The block compressed data</param>
+        /// <param name="dest">The destination buffer</param>
+        /// <param name="destSize">The size of the destination buffer, must be at least GetUncompressedSize(compressedData)</param>
+        /// <returns>The number of bytes written to the destination</returns>
+        public static long Uncompress(Byte[] compressedData, IntPtr dest, long destSize)
+        {
+            GCHandle compressedHandle = GCHandle.Alloc(compressedData, GCHandleType.Pinned);
+            try
+            {
+                long size = destSize;
+                CvInvoke.zlib_parallel_uncompress(dest, ref size, compressedHandle.AddrOfPinnedObject(), compressedData.Length);
+                return size;
+            }
+            finally
+            {
+                compressedHandle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Decompress the data
+        /// </summary>
+        /// <param name="compressedData">The block compressed data</param>
+        /// <returns>The decompressed data</returns>
+        public static Byte[] Uncompress(Byte[] compressedData)
+        {
+            Byte[] result = new Byte[GetUncompressedSize(compressedData)];
+            GCHandle resultHandle = GCHandle.Alloc(result, GCHandleType.Pinned);
+            try
+            {
+                Uncompress(compressedData, resultHandle.AddrOfPinnedObject(), result.Length);
+            }
+            finally
+            {
+                resultHandle.Free();
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Decompress the data straight into the pixels of a continuous Mat, which must have been created with the original size and type.
+        /// </summary>
+        /// <param name="compressedData">The block compressed data</param>
+        /// <param name="mat">The destination Mat</param>
+        public static void Uncompress(Byte[] compressedData, Mat mat)
+        {
+            if (!mat.IsContinuous)
+                throw new ArgumentException("Only continuous Mat can be used as destination");
+            long size = mat.Total.ToInt64() * mat.ElementSize;
+            if (GetUncompressedSize(compressedData) != size)
+                throw new ArgumentException("The size of the Mat does not match the size of the compressed data");
+            Uncompress(compressedData, mat.DataPointer, size);
+        }
+    }
+}
@@ -0,0 +1,286 @@
+﻿//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.IO;
+using System.IO.Compression;
+using System.Runtime.InteropServices;
+
+namespace Emgu.CV.Util
+{
+    /// <summary>
+    /// A stream that uses zlib included in OpenCV to compress the data written to it, or decompress the data read from it, chunk by chunk.
+    /// Only one chunk of compressed data is held in memory at any time.
+    /// </summary>
+    public class ZlibStream : Stream
+    {
+        private Stream _baseStream;
+        private CompressionMode _mode;
+        private bool _leaveOpen;
+        private IntPtr _zstream;
+        private Byte[] _buffer;
+        private int _bufferOffset;
+        private int _bufferCount;
+        private bool _streamEnd;
+
+        /// <summary>
+        /// Create a zlib stream
+        /// </summary>
+        /// <param name="baseStream">The stream the compressed data is written to or read from</param>
+        /// <param name="mode">Compress or decompress</param>
+        /// <param name="compressionLevel">The compression level, 0-9 where 0 mean no compression at all. Only used for compression.</param>
+        /// <param name="chunkSize">The size of the internal buffer of compressed data</param>
+        /// <param name="leaveOpen">If true, the base stream will not be closed when this stream is disposed</param>
+        public ZlibStream(Stream baseStream, CompressionMode mode, int compressionLevel = 6, int chunkSize = 64 * 1024, bool leaveOpen = false)
+        {
+            _baseStream = baseStream;
+            _mode = mode;
+            _leaveOpen = leaveOpen;
+            _buffer = new Byte[chunkSize];
+            _zstream = mode == CompressionMode.Compress ? CvInvoke.zlib_deflate_create(compressionLevel) : CvInvoke.zlib_inflate_create();
+        }
+
+        /// <summary>
+        /// Write the unmanaged data to the stream, without copying it to managed memory first
+        /// </summary>
+        /// <param name="data">Pointer to the data</param>
+        /// <param name="count">The number of bytes to write</param>
+        public void Write(IntPtr data, long count)
+        {
+            if (_mode != CompressionMode.Compress)
+                throw new NotSupportedException("The stream is opened for decompression");
+            GCHandle bufferHandle = GCHandle.Alloc(_buffer, GCHandleType.Pinned);
+            try
+            {
+                long offset = 0;
+                while (offset < count)
+                {
+                    int chunk = (int)Math.Min(count - offset, int.MaxValue);
+                    int consumed = 0, produced = 0;
+                    CvInvoke.zlib_deflate(_zstream, new IntPtr(data.ToInt64() + offset), chunk, bufferHandle.AddrOfPinnedObject(), _buffer.Length, ref consumed, ref produced, false);
+                    _baseStream.Write(_buffer, 0, produced);
+                    offset += consumed;
+                }
+            }
+            finally
+            {
+                bufferHandle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Write the pixels of the Mat to the stream, row by row.
+        /// </summary>
+        /// <param name="mat">The Mat</param>
+        public void Write(Mat mat)
+        {
+            if (mat.IsContinuous)
+            {
+                Write(mat.DataPointer, mat.Total.ToInt64() * mat.ElementSize);
+            }
+            else
+            {
+                int rowSize = mat.Cols * mat.ElementSize;
+                for (int i = 0; i < mat.Rows; i++)
+                    Write(new IntPtr(mat.DataPointer.ToInt64() + (long)i * mat.Step), rowSize);
+            }
+        }
+
+        /// <summary>
+        /// Compress the data and write it to the underlying stream
+        /// </summary>
+        public override void Write(byte[] buffer, int offset, int count)
+        {
+            GCHandle handle = GCHandle.Alloc(buffer, GCHandleType.Pinned);
+            try
+            {
+                Write(new IntPtr(handle.AddrOfPinnedObject().ToInt64() + offset), count);
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Read and decompress the data into an unmanaged buffer
+        /// </summary>
+        /// <param name="data">The destination</param>
+        /// <param name="count">The maximum number of bytes to read</param>
+        /// <returns>The number of bytes read, 0 if the end of the compressed stream has been reached</returns>
+        public long Read(IntPtr data, long count)
+        {
+            if (_mode != CompressionMode.Decompress)
+                throw new NotSupportedException("The stream is opened for compression");
+
+            GCHandle bufferHandle = GCHandle.Alloc(_buffer, GCHandleType.Pinned);
+            try
+            {
+                long total = 0;
+                while (total < count && !_streamEnd)
+                {
+                    if (_bufferCount == 0)
+                    {
+                        _bufferOffset = 0;
+                        _bufferCount = _baseStream.Read(_buffer, 0, _buffer.Length);
+                        if (_bufferCount == 0)
+                            throw new EndOfStreamException("The compressed stream ended unexpectedly");
+                    }
+                    int consumed = 0, produced = 0;
+                    _streamEnd = CvInvoke.zlib_inflate(
+                        _zstream,
+                        new IntPtr(bufferHandle.AddrOfPinnedObject().ToInt64() + _bufferOffset),
+                        _bufferCount,
+                        new IntPtr(data.ToInt64() + total),
+                        (int)Math.Min(count - total, int.MaxValue),
+                        ref consumed,
+                        ref produced);
+                    _bufferOffset += consumed;
+                    _bufferCount -= consumed;
+                    total += produced;
+                }
+                return total;
+            }
+            finally
+            {
+                bufferHandle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Read and decompress the pixels of the Mat, which must have been created with the size and type of the one that has been written.
+        /// </summary>
+        /// <param name="mat">The destination Mat</param>
+        public void Read(Mat mat)
+        {
+            int rowSize = mat.Cols * mat.ElementSize;
+            long size = mat.IsContinuous ? mat.Total.ToInt64() * mat.ElementSize : rowSize;
+            int rows = mat.IsContinuous ? 1 : mat.Rows;
+            for (int i = 0; i < rows; i++)
+            {
+                if (Read(new IntPtr(mat.DataPointer.ToInt64() + (long)i * mat.Step), size) != size)
+                    throw new EndOfStreamException("Not enough compressed data to fill the Mat");
+            }
+        }
+
+        /// <summary>
+        /// Read and decompress data from the underlying stream
+        /// </summary>
+        public override int Read(byte[] buffer, int offset, int count)
+        {
+            GCHandle handle = GCHandle.Alloc(buffer, GCHandleType.Pinned);
+            try
+            {
+                return (int)Read(new IntPtr(handle.AddrOfPinnedObject().ToInt64() + offset), count);
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Finish the compressed stream. No more data can be written after this call. It is called automatically when the stream is disposed.
+        /// </summary>
+        public void Finish()
+        {
+            if (_mode != CompressionMode.Compress || _streamEnd)
+                return;
+            GCHandle bufferHandle = GCHandle.Alloc(_buffer, GCHandleType.Pinned);
+            try
+            {
+                while (!_streamEnd)
+                {
+                    int consumed = 0, produced = 0;
+                    _streamEnd = CvInvoke.zlib_deflate(_zstream, IntPtr.Zero, 0, bufferHandle.AddrOfPinnedObject(), _buffer.Length, ref consumed, ref produced, true);
+                    _baseStream.Write(_buffer, 0, produced);
+                }
+            }
+            finally
+            {
+                bufferHandle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Flush the underlying stream
+        /// </summary>
+        public override void Flush()
+        {
+            _baseStream.Flush();
+        }
+
+        /// <summary>
+        /// True if the stream is opened for decompression
+        /// </summary>
+        public override bool CanRead { get { return _mode == CompressionMode.Decompress; } }
+
+        /// <summary>
+        /// Always false
+        /// </summary>
+        public override bool CanSeek { get { return false; } }
+
+        /// <summary>
+        /// True if the stream is opened for compression
+        /// </summary>
+        public override bool CanWrite { get { return _mode == CompressionMode.Compress; } }
+
+        /// <summary>
+        /// Not supported
+        /// </summary>
+        public override long Length { get { throw new NotSupportedException(); } }
+
+        /// <summary>
+        /// Not supported
+        /// </summary>
+        public override long Position
+        {
+            get { throw new NotSupportedException(); }
+            set { throw new NotSupportedException(); }
+        }
+
+        /// <summary>
+        /// Not supported
+        /// </summary>
+        public override long Seek(long offset, SeekOrigin origin)
+        {
+            throw new NotSupportedException();
+        }
+
+        /// <summary>
+        /// Not supported
+        /// </summary>
+        public override void SetLength(long value)
+        {
+            throw new NotSupportedException();
+        }
+
+        /// <summary>
+        /// Finish the compressed stream and release the unmanaged zlib stream
+        /// </summary>
+        protected override void Dispose(bool disposing)
+        {
+            try
+            {
+                if (disposing && _zstream != IntPtr.Zero)
+                {
+                    Finish();
+                    if (!_leaveOpen)
+                        _baseStream.Dispose();
+                }
+            }
+            finally
+            {
+                if (_zstream != IntPtr.Zero)
+                {
+                    if (_mode == CompressionMode.Compress)
+                        CvInvoke.zlib_deflate_release(ref _zstream);
+                    else
+                        CvInvoke.zlib_inflate_release(ref _zstream);
+                }
+                base.Dispose(disposing);
+            }
+        }
+    }
+}
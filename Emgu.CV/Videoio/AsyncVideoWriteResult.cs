@@ -0,0 +1,27 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+
+namespace Emgu.CV
+{
+    /// <summary>
+    /// The result of queuing a frame in an AsyncVideoWriter, the same values as emgu::AsyncVideoWriter::WriteResult
+    /// </summary>
+    public enum AsyncVideoWriteResult
+    {
+        /// <summary>
+        /// The queue stayed full for maxBlockMs, the frame has not been taken
+        /// </summary>
+        Dropped = 0,
+        /// <summary>
+        /// The frame has been queued
+        /// </summary>
+        Queued = 1,
+        /// <summary>
+        /// The frame has been queued and the queue depth reached the high water mark
+        /// </summary>
+        HighWater = 2
+    }
+}
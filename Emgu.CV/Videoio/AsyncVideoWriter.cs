@@ -0,0 +1,156 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.Util;
+
+namespace Emgu.CV
+{
+    /// <summary>
+    /// Encode the frames of a VideoWriter on a dedicated native thread, such that the producer does not wait for the encoder.
+    /// Frames are moved into a bounded queue of pooled Mats, they are not copied.
+    /// </summary>
+    /// <remarks>The VideoWriter must not be used directly while it is attached to an AsyncVideoWriter.</remarks>
+    public class AsyncVideoWriter : UnmanagedObject
+    {
+        private VideoWriter _writer;
+
+        /// <summary>
+        /// Start the encoder thread
+        /// </summary>
+        /// <param name="writer">The writer to encode the frames with. It must not be disposed before this object.</param>
+        /// <param name="capacity">The maximum number of frames waiting to be encoded</param>
+        /// <param name="maxBlockMs">The maximum time Write waits for room in the queue in milliseconds, after that the frame is dropped. Use a negative value to wait as long as needed such that no frame is dropped.</param>
+        /// <param name="highWaterMark">The queue depth that raises the QueueHighWater event. Use 0 to disable the event.</param>
+        public AsyncVideoWriter(VideoWriter writer, int capacity = 8, int maxBlockMs = -1, int highWaterMark = 0)
+        {
+            _writer = writer;
+            _ptr = CvInvoke.cveAsyncVideoWriterCreate(writer, capacity, maxBlockMs, highWaterMark);
+        }
+
+        /// <summary>
+        /// Raised on the producer thread by Write when the queue depth reaches the high water mark
+        /// </summary>
+        public event EventHandler QueueHighWater;
+
+        /// <summary>
+        /// Queue a frame for encoding. The frame is moved into the queue, not copied: if the frame has been queued,
+        /// <paramref name="frame"/> receives a recycled buffer of undefined content (or becomes empty) that can be filled with the next frame.
+        /// </summary>
+        /// <param name="frame">The frame to be encoded</param>
+        /// <returns>True if the frame has been queued, false if it has been dropped because the queue stayed full for longer than maxBlockMs</returns>
+        /// <remarks>If a previous frame failed to encode, the error is raised as an exception.</remarks>
+        public bool Write(Mat frame)
+        {
+            AsyncVideoWriteResult result = CvInvoke.cveAsyncVideoWriterWrite(_ptr, frame);
+            if (result == AsyncVideoWriteResult.HighWater && QueueHighWater != null)
+                QueueHighWater(this, EventArgs.Empty);
+            return result != AsyncVideoWriteResult.Dropped;
+        }
+
+        /// <summary>
+        /// Block until all the queued frames have been encoded. If a frame failed to encode, the error is raised as an exception.
+        /// </summary>
+        public void Flush()
+        {
+            CvInvoke.cveAsyncVideoWriterFlush(_ptr);
+        }
+
+        /// <summary>
+        /// Encode all the queued frames and stop the encoder thread. If a frame failed to encode, the error is raised as an exception.
+        /// </summary>
+        public void Close()
+        {
+            CvInvoke.cveAsyncVideoWriterClose(_ptr);
+        }
+
+        /// <summary>
+        /// The number of frames waiting to be encoded
+        /// </summary>
+        public int QueueDepth
+        {
+            get
+            {
+                int queueDepth = 0, maxQueueDepth = 0;
+                long written = 0, dropped = 0;
+                CvInvoke.cveAsyncVideoWriterGetStats(_ptr, ref queueDepth, ref maxQueueDepth, ref written, ref dropped);
+                return queueDepth;
+            }
+        }
+
+        /// <summary>
+        /// The maximum number of frames that have been waiting to be encoded at the same time
+        /// </summary>
+        public int MaxQueueDepth
+        {
+            get
+            {
+                int queueDepth = 0, maxQueueDepth = 0;
+                long written = 0, dropped = 0;
+                CvInvoke.cveAsyncVideoWriterGetStats(_ptr, ref queueDepth, ref maxQueueDepth, ref written, ref dropped);
+                return maxQueueDepth;
+            }
+        }
+
+        /// <summary>
+        /// The number of frames encoded so far
+        /// </summary>
+        public long WrittenCount
+        {
+            get
+            {
+                int queueDepth = 0, maxQueueDepth = 0;
+                long written = 0, dropped = 0;
+                CvInvoke.cveAsyncVideoWriterGetStats(_ptr, ref queueDepth, ref maxQueueDepth, ref written, ref dropped);
+                return written;
+            }
+        }
+
+        /// <summary>
+        /// The number of frames dropped, either because the queue was full or because of an encoding error
+        /// </summary>
+        public long DroppedCount
+        {
+            get
+            {
+                int queueDepth = 0, maxQueueDepth = 0;
+                long written = 0, dropped = 0;
+                CvInvoke.cveAsyncVideoWriterGetStats(_ptr, ref queueDepth, ref maxQueueDepth, ref written, ref dropped);
+                return dropped;
+            }
+        }
+
+        /// <summary>
+        /// Encode the queued frames, stop the encoder thread and release the frame pool
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                CvInvoke.cveAsyncVideoWriterRelease(ref _ptr);
+            _writer = null;
+        }
+    }
+
+    partial class CvInvoke
+    {
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveAsyncVideoWriterCreate(IntPtr writer, int capacity, int maxBlockMs, int highWaterMark);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveAsyncVideoWriterRelease(ref IntPtr writer);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern AsyncVideoWriteResult cveAsyncVideoWriterWrite(IntPtr writer, IntPtr frame);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveAsyncVideoWriterFlush(IntPtr writer);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveAsyncVideoWriterClose(IntPtr writer);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveAsyncVideoWriterGetStats(IntPtr writer, ref int queueDepth, ref int maxQueueDepth, ref long written, ref long dropped);
+    }
+}
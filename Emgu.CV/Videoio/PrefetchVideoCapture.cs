@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.Util;
+
+namespace Emgu.CV
+{
+    /// <summary>
+    /// Decode the frames of a VideoCapture on a dedicated native thread into a bounded queue of pooled Mats,
+    /// such that decoding overlaps with the processing of the previous frames.
+    /// </summary>
+    /// <remarks>The VideoCapture must not be used directly while it is attached to a PrefetchVideoCapture.</remarks>
+    public class PrefetchVideoCapture : UnmanagedObject
+    {
+        private VideoCapture _capture;
+
+        /// <summary>
+        /// Start decoding the frames of the capture in the background
+        /// </summary>
+        /// <param name="capture">The capture to read frames from. It must not be disposed before this object.</param>
+        /// <param name="capacity">The maximum number of decoded frames waiting to be read. When the queue is full the decoder waits, no frame is lost.</param>
+        /// <param name="latestFrameOnly">If true, only the most recent frame is kept and it is replaced by every newly decoded frame. Use this for live streams where a frame that is late is worthless. <paramref name="capacity"/> is ignored in this mode.</param>
+        public PrefetchVideoCapture(VideoCapture capture, int capacity = 4, bool latestFrameOnly = false)
+        {
+            _capture = capture;
+            _ptr = CvInvoke.cvePrefetchVideoCaptureCreate(capture, capacity, latestFrameOnly);
+        }
+
+        /// <summary>
+        /// Read the oldest decoded frame.
+        /// </summary>
+        /// <param name="frame">The Mat to be written to. Its buffer is swapped with the decoded frame and recycled for decoding, the data is not copied.</param>
+        /// <param name="timeoutMs">The maximum time to wait for a frame in milliseconds. Use a negative value to wait until a frame is available or the stream ends.</param>
+        /// <returns>True if a frame has been read, false if the timeout expired or the end of the stream has been reached. Use <see cref="IsEndOfStream"/> to tell the two apart.</returns>
+        public bool Read(Mat frame, int timeoutMs = -1)
+        {
+            return CvInvoke.cvePrefetchVideoCaptureRead(_ptr, frame, timeoutMs);
+        }
+
+        /// <summary>
+        /// Read the oldest decoded frame without waiting.
+        /// </summary>
+        /// <param name="frame">The Mat to be written to</param>
+        /// <returns>True if a frame was available</returns>
+        public bool TryRead(Mat frame)
+        {
+            return Read(frame, 0);
+        }
+
+        /// <summary>
+        /// True if the decoder has stopped and all the decoded frames have been read
+        /// </summary>
+        public bool IsEndOfStream
+        {
+            get { return CvInvoke.cvePrefetchVideoCaptureIsEndOfStream(_ptr); }
+        }
+
+        /// <summary>
+        /// The number of decoded frames waiting to be read
+        /// </summary>
+        public int QueueDepth
+        {
+            get
+            {
+                int queueDepth = 0;
+                long decoded = 0, delivered = 0, dropped = 0;
+                CvInvoke.cvePrefetchVideoCaptureGetStats(_ptr, ref queueDepth, ref decoded, ref delivered, ref dropped);
+                return queueDepth;
+            }
+        }
+
+        /// <summary>
+        /// The number of frames decoded so far
+        /// </summary>
+        public long DecodedCount
+        {
+            get
+            {
+                int queueDepth = 0;
+                long decoded = 0, delivered = 0, dropped = 0;
+                CvInvoke.cvePrefetchVideoCaptureGetStats(_ptr, ref queueDepth, ref decoded, ref delivered, ref dropped);
+                return decoded;
+            }
+        }
+
+        /// <summary>
+        /// The number of frames returned by Read
+        /// </summary>
+        public long DeliveredCount
+        {
+            get
+            {
+                int queueDepth = 0;
+                long decoded = 0, delivered = 0, dropped = 0;
+                CvInvoke.cvePrefetchVideoCaptureGetStats(_ptr, ref queueDepth, ref decoded, ref delivered, ref dropped);
+                return delivered;
+            }
+        }
+
+        /// <summary>
+        /// The number of frames replaced by a newer frame before they have been read, only non zero in latest frame only mode
+        /// </summary>
+        public long DroppedCount
+        {
+            get
+            {
+                int queueDepth = 0;
+                long decoded = 0, delivered = 0, dropped = 0;
+                CvInvoke.cvePrefetchVideoCaptureGetStats(_ptr, ref queueDepth, ref decoded, ref delivered, ref dropped);
+                return dropped;
+            }
+        }
+
+        /// <summary>
+        /// Stop the decoder thread. The frames that have already been decoded can still be read.
+        /// </summary>
+        public void Stop()
+        {
+            CvInvoke.cvePrefetchVideoCaptureStop(_ptr);
+        }
+
+        /// <summary>
+        /// Stop the decoder thread and release the queued frames
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                CvInvoke.cvePrefetchVideoCaptureRelease(ref _ptr);
+            _capture = null;
+        }
+    }
+
+    partial class CvInvoke
+    {
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cvePrefetchVideoCaptureCreate(
+            IntPtr capture,
+            int capacity,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool latestOnly);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cvePrefetchVideoCaptureRelease(ref IntPtr prefetch);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cvePrefetchVideoCaptureRead(IntPtr prefetch, IntPtr frame, int timeoutMs);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cvePrefetchVideoCaptureIsEndOfStream(IntPtr prefetch);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cvePrefetchVideoCaptureGetStats(IntPtr prefetch, ref int queueDepth, ref long decoded, ref long delivered, ref long dropped);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cvePrefetchVideoCaptureStop(IntPtr prefetch);
+    }
+}
@@ -0,0 +1,155 @@
+//----------------------------------------------------------------------------
+//  Copyright (C) 2004-2024 by EMGU Corporation. All rights reserved.
+//----------------------------------------------------------------------------
+
+using System;
+using System.Runtime.InteropServices;
+using Emgu.CV.Util;
+using Emgu.Util;
+
+namespace Emgu.CV
+{
+    /// <summary>
+    /// Read the frames of many VideoCaptures through a single queue without one thread per stream.
+    /// If all the captures use the V4L backend the streams are grabbed with VideoCapture.WaitAny from a single thread,
+    /// otherwise a pool of worker threads decodes the streams in round robin order.
+    /// </summary>
+    /// <remarks>The multiplexer shares the backends of the captures, they must not be read directly while the multiplexer is running. The VideoCapture objects can be disposed.</remarks>
+    public class VideoCaptureMultiplexer : UnmanagedObject
+    {
+        /// <summary>
+        /// Start decoding the captures in the background
+        /// </summary>
+        /// <param name="captures">The captures to read frames from</param>
+        /// <param name="perStreamCapacity">The maximum number of decoded frames waiting to be read for each stream</param>
+        /// <param name="dropWhenFull">If true, a stream whose queue is full replaces its oldest frame, use this for live streams. If false, the stream is not decoded again until a frame has been read from its queue.</param>
+        /// <param name="workerCount">The number of decoding threads if WaitAny is not supported by the backend. Use 0 for one thread per CPU core, up to the number of streams.</param>
+        public VideoCaptureMultiplexer(VideoCapture[] captures, int perStreamCapacity = 2, bool dropWhenFull = false, int workerCount = 0)
+        {
+            using (VectorOfVideoCapture vc = new VectorOfVideoCapture(captures))
+                _ptr = CvInvoke.cveVideoCaptureMultiplexerCreate(vc, perStreamCapacity, dropWhenFull, workerCount);
+        }
+
+        /// <summary>
+        /// Read the next frame. The streams with queued frames are visited in round robin order, such that a fast stream can not starve the others.
+        /// </summary>
+        /// <param name="streamIndex">The index of the capture the frame comes from</param>
+        /// <param name="timestamp">The position of the frame in the stream in milliseconds, as reported by the backend</param>
+        /// <param name="frame">The Mat to be written to. Its buffer is swapped with the decoded frame and recycled for decoding, the data is not copied.</param>
+        /// <param name="timeoutMs">The maximum time to wait for a frame in milliseconds. Use a negative value to wait until a frame is available or all the streams have ended.</param>
+        /// <returns>True if a frame has been read, false if the timeout expired or all the streams have ended.</returns>
+        public bool Read(out int streamIndex, out double timestamp, Mat frame, int timeoutMs = -1)
+        {
+            streamIndex = -1;
+            timestamp = 0;
+            return CvInvoke.cveVideoCaptureMultiplexerRead(_ptr, ref streamIndex, ref timestamp, frame, timeoutMs);
+        }
+
+        /// <summary>
+        /// The number of streams
+        /// </summary>
+        public int StreamCount
+        {
+            get { return CvInvoke.cveVideoCaptureMultiplexerGetStreamCount(_ptr); }
+        }
+
+        /// <summary>
+        /// True if the streams are grabbed with VideoCapture.WaitAny, false if they are decoded by a pool of worker threads
+        /// </summary>
+        public bool UsesWaitAny
+        {
+            get { return CvInvoke.cveVideoCaptureMultiplexerUsesWaitAny(_ptr); }
+        }
+
+        /// <summary>
+        /// True if all the streams have ended and all the decoded frames have been read
+        /// </summary>
+        public bool IsEndOfStream
+        {
+            get { return CvInvoke.cveVideoCaptureMultiplexerIsEndOfStream(_ptr); }
+        }
+
+        /// <summary>
+        /// Check if a stream has ended or failed. A stream that failed to open is ended from the start.
+        /// </summary>
+        /// <param name="streamIndex">The index of the stream</param>
+        /// <returns>True if no more frames will be decoded from the stream</returns>
+        public bool IsStreamFinished(int streamIndex)
+        {
+            return CvInvoke.cveVideoCaptureMultiplexerIsStreamFinished(_ptr, streamIndex);
+        }
+
+        /// <summary>
+        /// Get the statistics of a stream
+        /// </summary>
+        /// <param name="streamIndex">The index of the stream</param>
+        /// <param name="queueDepth">The number of decoded frames waiting to be read</param>
+        /// <param name="decoded">The number of frames decoded so far</param>
+        /// <param name="delivered">The number of frames returned by Read</param>
+        /// <param name="dropped">The number of frames replaced by a newer frame before they have been read</param>
+        public void GetStats(int streamIndex, out int queueDepth, out long decoded, out long delivered, out long dropped)
+        {
+            queueDepth = 0;
+            decoded = 0;
+            delivered = 0;
+            dropped = 0;
+            CvInvoke.cveVideoCaptureMultiplexerGetStats(_ptr, streamIndex, ref queueDepth, ref decoded, ref delivered, ref dropped);
+        }
+
+        /// <summary>
+        /// Stop the decoding threads. The frames that have already been decoded can still be read.
+        /// </summary>
+        public void Stop()
+        {
+            CvInvoke.cveVideoCaptureMultiplexerStop(_ptr);
+        }
+
+        /// <summary>
+        /// Stop the decoding threads and release the captures and the queued frames
+        /// </summary>
+        protected override void DisposeObject()
+        {
+            if (_ptr != IntPtr.Zero)
+                CvInvoke.cveVideoCaptureMultiplexerRelease(ref _ptr);
+        }
+    }
+
+    partial class CvInvoke
+    {
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern IntPtr cveVideoCaptureMultiplexerCreate(
+            IntPtr captures,
+            int perStreamCapacity,
+            [MarshalAs(CvInvoke.BoolMarshalType)]
+            bool dropWhenFull,
+            int workerCount);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveVideoCaptureMultiplexerRelease(ref IntPtr multiplexer);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cveVideoCaptureMultiplexerRead(IntPtr multiplexer, ref int streamIndex, ref double timestamp, IntPtr frame, int timeoutMs);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern int cveVideoCaptureMultiplexerGetStreamCount(IntPtr multiplexer);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cveVideoCaptureMultiplexerUsesWaitAny(IntPtr multiplexer);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cveVideoCaptureMultiplexerIsStreamFinished(IntPtr multiplexer, int streamIndex);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        [return: MarshalAs(CvInvoke.BoolMarshalType)]
+        internal static extern bool cveVideoCaptureMultiplexerIsEndOfStream(IntPtr multiplexer);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveVideoCaptureMultiplexerGetStats(IntPtr multiplexer, int streamIndex, ref int queueDepth, ref long decoded, ref long delivered, ref long dropped);
+
+        [DllImport(ExternLibrary, CallingConvention = CvInvoke.CvCallingConvention)]
+        internal static extern void cveVideoCaptureMultiplexerStop(IntPtr multiplexer);
+    }
+}
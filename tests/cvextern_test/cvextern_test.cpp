@@ -2,6 +2,7 @@
 #include "doubleOps.h"
 #include "stdio.h"
 #include <iostream>
+#include <vector>
 #include "quaternions.h"
 #include "opencv2/opencv_modules.hpp"
 
@@ -101,6 +102,135 @@ void Test_double_MulS()
 	cout << "Test mulS: " << (success ? "Passed" : "Failed") << std::endl;
 }
 
+#define DOUBLE_OPS_CHECK(expr, name) { bool ok = (expr); if (!ok) cout << name << " failed" << std::endl; success &= ok; }
+#define fnear(a, b) (fabs((a) - (b)) <= 1.0e-9 * (fabs(a) + fabs(b) + 1.0))
+
+template<typename WeightedSum, typename MulS, typename Add, typename Axpy, typename Dot, typename SumSq, typename MinMaxIdx>
+bool Test_doubleOps_impl(const char* name, WeightedSum weightedSum, MulS mulS, Add add, Axpy axpy, Dot dot, SumSq sumSq, MinMaxIdx minMaxIdx)
+{
+	bool success = true;
+	//odd lengths to cover the remainder loops
+	int lengths[] = { 0, 1, 3, 7, 17, 33, 1001 };
+	for (int l = 0; l < (int)(sizeof(lengths) / sizeof(int)); l++)
+	{
+		int n = lengths[l];
+		std::vector<double> a(n + 1), b(n + 1), r(n + 1), expected(n + 1);
+		for (int i = 0; i < n; i++)
+		{
+			a[i] = (rand() % 2001 - 1000) * 0.01;
+			b[i] = (rand() % 2001 - 1000) * 0.01;
+		}
+		if (n > 10)
+		{
+			//repeated extreme values, the first one is expected
+			a[n / 3] = a[n - 2] = 1.0e6;
+			a[n / 2] = a[n - 1] = -1.0e6;
+		}
+
+		doubleOps::scalar::weightedSum(&a[0], &b[0], n, 0.3, 0.7, &expected[0]);
+		weightedSum(&a[0], &b[0], n, 0.3, 0.7, &r[0]);
+		for (int i = 0; i < n; i++) DOUBLE_OPS_CHECK(fnear(r[i], expected[i]), "weightedSum");
+
+		doubleOps::scalar::mulS(&a[0], 0.12345, n, &expected[0]);
+		mulS(&a[0], 0.12345, n, &r[0]);
+		for (int i = 0; i < n; i++) DOUBLE_OPS_CHECK(fnear(r[i], expected[i]), "mulS");
+
+		doubleOps::scalar::add(&a[0], &b[0], n, &expected[0]);
+		add(&a[0], &b[0], n, &r[0]);
+		for (int i = 0; i < n; i++) DOUBLE_OPS_CHECK(fnear(r[i], expected[i]), "add");
+
+		expected = b; r = b;
+		doubleOps::scalar::axpy(-2.5, &a[0], n, &expected[0]);
+		axpy(-2.5, &a[0], n, &r[0]);
+		for (int i = 0; i < n; i++) DOUBLE_OPS_CHECK(fnear(r[i], expected[i]), "axpy");
+
+		DOUBLE_OPS_CHECK(fnear(dot(&a[0], &b[0], n), doubleOps::scalar::dot(&a[0], &b[0], n)), "dot");
+		DOUBLE_OPS_CHECK(fnear(sumSq(&a[0], n), doubleOps::scalar::sumSq(&a[0], n)), "sumSq");
+
+		double minVal = 0, maxVal = 0, eMinVal = 0, eMaxVal = 0;
+		int minIdx = 0, maxIdx = 0, eMinIdx = 0, eMaxIdx = 0;
+		doubleOps::scalar::minMaxIdx(&a[0], n, &eMinVal, &eMinIdx, &eMaxVal, &eMaxIdx);
+		minMaxIdx(&a[0], n, &minVal, &minIdx, &maxVal, &maxIdx);
+		DOUBLE_OPS_CHECK(minIdx == eMinIdx && maxIdx == eMaxIdx && (n == 0 || (minVal == eMinVal && maxVal == eMaxVal)), "minMaxIdx");
+	}
+	cout << "Test doubleOps (" << name << "): " << (success ? "Passed" : "Failed") << std::endl;
+	return success;
+}
+
+#define TEST_DOUBLE_OPS(ns) Test_doubleOps_impl(#ns, ns::weightedSum, ns::mulS, ns::add, ns::axpy, ns::dot, ns::sumSq, ns::minMaxIdx)
+
+void Test_doubleOps()
+{
+	TEST_DOUBLE_OPS(doubleOps);
+#if EMGU_SSE2
+	TEST_DOUBLE_OPS(doubleOps::sse2);
+#endif
+#if EMGU_AVX2
+	if (simdAVX2) TEST_DOUBLE_OPS(doubleOps::avx2);
+#endif
+#if EMGU_AVX512
+	if (simdAVX512) TEST_DOUBLE_OPS(doubleOps::avx512);
+#endif
+}
+
+template<typename Axpy, typename Dot, typename MinMaxIdx>
+void Benchmark_doubleOps_impl(const char* name, Axpy axpy, Dot dot, MinMaxIdx minMaxIdx)
+{
+	const int n = 4096;
+	const int iterations = 20000;
+	std::vector<double> a(n), b(n);
+	for (int i = 0; i < n; i++)
+	{
+		a[i] = rand() * 1.0e-6;
+		b[i] = rand() * 1.0e-6;
+	}
+
+	cv::TickMeter meter;
+	double s = 0;
+	meter.start();
+	for (int i = 0; i < iterations; i++)
+		s += dot(&a[0], &b[0], n);
+	meter.stop();
+	double dotTime = meter.getTimeMilli();
+
+	meter.reset();
+	meter.start();
+	for (int i = 0; i < iterations; i++)
+		axpy(1.0e-9, &a[0], n, &b[0]);
+	meter.stop();
+	double axpyTime = meter.getTimeMilli();
+
+	double minVal, maxVal;
+	int minIdx, maxIdx;
+	meter.reset();
+	meter.start();
+	for (int i = 0; i < iterations; i++)
+	{
+		minMaxIdx(&b[0], n, &minVal, &minIdx, &maxVal, &maxIdx);
+		s += minIdx;
+	}
+	meter.stop();
+	double minMaxTime = meter.getTimeMilli();
+
+	cout << "doubleOps benchmark (" << name << "): dot " << dotTime << "ms; axpy " << axpyTime << "ms; minMaxIdx " << minMaxTime << "ms (" << s << ")" << std::endl;
+}
+
+#define BENCHMARK_DOUBLE_OPS(ns) Benchmark_doubleOps_impl(#ns, ns::axpy, ns::dot, ns::minMaxIdx)
+
+void Benchmark_doubleOps()
+{
+	BENCHMARK_DOUBLE_OPS(doubleOps::scalar);
+#if EMGU_SSE2
+	BENCHMARK_DOUBLE_OPS(doubleOps::sse2);
+#endif
+#if EMGU_AVX2
+	if (simdAVX2) BENCHMARK_DOUBLE_OPS(doubleOps::avx2);
+#endif
+#if EMGU_AVX512
+	if (simdAVX512) BENCHMARK_DOUBLE_OPS(doubleOps::avx512);
+#endif
+}
+
 void Test_quaternions()
 {
 	const double eps = 1.0e-10;
@@ -128,6 +258,113 @@ void Test_quaternions()
 			? "Passed" : "Failed") << std::endl;
 }
 
+#define QUATERNIONS_SOA(v, n) { &v[0], &v[n], &v[2 * n], &v[3 * n] }
+#define POINTS_SOA(v, n) { &v[0], &v[n], &v[2 * n] }
+
+void Test_quaternions_batch()
+{
+	bool success = true;
+	//odd count to cover the remainder loops
+	const int n = 1003;
+	std::vector<double> q1Buf(4 * n), q2Buf(4 * n), qBuf(4 * n), pBuf(3 * n), pDstBuf(3 * n);
+	QuaternionsSoA q1 = QUATERNIONS_SOA(q1Buf, n), q2 = QUATERNIONS_SOA(q2Buf, n), qDst = QUATERNIONS_SOA(qBuf, n);
+	Point3D64fSoA p = POINTS_SOA(pBuf, n), pDst = POINTS_SOA(pDstBuf, n);
+	for (int i = 0; i < 4 * n; i++)
+	{
+		q1Buf[i] = (rand() % 2001 - 1000) * 0.01;
+		q2Buf[i] = (rand() % 2001 - 1000) * 0.01;
+	}
+	for (int i = 0; i < 3 * n; i++)
+		pBuf[i] = (rand() % 2001 - 1000) * 0.01;
+
+	quaternionsBatchRenorm(&q1, n);
+	quaternionsBatchRenorm(&q2, n);
+
+	quaternionsBatchMultiply(&q1, &q2, &qDst, n);
+	quaternionsBatchRotatePoints(&q1, &p, &pDst, n);
+	for (int i = 0; i < n; i++)
+	{
+		Quaternions a, b, m;
+		a.w = q1.w[i]; a.x = q1.x[i]; a.y = q1.y[i]; a.z = q1.z[i];
+		b.w = q2.w[i]; b.x = q2.x[i]; b.y = q2.y[i]; b.z = q2.z[i];
+		success &= fnear(a.w * a.w + a.x * a.x + a.y * a.y + a.z * a.z, 1.0);
+		a.multiply(&b, &m);
+		success &= fnear(m.w, qDst.w[i]) && fnear(m.x, qDst.x[i]) && fnear(m.y, qDst.y[i]) && fnear(m.z, qDst.z[i]);
+		CvPoint3D64f pt = cvPoint3D64f(p.x[i], p.y[i], p.z[i]), ptDst;
+		a.rotatePoint(&pt, &ptDst);
+		success &= fnear(ptDst.x, pDst.x[i]) && fnear(ptDst.y, pDst.y[i]) && fnear(ptDst.z, pDst.z[i]);
+	}
+	cout << "Test quaternions batch multiply and rotate: " << (success ? "Passed" : "Failed") << std::endl;
+
+	success = true;
+	Quaternions r;
+	r.w = q1.w[0]; r.x = q1.x[0]; r.y = q1.y[0]; r.z = q1.z[0];
+	//the second pass is not normalized, the points are still rotated the same way as rotatePoint does
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1)
+		{
+			r.w *= 1.7; r.x *= 1.7; r.y *= 1.7; r.z *= 1.7;
+		}
+		quaternionsRotatePointsSoA(&r, &p, &pDst, n);
+		for (int i = 0; i < n; i++)
+		{
+			CvPoint3D64f pt = cvPoint3D64f(p.x[i], p.y[i], p.z[i]), ptDst;
+			r.rotatePoint(&pt, &ptDst);
+			success &= fnear(ptDst.x, pDst.x[i]) && fnear(ptDst.y, pDst.y[i]) && fnear(ptDst.z, pDst.z[i]);
+		}
+	}
+	cout << "Test quaternions rotate points SoA: " << (success ? "Passed" : "Failed") << std::endl;
+
+	success = true;
+	quaternionsBatchSlerp(&q1, &q2, 0.3, &qDst, n);
+	std::vector<double> eulerBuf(3 * n);
+	Point3D64fSoA euler = POINTS_SOA(eulerBuf, n);
+	quaternionsBatchToEuler(&q1, &euler, n);
+	eulerToQuaternionsBatch(&euler, &q2, n);
+	for (int i = 0; i < n; i++)
+	{
+		//euler angles represent the same rotation, the quaternions may differ by sign
+		double sign = q1.w[i] * q2.w[i] + q1.x[i] * q2.x[i] + q1.y[i] * q2.y[i] + q1.z[i] * q2.z[i] < 0 ? -1.0 : 1.0;
+		success &= fabs(q1.w[i] - sign * q2.w[i]) < 1.0e-6 && fabs(q1.x[i] - sign * q2.x[i]) < 1.0e-6
+			&& fabs(q1.y[i] - sign * q2.y[i]) < 1.0e-6 && fabs(q1.z[i] - sign * q2.z[i]) < 1.0e-6;
+		success &= fnear(qDst.w[i] * qDst.w[i] + qDst.x[i] * qDst.x[i] + qDst.y[i] * qDst.y[i] + qDst.z[i] * qDst.z[i], 1.0);
+	}
+	cout << "Test quaternions batch slerp and euler: " << (success ? "Passed" : "Failed") << std::endl;
+}
+
+void Benchmark_quaternions_batch()
+{
+	const int n = 1 << 16;
+	const int iterations = 100;
+	std::vector<double> pBuf(3 * n), pDstBuf(3 * n);
+	std::vector<CvPoint3D64f> points(n), pointsDst(n);
+	for (int i = 0; i < 3 * n; i++)
+		pBuf[i] = (rand() % 2001 - 1000) * 0.01;
+	for (int i = 0; i < n; i++)
+		points[i] = cvPoint3D64f(pBuf[i], pBuf[n + i], pBuf[2 * n + i]);
+	Point3D64fSoA p = POINTS_SOA(pBuf, n), pDst = POINTS_SOA(pDstBuf, n);
+
+	Quaternions q;
+	q.w = 0.5; q.x = 0.3; q.y = -0.2; q.z = 0.7;
+	q.renorm();
+
+	cv::TickMeter tm;
+	tm.start();
+	for (int k = 0; k < iterations; k++)
+		for (int i = 0; i < n; i++)
+			q.rotatePoint(&points[i], &pointsDst[i]);
+	tm.stop();
+	double single = tm.getTimeMilli();
+
+	tm.reset();
+	tm.start();
+	for (int k = 0; k < iterations; k++)
+		quaternionsRotatePointsSoA(&q, &p, &pDst, n);
+	tm.stop();
+	cout << "Rotate " << n << " points x" << iterations << ": per point " << single << "ms, SoA " << tm.getTimeMilli() << "ms" << std::endl;
+}
+
 /*
 void Test_GpuMatCopy()
 {
@@ -271,7 +508,11 @@ int main()
 	Test_3D_cross_product();
 
 	Test_double_MulS();
+	Test_doubleOps();
+	Benchmark_doubleOps();
 	Test_quaternions();
+	Test_quaternions_batch();
+	Benchmark_quaternions_batch();
 	//Test_GpuMatCopy();
 	Test_MatchTemplate();
 